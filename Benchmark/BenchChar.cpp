@@ -0,0 +1,519 @@
+/**
+ * @file BenchChar.cpp
+ * @brief Benchmark de la versión char[] del cifrado.
+ *
+ * Mide las mismas operaciones que BenchString.cpp para poder comparar
+ * ambas versiones. Como la versión char[] no tiene encriptarCadena, esa
+ * fila mide textoAbinario() + encriptarBits(), que es lo equivalente.
+ * Además mide encriptarArchivoEn(), la ruta que usa main.cpp al guardar,
+ * y compara guardarArchivoLineas() (writev y rename) con el guardado
+ * anterior por ofstream. Antes de medir comprueba que todas las rutas
+ * den lo mismo, que el cifrado por flujo dé lo mismo en trozos que de
+ * una vez, que los núcleos SSE2/AVX2 de la conversión den lo mismo que
+ * el escalar y que encriptarArchivoEn() reserve memoria una vez por
+ * archivo, no por línea.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Medicion.h"
+#include "AlmacenSegmentado.h"
+#include "CifradoFlujo.h"
+#include "ConversionSIMD.h"
+#include "Encriptacion.h"
+#include "IndiceCedulas.h"
+#include "ManipulacionDeArchivos.h"
+#include "PoolHilos.h"
+#include "UtilidadesCadena.h"
+
+using namespace std;
+
+/// Acumula resultados para que el compilador no descarte las llamadas.
+static volatile size_t sumidero = 0;
+
+/**
+ * @brief Convierte registros generados a un arreglo char** (líneas con '\0').
+ */
+static char** crearLineas(const vector<string>& registros) {
+    char** lineas = new char*[registros.size()];
+    for (size_t i = 0; i < registros.size(); i++) {
+        lineas[i] = new char[registros[i].size() + 1];
+        copiar(lineas[i], registros[i].c_str());
+    }
+    return lineas;
+}
+
+static void liberarLineas(char** lineas, int numLineas) {
+    for (int i = 0; i < numLineas; i++) delete[] lineas[i];
+    delete[] lineas;
+}
+
+/// Las pasadas de guardado escriben unos 4 MB, para que abrir y
+/// renombrar el archivo no dominen la medición.
+static const int FACTOR_REGISTROS_ARCHIVO = 16;
+
+/**
+ * @brief Guardado anterior a las escrituras reunidas: cada línea y cada
+ *        "\n" pasan por ofstream::operator<<. Sirve de referencia.
+ */
+static bool guardarConFlujo(const char* rutaArchivo, char** lineas, int numLineas) {
+    ofstream archivo(rutaArchivo, ios::trunc | ios::binary);
+    if (!archivo.is_open()) return false;
+    for (int i = 0; i < numLineas; i++) {
+        archivo << lineas[i];
+        if (i < numLineas - 1) archivo << "\n";
+    }
+    archivo.close();
+    return !archivo.fail();
+}
+
+/**
+ * @brief Comprueba que guardarArchivoLineas() escriba lo mismo que el
+ *        guardado por ofstream.
+ */
+static bool verificarGuardado(int tam, const string& rutaNueva, const string& rutaFlujo) {
+    vector<string> registros = generarRegistros(100, tam);
+    registros[10].clear();   // las líneas vacías también deben coincidir
+    int n = (int)registros.size();
+    char** lineas = crearLineas(registros);
+
+    bool ok = true;
+    {
+        SilencioCout silencio;
+        if (!guardarArchivoLineas(rutaNueva.c_str(), lineas, n) || !guardarConFlujo(rutaFlujo.c_str(), lineas, n))
+            ok = fallaEquivalencia("no se pudo escribir el archivo de prueba", 0, tam);
+        else if (leerContenido(rutaNueva) != leerContenido(rutaFlujo))
+            ok = fallaEquivalencia("guardarArchivoLineas != guardado por ofstream", 0, tam);
+    }
+    liberarLineas(lineas, n);
+    return ok;
+}
+
+/**
+ * @brief Cifra un registro con textoAbinario() + encriptarBits().
+ */
+static unsigned char* encriptarRegistro(const string& plano, int semilla) {
+    unsigned char* binario = textoAbinario((unsigned char*)plano.c_str(), (int)plano.size());
+    unsigned char* cifrado = encriptarBits(binario, (int)plano.size() * 8, semilla);
+    delete[] binario;
+    return cifrado;
+}
+
+/**
+ * @brief Comprueba que el cifrado por flujo dé lo mismo en trozos que de
+ *        una vez, y que encriptarAlmacenFlujo() escriba lo mismo que
+ *        encriptarArchivo() + guardarArchivoLineas() o guardarSegmentado().
+ */
+static bool verificarFlujo(int semilla, int tam, const string& rutaPlano, const string& rutaFlujo,
+                           const string& rutaEntera) {
+    bool ok = true;
+    vector<string> planos = generarRegistros(100, tam);
+    mt19937 azar((unsigned)(semilla * 1000 + tam));
+
+    CifradorFlujo cifrador, descifrador;
+    iniciarCifradorFlujo(cifrador, semilla);
+    iniciarCifradorFlujo(descifrador, semilla);
+    for (const string& plano : planos) {
+        int len = (int)plano.size();
+        const unsigned char* entrada = (const unsigned char*)plano.c_str();
+        vector<unsigned char> entero(len), trozos(len), descifrado(len);
+        encriptarBitsEmpaquetados(entrada, entero.data(), len * 8, semilla);
+
+        for (int i = 0, n; i < len; i += n) {
+            n = min(len - i, 1 + (int)(azar() % 13));
+            procesarFlujo(cifrador, entrada + i, n, &trozos[i]);
+        }
+        for (int i = 0, n; i < len; i += n) {
+            n = min(len - i, 1 + (int)(azar() % 13));
+            procesarFlujo(descifrador, &trozos[i], n, &descifrado[i]);
+        }
+        reiniciarCifradorFlujo(cifrador);
+        reiniciarCifradorFlujo(descifrador);
+        if (trozos != entero)
+            ok = fallaEquivalencia("CifradorFlujo en trozos != encriptarBitsEmpaquetados", semilla, tam);
+        if (memcmp(descifrado.data(), entrada, len) != 0)
+            ok = fallaEquivalencia("CifradorFlujo no descifra lo que cifra", semilla, tam);
+    }
+
+    // El texto plano lleva una línea vacía, que la carga descarta
+    vector<string> conVacia(planos);
+    conVacia.insert(conVacia.begin() + 10, string());
+    int n = (int)planos.size(), nVacia = (int)conVacia.size();
+    char** lineasPlano = crearLineas(conVacia);
+    char** cifradas = crearLineas(planos);
+    encriptarArchivo(cifradas, n, semilla);
+    const int64_t tamSegmento = (int64_t)(tam * 8 + 1) * 30;   // unos cuatro segmentos
+
+    SilencioCout silencio;
+    bool escritos = guardarArchivoLineas(rutaPlano.c_str(), lineasPlano, nVacia)
+                    && encriptarAlmacenFlujo(rutaPlano.c_str(), rutaFlujo.c_str(), semilla)
+                    && guardarArchivoLineas(rutaEntera.c_str(), cifradas, n);
+    if (!escritos) {
+        ok = fallaEquivalencia("no se pudo escribir el archivo de prueba", semilla, tam);
+    } else if (leerContenido(rutaFlujo) != leerContenido(rutaEntera)) {
+        ok = fallaEquivalencia("encriptarAlmacenFlujo != encriptarArchivo + guardarArchivoLineas", semilla, tam);
+    }
+
+    const string almacenFlujo = rutaFlujo + ".almacen", almacenEntero = rutaEntera + ".almacen";
+    escritos = escritos
+               && encriptarAlmacenFlujo(rutaPlano.c_str(), almacenFlujo.c_str(), semilla, tamSegmento)
+               && guardarSegmentado(almacenEntero.c_str(), cifradas, n, false, tamSegmento, true);
+    liberarLineas(lineasPlano, nVacia);
+    liberarLineas(cifradas, n);
+    if (!escritos)
+        return fallaEquivalencia("no se pudo escribir el almacén de prueba", semilla, tam);
+
+    ManifiestoAlmacen manifiesto;
+    bool iguales = leerManifiesto(almacenFlujo.c_str(), manifiesto) && manifiesto.numSegmentos > 1
+                   && leerContenido(almacenFlujo) == leerContenido(almacenEntero);
+    char segmentoFlujo[TAM_MAX_RUTA_SEGMENTO], segmentoEntero[TAM_MAX_RUTA_SEGMENTO];
+    for (int k = 0; k < manifiesto.numSegmentos; k++) {
+        rutaSegmento(almacenFlujo.c_str(), manifiesto.generacion, k, segmentoFlujo);
+        rutaSegmento(almacenEntero.c_str(), manifiesto.generacion, k, segmentoEntero);
+        iguales = iguales && leerContenido(segmentoFlujo) == leerContenido(segmentoEntero);
+        remove(segmentoFlujo);
+        remove(segmentoEntero);
+    }
+    liberarManifiesto(manifiesto);
+    remove(almacenFlujo.c_str());
+    remove(almacenEntero.c_str());
+    if (!iguales)
+        ok = fallaEquivalencia("encriptarAlmacenFlujo segmentado != guardarSegmentado", semilla, tam);
+    return ok;
+}
+
+/**
+ * @brief Comprueba que las distintas rutas del cifrado den lo mismo.
+ */
+static bool verificarEquivalencia(int semilla, int tam, PoolHilos& pool) {
+    bool ok = true;
+    vector<string> planos = generarRegistros(100, tam);
+    int n = (int)planos.size();
+    int bits = tam * 8;
+
+    for (const string& plano : planos) {
+        unsigned char* binario = textoAbinario((unsigned char*)plano.c_str(), tam);
+        unsigned char* texto = binarioAtexto(binario, bits);
+        if (!cadenasIguales((const char*)texto, plano.c_str()))
+            ok = fallaEquivalencia("binarioAtexto(textoAbinario(x)) != x", semilla, tam);
+
+        unsigned char* cifrado = encriptarBits(binario, bits, semilla);
+        bool esNot = true;
+        for (int j = 0; j < bits; j++)
+            if (cifrado[j] != (binario[j] == '0' ? '1' : '0')) esNot = false;
+        if (!esNot)
+            ok = fallaEquivalencia("encriptarBits != NOT bit a bit", semilla, tam);
+        unsigned char* descifrado = desencriptarBits(cifrado, bits, semilla);
+        if (!cadenasIguales((const char*)descifrado, (const char*)binario))
+            ok = fallaEquivalencia("desencriptarBits no invierte encriptarBits", semilla, tam);
+
+        delete[] binario;
+        delete[] texto;
+        delete[] cifrado;
+        delete[] descifrado;
+    }
+
+    char** secuencial = crearLineas(planos);
+    char** paralelo = crearLineas(planos);
+    char** vistas = new char*[n];
+    ArenaCifrado arena;
+
+    encriptarArchivo(secuencial, n, semilla);
+    encriptarArchivo(paralelo, n, semilla, pool);
+    for (int i = 0; i < n; i++) {
+        unsigned char* esperado = encriptarRegistro(planos[i], semilla);
+        if (!cadenasIguales(secuencial[i], (const char*)esperado) || !cadenasIguales(paralelo[i], (const char*)esperado))
+            ok = fallaEquivalencia("encriptarArchivo != textoAbinario + encriptarBits", semilla, tam);
+        delete[] esperado;
+    }
+
+    char** planosC = crearLineas(planos);
+    encriptarArchivoEn(planosC, n, semilla, arena, vistas, pool);
+    for (int i = 0; i < n; i++)
+        if (!cadenasIguales(vistas[i], secuencial[i]))
+            ok = fallaEquivalencia("encriptarArchivoEn != encriptarArchivo", semilla, tam);
+
+    liberarArena(arena);
+    delete[] vistas;
+    liberarLineas(secuencial, n);
+    liberarLineas(paralelo, n);
+    liberarLineas(planosC, n);
+    return ok;
+}
+
+/**
+ * @brief Comprueba que encriptarArchivoEn() haga O(1) reservas por archivo.
+ *
+ * Con una arena nueva debe reservar una sola vez, tenga el archivo 100
+ * u 800 líneas, y con la arena ya dimensionada ninguna. La versión con
+ * pool puede reservar algo para repartir el trabajo, pero lo mismo para
+ * los dos tamaños.
+ */
+static bool verificarReservas(int semilla, int tam, PoolHilos& pool) {
+    bool ok = true;
+    const int tamanios[2] = { 100, 800 };
+    vector<string> planos = generarRegistros(tamanios[1], tam);
+    char** lineas = crearLineas(planos);
+    char** vistas = new char*[tamanios[1]];
+    long conPool[2];
+
+    for (int k = 0; k < 2; k++) {
+        int n = tamanios[k];
+        ArenaCifrado arena;
+        long antes = reservasRealizadas();
+        encriptarArchivoEn(lineas, n, semilla, arena, vistas);
+        long nueva = reservasRealizadas() - antes;
+
+        antes = reservasRealizadas();
+        encriptarArchivoEn(lineas, n, semilla, arena, vistas);
+        long reutilizada = reservasRealizadas() - antes;
+        if (nueva != 1 || reutilizada != 0 || arena.reservas != 1)
+            ok = fallaEquivalencia("encriptarArchivoEn reserva memoria por línea o por llamada", semilla, tam);
+        liberarArena(arena);
+
+        ArenaCifrado arenaPool;
+        antes = reservasRealizadas();
+        encriptarArchivoEn(lineas, n, semilla, arenaPool, vistas, pool);
+        conPool[k] = reservasRealizadas() - antes;
+        if (arenaPool.reservas != 1)
+            ok = fallaEquivalencia("encriptarArchivoEn (pool) reservó la arena más de una vez", semilla, tam);
+        liberarArena(arenaPool);
+    }
+    if (conPool[0] != conPool[1])
+        ok = fallaEquivalencia("encriptarArchivoEn (pool) reserva según la cantidad de líneas", semilla, tam);
+
+    delete[] vistas;
+    liberarLineas(lineas, tamanios[1]);
+    return ok;
+}
+
+/**
+ * @brief Comprueba los límites de longitud de empaquetarCedula().
+ *
+ * Solo las longitudes que acepta errorCedula() (6 a 10 dígitos) deben
+ * dar una clave distinta de 0 que vuelva al mismo texto, incluida la
+ * cédula de puros ceros. Con más dígitos la cantidad ya no cabe en los
+ * 4 bits altos de la clave y se tiene que rechazar.
+ */
+static bool verificarCedulas() {
+    bool ok = true;
+    for (int digitos = 1; digitos <= 17; digitos++) {
+        const char* patrones[2] = { "98765432109876543", "00000000000000000" };
+        for (const char* patron : patrones) {
+            uint64_t clave = empaquetarCedula(patron, digitos);
+            bool aceptable = digitos >= 6 && digitos <= 10;
+            if ((clave != 0) != aceptable) {
+                ok = fallaEquivalencia("empaquetarCedula acepta una longitud inválida o rechaza una válida", 0, digitos);
+                continue;
+            }
+            if (!aceptable) continue;
+
+            char texto[TAM_TEXTO_CEDULA];
+            desempaquetarCedula(clave, texto);
+            if (strncmp(texto, patron, digitos) != 0 || texto[digitos] != '\0')
+                ok = fallaEquivalencia("desempaquetarCedula no invierte empaquetarCedula", 0, digitos);
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Compara los núcleos SSE2 y AVX2 de la conversión con el escalar.
+ *
+ * Longitudes al azar (con colas que no llenan un vector), entradas y
+ * salidas desalineadas y cadenas con un carácter inválido en una
+ * posición al azar. Ningún núcleo debe escribir más allá de su salida.
+ * Los núcleos que la CPU no soporta se saltan.
+ */
+static bool verificarNucleos() {
+    const int MAX_BYTES = 300, DESPLAZAMIENTO = 32, CENTINELA = 0xA5, PRUEBAS = 500;
+    const NucleoConversion nucleos[2] = { NUCLEO_SSE2, NUCLEO_AVX2 };
+    vector<unsigned char> bytes(MAX_BYTES + DESPLAZAMIENTO);
+    vector<unsigned char> bits(MAX_BYTES * 8 + DESPLAZAMIENTO);
+    vector<unsigned char> esperado(MAX_BYTES * 8 + DESPLAZAMIENTO);
+    vector<unsigned char> obtenido(MAX_BYTES * 8 + DESPLAZAMIENTO + 1);
+    mt19937 azar(20240611);
+    bool ok = true;
+
+    for (int prueba = 0; prueba < PRUEBAS; prueba++) {
+        int numBytes = (int)(azar() % (MAX_BYTES + 1));
+        int despEntrada = (int)(azar() % DESPLAZAMIENTO);
+        int despSalida = (int)(azar() % DESPLAZAMIENTO);
+        for (int i = 0; i < numBytes; i++) bytes[despEntrada + i] = (unsigned char)azar();
+        expandirBitsEscalar(&bytes[despEntrada], numBytes, &esperado[0]);
+
+        // Cadena de bits: válida, o con un carácter que no es '0' ni '1'
+        int numBits = numBytes * 8;
+        memcpy(&bits[despEntrada], &esperado[0], numBits);
+        bool conInvalido = numBits > 0 && azar() % 2 == 0;
+        if (conInvalido) {
+            unsigned char c;
+            do c = (unsigned char)azar(); while (c == '0' || c == '1');
+            bits[despEntrada + azar() % numBits] = c;
+        }
+
+        for (NucleoConversion nucleo : nucleos) {
+            if (!nucleoConversionSoportado(nucleo)) continue;
+            string nombre = nombreNucleoConversion(nucleo);
+
+            memset(&obtenido[0], CENTINELA, obtenido.size());
+            expandirBitsCon(nucleo, &bytes[despEntrada], numBytes, &obtenido[despSalida]);
+            if (memcmp(&obtenido[despSalida], &esperado[0], numBits) != 0 ||
+                obtenido[despSalida + numBits] != CENTINELA)
+                ok = fallaEquivalencia("expandirBits " + nombre + " != escalar", prueba, numBytes);
+
+            memset(&obtenido[0], CENTINELA, obtenido.size());
+            bool valido = empaquetarBitsCon(nucleo, &bits[despEntrada], numBits, &obtenido[despSalida]);
+            if (valido == conInvalido || obtenido[despSalida + numBytes] != CENTINELA ||
+                (valido && memcmp(&obtenido[despSalida], &bytes[despEntrada], numBytes) != 0))
+                ok = fallaEquivalencia("empaquetarBits " + nombre + " != escalar", prueba, numBytes);
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        OpcionesBenchmark opciones = leerOpciones(argc, argv);
+        PoolHilos pool(0);
+        vector<Resultado> resultados;
+
+        const string rutaNueva = rutaTemporal("bench_char_writev.txt");
+        const string rutaFlujo = rutaTemporal("bench_char_ofstream.txt");
+        const string rutaPlano = rutaTemporal("bench_char_plano.txt");
+        const string rutaCifradoFlujo = rutaTemporal("bench_char_cifrado_flujo.txt");
+        const string rutaCifradoEntero = rutaTemporal("bench_char_cifrado_entero.txt");
+
+        bool ok = verificarNucleos();
+        ok = verificarCedulas() && ok;
+        for (int tam : tamaniosBarrido(opciones)) {
+            for (int semilla : semillasBarrido(opciones)) {
+                ok = verificarEquivalencia(semilla, tam, pool) && ok;
+                ok = verificarReservas(semilla, tam, pool) && ok;
+                ok = verificarFlujo(semilla, tam, rutaPlano, rutaCifradoFlujo, rutaCifradoEntero) && ok;
+            }
+            ok = verificarGuardado(tam, rutaNueva, rutaFlujo) && ok;
+        }
+        if (!ok) return 2;
+
+        cout << "Benchmark version char[] (" << pool.numHilos() << " hilos)\n\n";
+        imprimirCabecera();
+
+        for (int tam : tamaniosBarrido(opciones)) {
+            int n = registrosPorPasada(tam);
+            int bits = tam * 8;
+            vector<string> planos = generarRegistros(n, tam);
+            vector<unsigned char*> binarios(n);
+            for (int i = 0; i < n; i++)
+                binarios[i] = textoAbinario((unsigned char*)planos[i].c_str(), tam);
+
+            resultados.push_back(medir("char", "textoAbinario", 0, tam, n, opciones, nullptr, [&] {
+                for (const string& p : planos) {
+                    unsigned char* b = textoAbinario((unsigned char*)p.c_str(), tam);
+                    sumidero += b[0];
+                    delete[] b;
+                }
+            }));
+            imprimirResultado(resultados.back());
+
+            resultados.push_back(medir("char", "binarioAtexto", 0, tam, n, opciones, nullptr, [&] {
+                for (unsigned char* b : binarios) {
+                    unsigned char* t = binarioAtexto(b, bits);
+                    sumidero += t[0];
+                    delete[] t;
+                }
+            }));
+            imprimirResultado(resultados.back());
+
+            char** datos = crearLineas(planos);
+            char** vistas = new char*[n];
+            ArenaCifrado arena;
+            auto restaurar = [&] {
+                for (int i = 0; i < n; i++) {
+                    delete[] datos[i];
+                    datos[i] = new char[tam + 1];
+                    copiar(datos[i], planos[i].c_str());
+                }
+            };
+
+            for (int semilla : semillasBarrido(opciones)) {
+                resultados.push_back(medir("char", "encriptarBits", semilla, tam, n, opciones, nullptr, [&] {
+                    for (unsigned char* b : binarios) {
+                        unsigned char* c = encriptarBits(b, bits, semilla);
+                        sumidero += c[0];
+                        delete[] c;
+                    }
+                }));
+                imprimirResultado(resultados.back());
+
+                resultados.push_back(medir("char", "encriptarCadena", semilla, tam, n, opciones, nullptr, [&] {
+                    for (const string& p : planos) {
+                        unsigned char* c = encriptarRegistro(p, semilla);
+                        sumidero += c[0];
+                        delete[] c;
+                    }
+                }));
+                imprimirResultado(resultados.back());
+
+                resultados.push_back(medir("char", "encriptarArchivo", semilla, tam, n, opciones, restaurar, [&] {
+                    encriptarArchivo(datos, n, semilla);
+                }));
+                imprimirResultado(resultados.back());
+
+                resultados.push_back(medir("char", "encriptarArchivoParalelo", semilla, tam, n, opciones, restaurar, [&] {
+                    encriptarArchivo(datos, n, semilla, pool);
+                }));
+                imprimirResultado(resultados.back());
+
+                restaurar();
+                resultados.push_back(medir("char", "encriptarArchivoEn", semilla, tam, n, opciones, nullptr, [&] {
+                    encriptarArchivoEn(datos, n, semilla, arena, vistas);
+                }));
+                imprimirResultado(resultados.back());
+            }
+
+            liberarArena(arena);
+            delete[] vistas;
+            liberarLineas(datos, n);
+            for (unsigned char* b : binarios) delete[] b;
+
+            // Guardado de líneas: semilla 0 porque no cifra
+            int nArchivo = n * FACTOR_REGISTROS_ARCHIVO;
+            char** lineas = crearLineas(generarRegistros(nArchivo, tam));
+            {
+                SilencioCout silencio;
+                resultados.push_back(medir("char", "guardarConFlujo", 0, tam, nArchivo, opciones, nullptr, [&] {
+                    if (!guardarConFlujo(rutaFlujo.c_str(), lineas, nArchivo))
+                        throw "Error: no se pudo escribir el archivo de prueba.";
+                }));
+                resultados.push_back(medir("char", "guardarArchivoLineas", 0, tam, nArchivo, opciones, nullptr, [&] {
+                    if (!guardarArchivoLineas(rutaNueva.c_str(), lineas, nArchivo))
+                        throw "Error: no se pudo escribir el archivo de prueba.";
+                }));
+            }
+            imprimirResultado(resultados[resultados.size() - 2]);
+            imprimirResultado(resultados.back());
+            liberarLineas(lineas, nArchivo);
+        }
+        remove(rutaNueva.c_str());
+        remove(rutaFlujo.c_str());
+        remove(rutaPlano.c_str());
+        remove(rutaCifradoFlujo.c_str());
+        remove(rutaCifradoEntero.c_str());
+
+        if (!opciones.rutaCsv.empty() && !guardarCsv(opciones.rutaCsv, resultados))
+            return 1;
+        if (!opciones.rutaBase.empty() && compararConBase(opciones.rutaBase, resultados, opciones.tolerancia) > 0)
+            return 3;
+        return 0;
+    }
+    catch (const char* e) {
+        cerr << e << endl;
+        return 1;
+    }
+}
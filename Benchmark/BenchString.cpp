@@ -0,0 +1,366 @@
+/**
+ * @file BenchString.cpp
+ * @brief Benchmark de la versión std::string del cifrado.
+ *
+ * Mide textoAbinario, binarioAtexto, encriptarBits, encriptarCadena y
+ * encriptarArchivo (secuencial y con el pool de hilos) barriendo semillas
+ * y tamaños de registro. También compara guardarArchivoLineas() (writev
+ * y rename) con el guardado anterior por ofstream. Antes de medir
+ * verifica que las rutas rápidas coincidan entre sí, que el cifrado por
+ * flujo dé lo mismo en trozos que de una vez y que los núcleos SSE2/AVX2
+ * de la conversión den lo mismo que el escalar.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Medicion.h"
+#include "AlmacenSegmentado.h"
+#include "CifradoFlujo.h"
+#include "ConversionSIMD.h"
+#include "Encriptacion.h"
+#include "IndiceCedulas.h"
+#include "ManipulacionArchivos.h"
+#include "PoolHilos.h"
+
+using namespace std;
+
+/// Acumula resultados para que el compilador no descarte las llamadas.
+static volatile size_t sumidero = 0;
+
+/// Las pasadas de guardado escriben unos 4 MB, para que abrir y
+/// renombrar el archivo no dominen la medición.
+static const int FACTOR_REGISTROS_ARCHIVO = 16;
+
+/**
+ * @brief Guardado anterior a las escrituras reunidas: cada línea y cada
+ *        '\n' pasan por ofstream::operator<<. Sirve de referencia.
+ */
+static bool guardarConFlujo(const string& rutaArchivo, const string* lineas, int numLineas) {
+    ofstream archivo(rutaArchivo, ios::trunc | ios::binary);
+    if (!archivo.is_open()) return false;
+    for (int i = 0; i < numLineas; i++) {
+        archivo << lineas[i];
+        if (i < numLineas - 1) archivo << '\n';
+    }
+    archivo.close();
+    return !archivo.fail();
+}
+
+/**
+ * @brief Comprueba que guardarArchivoLineas() escriba lo mismo que el
+ *        guardado por ofstream.
+ */
+static bool verificarGuardado(int tam, const string& rutaNueva, const string& rutaFlujo) {
+    vector<string> lineas = generarRegistros(100, tam);
+    lineas[10].clear();   // las líneas vacías también deben coincidir
+    int n = static_cast<int>(lineas.size());
+
+    SilencioCout silencio;
+    if (!guardarArchivoLineas(rutaNueva, lineas.data(), n) || !guardarConFlujo(rutaFlujo, lineas.data(), n))
+        return fallaEquivalencia("no se pudo escribir el archivo de prueba", 0, tam);
+    if (leerContenido(rutaNueva) != leerContenido(rutaFlujo))
+        return fallaEquivalencia("guardarArchivoLineas != guardado por ofstream", 0, tam);
+    return true;
+}
+
+/**
+ * @brief Comprueba que las distintas rutas del cifrado den lo mismo.
+ */
+static bool verificarEquivalencia(int semilla, int tam, PoolHilos& pool) {
+    bool ok = true;
+    vector<string> planos = generarRegistros(100, tam);
+
+    for (const string& plano : planos) {
+        string binario = textoAbinario(plano);
+        if (binarioAtexto(binario) != plano)
+            ok = fallaEquivalencia("binarioAtexto(textoAbinario(x)) != x", semilla, tam);
+
+        string cifrado = encriptarBits(binario, semilla);
+        string invertido = binario;
+        for (char& c : invertido) c = (c == '0') ? '1' : '0';
+        if (cifrado != invertido)
+            ok = fallaEquivalencia("encriptarBits != NOT bit a bit", semilla, tam);
+        if (encriptarCadena(plano, semilla) != cifrado)
+            ok = fallaEquivalencia("encriptarCadena != encriptarBits(textoAbinario)", semilla, tam);
+        if (desencriptarBits(cifrado, semilla) != binario)
+            ok = fallaEquivalencia("desencriptarBits no invierte encriptarBits", semilla, tam);
+        if (desencriptarCadena(cifrado, semilla) != plano)
+            ok = fallaEquivalencia("desencriptarCadena no invierte encriptarCadena", semilla, tam);
+    }
+
+    int n = static_cast<int>(planos.size());
+    vector<string> secuencial(planos), paralelo(planos);
+    encriptarArchivo(secuencial.data(), n, semilla);
+    encriptarArchivo(paralelo.data(), n, semilla, pool);
+    for (int i = 0; i < n; i++)
+        if (secuencial[i] != paralelo[i] || secuencial[i] != encriptarCadena(planos[i], semilla))
+            ok = fallaEquivalencia("encriptarArchivo paralelo/secuencial", semilla, tam);
+
+    return ok;
+}
+
+/**
+ * @brief Comprueba que el cifrado por flujo dé lo mismo en trozos que
+ *        de una vez.
+ *
+ * Cada registro pasa por CifradorFlujo en trozos de tamaño al azar y se
+ * compara con encriptarBitsEmpaquetados(); luego se descifra en otros
+ * trozos. A nivel de archivo, encriptarAlmacenFlujo() debe escribir lo
+ * mismo que cargar, encriptarArchivo() y guardar: un archivo suelto
+ * como guardarArchivoLineas() y varios segmentos como guardarSegmentado().
+ */
+static bool verificarFlujo(int semilla, int tam, const string& rutaPlano, const string& rutaFlujo,
+                           const string& rutaEntera) {
+    bool ok = true;
+    vector<string> planos = generarRegistros(100, tam);
+    mt19937 azar(static_cast<unsigned>(semilla * 1000 + tam));
+
+    CifradorFlujo cifrador(semilla, CifradorFlujo::ENCRIPTAR);
+    CifradorFlujo descifrador(semilla, CifradorFlujo::DESENCRIPTAR);
+    for (const string& plano : planos) {
+        const uint8_t* entrada = reinterpret_cast<const uint8_t*>(plano.data());
+        vector<uint8_t> entero(plano.size()), trozos(plano.size()), descifrado(plano.size());
+        encriptarBitsEmpaquetados(entrada, entero.data(), plano.size() * 8, semilla);
+
+        for (size_t i = 0, n; i < plano.size(); i += n) {
+            n = min<size_t>(plano.size() - i, 1 + azar() % 13);
+            cifrador.procesar(entrada + i, n, &trozos[i]);
+        }
+        for (size_t i = 0, n; i < plano.size(); i += n) {
+            n = min<size_t>(plano.size() - i, 1 + azar() % 13);
+            descifrador.procesar(&trozos[i], n, &descifrado[i]);
+        }
+        cifrador.reiniciar();
+        descifrador.reiniciar();
+        if (trozos != entero)
+            ok = fallaEquivalencia("CifradorFlujo en trozos != encriptarBitsEmpaquetados", semilla, tam);
+        if (memcmp(descifrado.data(), plano.data(), plano.size()) != 0)
+            ok = fallaEquivalencia("CifradorFlujo no descifra lo que cifra", semilla, tam);
+    }
+
+    // El texto plano lleva una línea vacía, que la carga descarta
+    vector<string> conVacia(planos);
+    conVacia.insert(conVacia.begin() + 10, string());
+    vector<string> cifradas(planos);
+    encriptarArchivo(cifradas.data(), static_cast<int>(cifradas.size()), semilla);
+    const uint64_t tamSegmento = (tam * 8 + 1) * 30;   // unos cuatro segmentos
+
+    SilencioCout silencio;
+    bool escritos = guardarArchivoLineas(rutaPlano, conVacia.data(), static_cast<int>(conVacia.size()))
+                    && encriptarAlmacenFlujo(rutaPlano, rutaFlujo, semilla)
+                    && guardarArchivoLineas(rutaEntera, cifradas.data(), static_cast<int>(cifradas.size()));
+    if (!escritos)
+        return fallaEquivalencia("no se pudo escribir el archivo de prueba", semilla, tam);
+    if (leerContenido(rutaFlujo) != leerContenido(rutaEntera))
+        ok = fallaEquivalencia("encriptarAlmacenFlujo != encriptarArchivo + guardarArchivoLineas", semilla, tam);
+
+    const string almacenFlujo = rutaFlujo + ".almacen", almacenEntero = rutaEntera + ".almacen";
+    escritos = encriptarAlmacenFlujo(rutaPlano, almacenFlujo, semilla, tamSegmento)
+               && guardarSegmentado(almacenEntero, cifradas.data(), static_cast<int64_t>(cifradas.size()), false,
+                                    tamSegmento, true);
+    if (!escritos)
+        return fallaEquivalencia("no se pudo escribir el almacén de prueba", semilla, tam);
+    ManifiestoAlmacen manifiesto;
+    bool iguales = leerManifiesto(almacenFlujo, manifiesto) && manifiesto.segmentos.size() > 1
+                   && leerContenido(almacenFlujo) == leerContenido(almacenEntero);
+    for (size_t k = 0; k < manifiesto.segmentos.size(); k++) {
+        const string segmentoFlujo = rutaSegmento(almacenFlujo, manifiesto.generacion, k);
+        const string segmentoEntero = rutaSegmento(almacenEntero, manifiesto.generacion, k);
+        iguales = iguales && leerContenido(segmentoFlujo) == leerContenido(segmentoEntero);
+        remove(segmentoFlujo.c_str());
+        remove(segmentoEntero.c_str());
+    }
+    remove(almacenFlujo.c_str());
+    remove(almacenEntero.c_str());
+    if (!iguales)
+        ok = fallaEquivalencia("encriptarAlmacenFlujo segmentado != guardarSegmentado", semilla, tam);
+    return ok;
+}
+
+/**
+ * @brief Comprueba los límites de longitud de empaquetarCedula().
+ *
+ * Solo las longitudes que acepta errorCedula() (6 a 10 dígitos) deben
+ * dar una clave distinta de 0 que vuelva al mismo texto, incluida la
+ * cédula de puros ceros. Con más dígitos la cantidad ya no cabe en los
+ * 4 bits altos de la clave y se tiene que rechazar.
+ */
+static bool verificarCedulas() {
+    bool ok = true;
+    for (int digitos = 1; digitos <= 17; digitos++) {
+        for (string cedula : { string("98765432109876543", digitos), string(digitos, '0') }) {
+            uint64_t clave = empaquetarCedula(cedula);
+            bool aceptable = digitos >= 6 && digitos <= 10;
+            if ((clave != 0) != aceptable)
+                ok = fallaEquivalencia("empaquetarCedula acepta una longitud inválida o rechaza una válida", 0, digitos);
+            else if (aceptable && desempaquetarCedula(clave) != cedula)
+                ok = fallaEquivalencia("desempaquetarCedula no invierte empaquetarCedula", 0, digitos);
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Compara los núcleos SSE2 y AVX2 de la conversión con el escalar.
+ *
+ * Longitudes al azar (con colas que no llenan un vector), entradas y
+ * salidas desalineadas y cadenas con un carácter inválido en una
+ * posición al azar. Ningún núcleo debe escribir más allá de su salida.
+ * Los núcleos que la CPU no soporta se saltan.
+ */
+static bool verificarNucleos() {
+    const size_t MAX_BYTES = 300, DESPLAZAMIENTO = 32;
+    const uint8_t CENTINELA = 0xA5;
+    const int PRUEBAS = 500;
+    const NucleoConversion nucleos[2] = { NUCLEO_SSE2, NUCLEO_AVX2 };
+    vector<uint8_t> bytes(MAX_BYTES + DESPLAZAMIENTO);
+    string bits(MAX_BYTES * 8 + DESPLAZAMIENTO, '\0');
+    string esperado(MAX_BYTES * 8, '\0');
+    vector<uint8_t> empaquetado(MAX_BYTES + DESPLAZAMIENTO + 1);
+    string expandido(MAX_BYTES * 8 + DESPLAZAMIENTO + 1, '\0');
+    mt19937 azar(20240611);
+    bool ok = true;
+
+    for (int prueba = 0; prueba < PRUEBAS; prueba++) {
+        size_t numBytes = azar() % (MAX_BYTES + 1);
+        size_t despEntrada = azar() % DESPLAZAMIENTO;
+        size_t despSalida = azar() % DESPLAZAMIENTO;
+        for (size_t i = 0; i < numBytes; i++) bytes[despEntrada + i] = (uint8_t)azar();
+        expandirBitsEscalar(&bytes[despEntrada], numBytes, &esperado[0]);
+
+        // Cadena de bits: válida, o con un carácter que no es '0' ni '1'
+        size_t numBits = numBytes * 8;
+        memcpy(&bits[despEntrada], esperado.data(), numBits);
+        bool conInvalido = numBits > 0 && azar() % 2 == 0;
+        if (conInvalido) {
+            char c;
+            do c = (char)azar(); while (c == '0' || c == '1');
+            bits[despEntrada + azar() % numBits] = c;
+        }
+
+        for (NucleoConversion nucleo : nucleos) {
+            if (!nucleoConversionSoportado(nucleo)) continue;
+            string nombre = nombreNucleoConversion(nucleo);
+
+            memset(&expandido[0], CENTINELA, expandido.size());
+            expandirBitsCon(nucleo, &bytes[despEntrada], numBytes, &expandido[despSalida]);
+            if (memcmp(&expandido[despSalida], esperado.data(), numBits) != 0 ||
+                (uint8_t)expandido[despSalida + numBits] != CENTINELA)
+                ok = fallaEquivalencia("expandirBits " + nombre + " != escalar", prueba, (int)numBytes);
+
+            memset(&empaquetado[0], CENTINELA, empaquetado.size());
+            bool valido = empaquetarBitsCon(nucleo, &bits[despEntrada], numBits, &empaquetado[despSalida]);
+            if (valido == conInvalido || empaquetado[despSalida + numBytes] != CENTINELA ||
+                (valido && memcmp(&empaquetado[despSalida], &bytes[despEntrada], numBytes) != 0))
+                ok = fallaEquivalencia("empaquetarBits " + nombre + " != escalar", prueba, (int)numBytes);
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        OpcionesBenchmark opciones = leerOpciones(argc, argv);
+        PoolHilos pool(0);
+        vector<Resultado> resultados;
+
+        const string rutaNueva = rutaTemporal("bench_string_writev.txt");
+        const string rutaFlujo = rutaTemporal("bench_string_ofstream.txt");
+        const string rutaPlano = rutaTemporal("bench_string_plano.txt");
+        const string rutaCifradoFlujo = rutaTemporal("bench_string_cifrado_flujo.txt");
+        const string rutaCifradoEntero = rutaTemporal("bench_string_cifrado_entero.txt");
+
+        bool ok = verificarNucleos();
+        ok = verificarCedulas() && ok;
+        for (int tam : tamaniosBarrido(opciones)) {
+            for (int semilla : semillasBarrido(opciones)) {
+                ok = verificarEquivalencia(semilla, tam, pool) && ok;
+                ok = verificarFlujo(semilla, tam, rutaPlano, rutaCifradoFlujo, rutaCifradoEntero) && ok;
+            }
+            ok = verificarGuardado(tam, rutaNueva, rutaFlujo) && ok;
+        }
+        if (!ok) return 2;
+
+        cout << "Benchmark version std::string (" << pool.numHilos() << " hilos)\n\n";
+        imprimirCabecera();
+
+        for (int tam : tamaniosBarrido(opciones)) {
+            int n = registrosPorPasada(tam);
+            vector<string> planos = generarRegistros(n, tam);
+            vector<string> binarios(n);
+            for (int i = 0; i < n; i++) binarios[i] = textoAbinario(planos[i]);
+
+            resultados.push_back(medir("string", "textoAbinario", 0, tam, n, opciones, nullptr, [&] {
+                for (const string& p : planos) sumidero += textoAbinario(p).size();
+            }));
+            imprimirResultado(resultados.back());
+
+            resultados.push_back(medir("string", "binarioAtexto", 0, tam, n, opciones, nullptr, [&] {
+                for (const string& b : binarios) sumidero += binarioAtexto(b).size();
+            }));
+            imprimirResultado(resultados.back());
+
+            vector<string> datos(n);
+            auto restaurar = [&] { for (int i = 0; i < n; i++) datos[i] = planos[i]; };
+
+            for (int semilla : semillasBarrido(opciones)) {
+                resultados.push_back(medir("string", "encriptarBits", semilla, tam, n, opciones, nullptr, [&] {
+                    for (const string& b : binarios) sumidero += encriptarBits(b, semilla).size();
+                }));
+                imprimirResultado(resultados.back());
+
+                resultados.push_back(medir("string", "encriptarCadena", semilla, tam, n, opciones, nullptr, [&] {
+                    for (const string& p : planos) sumidero += encriptarCadena(p, semilla).size();
+                }));
+                imprimirResultado(resultados.back());
+
+                resultados.push_back(medir("string", "encriptarArchivo", semilla, tam, n, opciones, restaurar, [&] {
+                    encriptarArchivo(datos.data(), n, semilla);
+                }));
+                imprimirResultado(resultados.back());
+
+                resultados.push_back(medir("string", "encriptarArchivoParalelo", semilla, tam, n, opciones, restaurar, [&] {
+                    encriptarArchivo(datos.data(), n, semilla, pool);
+                }));
+                imprimirResultado(resultados.back());
+            }
+
+            // Guardado de líneas: semilla 0 porque no cifra
+            int nArchivo = n * FACTOR_REGISTROS_ARCHIVO;
+            vector<string> lineas = generarRegistros(nArchivo, tam);
+            {
+                SilencioCout silencio;
+                resultados.push_back(medir("string", "guardarConFlujo", 0, tam, nArchivo, opciones, nullptr, [&] {
+                    if (!guardarConFlujo(rutaFlujo, lineas.data(), nArchivo))
+                        throw "Error: no se pudo escribir el archivo de prueba.";
+                }));
+                resultados.push_back(medir("string", "guardarArchivoLineas", 0, tam, nArchivo, opciones, nullptr, [&] {
+                    if (!guardarArchivoLineas(rutaNueva, lineas.data(), nArchivo))
+                        throw "Error: no se pudo escribir el archivo de prueba.";
+                }));
+            }
+            imprimirResultado(resultados[resultados.size() - 2]);
+            imprimirResultado(resultados.back());
+        }
+        remove(rutaNueva.c_str());
+        remove(rutaFlujo.c_str());
+        remove(rutaPlano.c_str());
+        remove(rutaCifradoFlujo.c_str());
+        remove(rutaCifradoEntero.c_str());
+
+        if (!opciones.rutaCsv.empty() && !guardarCsv(opciones.rutaCsv, resultados))
+            return 1;
+        if (!opciones.rutaBase.empty() && compararConBase(opciones.rutaBase, resultados, opciones.tolerancia) > 0)
+            return 3;
+        return 0;
+    }
+    catch (const char* e) {
+        cerr << e << endl;
+        return 1;
+    }
+}
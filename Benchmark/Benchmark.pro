@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+
+# Cada versión define funciones con los mismos nombres, así que cada una
+# se enlaza en su propio ejecutable.
+SUBDIRS += \
+    BenchmarkString.pro \
+    BenchmarkChar.pro
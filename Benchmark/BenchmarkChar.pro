@@ -0,0 +1,26 @@
+TEMPLATE = app
+TARGET = BenchmarkChar
+CONFIG += console c++17 thread release
+CONFIG -= app_bundle
+CONFIG -= qt
+
+OBJECTS_DIR = obj_char
+INCLUDEPATH += ../Practica3-Informatica2
+
+SOURCES += \
+        BenchChar.cpp \
+        Medicion.cpp \
+        ../Practica3-Informatica2/AlmacenSegmentado.cpp \
+        ../Practica3-Informatica2/ArchivoMapeado.cpp \
+        ../Practica3-Informatica2/ArchivoRanuras.cpp \
+        ../Practica3-Informatica2/CifradoEmpaquetado.cpp \
+        ../Practica3-Informatica2/CifradoFlujo.cpp \
+        ../Practica3-Informatica2/ConversionSIMD.cpp \
+        ../Practica3-Informatica2/Encriptacion.cpp \
+        ../Practica3-Informatica2/IndiceCedulas.cpp \
+        ../Practica3-Informatica2/ManipulacionDeArchivos.cpp \
+        ../Practica3-Informatica2/PoolHilos.cpp \
+        ../Practica3-Informatica2/UtilidadesCadena.cpp
+
+HEADERS += \
+    Medicion.h
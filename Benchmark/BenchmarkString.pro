@@ -0,0 +1,25 @@
+TEMPLATE = app
+TARGET = BenchmarkString
+CONFIG += console c++17 thread release
+CONFIG -= app_bundle
+CONFIG -= qt
+
+OBJECTS_DIR = obj_string
+INCLUDEPATH += ../Practica3-VersionString
+
+SOURCES += \
+        BenchString.cpp \
+        Medicion.cpp \
+        ../Practica3-VersionString/AlmacenSegmentado.cpp \
+        ../Practica3-VersionString/ArchivoMapeado.cpp \
+        ../Practica3-VersionString/ArchivoRanuras.cpp \
+        ../Practica3-VersionString/CifradoEmpaquetado.cpp \
+        ../Practica3-VersionString/CifradoFlujo.cpp \
+        ../Practica3-VersionString/ConversionSIMD.cpp \
+        ../Practica3-VersionString/Encriptacion.cpp \
+        ../Practica3-VersionString/IndiceCedulas.cpp \
+        ../Practica3-VersionString/ManipulacionArchivo.cpp \
+        ../Practica3-VersionString/PoolHilos.cpp
+
+HEADERS += \
+    Medicion.h
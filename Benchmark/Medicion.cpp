@@ -0,0 +1,259 @@
+#include "Medicion.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+using namespace std;
+
+// ================================================================
+// === Conteo de reservas de memoria ==============================
+// ================================================================
+
+static atomic<long> contadorReservas{0};
+
+void* operator new(size_t n) {
+    contadorReservas.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+
+void* operator new[](size_t n) {
+    contadorReservas.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+long reservasRealizadas() {
+    return contadorReservas.load(memory_order_relaxed);
+}
+
+// ================================================================
+// === Opciones y barridos ========================================
+// ================================================================
+
+/**
+ * @brief Interpreta los argumentos de línea de comandos.
+ *
+ * @throw const char* Si un argumento es desconocido o le falta su valor.
+ */
+OpcionesBenchmark leerOpciones(int argc, char* argv[]) {
+    OpcionesBenchmark opciones;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--rapido") {
+            opciones.rapido = true;
+        } else if (arg == "--csv" && i + 1 < argc) {
+            opciones.rutaCsv = argv[++i];
+        } else if (arg == "--base" && i + 1 < argc) {
+            opciones.rutaBase = argv[++i];
+        } else if (arg == "--tolerancia" && i + 1 < argc) {
+            opciones.tolerancia = atof(argv[++i]);
+            if (opciones.tolerancia < 0)
+                throw "Error: la tolerancia debe ser >= 0.";
+        } else {
+            throw "Uso: [--rapido] [--csv RUTA] [--base RUTA] [--tolerancia X]";
+        }
+    }
+    return opciones;
+}
+
+vector<int> semillasBarrido(const OpcionesBenchmark& opciones) {
+    if (opciones.rapido) return { 4 };
+    return { 1, 3, 4, 8, 16, 17, 64 };
+}
+
+vector<int> tamaniosBarrido(const OpcionesBenchmark& opciones) {
+    if (opciones.rapido) return { 64 };
+    return { 16, 64, 256, 4096 };
+}
+
+int registrosPorPasada(int tamRegistro) {
+    int registros = (256 * 1024) / tamRegistro;
+    return registros < 16 ? 16 : registros;
+}
+
+/**
+ * @brief Genera registros deterministas con el aspecto de una línea de usuarios.
+ */
+vector<string> generarRegistros(int cantidad, int tam) {
+    vector<string> registros(cantidad);
+    unsigned int estado = 12345u + static_cast<unsigned int>(tam);
+    for (string& r : registros) {
+        r.resize(tam);
+        for (char& c : r) {
+            estado = estado * 1103515245u + 12345u;
+            c = static_cast<char>(' ' + (estado >> 16) % 95);
+        }
+    }
+    return registros;
+}
+
+// ================================================================
+// === Medición ===================================================
+// ================================================================
+
+/**
+ * @brief Cronometra pasadas completas hasta acumular el tiempo mínimo.
+ */
+Resultado medir(const string& version, const string& funcion, int semilla, int tamRegistro,
+                int registros, const OpcionesBenchmark& opciones,
+                const function<void()>& preparar, const function<void()>& pasada) {
+    typedef chrono::steady_clock Reloj;
+    const double segundosMin = opciones.rapido ? 0.05 : 0.25;
+    const long pasadasMin = 3;
+
+    if (preparar) preparar();
+    pasada();   // calentamiento
+
+    double segundos = 0;
+    long pasadas = 0, reservas = 0;
+    while (segundos < segundosMin || pasadas < pasadasMin) {
+        if (preparar) preparar();
+        long reservasAntes = reservasRealizadas();
+        Reloj::time_point inicio = Reloj::now();
+        pasada();
+        Reloj::time_point fin = Reloj::now();
+        reservas += reservasRealizadas() - reservasAntes;
+        segundos += chrono::duration<double>(fin - inicio).count();
+        pasadas++;
+    }
+
+    Resultado r;
+    r.version = version;
+    r.funcion = funcion;
+    r.semilla = semilla;
+    r.tamRegistro = tamRegistro;
+    r.registros = registros;
+    r.pasadas = pasadas;
+
+    double totalRegistros = static_cast<double>(registros) * pasadas;
+    r.nsPorRegistro = segundos * 1e9 / totalRegistros;
+    r.registrosPorSegundo = totalRegistros / segundos;
+    r.mbPorSegundo = totalRegistros * tamRegistro / segundos / 1e6;
+    r.reservasPorRegistro = reservas / totalRegistros;
+    return r;
+}
+
+// ================================================================
+// === Salida =====================================================
+// ================================================================
+
+void imprimirCabecera() {
+    printf("%-7s %-26s %7s %7s %12s %12s %14s %10s\n",
+           "version", "funcion", "semilla", "tam", "ns/registro", "MB/s", "registros/s", "reservas");
+}
+
+void imprimirResultado(const Resultado& r) {
+    printf("%-7s %-26s %7d %7d %12.1f %12.2f %14.0f %10.2f\n",
+           r.version.c_str(), r.funcion.c_str(), r.semilla, r.tamRegistro,
+           r.nsPorRegistro, r.mbPorSegundo, r.registrosPorSegundo, r.reservasPorRegistro);
+    fflush(stdout);
+}
+
+/**
+ * @brief Guarda los resultados en CSV.
+ */
+bool guardarCsv(const string& ruta, const vector<Resultado>& resultados) {
+    ofstream archivo(ruta, ios::trunc);
+    if (!archivo.is_open()) {
+        cerr << "ERROR en guardarCsv(): no se pudo abrir " << ruta << endl;
+        return false;
+    }
+
+    archivo << "version,funcion,semilla,tam_registro,registros,pasadas,"
+               "ns_por_registro,mb_s,registros_s,reservas_por_registro\n";
+    for (const Resultado& r : resultados) {
+        archivo << r.version << ',' << r.funcion << ',' << r.semilla << ','
+                << r.tamRegistro << ',' << r.registros << ',' << r.pasadas << ','
+                << r.nsPorRegistro << ',' << r.mbPorSegundo << ','
+                << r.registrosPorSegundo << ',' << r.reservasPorRegistro << '\n';
+    }
+    return static_cast<bool>(archivo);
+}
+
+/**
+ * @brief Clave de comparación: la versión no forma parte, así se puede
+ *        comparar una versión contra la otra.
+ */
+static string claveResultado(const string& funcion, int semilla, int tam) {
+    return funcion + "|" + to_string(semilla) + "|" + to_string(tam);
+}
+
+/**
+ * @brief Compara los MB/s medidos contra un CSV base.
+ */
+int compararConBase(const string& rutaBase, const vector<Resultado>& resultados, double tolerancia) {
+    ifstream archivo(rutaBase);
+    if (!archivo.is_open()) {
+        cerr << "ERROR en compararConBase(): no se pudo abrir " << rutaBase << endl;
+        return 0;
+    }
+
+    map<string, double> base;
+    string linea;
+    getline(archivo, linea);   // cabecera
+    while (getline(archivo, linea)) {
+        vector<string> campos;
+        stringstream ss(linea);
+        string campo;
+        while (getline(ss, campo, ',')) campos.push_back(campo);
+        if (campos.size() < 8) continue;
+        base[claveResultado(campos[1], atoi(campos[2].c_str()), atoi(campos[3].c_str()))] = atof(campos[7].c_str());
+    }
+
+    int regresiones = 0;
+    printf("\n=== Comparacion contra %s (tolerancia %.0f %%) ===\n", rutaBase.c_str(), tolerancia * 100);
+    printf("%-26s %7s %7s %12s %12s %9s\n", "funcion", "semilla", "tam", "base MB/s", "MB/s", "cambio");
+    for (const Resultado& r : resultados) {
+        map<string, double>::const_iterator it = base.find(claveResultado(r.funcion, r.semilla, r.tamRegistro));
+        if (it == base.end() || it->second <= 0) continue;
+
+        double cambio = r.mbPorSegundo / it->second - 1.0;
+        bool regresion = cambio < -tolerancia;
+        if (regresion) regresiones++;
+        printf("%-26s %7d %7d %12.2f %12.2f %+8.1f%%%s\n", r.funcion.c_str(), r.semilla, r.tamRegistro,
+               it->second, r.mbPorSegundo, cambio * 100, regresion ? "  REGRESION" : "");
+    }
+    printf("Regresiones: %d\n", regresiones);
+    return regresiones;
+}
+
+bool fallaEquivalencia(const string& descripcion, int semilla, int tam) {
+    cerr << "ERROR de equivalencia: " << descripcion
+         << " (semilla " << semilla << ", tam " << tam << ")" << endl;
+    return false;
+}
+
+// ================================================================
+// === Archivos de prueba =========================================
+// ================================================================
+
+string rutaTemporal(const string& nombre) {
+    return (filesystem::temp_directory_path() / nombre).string();
+}
+
+string leerContenido(const string& ruta) {
+    ifstream archivo(ruta, ios::binary);
+    stringstream contenido;
+    contenido << archivo.rdbuf();
+    return contenido.str();
+}
+
+SilencioCout::SilencioCout() : anterior(cout.rdbuf(nullptr)) {}
+
+SilencioCout::~SilencioCout() {
+    cout.rdbuf(anterior);
+    cout.clear();
+}
@@ -0,0 +1,139 @@
+#ifndef MEDICION_H
+#define MEDICION_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// ================================================================
+// === Arnés de medición compartido por los dos benchmarks ========
+// ================================================================
+//
+// Cada versión (std::string y char[]) se compila en su propio ejecutable
+// porque ambas definen funciones con el mismo nombre; este módulo no
+// depende de ninguna de las dos.
+
+/**
+ * Resultado de medir una función sobre un conjunto de registros.
+ * Las tasas se expresan en bytes de texto plano procesados.
+ */
+struct Resultado {
+    string version;              ///< "string" o "char"
+    string funcion;              ///< Nombre de la función medida
+    int semilla = 0;             ///< 0 si la función no usa semilla
+    int tamRegistro = 0;         ///< Bytes de texto plano por registro
+    int registros = 0;           ///< Registros procesados por pasada
+    long pasadas = 0;            ///< Pasadas cronometradas
+    double nsPorRegistro = 0;
+    double mbPorSegundo = 0;
+    double registrosPorSegundo = 0;
+    double reservasPorRegistro = 0;
+};
+
+/**
+ * Opciones de línea de comandos comunes.
+ *
+ *   --rapido          barrido reducido (una semilla, un tamaño)
+ *   --csv RUTA        guarda los resultados en CSV
+ *   --base RUTA       compara contra un CSV previo (de cualquier versión)
+ *   --tolerancia X    caída de MB/s tolerada frente a la base (0.10 = 10 %)
+ */
+struct OpcionesBenchmark {
+    bool rapido = false;
+    string rutaCsv;
+    string rutaBase;
+    double tolerancia = 0.10;
+};
+
+/**
+ * Interpreta los argumentos. Lanza const char* si alguno es inválido.
+ */
+OpcionesBenchmark leerOpciones(int argc, char* argv[]);
+
+/**
+ * Semillas y tamaños de registro a barrer según las opciones.
+ */
+vector<int> semillasBarrido(const OpcionesBenchmark& opciones);
+vector<int> tamaniosBarrido(const OpcionesBenchmark& opciones);
+
+/**
+ * Registros por pasada para un tamaño dado (unos 256 KB de texto plano).
+ */
+int registrosPorPasada(int tamRegistro);
+
+/**
+ * Genera `cantidad` registros de `tam` caracteres imprimibles (deterministas).
+ */
+vector<string> generarRegistros(int cantidad, int tam);
+
+/**
+ * Reservas de memoria (operator new / new[]) hechas hasta ahora por el proceso.
+ */
+long reservasRealizadas();
+
+/**
+ * Mide una función.
+ *
+ * `pasada` procesa los `registros` registros una vez; `preparar` (que
+ * puede ser vacía) restaura los datos antes de cada pasada y no se
+ * cronometra ni cuenta reservas. Se repite hasta acumular el tiempo
+ * mínimo de medición, tras una pasada de calentamiento.
+ */
+Resultado medir(const string& version, const string& funcion, int semilla, int tamRegistro,
+                int registros, const OpcionesBenchmark& opciones,
+                const function<void()>& preparar, const function<void()>& pasada);
+
+/**
+ * Imprime la cabecera de la tabla de resultados.
+ */
+void imprimirCabecera();
+
+/**
+ * Imprime una fila de la tabla de resultados.
+ */
+void imprimirResultado(const Resultado& r);
+
+/**
+ * Guarda los resultados en CSV (una fila por medición, con cabecera).
+ */
+bool guardarCsv(const string& ruta, const vector<Resultado>& resultados);
+
+/**
+ * Compara con un CSV base por (función, semilla, tamaño) e imprime la
+ * variación de MB/s. Retorna la cantidad de regresiones mayores que la
+ * tolerancia.
+ */
+int compararConBase(const string& rutaBase, const vector<Resultado>& resultados, double tolerancia);
+
+/**
+ * Ruta para un archivo de prueba en el directorio temporal del sistema.
+ */
+string rutaTemporal(const string& nombre);
+
+/**
+ * Contenido completo de un archivo ("" si no se puede leer).
+ */
+string leerContenido(const string& ruta);
+
+/**
+ * Descarta lo que se escriba en cout mientras exista (las funciones de
+ * guardado informan cada archivo escrito; la tabla usa printf).
+ */
+class SilencioCout {
+public:
+    SilencioCout();
+    ~SilencioCout();
+
+private:
+    streambuf* anterior;
+};
+
+/**
+ * Informa una falla de la verificación de equivalencia previa a medir.
+ * Retorna false para poder usarse como `ok = verificar(...) && ok`.
+ */
+bool fallaEquivalencia(const string& descripcion, int semilla, int tam);
+
+#endif // MEDICION_H
@@ -0,0 +1,374 @@
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include "AlmacenSegmentado.h"
+#include "ArchivoRanuras.h"
+#include "UtilidadesCadena.h"
+using namespace std;
+
+/** Primeros bytes de un manifiesto. */
+const char MAGIA_MANIFIESTO[4] = { 'P', '3', 'S', 'M' };
+
+// ============================================================
+//  MANIFIESTO
+// ============================================================
+
+/**
+ * @brief Escribe un entero de `bytes` bytes en little-endian.
+ */
+static void escribirLE(char* destino, uint64_t valor, int bytes) {
+    for (int k = 0; k < bytes; k++)
+        destino[k] = (char)((valor >> (8 * k)) & 0xFF);
+}
+
+/**
+ * @brief Lee un entero de `bytes` bytes en little-endian.
+ */
+static uint64_t leerLE(const char* origen, int bytes) {
+    uint64_t valor = 0;
+    for (int k = bytes - 1; k >= 0; k--)
+        valor = (valor << 8) | (unsigned char)origen[k];
+    return valor;
+}
+
+/**
+ * @brief Compara los primeros 4 bytes con la marca del manifiesto.
+ */
+static bool tieneMagiaManifiesto(const char* datos) {
+    for (int k = 0; k < 4; k++)
+        if (datos[k] != MAGIA_MANIFIESTO[k]) return false;
+    return true;
+}
+
+bool esManifiestoSegmentado(const char* ruta) {
+    ifstream archivo(ruta, ios::binary);
+    char magia[4];
+    if (!archivo.read(magia, 4)) return false;
+    return tieneMagiaManifiesto(magia);
+}
+
+bool esAlmacenEmpaquetado(const char* ruta) {
+    if (!esManifiestoSegmentado(ruta)) return esArchivoEmpaquetado(ruta);
+    ManifiestoAlmacen manifiesto;
+    bool empaquetado = leerManifiesto(ruta, manifiesto) && manifiesto.empaquetado;
+    liberarManifiesto(manifiesto);
+    return empaquetado;
+}
+
+/**
+ * @brief Lee y valida un manifiesto.
+ * @throws const char* Si la cabecera o las entradas no son coherentes.
+ */
+bool leerManifiesto(const char* ruta, ManifiestoAlmacen& manifiesto) {
+    liberarManifiesto(manifiesto);
+    char* entradas = nullptr;
+    try {
+        ifstream archivo(ruta, ios::binary);
+        if (!archivo.is_open()) {
+            throw "No se pudo abrir el manifiesto.";
+        }
+
+        char cabecera[TAM_CABECERA_MANIFIESTO];
+        if (!archivo.read(cabecera, TAM_CABECERA_MANIFIESTO)) {
+            throw "Cabecera incompleta.";
+        }
+        if (!tieneMagiaManifiesto(cabecera)) {
+            throw "El archivo no es un manifiesto.";
+        }
+        if ((unsigned char)cabecera[4] != VERSION_MANIFIESTO) {
+            throw "Versión de manifiesto no soportada.";
+        }
+
+        manifiesto.empaquetado = cabecera[5] != 0;
+        manifiesto.generacion = (unsigned int)leerLE(cabecera + 8, 4);
+        uint64_t numSegmentos = leerLE(cabecera + 12, 4);
+        manifiesto.totalRegistros = leerLE(cabecera + 16, 8);
+        if (numSegmentos == 0 || numSegmentos > 0x7FFFFFFF / TAM_ENTRADA_MANIFIESTO) {
+            throw "Número de segmentos inválido.";
+        }
+
+        int tamEntradas = (int)numSegmentos * TAM_ENTRADA_MANIFIESTO;
+        entradas = new char[tamEntradas];
+        if (!archivo.read(entradas, tamEntradas)) {
+            throw "Manifiesto truncado.";
+        }
+
+        manifiesto.numSegmentos = (int)numSegmentos;
+        manifiesto.segmentos = new SegmentoAlmacen[manifiesto.numSegmentos];
+        uint64_t suma = 0;
+        for (int i = 0; i < manifiesto.numSegmentos; i++) {
+            const char* entrada = entradas + i * TAM_ENTRADA_MANIFIESTO;
+            manifiesto.segmentos[i].registros = leerLE(entrada, 8);
+            manifiesto.segmentos[i].bytes = leerLE(entrada + 8, 8);
+            suma += manifiesto.segmentos[i].registros;
+        }
+        delete[] entradas;
+        entradas = nullptr;
+
+        if (suma != manifiesto.totalRegistros) {
+            throw "El total de registros no coincide con los segmentos.";
+        }
+        return true;
+    }
+    catch (const char* msg) {
+        cerr << "ERROR en leerManifiesto(): " << msg << endl;
+        delete[] entradas;
+        liberarManifiesto(manifiesto);
+        return false;
+    }
+}
+
+void liberarManifiesto(ManifiestoAlmacen& manifiesto) {
+    delete[] manifiesto.segmentos;
+    manifiesto.segmentos = nullptr;
+    manifiesto.numSegmentos = 0;
+    manifiesto.totalRegistros = 0;
+    manifiesto.generacion = 0;
+    manifiesto.empaquetado = false;
+}
+
+void rutaSegmento(const char* ruta, unsigned int generacion, int indice, char* destino) {
+    snprintf(destino, TAM_MAX_RUTA_SEGMENTO, "%s.g%u.%04d", ruta, generacion, indice);
+}
+
+/**
+ * @brief Ubica un registro global recorriendo los conteos del manifiesto.
+ */
+bool localizarRegistro(const ManifiestoAlmacen& manifiesto, uint64_t indice, int& segmento, uint64_t& indiceLocal) {
+    for (int i = 0; i < manifiesto.numSegmentos; i++) {
+        if (indice < manifiesto.segmentos[i].registros) {
+            segmento = i;
+            indiceLocal = indice;
+            return true;
+        }
+        indice -= manifiesto.segmentos[i].registros;
+    }
+    return false;
+}
+
+bool cargarSegmento(const char* ruta, const ManifiestoAlmacen& manifiesto, int indice, LineasMapeadas& lineas) {
+    liberarLineasMapeadas(lineas);
+    if (indice < 0 || indice >= manifiesto.numSegmentos) {
+        cerr << "ERROR en cargarSegmento(): segmento fuera de rango." << endl;
+        return false;
+    }
+
+    char destino[TAM_MAX_RUTA_SEGMENTO];
+    rutaSegmento(ruta, manifiesto.generacion, indice, destino);
+    if (!cargarLineasMapeadas(destino, lineas)) return false;
+
+    if ((uint64_t)lineas.numLineas != manifiesto.segmentos[indice].registros) {
+        cerr << "ERROR en cargarSegmento(): el segmento no coincide con el manifiesto." << endl;
+        liberarLineasMapeadas(lineas);
+        return false;
+    }
+    return true;
+}
+
+// ============================================================
+//  GUARDADO
+// ============================================================
+
+/**
+ * @brief Bytes que ocupa una línea no vacía dentro de un segmento.
+ */
+static int64_t bytesRegistro(int len, bool empaquetado) {
+    return empaquetado ? 4 + len / 8 : len + 1;
+}
+
+/**
+ * @brief Borra los segmentos [0, numSegmentos) de una generación.
+ */
+static void borrarSegmentos(const char* ruta, unsigned int generacion, int numSegmentos) {
+    char destino[TAM_MAX_RUTA_SEGMENTO];
+    for (int i = 0; i < numSegmentos; i++) {
+        rutaSegmento(ruta, generacion, i, destino);
+        remove(destino);
+    }
+}
+
+/**
+ * @brief Escribe el manifiesto en un temporal y lo reemplaza sobre `ruta`.
+ */
+static bool escribirManifiesto(const char* ruta, const ManifiestoAlmacen& manifiesto) {
+    int total = TAM_CABECERA_MANIFIESTO + manifiesto.numSegmentos * TAM_ENTRADA_MANIFIESTO;
+    char* contenido = new char[total];
+    for (int k = 0; k < TAM_CABECERA_MANIFIESTO; k++) contenido[k] = 0;
+    for (int k = 0; k < 4; k++) contenido[k] = MAGIA_MANIFIESTO[k];
+    contenido[4] = (char)VERSION_MANIFIESTO;
+    contenido[5] = manifiesto.empaquetado ? 1 : 0;
+    escribirLE(contenido + 8, manifiesto.generacion, 4);
+    escribirLE(contenido + 12, (uint64_t)manifiesto.numSegmentos, 4);
+    escribirLE(contenido + 16, manifiesto.totalRegistros, 8);
+    for (int i = 0; i < manifiesto.numSegmentos; i++) {
+        char* entrada = contenido + TAM_CABECERA_MANIFIESTO + i * TAM_ENTRADA_MANIFIESTO;
+        escribirLE(entrada, manifiesto.segmentos[i].registros, 8);
+        escribirLE(entrada + 8, manifiesto.segmentos[i].bytes, 8);
+    }
+
+    char* temporal = new char[longitud(ruta) + 5];
+    copiar(temporal, ruta);
+    concatenar(temporal, ".tmp");
+
+    bool ok;
+    {
+        ofstream archivo(temporal, ios::trunc | ios::binary);
+        ok = archivo.is_open() && archivo.write(contenido, total);
+    }
+    if (ok)
+        ok = reemplazarArchivo(temporal, ruta);   // borra el temporal si falla
+    else
+        remove(temporal);
+
+    delete[] temporal;
+    delete[] contenido;
+    return ok;
+}
+
+unsigned int siguienteGeneracion(const char* ruta) {
+    ManifiestoAlmacen anterior;
+    unsigned int generacion = 1;
+    if (esManifiestoSegmentado(ruta) && leerManifiesto(ruta, anterior))
+        generacion = anterior.generacion + 1;
+    liberarManifiesto(anterior);
+    return generacion;
+}
+
+bool publicarManifiesto(const char* ruta, const ManifiestoAlmacen& manifiesto) {
+    ManifiestoAlmacen anterior;
+    bool habiaManifiesto = esManifiestoSegmentado(ruta) && leerManifiesto(ruta, anterior);
+
+    bool ok = escribirManifiesto(ruta, manifiesto);
+    if (ok && habiaManifiesto)
+        borrarSegmentos(ruta, anterior.generacion, anterior.numSegmentos);
+    liberarManifiesto(anterior);
+    return ok;
+}
+
+/**
+ * @brief Escribe un archivo suelto, de texto o empaquetado, por temporal
+ *        y reemplazarArchivo().
+ */
+static bool guardarArchivoSuelto(const char* ruta, char** lineas, int numLineas, bool empaquetado, bool silencioso) {
+    // guardarArchivoLineas() ya pasa por su propio temporal
+    if (!empaquetado)
+        return guardarArchivoLineas(ruta, lineas, numLineas, silencioso);
+    char* temporal = new char[longitud(ruta) + 5];
+    copiar(temporal, ruta);
+    concatenar(temporal, ".tmp");
+
+    bool ok = guardarArchivoEmpaquetado(temporal, lineas, numLineas, silencioso);
+    if (ok && !reemplazarArchivo(temporal, ruta)) {
+        cerr << "ERROR: no se pudo reemplazar " << ruta << endl;
+        ok = false;
+    }
+    if (!ok) remove(temporal);
+
+    delete[] temporal;
+    return ok;
+}
+
+/**
+ * @brief Guarda líneas en segmentos de una generación nueva.
+ *
+ * Corta un segmento nuevo cada vez que el siguiente registro haría pasar
+ * el actual de tamMaxSegmento. Los segmentos se escriben como un archivo
+ * suelto; el manifiesto va al final y solo después se borra la
+ * generación anterior.
+ *
+ * @throws const char* Si un registro no cabe en un segmento o falla la escritura.
+ */
+bool guardarSegmentado(const char* ruta, char** lineas, int64_t numLineas, bool empaquetado, int64_t tamMaxSegmento,
+                       bool silencioso) {
+    ManifiestoAlmacen nuevo;
+    nuevo.generacion = siguienteGeneracion(ruta);
+    nuevo.empaquetado = empaquetado;
+    int capacidad = 0;
+    char destino[TAM_MAX_RUTA_SEGMENTO];
+
+    try {
+        if (lineas == nullptr || numLineas <= 0) {
+            throw "Arreglo vacío o no inicializado.";
+        }
+
+        const int64_t base = empaquetado ? TAM_CABECERA_EMPAQUETADO : 0;
+        int64_t inicio = 0;
+        while (inicio < numLineas) {
+            SegmentoAlmacen segmento;
+            int64_t bytes = base;
+            int64_t fin = inicio;
+            for (; fin < numLineas; fin++) {
+                int len = longitud(lineas[fin]);
+                if (len == 0) {
+                    if (!empaquetado) bytes++;      // el texto conserva su '\n'
+                    continue;
+                }
+                int64_t tam = bytesRegistro(len, empaquetado);
+                if (segmento.registros > 0 && bytes + tam > tamMaxSegmento) break;
+                if (base + tam > tamMaxSegmento) {
+                    throw "Registro más grande que un segmento.";
+                }
+                bytes += tam;
+                segmento.registros++;
+            }
+            if (segmento.registros == 0) break;     // solo quedaban líneas vacías
+            if (!empaquetado) bytes--;              // la última línea va sin '\n'
+            segmento.bytes = (uint64_t)bytes;
+
+            if (nuevo.numSegmentos == capacidad) {
+                capacidad = capacidad == 0 ? 4 : capacidad * 2;
+                SegmentoAlmacen* mayor = new SegmentoAlmacen[capacidad];
+                for (int i = 0; i < nuevo.numSegmentos; i++) mayor[i] = nuevo.segmentos[i];
+                delete[] nuevo.segmentos;
+                nuevo.segmentos = mayor;
+            }
+            rutaSegmento(ruta, nuevo.generacion, nuevo.numSegmentos, destino);
+            nuevo.segmentos[nuevo.numSegmentos++] = segmento;
+            nuevo.totalRegistros += segmento.registros;
+
+            if (!guardarArchivoSuelto(destino, lineas + inicio, (int)(fin - inicio), empaquetado, silencioso)) {
+                throw "No se pudo escribir un segmento.";
+            }
+            inicio = fin;
+        }
+
+        if (nuevo.numSegmentos == 0) {
+            throw "No hay registros para guardar.";
+        }
+        if (!publicarManifiesto(ruta, nuevo)) {
+            throw "No se pudo reemplazar el manifiesto.";
+        }
+
+        if (!silencioso)
+            cout << "Almacén segmentado guardado: " << ruta << " (" << nuevo.totalRegistros << " registros, "
+                 << nuevo.numSegmentos << " segmentos)" << endl;
+        liberarManifiesto(nuevo);
+        return true;
+    }
+    catch (const char* msg) {
+        cerr << "ERROR en guardarSegmentado(): " << msg << endl;
+        borrarSegmentos(ruta, nuevo.generacion, nuevo.numSegmentos);
+        liberarManifiesto(nuevo);
+        return false;
+    }
+}
+
+bool guardarAlmacen(const char* ruta, char** lineas, int64_t numLineas, bool empaquetado, bool silencioso) {
+    // Las ranuras fijas se eligen a mano (--ranuras) y se conservan
+    if (esArchivoRanuras(ruta))
+        return guardarArchivoRanuras(ruta, lineas, (int)numLineas, 0, silencioso);
+
+    bool segmentar = esManifiestoSegmentado(ruta);
+    if (!segmentar && lineas != nullptr) {
+        int64_t total = empaquetado ? TAM_CABECERA_EMPAQUETADO : 0;
+        for (int64_t i = 0; i < numLineas && total <= TAM_MAX_SEGMENTO; i++) {
+            int len = longitud(lineas[i]);
+            if (len > 0) total += bytesRegistro(len, empaquetado);
+        }
+        segmentar = total > TAM_MAX_SEGMENTO;
+    }
+
+    if (segmentar)
+        return guardarSegmentado(ruta, lineas, numLineas, empaquetado, TAM_MAX_SEGMENTO, silencioso);
+    return guardarArchivoSuelto(ruta, lineas, (int)numLineas, empaquetado, silencioso);
+}
@@ -0,0 +1,160 @@
+#ifndef ALMACEN_SEGMENTADO_H
+#define ALMACEN_SEGMENTADO_H
+
+#include <cstdint>
+#include "ManipulacionDeArchivos.h"
+
+// ===================== ALMACÉN SEGMENTADO =====================
+//
+// Cuando los datos no caben en un solo archivo, la ruta original (por
+// ejemplo usuarios.bin) pasa a ser un manifiesto y los registros se
+// reparten en segmentos "<ruta>.g<generación>.<índice>", cada uno un
+// archivo normal (texto o empaquetado) de a lo sumo TAM_MAX_SEGMENTO
+// bytes.
+//
+// Manifiesto (little-endian):
+//   [0..3]   "P3SM"
+//   [4]      versión (VERSION_MANIFIESTO)
+//   [5]      1 si los segmentos están empaquetados, 0 si son de texto
+//   [6..7]   reservado (0)
+//   [8..11]  generación (32 bits)
+//   [12..15] número de segmentos (32 bits)
+//   [16..23] total de registros (64 bits)
+// Por cada segmento: registros (64 bits) y bytes (64 bits).
+//
+// Los segmentos de una generación nueva se escriben antes de reemplazar
+// el manifiesto con rename(): una falla a mitad de camino deja intacta
+// la generación anterior.
+//
+// Alcance: el almacén solo levanta el tope de 10 MB por archivo; no
+// carga los datos por partes. Al arrancar, cargarLineasMapeadas()
+// proyecta todos los segmentos en un único arreglo de vistas y el resto
+// del programa sigue contando cuentas con int, así que el total queda
+// acotado por la memoria y por INT32_MAX registros. Solo --buscar-cedula
+// lee un único segmento bajo demanda, con cargarSegmento().
+
+const int VERSION_MANIFIESTO = 1;
+const int TAM_CABECERA_MANIFIESTO = 24;
+const int TAM_ENTRADA_MANIFIESTO = 16;
+const int TAM_MAX_RUTA_SEGMENTO = 512;
+
+/** Bytes máximos de un segmento (por debajo del límite por archivo del cargador). */
+const int64_t TAM_MAX_SEGMENTO = 8000000;
+
+/**
+ * @brief Entrada del manifiesto para un segmento.
+ */
+struct SegmentoAlmacen {
+    uint64_t registros = 0;             /**< Líneas no vacías del segmento */
+    uint64_t bytes = 0;                 /**< Tamaño del archivo del segmento */
+};
+
+/**
+ * @brief Contenido de un manifiesto.
+ */
+struct ManifiestoAlmacen {
+    unsigned int generacion = 0;
+    bool empaquetado = false;
+    uint64_t totalRegistros = 0;
+    SegmentoAlmacen* segmentos = nullptr;
+    int numSegmentos = 0;
+};
+
+/**
+ * @brief Indica si el archivo es el manifiesto de un almacén segmentado.
+ */
+bool esManifiestoSegmentado(const char* ruta);
+
+/**
+ * @brief Indica si los datos están empaquetados, sea un archivo suelto
+ *        o un almacén segmentado.
+ */
+bool esAlmacenEmpaquetado(const char* ruta);
+
+/**
+ * @brief Lee y valida un manifiesto.
+ * @param ruta Ruta del manifiesto.
+ * @param manifiesto Destino (liberar con liberarManifiesto()).
+ * @return true si el manifiesto es válido.
+ */
+bool leerManifiesto(const char* ruta, ManifiestoAlmacen& manifiesto);
+
+/**
+ * @brief Libera las entradas de un manifiesto.
+ */
+void liberarManifiesto(ManifiestoAlmacen& manifiesto);
+
+/**
+ * @brief Escribe en `destino` la ruta de un segmento.
+ * @param ruta Ruta del manifiesto.
+ * @param generacion Generación del almacén.
+ * @param indice Índice del segmento.
+ * @param destino Buffer de al menos TAM_MAX_RUTA_SEGMENTO caracteres.
+ */
+void rutaSegmento(const char* ruta, unsigned int generacion, int indice, char* destino);
+
+/**
+ * @brief Ubica un registro global dentro de los segmentos.
+ * @param manifiesto Manifiesto del almacén.
+ * @param indice Índice global (0 .. totalRegistros - 1).
+ * @param segmento Índice del segmento que lo contiene.
+ * @param indiceLocal Posición dentro de ese segmento.
+ * @return false si el índice está fuera de rango.
+ */
+bool localizarRegistro(const ManifiestoAlmacen& manifiesto, uint64_t indice, int& segmento, uint64_t& indiceLocal);
+
+/**
+ * @brief Carga bajo demanda un solo segmento como vistas.
+ *
+ * Permite recorrer almacenes más grandes que la memoria disponible, de
+ * a un segmento por vez.
+ *
+ * @return true si el segmento existe y coincide con el manifiesto.
+ */
+bool cargarSegmento(const char* ruta, const ManifiestoAlmacen& manifiesto, int indice, LineasMapeadas& lineas);
+
+/**
+ * @brief Generación que le toca al próximo guardado en `ruta` (1 si no
+ *        es un manifiesto).
+ */
+unsigned int siguienteGeneracion(const char* ruta);
+
+/**
+ * @brief Reemplaza el manifiesto de `ruta` por `manifiesto`.
+ *
+ * Los segmentos de `manifiesto` ya deben estar escritos. Se escribe por
+ * temporal y reemplazarArchivo(); solo después se borran los segmentos
+ * de la generación anterior, si la había.
+ *
+ * @return false si no se pudo escribir (la generación anterior queda intacta).
+ */
+bool publicarManifiesto(const char* ruta, const ManifiestoAlmacen& manifiesto);
+
+/**
+ * @brief Guarda líneas en segmentos de una generación nueva.
+ * @param ruta Ruta del manifiesto.
+ * @param lineas Líneas a guardar.
+ * @param numLineas Número de líneas.
+ * @param empaquetado true para segmentos en formato empaquetado.
+ * @param tamMaxSegmento Bytes máximos por segmento.
+ * @param silencioso true para no informar en consola cuando todo sale bien.
+ * @return true si todos los segmentos y el manifiesto quedaron escritos.
+ */
+bool guardarSegmentado(const char* ruta, char** lineas, int64_t numLineas, bool empaquetado,
+                       int64_t tamMaxSegmento = TAM_MAX_SEGMENTO, bool silencioso = false);
+
+/**
+ * @brief Guarda líneas eligiendo entre archivo suelto y almacén segmentado.
+ *
+ * Usa segmentos si la ruta ya es un manifiesto o si los datos no caben
+ * en TAM_MAX_SEGMENTO; si no, escribe un archivo normal en un temporal
+ * y lo reemplaza con reemplazarArchivo().
+ * Un archivo de ranuras fijas (ArchivoRanuras.h) se reescribe en ranuras.
+ *
+ * @param silencioso true para no informar en consola cuando todo sale
+ *        bien (los puntos de control guardan mientras se usa el menú).
+ * @return true si los datos quedaron escritos y sincronizados con el disco.
+ */
+bool guardarAlmacen(const char* ruta, char** lineas, int64_t numLineas, bool empaquetado, bool silencioso = false);
+
+#endif // ALMACEN_SEGMENTADO_H
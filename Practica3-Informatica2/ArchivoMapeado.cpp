@@ -0,0 +1,99 @@
+#include "ArchivoMapeado.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+void abrirMapeo(ArchivoMapeado& archivo, const char* ruta) {
+    cerrarMapeo(archivo);
+
+    HANDLE manejador = CreateFileA(ruta, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                   OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (manejador == INVALID_HANDLE_VALUE)
+        throw "No se pudo abrir el archivo para lectura.";
+
+    LARGE_INTEGER tam;
+    if (!GetFileSizeEx(manejador, &tam)) {
+        CloseHandle(manejador);
+        throw "No se pudo obtener el tamaño del archivo.";
+    }
+    if (tam.QuadPart == 0) {            // no se puede proyectar un archivo vacío
+        CloseHandle(manejador);
+        return;
+    }
+
+    HANDLE mapeo = CreateFileMappingA(manejador, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapeo == nullptr) {
+        CloseHandle(manejador);
+        throw "No se pudo proyectar el archivo en memoria.";
+    }
+
+    void* vista = MapViewOfFile(mapeo, FILE_MAP_READ, 0, 0, 0);
+    if (vista == nullptr) {
+        CloseHandle(mapeo);
+        CloseHandle(manejador);
+        throw "No se pudo proyectar el archivo en memoria.";
+    }
+
+    archivo.manejadorArchivo = manejador;
+    archivo.manejadorMapeo = mapeo;
+    archivo.datos = (const char*)vista;
+    archivo.tamanio = (long)tam.QuadPart;
+}
+
+void cerrarMapeo(ArchivoMapeado& archivo) {
+    if (archivo.datos) UnmapViewOfFile(archivo.datos);
+    if (archivo.manejadorMapeo) CloseHandle(archivo.manejadorMapeo);
+    if (archivo.manejadorArchivo) CloseHandle(archivo.manejadorArchivo);
+    archivo.datos = nullptr;
+    archivo.tamanio = 0;
+    archivo.manejadorMapeo = nullptr;
+    archivo.manejadorArchivo = nullptr;
+}
+
+#else
+
+void abrirMapeo(ArchivoMapeado& archivo, const char* ruta) {
+    cerrarMapeo(archivo);
+
+    int fd = open(ruta, O_RDONLY);
+    if (fd < 0)
+        throw "No se pudo abrir el archivo para lectura.";
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw "No se pudo obtener el tamaño del archivo.";
+    }
+    if (info.st_size == 0) {            // mmap no acepta longitud 0
+        close(fd);
+        return;
+    }
+
+    void* vista = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);                          // la proyección sigue siendo válida
+    if (vista == MAP_FAILED)
+        throw "No se pudo proyectar el archivo en memoria.";
+
+#ifdef MADV_SEQUENTIAL
+    madvise(vista, (size_t)info.st_size, MADV_SEQUENTIAL);
+#endif
+
+    archivo.datos = (const char*)vista;
+    archivo.tamanio = (long)info.st_size;
+}
+
+void cerrarMapeo(ArchivoMapeado& archivo) {
+    if (archivo.datos) munmap((void*)archivo.datos, (size_t)archivo.tamanio);
+    archivo.datos = nullptr;
+    archivo.tamanio = 0;
+}
+
+#endif
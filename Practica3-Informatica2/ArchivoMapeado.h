@@ -0,0 +1,43 @@
+#ifndef ARCHIVO_MAPEADO_H
+#define ARCHIVO_MAPEADO_H
+
+// ===================== ARCHIVO PROYECTADO =====================
+
+/**
+ * @brief Archivo de solo lectura proyectado en memoria.
+ *
+ * Usa mmap() en sistemas POSIX y MapViewOfFile() en Windows: el
+ * contenido se lee directamente desde la caché de páginas del sistema,
+ * sin copiarlo a un buffer propio. No se debe sobrescribir el archivo
+ * mientras está proyectado.
+ */
+struct ArchivoMapeado {
+    const char* datos = nullptr;        /**< Contenido (nullptr si el archivo está vacío) */
+    long tamanio = 0;                   /**< Bytes del contenido */
+    void* manejadorArchivo = nullptr;   /**< Solo Windows */
+    void* manejadorMapeo = nullptr;     /**< Solo Windows */
+};
+
+/**
+ * @brief Parte de una línea dentro de un buffer ajeno (no termina en '\0').
+ */
+struct VistaLinea {
+    const char* inicio = nullptr;       /**< Primer carácter */
+    int longitud = 0;                   /**< Caracteres de la línea */
+};
+
+/**
+ * @brief Proyecta un archivo completo (cierra antes el que hubiera).
+ * @param archivo Estructura destino.
+ * @param ruta Ruta del archivo.
+ * @throws const char* Si el archivo no se puede abrir o proyectar.
+ */
+void abrirMapeo(ArchivoMapeado& archivo, const char* ruta);
+
+/**
+ * @brief Libera la proyección; `datos` deja de ser válido.
+ * @param archivo Archivo a cerrar (queda vacío y reutilizable).
+ */
+void cerrarMapeo(ArchivoMapeado& archivo);
+
+#endif // ARCHIVO_MAPEADO_H
@@ -0,0 +1,405 @@
+#include <cstdio>
+#include <cstdint>
+#include <iostream>
+#include <fstream>
+#include "AlmacenSegmentado.h"
+#include "ArchivoRanuras.h"
+#include "ConversionSIMD.h"
+#include "ManipulacionDeArchivos.h"
+#include "UtilidadesCadena.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/** Primeros bytes de un archivo de ranuras fijas. */
+const char MAGIA_RANURAS[4] = { 'P', '3', 'R', 'F' };
+
+/** Límites aceptados para el tamaño de ranura. */
+const unsigned int TAM_RANURA_MINIMO = 64;
+const unsigned int TAM_RANURA_MAXIMO = 1 << 20;
+
+/**
+ * @brief Escribe un entero de 32 bits en little-endian.
+ */
+static void escribirEntero32(char* destino, unsigned int valor) {
+    for (int k = 0; k < 4; k++)
+        destino[k] = (char)((valor >> (8 * k)) & 0xFF);
+}
+
+/**
+ * @brief Lee un entero de 32 bits en little-endian.
+ */
+static unsigned int leerEntero32(const char* origen) {
+    unsigned int valor = 0;
+    for (int k = 3; k >= 0; k--)
+        valor = (valor << 8) | (unsigned char)origen[k];
+    return valor;
+}
+
+/**
+ * @brief Compara los primeros 4 bytes con la marca del formato.
+ */
+static bool tieneMagia(const char* datos) {
+    for (int k = 0; k < 4; k++)
+        if (datos[k] != MAGIA_RANURAS[k]) return false;
+    return true;
+}
+
+/**
+ * @brief Valida la cabecera y devuelve registros y tamaño de ranura.
+ * @throws const char* Si la cabecera no es coherente con el archivo.
+ */
+static void validarCabecera(const char* cabecera, int64_t tamArchivo, unsigned int& registros, unsigned int& tamRanura) {
+    if (!tieneMagia(cabecera))
+        throw "El archivo no está en formato de ranuras fijas.";
+    if ((unsigned char)cabecera[4] != VERSION_FORMATO_RANURAS)
+        throw "Versión de formato no soportada.";
+
+    registros = leerEntero32(cabecera + 8);
+    tamRanura = leerEntero32(cabecera + 12);
+    if (tamRanura < TAM_RANURA_MINIMO || tamRanura > TAM_RANURA_MAXIMO)
+        throw "Tamaño de ranura inválido.";
+    if (registros > (unsigned int)INT32_MAX)
+        throw "Número de registros inválido.";
+    // Puede sobrar una ranura al final si se cortó un agregado
+    if (tamArchivo < ((int64_t)registros + 1) * tamRanura)
+        throw "El archivo es más corto que lo que indica la cabecera.";
+}
+
+/**
+ * @brief Tamaño de ranura del archivo existente, o 0 si no es de ranuras.
+ */
+static unsigned int tamRanuraActual(const char* rutaArchivo) {
+    ifstream archivo(rutaArchivo, ios::binary);
+    char cabecera[16];
+    if (!archivo.read(cabecera, 16) || !tieneMagia(cabecera)) return 0;
+    return leerEntero32(cabecera + 12);
+}
+
+bool esArchivoRanuras(const char* rutaArchivo) {
+    ifstream archivo(rutaArchivo, ios::binary);
+    char magia[4];
+    if (!archivo.read(magia, 4)) return false;
+    return tieneMagia(magia);
+}
+
+char** leerArchivoRanuras(const char* rutaArchivo, int& numLineas) {
+    char* ranura = nullptr;
+    char** lineas = nullptr;
+    int creadas = 0;
+    try {
+        ifstream archivo(rutaArchivo, ios::binary);
+        if (!archivo.is_open()) {
+            throw "No se pudo abrir el archivo para lectura.";
+        }
+
+        archivo.seekg(0, ios::end);
+        int64_t fileSize = (int64_t)archivo.tellg();
+        archivo.seekg(0, ios::beg);
+
+        cout << "Leyendo archivo de ranuras: " << rutaArchivo << " (" << fileSize << " bytes)" << endl;
+
+        char cabecera[16];
+        if (fileSize < 16 || !archivo.read(cabecera, 16)) {
+            throw "Cabecera incompleta.";
+        }
+        unsigned int registros = 0, tamRanura = 0;
+        validarCabecera(cabecera, fileSize, registros, tamRanura);
+        if (registros == 0) {
+            throw "El archivo está vacío.";
+        }
+
+        numLineas = (int)registros;
+        lineas = new char*[numLineas];
+
+        // Se lee de a una ranura: el tamaño del archivo no está acotado
+        ranura = new char[tamRanura];
+        archivo.seekg(tamRanura, ios::beg);
+        for (int i = 0; i < numLineas; i++) {
+            if (!archivo.read(ranura, tamRanura)) {
+                throw "Registro truncado.";
+            }
+            unsigned int len = leerEntero32(ranura);
+            if (len == 0 || len > tamRanura - 4) {
+                throw "Longitud de registro inválida.";
+            }
+
+            lineas[i] = new char[len * 8 + 1];
+            creadas++;
+            expandirBits((const unsigned char*)ranura + 4, (int)len, (unsigned char*)lineas[i]);
+            lineas[i][len * 8] = '\0';
+        }
+
+        delete[] ranura;
+        cout << "Archivo cargado correctamente: " << numLineas << " registros" << endl << endl;
+        return lineas;
+    }
+    catch (const char* msg) {
+        cerr << "ERROR en leerArchivoRanuras(): " << msg << endl;
+        for (int i = 0; i < creadas; i++) delete[] lineas[i];
+        delete[] lineas;
+        delete[] ranura;
+        numLineas = 0;
+        return nullptr;
+    }
+}
+
+bool guardarArchivoRanuras(const char* rutaArchivo, char** lineas, int numLineas, unsigned int tamRanura,
+                           bool silencioso) {
+    char* ranura = nullptr;
+    char* temporal = new char[longitud(rutaArchivo) + 5];
+    copiar(temporal, rutaArchivo);
+    concatenar(temporal, ".tmp");
+    try {
+        if (lineas == nullptr || numLineas <= 0) {
+            throw "Arreglo vacío o no inicializado.";
+        }
+
+        if (tamRanura == 0) tamRanura = tamRanuraActual(rutaArchivo);
+        if (tamRanura == 0) tamRanura = TAM_RANURA_PREDETERMINADO;
+        if (tamRanura < TAM_RANURA_MINIMO) tamRanura = TAM_RANURA_MINIMO;
+
+        unsigned int registros = 0;
+        for (int i = 0; i < numLineas; i++) {
+            int len = longitud(lineas[i]);
+            if (len == 0) continue;
+            if (len % 8 != 0) {
+                throw "Línea con longitud no múltiplo de 8: no se puede empaquetar.";
+            }
+            unsigned int necesario = 4 + (unsigned int)len / 8;
+            if (necesario > TAM_RANURA_MAXIMO) {
+                throw "Registro demasiado largo para una ranura.";
+            }
+            while (necesario > tamRanura) tamRanura += 64;
+            registros++;
+        }
+
+        ofstream archivo(temporal, ios::trunc | ios::binary);
+        if (!archivo.is_open()) {
+            throw "No se pudo abrir el archivo para escritura.";
+        }
+
+        ranura = new char[tamRanura];
+        for (unsigned int k = 0; k < tamRanura; k++) ranura[k] = 0;
+        for (int k = 0; k < 4; k++) ranura[k] = MAGIA_RANURAS[k];
+        ranura[4] = (char)VERSION_FORMATO_RANURAS;
+        escribirEntero32(ranura + 8, registros);
+        escribirEntero32(ranura + 12, tamRanura);
+        archivo.write(ranura, tamRanura);
+
+        for (int i = 0; i < numLineas && archivo; i++) {
+            int len = longitud(lineas[i]);
+            if (len == 0) continue;
+            for (unsigned int k = 0; k < tamRanura; k++) ranura[k] = 0;
+            escribirEntero32(ranura, (unsigned int)(len / 8));
+            if (!empaquetarBits((const unsigned char*)lineas[i], len, (unsigned char*)ranura + 4)) {
+                throw "Línea con caracteres no binarios: no se puede empaquetar.";
+            }
+            archivo.write(ranura, tamRanura);
+        }
+
+        archivo.close();
+        if (!archivo) {
+            throw "Error al escribir el archivo.";
+        }
+        if (!reemplazarArchivo(temporal, rutaArchivo)) {
+            throw "No se pudo reemplazar el archivo original.";
+        }
+
+        if (!silencioso)
+            cout << "Archivo guardado (ranuras de " << tamRanura << " bytes): " << rutaArchivo << " (" << registros << " registros)" << endl;
+        delete[] ranura;
+        delete[] temporal;
+        return true;
+    }
+    catch (const char* msg) {
+        cerr << "ERROR en guardarArchivoRanuras(): " << msg << endl;
+        remove(temporal);
+        delete[] ranura;
+        delete[] temporal;
+        return false;
+    }
+}
+
+bool migrarArchivoRanuras(const char* rutaArchivo) {
+    if (esArchivoRanuras(rutaArchivo)) {
+        cout << "El archivo ya está en ranuras fijas: " << rutaArchivo << endl;
+        return true;
+    }
+    if (esManifiestoSegmentado(rutaArchivo)) {
+        cerr << "ERROR en migrarArchivoRanuras(): un almacén segmentado no se puede pasar a ranuras." << endl;
+        return false;
+    }
+
+    int numLineas = 0;
+    char** lineas = leerArchivoLineas(rutaArchivo, numLineas);
+    if (lineas == nullptr) return false;
+
+    bool ok = guardarArchivoRanuras(rutaArchivo, lineas, numLineas, TAM_RANURA_PREDETERMINADO);
+    for (int i = 0; i < numLineas; i++) delete[] lineas[i];
+    delete[] lineas;
+    if (ok) cout << "Archivo migrado a ranuras fijas: " << rutaArchivo << endl;
+    return ok;
+}
+
+// ============================================================
+//  ACTUALIZACIÓN EN EL LUGAR
+// ============================================================
+
+static bool escribirEn(ArchivoRanuras& archivo, int64_t desplazamiento, const char* datos, int bytes);
+
+bool escribirRanura(ArchivoRanuras& archivo, int indice, const char* lineaBinaria, int len) {
+    if (!ranurasAbiertas(archivo) || indice < 0 || (unsigned int)indice > archivo.registros) return false;
+    if (lineaBinaria == nullptr || len <= 0 || len % 8 != 0) return false;
+
+    unsigned int bytes = (unsigned int)len / 8;
+    if (4 + bytes > archivo.tamRanura) {
+        cerr << "ERROR en escribirRanura(): el registro no cabe en la ranura." << endl;
+        return false;
+    }
+
+    char* ranura = new char[archivo.tamRanura];
+    for (unsigned int k = 0; k < archivo.tamRanura; k++) ranura[k] = 0;
+    escribirEntero32(ranura, bytes);
+    bool ok = empaquetarBits((const unsigned char*)lineaBinaria, len, (unsigned char*)ranura + 4)
+           && escribirEn(archivo, ((int64_t)indice + 1) * archivo.tamRanura, ranura, (int)archivo.tamRanura);
+    delete[] ranura;
+    if (!ok) return false;
+
+    if ((unsigned int)indice == archivo.registros) {
+        char cuenta[4];
+        escribirEntero32(cuenta, archivo.registros + 1);
+        if (!escribirEn(archivo, 8, cuenta, 4)) return false;
+        archivo.registros++;
+    }
+
+    if (archivo.fsyncCada > 0 && ++archivo.sinSincronizar >= archivo.fsyncCada)
+        return sincronizarRanuras(archivo);
+    return true;
+}
+
+#ifdef _WIN32
+
+void abrirRanuras(ArchivoRanuras& archivo, const char* ruta, int fsyncCada) {
+    cerrarRanuras(archivo);
+
+    HANDLE manejador = CreateFileA(ruta, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (manejador == INVALID_HANDLE_VALUE)
+        throw "No se pudo abrir el archivo de ranuras.";
+
+    LARGE_INTEGER tam;
+    char cabecera[16];
+    DWORD leidos = 0;
+    if (!GetFileSizeEx(manejador, &tam) || !ReadFile(manejador, cabecera, 16, &leidos, nullptr) || leidos != 16) {
+        CloseHandle(manejador);
+        throw "Cabecera incompleta.";
+    }
+    try {
+        validarCabecera(cabecera, tam.QuadPart, archivo.registros, archivo.tamRanura);
+    } catch (const char*) {
+        CloseHandle(manejador);
+        throw;
+    }
+
+    archivo.manejador = manejador;
+    archivo.fsyncCada = fsyncCada;
+    archivo.sinSincronizar = 0;
+}
+
+void cerrarRanuras(ArchivoRanuras& archivo) {
+    if (!ranurasAbiertas(archivo)) return;
+    if (archivo.sinSincronizar > 0) sincronizarRanuras(archivo);
+    CloseHandle(archivo.manejador);
+    archivo.manejador = nullptr;
+}
+
+bool ranurasAbiertas(const ArchivoRanuras& archivo) {
+    return archivo.manejador != nullptr;
+}
+
+static bool escribirEn(ArchivoRanuras& archivo, int64_t desplazamiento, const char* datos, int bytes) {
+    OVERLAPPED posicion = {};
+    posicion.Offset = (DWORD)(desplazamiento & 0xFFFFFFFF);
+    posicion.OffsetHigh = (DWORD)(desplazamiento >> 32);
+    DWORD escritos = 0;
+    if (!WriteFile(archivo.manejador, datos, (DWORD)bytes, &escritos, &posicion) || escritos != (DWORD)bytes) {
+        cerr << "ERROR en escribirRanura(): escritura incompleta." << endl;
+        return false;
+    }
+    return true;
+}
+
+bool sincronizarRanuras(ArchivoRanuras& archivo) {
+    archivo.sinSincronizar = 0;
+    return ranurasAbiertas(archivo) && FlushFileBuffers(archivo.manejador);
+}
+
+#else
+
+void abrirRanuras(ArchivoRanuras& archivo, const char* ruta, int fsyncCada) {
+    cerrarRanuras(archivo);
+
+    int fd = open(ruta, O_RDWR);
+    if (fd < 0)
+        throw "No se pudo abrir el archivo de ranuras.";
+
+    char cabecera[16];
+    off_t tam = lseek(fd, 0, SEEK_END);
+    if (tam < 0 || pread(fd, cabecera, 16, 0) != 16) {
+        close(fd);
+        throw "Cabecera incompleta.";
+    }
+    try {
+        validarCabecera(cabecera, (int64_t)tam, archivo.registros, archivo.tamRanura);
+    } catch (const char*) {
+        close(fd);
+        throw;
+    }
+
+    archivo.descriptor = fd;
+    archivo.fsyncCada = fsyncCada;
+    archivo.sinSincronizar = 0;
+}
+
+void cerrarRanuras(ArchivoRanuras& archivo) {
+    if (!ranurasAbiertas(archivo)) return;
+    if (archivo.sinSincronizar > 0) sincronizarRanuras(archivo);
+    close(archivo.descriptor);
+    archivo.descriptor = -1;
+}
+
+bool ranurasAbiertas(const ArchivoRanuras& archivo) {
+    return archivo.descriptor >= 0;
+}
+
+static bool escribirEn(ArchivoRanuras& archivo, int64_t desplazamiento, const char* datos, int bytes) {
+    while (bytes > 0) {
+        ssize_t escritos = pwrite(archivo.descriptor, datos, (size_t)bytes, (off_t)desplazamiento);
+        if (escritos <= 0) {
+            cerr << "ERROR en escribirRanura(): escritura incompleta." << endl;
+            return false;
+        }
+        datos += escritos;
+        bytes -= (int)escritos;
+        desplazamiento += escritos;
+    }
+    return true;
+}
+
+bool sincronizarRanuras(ArchivoRanuras& archivo) {
+    archivo.sinSincronizar = 0;
+#if defined(__APPLE__)
+    return ranurasAbiertas(archivo) && fsync(archivo.descriptor) == 0;
+#else
+    return ranurasAbiertas(archivo) && fdatasync(archivo.descriptor) == 0;
+#endif
+}
+
+#endif
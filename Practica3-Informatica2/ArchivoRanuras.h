@@ -0,0 +1,112 @@
+#ifndef ARCHIVO_RANURAS_H
+#define ARCHIVO_RANURAS_H
+
+// ===================== REGISTROS DE ANCHO FIJO =====================
+//
+// El archivo se divide en ranuras de `tamRanura` bytes. La ranura 0 es
+// la cabecera:
+//   [0..3]   "P3RF"
+//   [4]      versión del formato (VERSION_FORMATO_RANURAS)
+//   [5..7]   reservado (0)
+//   [8..11]  número de registros (uint32, little-endian)
+//   [12..15] tamaño de cada ranura en bytes (uint32, little-endian)
+// El registro i ocupa la ranura i + 1: longitud en bytes (uint32,
+// little-endian), los bytes cifrados empaquetados (8 bits por byte) y
+// ceros hasta completar la ranura. Como cada registro está en una
+// posición conocida, un cambio se escribe en su lugar sin reescribir
+// el archivo.
+
+const unsigned char VERSION_FORMATO_RANURAS = 1;
+
+/** Ranura por omisión: cabe cualquier Cuenta serializada y, al ser
+ *  divisor de 4096, ninguna ranura cruza un límite de página. */
+const unsigned int TAM_RANURA_PREDETERMINADO = 256;
+
+/**
+ * @brief Archivo de ranuras abierto para actualizar registros en su lugar.
+ *
+ * Cada escritura es una sola escritura posicionada (pwrite() en POSIX,
+ * WriteFile() con desplazamiento en Windows) de la ranura completa.
+ * `fsyncCada` decide cuándo se fuerza a disco: 0 deja la descarga al
+ * sistema operativo (y al cierre), 1 sincroniza tras cada escritura y
+ * N > 1 cada N escrituras.
+ */
+struct ArchivoRanuras {
+    int descriptor = -1;                /**< Solo POSIX */
+    void* manejador = nullptr;          /**< Solo Windows */
+    unsigned int registros = 0;         /**< Registros según la cabecera */
+    unsigned int tamRanura = 0;         /**< Bytes por ranura */
+    int fsyncCada = 1;                  /**< Escrituras entre sincronizaciones */
+    int sinSincronizar = 0;             /**< Escrituras desde la última */
+};
+
+/**
+ * @brief Indica si el archivo empieza con la cabecera de ranuras fijas.
+ */
+bool esArchivoRanuras(const char* rutaArchivo);
+
+/**
+ * @brief Lee un archivo de ranuras fijas.
+ *
+ * Devuelve cada registro expandido a '0'/'1', igual que
+ * leerArchivoEmpaquetado().
+ *
+ * @return char** Arreglo dinámico de líneas, o nullptr si ocurre un error.
+ */
+char** leerArchivoRanuras(const char* rutaArchivo, int& numLineas);
+
+/**
+ * @brief Escribe líneas binarias en ranuras fijas (archivo temporal +
+ *        reemplazarArchivo()).
+ *
+ * Si un registro no cabe, la ranura crece de a 64 bytes.
+ *
+ * @param tamRanura Tamaño de ranura pedido; 0 conserva el del archivo
+ *        actual (o TAM_RANURA_PREDETERMINADO si no hay).
+ * @param silencioso true para no informar en consola cuando todo sale bien.
+ * @return true si el archivo se escribió completo.
+ */
+bool guardarArchivoRanuras(const char* rutaArchivo, char** lineas, int numLineas, unsigned int tamRanura = 0,
+                           bool silencioso = false);
+
+/**
+ * @brief Convierte un archivo de texto o empaquetado a ranuras fijas.
+ * @return true si el archivo queda en ranuras fijas.
+ */
+bool migrarArchivoRanuras(const char* rutaArchivo);
+
+/**
+ * @brief Abre el archivo para lectura y escritura (cierra antes el que hubiera).
+ * @throws const char* Si no se puede abrir o la cabecera es inválida.
+ */
+void abrirRanuras(ArchivoRanuras& archivo, const char* ruta, int fsyncCada);
+
+/**
+ * @brief Sincroniza lo pendiente y cierra el archivo.
+ */
+void cerrarRanuras(ArchivoRanuras& archivo);
+
+/**
+ * @brief Indica si el archivo está abierto.
+ */
+bool ranurasAbiertas(const ArchivoRanuras& archivo);
+
+/**
+ * @brief Escribe el registro `indice` en su ranura.
+ *
+ * Con `indice == registros` agrega un registro al final: primero la
+ * ranura y después la cabecera, así que un corte entre ambas solo deja
+ * una ranura sobrante que se ignora.
+ *
+ * @param lineaBinaria Registro cifrado en '0'/'1'.
+ * @param len Caracteres de la línea.
+ * @return false si no cabe en la ranura o la escritura falló.
+ */
+bool escribirRanura(ArchivoRanuras& archivo, int indice, const char* lineaBinaria, int len);
+
+/**
+ * @brief Fuerza a disco las escrituras hechas.
+ */
+bool sincronizarRanuras(ArchivoRanuras& archivo);
+
+#endif // ARCHIVO_RANURAS_H
@@ -0,0 +1,410 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "Bitacora.h"
+#include "ConversionSIMD.h"
+#include "Encriptacion.h"
+#include "UtilidadesCadena.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/** Primeros bytes de una bitácora. */
+const char MAGIA_BITACORA[4] = { 'P', '3', 'B', 'J' };
+
+/** Bytes de la cabecera de cada entrada (longitud, suma y secuencia). */
+const int TAM_CABECERA_ENTRADA = 16;
+
+/** Bytes de la cabecera de una entrada de la versión 1 (sin secuencia). */
+const int TAM_CABECERA_ENTRADA_V1 = 8;
+
+/**
+ * @brief Escribe un entero de 32 bits en little-endian.
+ */
+static void escribirEntero32(char* destino, unsigned int valor) {
+    for (int k = 0; k < 4; k++)
+        destino[k] = (char)((valor >> (8 * k)) & 0xFF);
+}
+
+/**
+ * @brief Lee un entero de 32 bits en little-endian.
+ */
+static unsigned int leerEntero32(const char* origen) {
+    unsigned int valor = 0;
+    for (int k = 3; k >= 0; k--)
+        valor = (valor << 8) | (unsigned char)origen[k];
+    return valor;
+}
+
+/**
+ * @brief Escribe un entero de 64 bits en little-endian.
+ */
+static void escribirEntero64(char* destino, uint64_t valor) {
+    for (int k = 0; k < 8; k++)
+        destino[k] = (char)((valor >> (8 * k)) & 0xFF);
+}
+
+/**
+ * @brief Lee un entero de 64 bits en little-endian.
+ */
+static uint64_t leerEntero64(const char* origen) {
+    uint64_t valor = 0;
+    for (int k = 7; k >= 0; k--)
+        valor = (valor << 8) | (unsigned char)origen[k];
+    return valor;
+}
+
+/**
+ * @brief Suma FNV-1a de 32 bits.
+ *
+ * @param suma Suma de los bytes anteriores, para continuarla.
+ */
+static unsigned int sumaFNV(const char* datos, int bytes, unsigned int suma = 2166136261u) {
+    for (int i = 0; i < bytes; i++) {
+        suma ^= (unsigned char)datos[i];
+        suma *= 16777619u;
+    }
+    return suma;
+}
+
+/**
+ * @brief Vacía los buffers y sincroniza el archivo con el disco.
+ */
+static bool sincronizarArchivo(FILE* archivo) {
+    if (fflush(archivo) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(archivo)) == 0;
+#elif defined(__APPLE__)
+    return fsync(fileno(archivo)) == 0;
+#else
+    return fdatasync(fileno(archivo)) == 0;
+#endif
+}
+
+/**
+ * @brief Interpreta "motivo,delta,<cuenta>" o, en la versión 1,
+ *        "secuencia,motivo,delta,<cuenta>".
+ *
+ * @param conSecuencia true si la línea empieza por la secuencia; si no,
+ *        `movimiento.secuencia` ya viene de la cabecera de la entrada.
+ * @return false si la línea no tiene ese formato.
+ */
+static bool parsearMovimiento(const char* linea, bool conSecuencia, MovimientoCuenta& movimiento) {
+    const char* p = linea;
+
+    if (conSecuencia) {
+        uint64_t secuencia = 0;
+        if (*p < '0' || *p > '9') return false;
+        while (*p >= '0' && *p <= '9') secuencia = secuencia * 10 + (uint64_t)(*p++ - '0');
+        if (*p++ != ',') return false;
+        movimiento.secuencia = secuencia;
+    }
+
+    if (*p < '1' || *p > '3' || p[1] != ',') return false;
+    int motivo = *p - '0';
+    p += 2;
+
+    bool negativo = (*p == '-');
+    if (negativo) p++;
+    int64_t delta = 0;
+    int digitos = 0;
+    while (*p >= '0' && *p <= '9') {
+        if (++digitos > 18) return false;
+        delta = delta * 10 + (*p++ - '0');
+    }
+    if (digitos == 0 || *p++ != ',') return false;
+
+    if (movimiento.secuencia == 0 || !parsearCuenta(p, movimiento.cuenta)) return false;
+    movimiento.motivo = (MotivoCambio)motivo;
+    movimiento.delta = negativo ? -delta : delta;
+    return true;
+}
+
+int64_t reproducirBitacora(const char* ruta, int semilla, AplicarMovimiento aplicar, void* contexto, int64_t* finValido) {
+    if (finValido != nullptr) *finValido = 0;
+    ifstream archivo(ruta, ios::binary);
+    if (!archivo.is_open()) return 0;
+
+    archivo.seekg(0, ios::end);
+    int64_t tam = (int64_t)archivo.tellg();
+    archivo.seekg(0, ios::beg);
+    if (tam <= 0) return 0;
+
+    char* contenido = new char[tam];
+    bool valido = archivo.read(contenido, tam) && tam >= TAM_CABECERA_BITACORA
+               && ((unsigned char)contenido[4] == VERSION_BITACORA || contenido[4] == 1);
+    for (int k = 0; valido && k < 4; k++)
+        if (contenido[k] != MAGIA_BITACORA[k]) valido = false;
+    if (!valido) {
+        cerr << "ERROR en reproducirBitacora(): " << ruta << " no es una bitácora válida." << endl;
+        delete[] contenido;
+        return -1;
+    }
+
+    bool version1 = contenido[4] == 1;
+    int cabecera = version1 ? TAM_CABECERA_ENTRADA_V1 : TAM_CABECERA_ENTRADA;
+    int64_t aplicadas = 0;
+    uint64_t ultimaSecuencia = 0;
+    int64_t pos = TAM_CABECERA_BITACORA;
+    while (pos + cabecera <= tam) {
+        unsigned int len = leerEntero32(contenido + pos);
+        unsigned int suma = leerEntero32(contenido + pos + 4);
+        const char* datos = contenido + pos + cabecera;
+        if (len == 0 || (int64_t)len > tam - pos - cabecera)
+            break;
+        unsigned int calculada = sumaFNV(datos, (int)len);
+        if (!version1) calculada = sumaFNV(contenido + pos + 8, 8, calculada);
+        if (calculada != suma)
+            break;
+
+        // desencriptarArchivo() reemplaza la línea por el texto plano
+        char* linea = new char[len * 8 + 1];
+        expandirBits((const unsigned char*)datos, (int)len, (unsigned char*)linea);
+        linea[len * 8] = '\0';
+        desencriptarArchivo(&linea, 1, semilla);
+
+        MovimientoCuenta movimiento;
+        if (!version1) movimiento.secuencia = leerEntero64(contenido + pos + 8);
+        bool ok = parsearMovimiento(linea, version1, movimiento) && movimiento.secuencia > ultimaSecuencia;
+        delete[] linea;
+        if (!ok) break;
+
+        aplicar(movimiento, contexto);
+        ultimaSecuencia = movimiento.secuencia;
+        aplicadas++;
+        pos += cabecera + len;
+    }
+
+    if (pos < tam)
+        cerr << "Advertencia: la bitácora " << ruta << " termina en una entrada incompleta; se descarta.\n";
+    if (finValido != nullptr) *finValido = pos;
+    delete[] contenido;
+    return aplicadas;
+}
+
+/**
+ * @brief Guarda la secuencia de cada entrada (para abrirBitacora()).
+ */
+static void anotarSecuencia(const MovimientoCuenta& movimiento, void* contexto) {
+    *(uint64_t*)contexto = movimiento.secuencia;
+}
+
+/**
+ * @brief Escribe un lote de entradas y lo sincroniza (sin el candado).
+ */
+static bool escribirLote(Bitacora& bitacora, const char* lote, int tam) {
+    char cabecera[TAM_CABECERA_BITACORA] = {};
+    bool conCabecera = false;
+    if (bitacora.archivo == nullptr) {
+        bitacora.archivo = fopen(bitacora.ruta, "ab");
+        if (bitacora.archivo == nullptr) {
+            cerr << "ERROR en la bitácora: no se pudo abrir " << bitacora.ruta << endl;
+            return false;
+        }
+        if (bitacora.bytes == 0) {
+            for (int k = 0; k < 4; k++) cabecera[k] = MAGIA_BITACORA[k];
+            cabecera[4] = (char)VERSION_BITACORA;
+            conCabecera = true;
+        }
+    }
+
+    bool ok = (!conCabecera || fwrite(cabecera, 1, TAM_CABECERA_BITACORA, bitacora.archivo) == (size_t)TAM_CABECERA_BITACORA)
+           && fwrite(lote, 1, (size_t)tam, bitacora.archivo) == (size_t)tam
+           && sincronizarArchivo(bitacora.archivo);
+    if (!ok) {
+        cerr << "ERROR en la bitácora: no se pudo escribir en " << bitacora.ruta << endl;
+        return false;
+    }
+
+    bitacora.bytes += (conCabecera ? TAM_CABECERA_BITACORA : 0) + tam;
+    return true;
+}
+
+/**
+ * @brief Hilo escritor: junta las entradas encoladas y las sincroniza juntas.
+ */
+static void bucleEscritor(Bitacora* bitacora) {
+    Bitacora& b = *bitacora;
+    unique_lock<mutex> lock(b.m);
+    while (true) {
+        b.hayPendientes.wait(lock, [&] { return b.detener || b.numPendiente > 0; });
+        if (b.numPendiente == 0) break;     // detener y nada más que escribir
+
+        // Confirmación en grupo: se da un momento para que lleguen más
+        // entradas y se sincronizan todas juntas
+        if (b.esperaGrupoMs > 0 && !b.detener)
+            b.hayPendientes.wait_for(lock, chrono::milliseconds(b.esperaGrupoMs), [&] { return b.detener; });
+
+        char* lote = b.pendiente;
+        int tam = b.numPendiente;
+        uint64_t hasta = b.ultimaEncolada;
+        b.pendiente = nullptr;
+        b.numPendiente = b.capacidadPendiente = 0;
+        b.escribiendo = true;
+        lock.unlock();
+
+        bool ok = escribirLote(b, lote, tam);
+        delete[] lote;
+
+        lock.lock();
+        b.escribiendo = false;
+        if (ok) b.ultimaConfirmada = hasta;
+        else b.fallo = true;
+        b.hayConfirmadas.notify_all();
+    }
+}
+
+void abrirBitacora(Bitacora& bitacora, const char* ruta, int semilla, uint64_t primeraSecuencia, int esperaGrupoMs) {
+    cerrarBitacora(bitacora);
+
+    uint64_t ultima = 0;
+    int64_t finValido = 0;
+    if (reproducirBitacora(ruta, semilla, anotarSecuencia, &ultima, &finValido) < 0)
+        throw "La bitácora existente está dañada.";
+    if (finValido > 0) {
+        // Las entradas nuevas no pueden quedar detrás de una cabecera vieja
+        ifstream existente(ruta, ios::binary);
+        char cabecera[TAM_CABECERA_BITACORA] = {};
+        existente.read(cabecera, TAM_CABECERA_BITACORA);
+        if ((unsigned char)cabecera[4] != VERSION_BITACORA)
+            throw "La bitácora existente es de otra versión; debe reproducirse antes de abrirla.";
+    }
+
+    // Lo que sigue a la última entrada válida se descarta para que las
+    // nuevas no queden detrás de basura
+    error_code error;
+    if (filesystem::exists(ruta, error) && (int64_t)filesystem::file_size(ruta, error) > finValido) {
+        filesystem::resize_file(ruta, (uintmax_t)finValido, error);
+        if (error) throw "No se pudo descartar el final incompleto de la bitácora.";
+    }
+
+    bitacora.ruta = new char[longitud(ruta) + 1];
+    copiar(bitacora.ruta, ruta);
+    bitacora.semilla = semilla;
+    bitacora.esperaGrupoMs = esperaGrupoMs;
+    bitacora.bytes = finValido;
+    bitacora.siguiente = primeraSecuencia > ultima + 1 ? primeraSecuencia : ultima + 1;
+    bitacora.ultimaEncolada = bitacora.ultimaConfirmada = bitacora.siguiente - 1;
+    bitacora.escribiendo = bitacora.detener = bitacora.fallo = false;
+    bitacora.escritor = thread(bucleEscritor, &bitacora);
+}
+
+void cerrarBitacora(Bitacora& bitacora) {
+    if (!bitacora.escritor.joinable()) return;
+    {
+        lock_guard<mutex> lock(bitacora.m);
+        bitacora.detener = true;
+    }
+    bitacora.hayPendientes.notify_all();
+    bitacora.escritor.join();
+
+    if (bitacora.archivo != nullptr) {
+        fclose(bitacora.archivo);
+        bitacora.archivo = nullptr;
+    }
+    delete[] bitacora.pendiente;
+    bitacora.pendiente = nullptr;
+    bitacora.numPendiente = bitacora.capacidadPendiente = 0;
+    delete[] bitacora.ruta;
+    bitacora.ruta = nullptr;
+}
+
+uint64_t registrarMovimiento(Bitacora& bitacora, MotivoCambio motivo, int64_t delta, const Cuenta& cuenta) {
+    // El registro "motivo,delta,<cuenta>" se arma, se cifra y se empaqueta
+    // sin el candado: los cajeros cifran en paralelo y solo se turnan para
+    // numerarlo y copiarlo. encriptarArchivo() reemplaza la línea por su
+    // versión binaria
+    char prefijo[48];
+    snprintf(prefijo, sizeof(prefijo), "%d,%lld,", (int)motivo, (long long)delta);
+    char* cuentaTexto = serializarCuenta(cuenta);
+    char* linea = new char[longitud(prefijo) + longitud(cuentaTexto) + 1];
+    copiar(linea, prefijo);
+    concatenar(linea, cuentaTexto);
+    delete[] cuentaTexto;
+    encriptarArchivo(&linea, 1, bitacora.semilla);
+
+    int bits = longitud(linea);
+    int len = bits / 8;
+    char* registro = new char[len > 0 ? len : 1];
+    bool ok = bits % 8 == 0 && empaquetarBits((const unsigned char*)linea, bits, (unsigned char*)registro);
+    delete[] linea;
+    if (!ok) {
+        delete[] registro;
+        return 0;
+    }
+    unsigned int sumaRegistro = sumaFNV(registro, len);
+
+    uint64_t secuencia = 0;
+    {
+        lock_guard<mutex> lock(bitacora.m);
+        if (bitacora.escritor.joinable() && !bitacora.detener && !bitacora.fallo) {
+            int necesario = bitacora.numPendiente + TAM_CABECERA_ENTRADA + len;
+            if (necesario > bitacora.capacidadPendiente) {
+                int nueva = bitacora.capacidadPendiente == 0 ? 1024 : bitacora.capacidadPendiente * 2;
+                while (nueva < necesario) nueva *= 2;
+                char* ampliado = new char[nueva];
+                for (int i = 0; i < bitacora.numPendiente; i++) ampliado[i] = bitacora.pendiente[i];
+                delete[] bitacora.pendiente;
+                bitacora.pendiente = ampliado;
+                bitacora.capacidadPendiente = nueva;
+            }
+
+            secuencia = bitacora.siguiente++;
+            char* entrada = bitacora.pendiente + bitacora.numPendiente;
+            escribirEntero32(entrada, (unsigned int)len);
+            escribirEntero64(entrada + 8, secuencia);
+            escribirEntero32(entrada + 4, sumaFNV(entrada + 8, 8, sumaRegistro));
+            for (int i = 0; i < len; i++) entrada[TAM_CABECERA_ENTRADA + i] = registro[i];
+
+            bitacora.numPendiente = necesario;
+            bitacora.ultimaEncolada = secuencia;
+            bitacora.hayPendientes.notify_one();
+        }
+    }
+    delete[] registro;
+    return secuencia;
+}
+
+bool esperarMovimiento(Bitacora& bitacora, uint64_t secuencia) {
+    unique_lock<mutex> lock(bitacora.m);
+    bitacora.hayConfirmadas.wait(lock, [&] { return bitacora.ultimaConfirmada >= secuencia || bitacora.fallo; });
+    return bitacora.ultimaConfirmada >= secuencia;
+}
+
+bool confirmarMovimiento(Bitacora& bitacora, MotivoCambio motivo, int64_t delta, const Cuenta& cuenta) {
+    uint64_t secuencia = registrarMovimiento(bitacora, motivo, delta, cuenta);
+    return secuencia != 0 && esperarMovimiento(bitacora, secuencia);
+}
+
+int64_t tamanioBitacora(Bitacora& bitacora) {
+    return bitacora.bytes;
+}
+
+bool rotarBitacora(Bitacora& bitacora, const char* rutaVieja) {
+    unique_lock<mutex> lock(bitacora.m);
+    bitacora.hayConfirmadas.wait(lock, [&] {
+        return (bitacora.numPendiente == 0 && !bitacora.escribiendo) || bitacora.fallo;
+    });
+    if (bitacora.fallo || bitacora.bytes == 0) return false;
+
+    error_code error;
+    if (filesystem::exists(rutaVieja, error)) return false;
+
+    if (bitacora.archivo != nullptr) {
+        fclose(bitacora.archivo);
+        bitacora.archivo = nullptr;
+    }
+    if (rename(bitacora.ruta, rutaVieja) != 0) {
+        cerr << "ERROR en rotarBitacora(): no se pudo renombrar " << bitacora.ruta << endl;
+        return false;
+    }
+    bitacora.bytes = 0;
+    return true;
+}
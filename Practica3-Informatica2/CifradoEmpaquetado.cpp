@@ -0,0 +1,182 @@
+#include <cstdint>
+#include <cstring>
+#include "CifradoEmpaquetado.h"
+
+// ============================================================
+//  UTILIDADES DE BITS
+// ============================================================
+
+/**
+ * @brief Lee 8 bytes desde `byte` como entero big-endian; lo que queda
+ *        fuera del arreglo se lee como cero.
+ */
+static inline uint64_t leerVentana(const unsigned char* datos, int numBytes, int byte) {
+    uint64_t w = 0;
+    for (int k = 0; k < 8; k++) {
+        w <<= 8;
+        if (byte + k < numBytes) w |= datos[byte + k];
+    }
+    return w;
+}
+
+/**
+ * @brief Invierte los bits del rango [inicio, inicio + len).
+ */
+static void invertirRango(unsigned char* datos, int inicio, int len) {
+    if (len <= 0) return;
+    int fin = inicio + len;
+    int b0 = inicio >> 3;
+    int b1 = (fin - 1) >> 3;
+    unsigned char mascaraIni = (unsigned char)(0xFF >> (inicio & 7));
+    unsigned char mascaraFin = (unsigned char)(0xFF << (7 - ((fin - 1) & 7)));
+
+    if (b0 == b1) {
+        datos[b0] ^= (mascaraIni & mascaraFin);
+        return;
+    }
+
+    datos[b0] ^= mascaraIni;
+    int b = b0 + 1;
+    for (; b + 8 <= b1; b += 8) {
+        uint64_t w;
+        memcpy(&w, datos + b, 8);
+        w = ~w;
+        memcpy(datos + b, &w, 8);
+    }
+    for (; b < b1; b++) datos[b] ^= 0xFF;
+    datos[b1] ^= mascaraFin;
+}
+
+// ============================================================
+//  MOTOR DE CIFRADO
+// ============================================================
+
+/**
+ * @brief Decide la regla del siguiente bloque según el balance de bits.
+ */
+ReglaBloque reglaSegunBloque(int unos, int len) {
+    int ceros = len - unos;
+    if (unos == ceros) return INVERTIR_TODO;
+    if (ceros > unos)  return INVERTIR_CADA_2;
+    return INVERTIR_CADA_3;
+}
+
+/**
+ * @brief Encripta bits empaquetados con las reglas de encriptarBits().
+ *
+ * invertirCadaNBits() invierte completo cada grupo de n bits y los grupos
+ * cubren el bloque, así que las tres reglas invierten el bloque entero:
+ * la regla que elige reglaSegunBloque() no cambia el resultado y el
+ * cifrado es un NOT de todo el rango, sin contar unos por bloque.
+ */
+void encriptarBitsEmpaquetados(const unsigned char* entrada, unsigned char* salida, int numBits, int semilla) {
+    if (entrada == nullptr || salida == nullptr || numBits <= 0 || semilla <= 0)
+        throw "Error: parámetros inválidos en encriptarBitsEmpaquetados.";
+
+    if (entrada != salida)
+        memmove(salida, entrada, (numBits + 7) / 8);
+    invertirRango(salida, 0, numBits);
+}
+
+/**
+ * @brief Desencripta bits empaquetados.
+ *
+ * Todas las reglas invierten el bloque completo (ver
+ * encriptarBitsEmpaquetados()), así que descifrar es el mismo NOT de
+ * todo el rango, sin leer la regla del bloque cifrado anterior.
+ */
+void desencriptarBitsEmpaquetados(const unsigned char* entrada, unsigned char* salida, int numBits, int semilla) {
+    if (entrada == nullptr || salida == nullptr || numBits <= 0 || semilla <= 0)
+        throw "Error: parámetros inválidos en desencriptarBitsEmpaquetados.";
+
+    if (entrada != salida)
+        memcpy(salida, entrada, (numBits + 7) / 8);
+    invertirRango(salida, 0, numBits);
+}
+
+/**
+ * @brief Desencripta bits empaquetados repartiendo los bloques entre hilos.
+ *
+ * Los trozos son grupos de 8 bloques, de modo que cada uno empieza en un
+ * límite de byte y ningún par de hilos escribe en el mismo byte.
+ */
+void desencriptarBitsEmpaquetados(const unsigned char* entrada, unsigned char* salida, int numBits, int semilla, PoolHilos& pool) {
+    if (entrada == salida || numBits < BITS_MIN_PARALELO || pool.numHilos() <= 1) {
+        desencriptarBitsEmpaquetados(entrada, salida, numBits, semilla);
+        return;
+    }
+    if (entrada == nullptr || salida == nullptr || semilla <= 0)
+        throw "Error: parámetros inválidos en desencriptarBitsEmpaquetados.";
+
+    int numBloques = (numBits + semilla - 1) / semilla;
+    int numGrupos = (numBloques + 7) / 8;
+
+    pool.paraCadaTrozo(numGrupos, PoolHilos::trozoSugerido(numGrupos, pool.numHilos()),
+                       [=](int inicio, int fin, int) {
+                           int primero = inicio * 8;
+                           int ultimo = fin * 8 < numBloques ? fin * 8 : numBloques;
+                           int bitIni = primero * semilla;
+                           int bitFin = ultimo * semilla < numBits ? ultimo * semilla : numBits;
+                           int byteIni = bitIni / 8;
+                           memcpy(salida + byteIni, entrada + byteIni, (bitFin + 7) / 8 - byteIni);
+                           invertirRango(salida, bitIni, bitFin - bitIni);
+                       });
+}
+
+// ============================================================
+//  LOTES DE REGISTROS
+// ============================================================
+//
+// Se procesan hasta 64 registros a la vez. Como en
+// encriptarBitsEmpaquetados(), las tres reglas invierten el bloque
+// completo, así que la regla elegida por el balance del bloque anterior
+// no cambia el resultado y el lote se reduce a un NOT de cada palabra de 64 bits de cada registro:
+// no hace falta transponer a bit-slicing ni contar unos por carril.
+
+/**
+ * @brief Los 8 caracteres '0'/'1' de cada byte posible.
+ *
+ * El lote escribe de a 8 bytes por carril, muy poco para que
+ * expandirBits() aproveche sus núcleos SIMD.
+ */
+struct TablaCaracteres {
+    unsigned char v[256][8];
+    constexpr TablaCaracteres() : v() {
+        for (int i = 0; i < 256; i++)
+            for (int j = 0; j < 8; j++)
+                v[i][j] = (unsigned char)('0' + ((i >> (7 - j)) & 1));
+    }
+};
+static constexpr TablaCaracteres CARACTERES{};
+
+/**
+ * @brief Encripta hasta CARRILES_LOTE registros a la vez.
+ *
+ * Recorre los registros en tramos de 64 bits, los invierte con una sola
+ * operación de palabra y escribe cada carril ya expandido a '0'/'1'. El
+ * resultado es idéntico a encriptarBitsEmpaquetados() sobre cada registro.
+ */
+void encriptarLoteBinario(const unsigned char* const* entradas, const int* numBytes,
+                          int numCarriles, int semilla, unsigned char* const* salidas) {
+    if (semilla <= 0)
+        throw "Error: semilla inválida (debe ser > 0).";
+    if (numCarriles > CARRILES_LOTE)
+        throw "Error: demasiados registros en un lote.";
+    if (numCarriles <= 0)
+        return;
+
+    int maxBytes = 0;
+    for (int c = 0; c < numCarriles; c++)
+        if (numBytes[c] > maxBytes) maxBytes = numBytes[c];
+
+    for (int byte = 0; byte < maxBytes; byte += 8) {
+        for (int c = 0; c < numCarriles; c++) {
+            if (byte >= numBytes[c]) continue;
+            uint64_t w = ~leerVentana(entradas[c], numBytes[c], byte);
+            int n = numBytes[c] - byte < 8 ? numBytes[c] - byte : 8;
+            unsigned char* destino = salidas[c] + byte * 8;
+            for (int k = 0; k < n; k++)
+                memcpy(destino + 8 * k, CARACTERES.v[(unsigned char)(w >> (56 - 8 * k))], 8);
+        }
+    }
+}
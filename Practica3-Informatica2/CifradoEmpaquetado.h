@@ -0,0 +1,107 @@
+#ifndef CIFRADO_EMPAQUETADO_H
+#define CIFRADO_EMPAQUETADO_H
+
+#include "ConversionSIMD.h"
+#include "PoolHilos.h"
+
+/**
+ * @brief Regla de transformación de un bloque.
+ *
+ * Se elige a partir del balance de unos y ceros del bloque de salida
+ * anterior, igual que en encriptarBits():
+ * - INVERTIR_TODO: unos == ceros (y siempre el primer bloque).
+ * - INVERTIR_CADA_2: ceros > unos.
+ * - INVERTIR_CADA_3: unos > ceros.
+ */
+enum ReglaBloque {
+    INVERTIR_TODO,
+    INVERTIR_CADA_2,
+    INVERTIR_CADA_3
+};
+
+/**
+ * @brief Decide la regla del siguiente bloque.
+ * @param unos Cantidad de bits en 1 del bloque anterior.
+ * @param len Longitud del bloque anterior.
+ * @return Regla a aplicar al bloque siguiente.
+ */
+ReglaBloque reglaSegunBloque(int unos, int len);
+
+/**
+ * @brief Encripta bits empaquetados (8 por byte, bit más significativo primero).
+ *
+ * Aplica las mismas reglas por bloque que encriptarBits() pero sobre bytes
+ * reales; como las tres reglas invierten el bloque completo, se reduce a
+ * un NOT por palabras de 64 bits. El resultado es idéntico bit a bit al de
+ * la versión con caracteres '0'/'1'.
+ *
+ * @param entrada Bytes de entrada.
+ * @param salida Bytes de salida (puede ser el mismo arreglo que `entrada`).
+ * @param numBits Número de bits a procesar.
+ * @param semilla Tamaño de los bloques.
+ * @throw const char* Si los parámetros son inválidos.
+ */
+void encriptarBitsEmpaquetados(const unsigned char* entrada, unsigned char* salida, int numBits, int semilla);
+
+/**
+ * @brief Desencripta bits empaquetados.
+ *
+ * La regla de cada bloque se toma del bloque cifrado anterior (que es
+ * parte de la entrada), así que los bloques se descifran de forma
+ * independiente.
+ *
+ * @param entrada Bytes cifrados.
+ * @param salida Bytes de salida (puede ser el mismo arreglo que `entrada`).
+ * @param numBits Número de bits a procesar.
+ * @param semilla Tamaño de los bloques usado en la encriptación.
+ * @throw const char* Si los parámetros son inválidos.
+ */
+void desencriptarBitsEmpaquetados(const unsigned char* entrada, unsigned char* salida, int numBits, int semilla);
+
+/**
+ * @brief Registros con menos bits que esto se descifran en un solo hilo.
+ */
+const int BITS_MIN_PARALELO = 1 << 16;
+
+/**
+ * @brief Desencripta bits empaquetados repartiendo los bloques entre los hilos del pool.
+ *
+ * Pensada para registros muy largos. Si `entrada` y `salida` coinciden, o
+ * el registro es corto, se procesa en un solo hilo.
+ *
+ * @param pool Pool de hilos a usar.
+ * @throw const char* Si los parámetros son inválidos.
+ */
+void desencriptarBitsEmpaquetados(const unsigned char* entrada, unsigned char* salida, int numBits, int semilla, PoolHilos& pool);
+
+/**
+ * @brief Registros que procesa a la vez encriptarLoteBinario().
+ */
+const int CARRILES_LOTE = 64;
+
+/**
+ * @brief Semilla máxima para la que conviene encriptarLoteBinario().
+ *
+ * Con semillas mayores las líneas van por el motor escalar, una a una.
+ */
+const int SEMILLA_MAX_LOTE = 7;
+
+/**
+ * @brief Encripta hasta CARRILES_LOTE registros a la vez.
+ *
+ * Deja cada registro expandido a '0'/'1' en `salidas[c]` (numBytes[c] * 8
+ * caracteres, sin '\0'). El resultado de cada carril es idéntico al de
+ * encriptarBitsEmpaquetados(); conviene agrupar registros de longitud
+ * parecida, porque el lote avanza hasta el más largo.
+ *
+ * @param entradas Bytes de texto plano de cada registro.
+ * @param numBytes Longitud de cada registro.
+ * @param numCarriles Cantidad de registros (como mucho CARRILES_LOTE).
+ * @param semilla Tamaño de los bloques.
+ * @param salidas Destino de cada registro cifrado.
+ * @throw const char* Si la semilla es inválida o hay demasiados registros.
+ */
+void encriptarLoteBinario(const unsigned char* const* entradas, const int* numBytes,
+                          int numCarriles, int semilla, unsigned char* const* salidas);
+
+#endif // CIFRADO_EMPAQUETADO_H
@@ -0,0 +1,385 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "CifradoFlujo.h"
+#include "ConversionSIMD.h"
+#include "ManipulacionDeArchivos.h"
+#include "UtilidadesCadena.h"
+using namespace std;
+
+/** Bytes leídos del archivo en cada paso de los helpers de archivo. */
+const int TAM_TROZO_FLUJO = 64 * 1024;
+
+// ============================================================
+//  CIFRADOR POR FLUJO
+// ============================================================
+
+void iniciarCifradorFlujo(CifradorFlujo& cifrador, int semilla) {
+    if (semilla <= 0)
+        throw "Error: semilla inválida (debe ser > 0).";
+    cifrador.semilla = semilla;
+    cifrador.totalBits = 0;
+}
+
+void reiniciarCifradorFlujo(CifradorFlujo& cifrador) {
+    cifrador.totalBits = 0;
+}
+
+/**
+ * @brief Procesa el siguiente trozo del registro.
+ *
+ * Las tres reglas invierten el bloque completo (ver
+ * encriptarBitsEmpaquetados()), así que ningún byte depende de los
+ * anteriores y el trozo puede cortar el registro en cualquier lugar.
+ */
+void procesarFlujo(CifradorFlujo& cifrador, const unsigned char* entrada, int numBytes, unsigned char* salida) {
+    for (int b = 0; b < numBytes; b++)
+        salida[b] = (unsigned char)~entrada[b];
+    cifrador.totalBits += (int64_t)numBytes * 8;
+}
+
+// ============================================================
+//  ARCHIVOS POR FLUJO
+// ============================================================
+
+/**
+ * @brief Cifra cada línea no vacía de `rutaOrigen` y reparte los
+ *        registros entre varios destinos.
+ *
+ * Lee trozos de TAM_TROZO_FLUJO bytes; cada línea no vacía se cifra como
+ * un registro independiente aunque quede partida entre trozos. En cada
+ * destino las líneas se separan con '\n' (sin salto final), igual que
+ * guardarArchivoLineas().
+ *
+ * @param destinos Archivos de salida, en orden.
+ * @param registros Registros que van a cada destino salvo el último,
+ *        que recibe el resto (puede ser nullptr con un solo destino).
+ * @throw const char* Si no se puede leer o escribir.
+ */
+static void encriptarLineasFlujo(const char* rutaOrigen, int semilla, char** destinos, int numDestinos,
+                                 const uint64_t* registros) {
+    CifradorFlujo cifrador;
+    iniciarCifradorFlujo(cifrador, semilla);
+
+    ifstream origen(rutaOrigen, ios::binary);
+    if (!origen.is_open())
+        throw "No se pudo abrir el archivo de origen.";
+
+    ofstream destino(destinos[0], ios::trunc | ios::binary);
+    if (!destino.is_open())
+        throw "No se pudo abrir el archivo de destino.";
+    int actual = 0;
+    uint64_t enActual = 0;
+
+    char* lectura = new char[TAM_TROZO_FLUJO];
+    unsigned char* cifrado = new unsigned char[TAM_TROZO_FLUJO];
+    unsigned char* bits = new unsigned char[TAM_TROZO_FLUJO * 8];
+    bool enRegistro = false;
+
+    try {
+        while (origen.read(lectura, TAM_TROZO_FLUJO) || origen.gcount() > 0) {
+            int leidos = (int)origen.gcount();
+            int i = 0;
+            while (i < leidos) {
+                if (lectura[i] == '\n') {
+                    if (enRegistro) reiniciarCifradorFlujo(cifrador);
+                    enRegistro = false;
+                    i++;
+                    continue;
+                }
+
+                const char* salto = (const char*)memchr(lectura + i, '\n', leidos - i);
+                int fin = salto ? (int)(salto - lectura) : leidos;
+                int n = fin - i;
+
+                if (!enRegistro) {
+                    if (actual + 1 < numDestinos && enActual == registros[actual]) {
+                        destino.close();
+                        if (!destino)
+                            throw "Error de escritura en el archivo de destino.";
+                        destino.open(destinos[++actual], ios::trunc | ios::binary);
+                        if (!destino.is_open())
+                            throw "No se pudo abrir el archivo de destino.";
+                        enActual = 0;
+                    }
+                    if (enActual > 0) destino.put('\n');
+                    enRegistro = true;
+                    enActual++;
+                }
+
+                procesarFlujo(cifrador, (const unsigned char*)(lectura + i), n, cifrado);
+                expandirBits(cifrado, n, bits);
+                destino.write((const char*)bits, (streamsize)n * 8);
+                i = fin;
+            }
+        }
+
+        destino.close();
+        if (!destino)
+            throw "Error de escritura en el archivo de destino.";
+    } catch (const char*) {
+        delete[] lectura;
+        delete[] cifrado;
+        delete[] bits;
+        throw;
+    }
+    delete[] lectura;
+    delete[] cifrado;
+    delete[] bits;
+}
+
+bool encriptarArchivoFlujo(const char* rutaOrigen, const char* rutaDestino, int semilla) {
+    try {
+        char* destinos[1] = { (char*)rutaDestino };
+        encriptarLineasFlujo(rutaOrigen, semilla, destinos, 1, nullptr);
+        return true;
+    } catch (const char* msg) {
+        cerr << "ERROR en encriptarArchivoFlujo(): " << msg << endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Reparte los registros de un texto plano en segmentos según el
+ *        tamaño que tendrán cifrados, con las reglas de guardarSegmentado().
+ *
+ * Solo recorre el archivo midiendo líneas: cada registro de n caracteres
+ * ocupa 8n bytes más su '\n'.
+ *
+ * @param numSegmentos Segmentos planificados.
+ * @return Arreglo de segmentos (liberar con delete[]).
+ * @throw const char* Si no se puede leer, no hay registros o uno no cabe en un segmento.
+ */
+static SegmentoAlmacen* planificarSegmentos(const char* rutaOrigen, int64_t tamMaxSegmento, int& numSegmentos) {
+    ifstream origen(rutaOrigen, ios::binary);
+    if (!origen.is_open())
+        throw "No se pudo abrir el archivo de origen.";
+
+    int capacidad = 4;
+    SegmentoAlmacen* segmentos = new SegmentoAlmacen[capacidad];
+    numSegmentos = 1;
+    uint64_t largo = 0;
+    char* lectura = new char[TAM_TROZO_FLUJO];
+
+    try {
+        bool finArchivo = false;
+        while (!finArchivo) {
+            origen.read(lectura, TAM_TROZO_FLUJO);
+            int leidos = (int)origen.gcount();
+            finArchivo = leidos == 0;
+
+            int i = 0;
+            // Al final del archivo se cierra el último registro como si hubiera un '\n'
+            while (i < leidos || finArchivo) {
+                if (i < leidos && lectura[i] != '\n') {
+                    const char* salto = (const char*)memchr(lectura + i, '\n', leidos - i);
+                    int fin = salto ? (int)(salto - lectura) : leidos;
+                    largo += (uint64_t)(fin - i);
+                    i = fin;
+                    continue;
+                }
+                i++;
+                if (largo > 0) {
+                    uint64_t bytes = largo * 8 + 1;
+                    if (bytes > (uint64_t)tamMaxSegmento)
+                        throw "Registro más grande que un segmento.";
+                    SegmentoAlmacen& ultimo = segmentos[numSegmentos - 1];
+                    if (ultimo.registros > 0 && ultimo.bytes + bytes > (uint64_t)tamMaxSegmento) {
+                        if (numSegmentos == capacidad) {
+                            capacidad *= 2;
+                            SegmentoAlmacen* mayor = new SegmentoAlmacen[capacidad];
+                            for (int k = 0; k < numSegmentos; k++) mayor[k] = segmentos[k];
+                            delete[] segmentos;
+                            segmentos = mayor;
+                        }
+                        numSegmentos++;
+                    }
+                    segmentos[numSegmentos - 1].bytes += bytes;
+                    segmentos[numSegmentos - 1].registros++;
+                    largo = 0;
+                }
+                if (finArchivo) break;
+            }
+        }
+
+        if (segmentos[numSegmentos - 1].registros == 0)
+            throw "No hay registros para cifrar.";
+    } catch (const char*) {
+        delete[] lectura;
+        delete[] segmentos;
+        throw;
+    }
+
+    delete[] lectura;
+    for (int k = 0; k < numSegmentos; k++)
+        segmentos[k].bytes--;       // la última línea va sin '\n'
+    return segmentos;
+}
+
+/**
+ * @brief Encripta un texto plano hacia un almacén sin cargarlo.
+ *
+ * Primero mide las líneas para saber dónde cortar y luego cifra en una
+ * sola pasada, escribiendo cada archivo por temporal y
+ * reemplazarArchivo(). Si hay un solo segmento y el destino no era ya
+ * un manifiesto, el resultado es un archivo suelto, como en
+ * guardarAlmacen(); si no, los segmentos de una generación nueva y su
+ * manifiesto.
+ */
+bool encriptarAlmacenFlujo(const char* rutaOrigen, const char* rutaAlmacen, int semilla, int64_t tamMaxSegmento) {
+    SegmentoAlmacen* segmentos = nullptr;
+    int numSegmentos = 0;
+    char** destinos = nullptr;
+    uint64_t* registros = nullptr;
+    ManifiestoAlmacen manifiesto;
+    char final[TAM_MAX_RUTA_SEGMENTO];
+
+    try {
+        segmentos = planificarSegmentos(rutaOrigen, tamMaxSegmento, numSegmentos);
+
+        // Un almacén que ya era segmentado sigue siéndolo, como en guardarAlmacen()
+        bool segmentar = numSegmentos > 1 || esManifiestoSegmentado(rutaAlmacen);
+        manifiesto.generacion = siguienteGeneracion(rutaAlmacen);
+        manifiesto.empaquetado = false;
+
+        destinos = new char*[numSegmentos]();
+        registros = new uint64_t[numSegmentos];
+        for (int k = 0; k < numSegmentos; k++) {
+            registros[k] = segmentos[k].registros;
+            manifiesto.totalRegistros += segmentos[k].registros;
+            destinos[k] = new char[TAM_MAX_RUTA_SEGMENTO + 4];
+            if (segmentar)
+                rutaSegmento(rutaAlmacen, manifiesto.generacion, k, destinos[k]);
+            else
+                copiar(destinos[k], rutaAlmacen);
+            concatenar(destinos[k], ".tmp");
+        }
+        encriptarLineasFlujo(rutaOrigen, semilla, destinos, numSegmentos, registros);
+
+        if (!segmentar) {
+            if (!reemplazarArchivo(destinos[0], rutaAlmacen))
+                throw "No se pudo reemplazar el archivo.";
+            destinos[0][0] = '\0';
+        } else {
+            manifiesto.segmentos = new SegmentoAlmacen[numSegmentos];
+            for (int k = 0; k < numSegmentos; k++) {
+                rutaSegmento(rutaAlmacen, manifiesto.generacion, k, final);
+                if (!reemplazarArchivo(destinos[k], final))
+                    throw "No se pudo escribir un segmento.";
+                destinos[k][0] = '\0';
+                manifiesto.segmentos[manifiesto.numSegmentos++] = segmentos[k];
+            }
+            if (!publicarManifiesto(rutaAlmacen, manifiesto))
+                throw "No se pudo escribir el manifiesto.";
+        }
+    } catch (const char* msg) {
+        cerr << "ERROR en encriptarAlmacenFlujo(): " << msg << endl;
+        for (int k = 0; destinos != nullptr && k < numSegmentos; k++)
+            if (destinos[k] != nullptr && destinos[k][0] != '\0') remove(destinos[k]);
+        for (int k = 0; k < manifiesto.numSegmentos; k++) {
+            rutaSegmento(rutaAlmacen, manifiesto.generacion, k, final);
+            remove(final);
+        }
+        for (int k = 0; destinos != nullptr && k < numSegmentos; k++) delete[] destinos[k];
+        delete[] destinos;
+        delete[] registros;
+        delete[] segmentos;
+        liberarManifiesto(manifiesto);
+        return false;
+    }
+
+    for (int k = 0; k < numSegmentos; k++) delete[] destinos[k];
+    delete[] destinos;
+    delete[] registros;
+    delete[] segmentos;
+    liberarManifiesto(manifiesto);
+    return true;
+}
+
+/**
+ * @brief Desencripta un archivo binario sin cargarlo completo.
+ *
+ * Los caracteres '0'/'1' se empaquetan de a 8; si un byte queda partido
+ * entre dos trozos, sus primeros bits se guardan hasta el siguiente.
+ */
+bool desencriptarArchivoFlujo(const char* rutaOrigen, const char* rutaDestino, int semilla) {
+    char* lectura = nullptr;
+    unsigned char* bytes = nullptr;
+    try {
+        CifradorFlujo descifrador;
+        iniciarCifradorFlujo(descifrador, semilla);
+
+        ifstream origen(rutaOrigen, ios::binary);
+        if (!origen.is_open())
+            throw "No se pudo abrir el archivo de origen.";
+        ofstream destino(rutaDestino, ios::trunc | ios::binary);
+        if (!destino.is_open())
+            throw "No se pudo abrir el archivo de destino.";
+
+        lectura = new char[TAM_TROZO_FLUJO];
+        bytes = new unsigned char[TAM_TROZO_FLUJO / 8 + 1];
+        unsigned char pendiente[8];
+        int numPendiente = 0;
+        bool enRegistro = false, hayRegistros = false;
+
+        while (origen.read(lectura, TAM_TROZO_FLUJO) || origen.gcount() > 0) {
+            int leidos = (int)origen.gcount();
+            int i = 0;
+            while (i < leidos) {
+                if (lectura[i] == '\n') {
+                    if (numPendiente != 0)
+                        throw "Línea cifrada con longitud no múltiplo de 8.";
+                    if (enRegistro) reiniciarCifradorFlujo(descifrador);
+                    enRegistro = false;
+                    i++;
+                    continue;
+                }
+
+                const char* salto = (const char*)memchr(lectura + i, '\n', leidos - i);
+                int fin = salto ? (int)(salto - lectura) : leidos;
+
+                if (!enRegistro) {
+                    if (hayRegistros) destino.put('\n');
+                    enRegistro = hayRegistros = true;
+                }
+
+                // Completar el byte que quedó partido en el trozo anterior
+                while (numPendiente > 0 && numPendiente < 8 && i < fin)
+                    pendiente[numPendiente++] = (unsigned char)lectura[i++];
+                if (numPendiente == 8) {
+                    if (!empaquetarBits(pendiente, 8, bytes))
+                        throw "Caracter inválido en el archivo cifrado.";
+                    procesarFlujo(descifrador, bytes, 1, bytes);
+                    destino.write((const char*)bytes, 1);
+                    numPendiente = 0;
+                }
+
+                int completos = (fin - i) / 8 * 8;
+                if (completos > 0) {
+                    if (!empaquetarBits((const unsigned char*)(lectura + i), completos, bytes))
+                        throw "Caracter inválido en el archivo cifrado.";
+                    procesarFlujo(descifrador, bytes, completos / 8, bytes);
+                    destino.write((const char*)bytes, completos / 8);
+                }
+                i += completos;
+
+                while (i < fin)
+                    pendiente[numPendiente++] = (unsigned char)lectura[i++];
+            }
+        }
+
+        if (numPendiente != 0)
+            throw "Línea cifrada con longitud no múltiplo de 8.";
+        if (!destino)
+            throw "Error de escritura en el archivo de destino.";
+    } catch (const char* msg) {
+        cerr << "ERROR en desencriptarArchivoFlujo(): " << msg << endl;
+        delete[] lectura;
+        delete[] bytes;
+        return false;
+    }
+    delete[] lectura;
+    delete[] bytes;
+    return true;
+}
@@ -0,0 +1,85 @@
+#ifndef CIFRADO_FLUJO_H
+#define CIFRADO_FLUJO_H
+
+#include <cstdint>
+#include "AlmacenSegmentado.h"
+#include "CifradoEmpaquetado.h"
+
+// ===================== CIFRADO POR FLUJO =====================
+//
+// Aplica las mismas reglas por bloque que encriptarBits() sin necesitar
+// el registro completo en memoria. Como las tres reglas invierten el
+// bloque entero, la regla que elige el balance del bloque anterior no
+// cambia el resultado y no hay estado de bloque que arrastrar entre
+// trozos: un registro puede llegar partido en cualquier lugar y
+// procesarlo de una vez o en trozos da el mismo resultado.
+
+/**
+ * @brief Cifrador incremental de un registro de bits empaquetados
+ *        (8 bits por byte, bit más significativo primero).
+ *
+ * Cifrar y descifrar son la misma operación (un NOT), así que el mismo
+ * cifrador sirve para los dos sentidos.
+ */
+struct CifradorFlujo {
+    int semilla = 0;                    /**< Tamaño de bloque */
+    int64_t totalBits = 0;              /**< Bits procesados desde el último reinicio */
+};
+
+/**
+ * @brief Prepara el cifrador al inicio de un registro.
+ * @param cifrador Cifrador a preparar.
+ * @param semilla Tamaño de bloque.
+ * @throw const char* Si la semilla no es positiva.
+ */
+void iniciarCifradorFlujo(CifradorFlujo& cifrador, int semilla);
+
+/**
+ * @brief Procesa los siguientes `numBytes` bytes del registro.
+ * @param cifrador Cifrador en curso.
+ * @param entrada Bytes de entrada.
+ * @param numBytes Cantidad de bytes.
+ * @param salida Bytes de salida (puede ser `entrada`).
+ */
+void procesarFlujo(CifradorFlujo& cifrador, const unsigned char* entrada, int numBytes, unsigned char* salida);
+
+/**
+ * @brief Termina el registro actual: el siguiente byte procesado empieza
+ *        un registro nuevo.
+ */
+void reiniciarCifradorFlujo(CifradorFlujo& cifrador);
+
+/**
+ * @brief Encripta un archivo de texto línea por línea con memoria constante.
+ *
+ * Cada línea no vacía es un registro independiente; la salida tiene el
+ * mismo formato que guardarArchivoLineas() tras encriptarArchivo().
+ *
+ * @return false (informado por cerr) si algo falla.
+ */
+bool encriptarArchivoFlujo(const char* rutaOrigen, const char* rutaDestino, int semilla);
+
+/**
+ * @brief Operación inversa de encriptarArchivoFlujo().
+ *
+ * Falla si alguna línea trae caracteres distintos de '0'/'1' o una
+ * longitud no múltiplo de 8.
+ */
+bool desencriptarArchivoFlujo(const char* rutaOrigen, const char* rutaDestino, int semilla);
+
+/**
+ * @brief Encripta un texto plano hacia un almacén (AlmacenSegmentado.h)
+ *        con memoria constante, sin el límite de cargarLineasMapeadas().
+ *
+ * Si el binario cabe en `tamMaxSegmento` (y `rutaAlmacen` no era ya un
+ * manifiesto) queda en un archivo suelto; si no, en segmentos de una
+ * generación nueva con su manifiesto, cortados igual que en
+ * guardarSegmentado(). `rutaAlmacen` puede ser la misma `rutaOrigen`:
+ * se reemplaza solo al final.
+ *
+ * @return false (informado por cerr) si algo falla; `rutaAlmacen` queda intacta.
+ */
+bool encriptarAlmacenFlujo(const char* rutaOrigen, const char* rutaAlmacen, int semilla,
+                           int64_t tamMaxSegmento = TAM_MAX_SEGMENTO);
+
+#endif // CIFRADO_FLUJO_H
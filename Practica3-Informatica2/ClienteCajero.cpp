@@ -0,0 +1,423 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include "ArchivoMapeado.h"
+#include "ClienteCajero.h"
+#include "OperacionesUsuario.h"
+#include "ProtocoloCajero.h"
+#include "UtilidadesCadena.h"
+
+using namespace std;
+
+/**
+ * @brief Indica si la respuesta empieza con `prefijo`.
+ */
+static bool empiezaCon(const char* respuesta, const char* prefijo) {
+    int k = 0;
+    while (prefijo[k] != '\0' && respuesta[k] == prefijo[k]) k++;
+    return prefijo[k] == '\0';
+}
+
+/**
+ * @brief Motivo de una respuesta "error <motivo>" (o la respuesta completa).
+ */
+static const char* motivoError(const char* respuesta) {
+    return empiezaCon(respuesta, "error ") ? respuesta + 6 : respuesta;
+}
+
+/**
+ * @brief Submenu de operaciones de un usuario ya autenticado.
+ * @throws const char* Si se perdió la conexión.
+ */
+static void operacionesRemotas(ConexionCajero& conexion, const char* nombre) {
+    char peticion[TAM_MAX_LINEA_PROTOCOLO + 1];
+    char respuesta[TAM_MAX_LINEA_PROTOCOLO + 1];
+    bool continuar = true;
+    while (continuar) {
+        int opcion;
+        cout << "\n=================================\n";
+        cout << "    OPERACIONES DISPONIBLES\n";
+        cout << "=================================\n";
+        cout << "1. Consultar saldo (Costo: " << COSTO_CONSULTA << " COP)\n";
+        cout << "2. Retirar dinero (Costo: " << COSTO_RETIRO << " COP + monto)\n";
+        cout << "3. Volver al menu principal\n";
+        cout << "=================================\n";
+        cout << "Opcion: ";
+
+        if (!(cin >> opcion)) {
+            if (cin.eof()) return;
+            cin.clear();
+            cin.ignore(10000, '\n');
+            cout << "\n Entrada invalida. Ingrese un numero.\n";
+            continue;
+        }
+
+        switch (opcion) {
+        case 1: {
+            if (!peticionCajero(conexion, "consulta", respuesta, sizeof(respuesta)))
+                throw "Se perdio la conexion con el servicio.";
+            long long saldo = 0, cobrado = 0;
+            if (sscanf(respuesta, "ok %lld %lld", &saldo, &cobrado) != 2) {
+                cout << "\n[Error] " << motivoError(respuesta) << "\n";
+                break;
+            }
+            cout << "\n---------------------------------\n";
+            cout << "Usuario: " << nombre << endl;
+            cout << "Costo de la consulta: " << cobrado << " COP\n";
+            cout << "Saldo despues del cobro: " << saldo << " COP\n";
+            cout << "---------------------------------\n";
+            break;
+        }
+        case 2: {
+            int monto;
+            cout << "\nMonto a retirar: ";
+            if (!(cin >> monto) || monto <= 0) {
+                if (cin.eof()) return;
+                cin.clear();
+                cin.ignore(10000, '\n');
+                cout << "\n El monto debe ser mayor a cero.\n";
+                break;
+            }
+            snprintf(peticion, sizeof(peticion), "retiro %d", monto);
+            if (!peticionCajero(conexion, peticion, respuesta, sizeof(respuesta)))
+                throw "Se perdio la conexion con el servicio.";
+            long long saldo = 0;
+            cout << "\n---------------------------------\n";
+            if (sscanf(respuesta, "ok %lld", &saldo) != 1) {
+                cout << "Retiro rechazado: " << motivoError(respuesta) << ".\n";
+            } else {
+                cout << "Retiro exitoso.\n";
+                cout << "Monto retirado: " << monto << " COP\n";
+                cout << "Costo de operacion: " << COSTO_RETIRO << " COP\n";
+                cout << "Saldo restante: " << saldo << " COP\n";
+            }
+            cout << "---------------------------------\n";
+            break;
+        }
+        case 3:
+            cout << "\n Volviendo al menu principal...\n";
+            continuar = false;
+            break;
+        default:
+            cout << "\n Opcion invalida.\n";
+        }
+    }
+}
+
+int menuCajeroRemoto(const char* direccion) {
+    ConexionCajero conexion;
+    if (!conectarCajero(conexion, direccion))
+        return 1;
+
+    char peticion[TAM_MAX_LINEA_PROTOCOLO + 1];
+    char respuesta[TAM_MAX_LINEA_PROTOCOLO + 1];
+    int opcion = 0;
+    try {
+        do {
+            cout << "\n===================================\n";
+            cout << "||      SISTEMA BANCARIO         ||\n";
+            cout << "===================================\n";
+            cout << "|| 1. Administrador              ||\n";
+            cout << "|| 2. Usuario                    ||\n";
+            cout << "|| 3. Salir                      ||\n";
+            cout << "===================================\n";
+            cout << "Seleccione una opcion: ";
+
+            if (!(cin >> opcion)) {
+                if (cin.eof()) break;
+                cin.clear();
+                cin.ignore(10000, '\n');
+                cout << "\n Entrada invalida. Debe ingresar un numero.\n";
+                continue;
+            }
+
+            switch (opcion) {
+            case 1:
+                cout << "\n El registro de usuarios solo esta disponible en el cajero local.\n";
+                break;
+            case 2: {
+                char cedula[50], clave[50];
+                cout << "\n=================================\n";
+                cout << "        MENU USUARIO\n";
+                cout << "=================================\n";
+                cout << "Cedula: ";
+                cin.width(sizeof(cedula));
+                cin >> cedula;
+                cout << "Clave: ";
+                cin.width(sizeof(clave));
+                cin >> clave;
+                snprintf(peticion, sizeof(peticion), "auth %s %s", cedula, clave);
+                if (!peticionCajero(conexion, peticion, respuesta, sizeof(respuesta)))
+                    throw "Se perdio la conexion con el servicio.";
+                if (!empiezaCon(respuesta, "ok ")) {
+                    cout << "\n[Error] " << motivoError(respuesta) << "\n";
+                    break;
+                }
+                operacionesRemotas(conexion, respuesta + 3);
+                break;
+            }
+            case 3:
+                cout << "\n Gracias por usar el sistema. Hasta pronto!\n";
+                break;
+            default:
+                cout << "\n Opcion invalida. Seleccione 1, 2 o 3.\n";
+            }
+        } while (opcion != 3 && !cin.eof());
+    }
+    catch (const char* msg) {
+        cerr << "\n[ERROR CAJERO REMOTO]: " << msg << "\n";
+        cerrarConexion(conexion);
+        return 1;
+    }
+
+    peticionCajero(conexion, "salir", respuesta, sizeof(respuesta));
+    cerrarConexion(conexion);
+    return 0;
+}
+
+/**
+ * @brief Cédula y clave de una fila del archivo de credenciales.
+ */
+struct Credencial {
+    VistaLinea cedula;
+    VistaLinea clave;
+};
+
+/**
+ * @brief Lee pares (cédula, clave) de un CSV "cedula,clave,..." ya proyectado.
+ *
+ * Las vistas apuntan dentro de `archivo`.
+ *
+ * @return Arreglo dinámico (el llamador lo libera); `cantidad` recibe su tamaño.
+ */
+static Credencial* leerCredenciales(const ArchivoMapeado& archivo, int& cantidad) {
+    const char* fin = archivo.datos + archivo.tamanio;
+    int filas = 0;
+    for (const char* p = archivo.datos; p != nullptr && p < fin; filas++) {
+        const char* salto = (const char*)memchr(p, '\n', fin - p);
+        p = salto ? salto + 1 : fin;
+    }
+
+    Credencial* credenciales = new Credencial[filas > 0 ? filas : 1];
+    cantidad = 0;
+    for (const char* p = archivo.datos; p != nullptr && p < fin; ) {
+        const char* salto = (const char*)memchr(p, '\n', fin - p);
+        const char* finFila = salto ? salto : fin;
+        const char* c1 = (const char*)memchr(p, ',', finFila - p);
+        if (c1 != nullptr && *p >= '0' && *p <= '9') {     // el encabezado no empieza con dígito
+            const char* c2 = (const char*)memchr(c1 + 1, ',', finFila - c1 - 1);
+            const char* finClave = c2 ? c2 : finFila;
+            if (finClave > c1 + 1 && finClave[-1] == '\r') finClave--;
+            Credencial& cred = credenciales[cantidad];
+            cred.cedula.inicio = p;
+            cred.cedula.longitud = (int)(c1 - p);
+            cred.clave.inicio = c1 + 1;
+            cred.clave.longitud = (int)(finClave - c1 - 1);
+            // La petición "auth <cedula> <clave>" debe caber en una línea
+            if (cred.cedula.longitud + cred.clave.longitud + 6 <= TAM_MAX_LINEA_PROTOCOLO)
+                cantidad++;
+        }
+        p = finFila + 1;
+    }
+    return credenciales;
+}
+
+/**
+ * @brief Resultado de una conexión del generador de carga.
+ */
+struct ResultadoCliente {
+    int64_t* latenciasNs = nullptr;     /**< Una por petición respondida */
+    int respondidas = 0;
+    int rechazadas = 0;                 /**< Respuestas "error ..." */
+    bool fallo = false;                 /**< Se perdió o no se abrió la conexión */
+};
+
+/**
+ * @brief Una conexión del generador: ciclos de auth, consulta y retiro.
+ *
+ * La conexión `numero` de `clientes` recorre solo su porción de las
+ * credenciales: dos conexiones nunca operan sobre la misma cuenta.
+ */
+static void clienteCarga(const OpcionesCarga* opciones, const Credencial* credenciales, int numCredenciales,
+                         int clientes, int numero, ResultadoCliente* resultado) {
+    ConexionCajero conexion;
+    if (!conectarCajero(conexion, opciones->direccion)) {
+        resultado->fallo = true;
+        return;
+    }
+
+    char peticion[TAM_MAX_LINEA_PROTOCOLO + 1];
+    char respuesta[TAM_MAX_LINEA_PROTOCOLO + 1];
+    int desde = (int)((long long)numCredenciales * numero / clientes);
+    int hasta = (int)((long long)numCredenciales * (numero + 1) / clientes);
+    int siguiente = desde;
+    for (int k = 0; k < opciones->peticiones; k++) {
+        if (k % 3 == 0) {
+            const Credencial& cuenta = credenciales[siguiente];
+            if (++siguiente == hasta) siguiente = desde;
+            snprintf(peticion, sizeof(peticion), "auth %.*s %.*s", cuenta.cedula.longitud, cuenta.cedula.inicio,
+                     cuenta.clave.longitud, cuenta.clave.inicio);
+        } else if (k % 3 == 1) {
+            copiar(peticion, "consulta");
+        } else {
+            snprintf(peticion, sizeof(peticion), "retiro %d", 1 + (k + numero) % 100);
+        }
+
+        auto inicio = chrono::steady_clock::now();
+        if (!peticionCajero(conexion, peticion, respuesta, sizeof(respuesta))) {
+            resultado->fallo = true;
+            cerrarConexion(conexion);
+            return;
+        }
+        resultado->latenciasNs[resultado->respondidas++] =
+            chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - inicio).count();
+        if (!empiezaCon(respuesta, "ok")) resultado->rechazadas++;
+    }
+    peticionCajero(conexion, "salir", respuesta, sizeof(respuesta));
+    cerrarConexion(conexion);
+}
+
+/**
+ * @brief Totales de una corrida del generador.
+ */
+struct MedicionCarga {
+    int peticiones = 0;                 /**< Peticiones respondidas */
+    double segundos = 0;
+    double p50 = 0, p99 = 0, maximo = 0;/**< Latencias en us */
+    int rechazadas = 0;
+    int fallidas = 0;                   /**< Conexiones que se perdieron */
+};
+
+/**
+ * @brief Peticiones por segundo de una medición.
+ */
+static double porSegundo(const MedicionCarga& medicion) {
+    return medicion.segundos > 0 ? medicion.peticiones / medicion.segundos : 0;
+}
+
+/**
+ * @brief Corre el generador con `clientes` conexiones simultáneas.
+ */
+static MedicionCarga medirCarga(const OpcionesCarga& opciones, const Credencial* credenciales,
+                                int numCredenciales, int clientes) {
+    ResultadoCliente* resultados = new ResultadoCliente[clientes];
+    for (int c = 0; c < clientes; c++)
+        resultados[c].latenciasNs = new int64_t[opciones.peticiones > 0 ? opciones.peticiones : 1];
+    thread* hilos = new thread[clientes];
+    auto inicio = chrono::steady_clock::now();
+    for (int c = 0; c < clientes; c++)
+        hilos[c] = thread(clienteCarga, &opciones, credenciales, numCredenciales, clientes, c, &resultados[c]);
+    for (int c = 0; c < clientes; c++) hilos[c].join();
+    MedicionCarga medicion;
+    medicion.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    delete[] hilos;
+
+    // Latencias de todas las conexiones, ordenadas para los percentiles
+    int total = 0;
+    for (int c = 0; c < clientes; c++) total += resultados[c].respondidas;
+    int64_t* latencias = new int64_t[total > 0 ? total : 1];
+    int n = 0;
+    for (int c = 0; c < clientes; c++) {
+        for (int k = 0; k < resultados[c].respondidas; k++)
+            latencias[n++] = resultados[c].latenciasNs[k];
+        medicion.rechazadas += resultados[c].rechazadas;
+        if (resultados[c].fallo) medicion.fallidas++;
+        delete[] resultados[c].latenciasNs;
+    }
+    delete[] resultados;
+    sort(latencias, latencias + total);
+    medicion.peticiones = total;
+    medicion.p50 = total > 0 ? latencias[(int)(0.50 * (total - 1))] / 1000.0 : 0;
+    medicion.p99 = total > 0 ? latencias[(int)(0.99 * (total - 1))] / 1000.0 : 0;
+    medicion.maximo = total > 0 ? latencias[total - 1] / 1000.0 : 0;
+    delete[] latencias;
+    return medicion;
+}
+
+int generarCarga(const OpcionesCarga& opciones) {
+    ArchivoMapeado archivo;
+    try {
+        abrirMapeo(archivo, opciones.rutaCredenciales);
+    }
+    catch (const char* e) {
+        cerr << "ERROR en generarCarga(): " << e << endl;
+        return 1;
+    }
+    int numCredenciales = 0;
+    Credencial* credenciales = leerCredenciales(archivo, numCredenciales);
+    if (numCredenciales == 0) {
+        cerr << "ERROR en generarCarga(): no hay credenciales en " << opciones.rutaCredenciales << endl;
+        delete[] credenciales;
+        cerrarMapeo(archivo);
+        return 1;
+    }
+    if (numCredenciales < opciones.clientes) {
+        cerr << "ERROR en generarCarga(): " << opciones.clientes << " conexiones necesitan al menos "
+             << opciones.clientes << " credenciales (una cuenta propia cada una); hay " << numCredenciales << endl;
+        delete[] credenciales;
+        cerrarMapeo(archivo);
+        return 1;
+    }
+
+    int fallidas = 0;
+    bool alcanzado = true;
+    if (!opciones.escalado) {
+        MedicionCarga m = medirCarga(opciones, credenciales, numCredenciales, opciones.clientes);
+        cout << "Carga: " << opciones.clientes << " conexiones, " << m.peticiones << " peticiones en "
+             << m.segundos << " s (" << porSegundo(m) << " pet/s).\n";
+        cout << "  Latencia p50 " << m.p50 << " us, p99 " << m.p99 << " us, max " << m.maximo << " us.\n";
+        cout << "  Respuestas de error: " << m.rechazadas << "; conexiones fallidas: " << m.fallidas << ".\n";
+        fallidas = m.fallidas;
+    } else {
+        // Escalado: 1, 2, 4, ... conexiones sobre cuentas disjuntas; si el
+        // servicio no serializa cuentas distintas, pet/s crece con ellas
+        // hasta agotar los núcleos. El servicio solo escucha en esta
+        // máquina y cada conexión ocupa un hilo de cada lado, así que al
+        // servicio le toca la mitad de los núcleos. Más aceleración que
+        // núcleos hay en la máquina no sale de la CPU: las conexiones están
+        // esperando el disco (la bitácora) y la medición no sirve
+        int todos = (int)thread::hardware_concurrency();
+        if (todos < 1) todos = 1;
+        int nucleos = todos / 2;
+        if (nucleos < 1) nucleos = 1;
+        bool esperandoDisco = false;
+        cout << "Escalado (" << opciones.peticiones << " peticiones por conexión, " << nucleos
+             << " núcleo(s) para el servicio; mínimo " << FRACCION_MINIMA_ESCALADO << " del ideal):\n";
+        // Una corrida descartada calienta el servicio para que la base no
+        // salga baja
+        medirCarga(opciones, credenciales, numCredenciales, 1);
+        double base = 0;
+        for (int clientes = 1; ; clientes = min(clientes * 2, opciones.clientes)) {
+            MedicionCarga m = medirCarga(opciones, credenciales, numCredenciales, clientes);
+            if (clientes == 1) base = porSegundo(m);
+            fallidas += m.fallidas;
+            double minimo = FRACCION_MINIMA_ESCALADO * min(clientes, nucleos) * base;
+            cout << "  " << clientes << " conexiones: " << porSegundo(m) << " pet/s (x"
+                 << (base > 0 ? porSegundo(m) / base : 0) << "), p99 " << m.p99 << " us";
+            if (m.rechazadas > 0 || m.fallidas > 0)
+                cout << ", " << m.rechazadas << " errores, " << m.fallidas << " conexiones fallidas";
+            if (clientes > 1 && porSegundo(m) < minimo) {
+                cout << ", por debajo de " << minimo << " pet/s";
+                alcanzado = false;
+            }
+            if (porSegundo(m) > LIMITE_ACELERACION_NUCLEOS * todos * base) {
+                cout << ", más que los " << todos << " núcleo(s)";
+                esperandoDisco = true;
+            }
+            cout << "\n";
+            if (clientes >= opciones.clientes) break;
+        }
+        if (esperandoDisco) {
+            cout << "La aceleración supera a los núcleos: se midió la espera de la bitácora; corra el servicio con --sin-bitacora.\n";
+            alcanzado = false;
+        } else if (!alcanzado) {
+            cout << "El servicio no escala: hay cuentas distintas que se esperan entre sí.\n";
+        }
+    }
+    delete[] credenciales;
+    cerrarMapeo(archivo);
+    return fallidas == 0 && alcanzado ? 0 : 1;
+}
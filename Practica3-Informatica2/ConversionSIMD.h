@@ -0,0 +1,72 @@
+#ifndef CONVERSION_SIMD_H
+#define CONVERSION_SIMD_H
+
+// ============================================================
+//  CONVERSIÓN BYTES <-> CARACTERES '0'/'1'
+// ============================================================
+//
+// Núcleos de textoAbinario() / binarioAtexto(). En x86 se elige en
+// tiempo de ejecución entre AVX2, SSE2 y la versión escalar según lo que
+// soporte la CPU; en otras arquitecturas se usa siempre la escalar.
+
+/**
+ * @brief Expande bytes a caracteres '0'/'1' (8 por byte, bit más significativo primero).
+ * @param bytes Bytes de entrada.
+ * @param numBytes Número de bytes.
+ * @param salida Buffer de al menos numBytes * 8 caracteres (no se añade '\0').
+ */
+void expandirBits(const unsigned char* bytes, int numBytes, unsigned char* salida);
+
+/**
+ * @brief Empaqueta caracteres '0'/'1' en bytes.
+ * @param bits Cadena binaria.
+ * @param numBits Número de bits (se procesan numBits / 8 bytes completos).
+ * @param salida Buffer de al menos numBits / 8 bytes.
+ * @return false si aparece un carácter distinto de '0' o '1'.
+ */
+bool empaquetarBits(const unsigned char* bits, int numBits, unsigned char* salida);
+
+/**
+ * @brief Versión escalar de expandirBits() (siempre disponible).
+ */
+void expandirBitsEscalar(const unsigned char* bytes, int numBytes, unsigned char* salida);
+
+/**
+ * @brief Versión escalar de empaquetarBits() (siempre disponible).
+ */
+bool empaquetarBitsEscalar(const unsigned char* bits, int numBits, unsigned char* salida);
+
+/**
+ * @brief Nombre del núcleo elegido para esta CPU.
+ * @return "avx2", "sse2" o "escalar".
+ */
+const char* nucleoConversionActivo();
+
+/**
+ * @brief Núcleos de conversión, del más lento al más rápido.
+ */
+enum NucleoConversion { NUCLEO_ESCALAR, NUCLEO_SSE2, NUCLEO_AVX2 };
+
+/**
+ * @brief Indica si `nucleo` puede ejecutarse en esta CPU.
+ */
+bool nucleoConversionSoportado(NucleoConversion nucleo);
+
+/**
+ * @brief expandirBits() con un núcleo concreto (para comparar núcleos).
+ * @param nucleo Núcleo a usar; debe estar soportado (nucleoConversionSoportado()).
+ */
+void expandirBitsCon(NucleoConversion nucleo, const unsigned char* bytes, int numBytes, unsigned char* salida);
+
+/**
+ * @brief empaquetarBits() con un núcleo concreto (para comparar núcleos).
+ * @param nucleo Núcleo a usar; debe estar soportado (nucleoConversionSoportado()).
+ */
+bool empaquetarBitsCon(NucleoConversion nucleo, const unsigned char* bits, int numBits, unsigned char* salida);
+
+/**
+ * @brief Nombre de un núcleo: "avx2", "sse2" o "escalar".
+ */
+const char* nombreNucleoConversion(NucleoConversion nucleo);
+
+#endif // CONVERSION_SIMD_H
@@ -0,0 +1,179 @@
+#include <iostream>
+#include "Cuenta.h"
+#include "UtilidadesCadena.h"
+using namespace std;
+
+// ============================================================
+//  CAMPOS
+// ============================================================
+
+/**
+ * @brief Copia `len` caracteres a un campo de capacidad fija, sin los
+ *        espacios del inicio y del final si `recortar` es true.
+ * @return false si no cabe junto con el '\0'.
+ */
+static bool copiarCampo(char* destino, int capacidad, const char* texto, int len, bool recortar) {
+    int inicio = 0, fin = len;
+    if (recortar) {
+        while (inicio < fin && (texto[inicio] == ' ' || texto[inicio] == '\t')) inicio++;
+        while (fin > inicio && (texto[fin - 1] == ' ' || texto[fin - 1] == '\t' ||
+                                texto[fin - 1] == '\r' || texto[fin - 1] == '\n')) fin--;
+    }
+    if (fin - inicio >= capacidad) return false;
+    copiarN(destino, texto + inicio, fin - inicio);
+    destino[fin - inicio] = '\0';
+    return true;
+}
+
+/**
+ * @brief Arma la cuenta a partir de los campos ya delimitados.
+ */
+static bool crearCuentaN(const char* cedula, int lenCedula, const char* clave, int lenClave,
+                         const char* nombre, int lenNombre, int64_t saldo, Cuenta& cuenta) {
+    Cuenta nueva;
+    nueva.cedula = empaquetarCedula(cedula, lenCedula);
+    nueva.saldo = saldo;
+    if (nueva.cedula == 0) return false;
+    for (int i = 0; i < lenClave; i++)
+        if (clave[i] == ',') return false;
+    if (!copiarCampo(nueva.clave, TAM_CLAVE_CUENTA, clave, lenClave, true)) return false;
+    if (!copiarCampo(nueva.nombre, TAM_NOMBRE_CUENTA, nombre, lenNombre, false)) return false;
+
+    cuenta = nueva;
+    return true;
+}
+
+bool crearCuenta(const char* cedula, const char* clave, const char* nombre, int64_t saldo, Cuenta& cuenta) {
+    if (!cedula || !clave || !nombre) return false;
+    return crearCuentaN(cedula, longitud(cedula), clave, longitud(clave),
+                        nombre, longitud(nombre), saldo, cuenta);
+}
+
+bool parsearCuenta(const char* linea, Cuenta& cuenta) {
+    if (!linea) return false;
+
+    // Dos primeras comas y la última: si el nombre trae comas quedan
+    // dentro del nombre y la línea se reescribe igual
+    int comas[3];
+    int encontradas = 0;
+    for (int i = 0; linea[i] != '\0'; i++) {
+        if (linea[i] != ',') continue;
+        if (encontradas < 2) comas[encontradas++] = i;
+        else {
+            comas[2] = i;
+            encontradas = 3;
+        }
+    }
+    if (encontradas < 3) return false;
+
+    // Saldo: entero al inicio del último campo ("25000 COP")
+    int k = comas[2] + 1;
+    while (linea[k] == ' ' || linea[k] == '\t') k++;
+    bool negativo = false;
+    if (linea[k] == '-') {
+        negativo = true;
+        k++;
+    }
+    if (linea[k] < '0' || linea[k] > '9') return false;
+
+    int64_t saldo = 0;
+    for (; linea[k] >= '0' && linea[k] <= '9'; k++) {
+        if (saldo > (INT64_MAX - 9) / 10) return false;
+        saldo = saldo * 10 + (linea[k] - '0');
+    }
+
+    return crearCuentaN(linea, comas[0],
+                        linea + comas[0] + 1, comas[1] - comas[0] - 1,
+                        linea + comas[1] + 1, comas[2] - comas[1] - 1,
+                        negativo ? -saldo : saldo, cuenta);
+}
+
+char* serializarCuenta(const Cuenta& cuenta) {
+    char cedula[TAM_TEXTO_CEDULA];
+    desempaquetarCedula(cuenta.cedula, cedula);
+
+    // Saldo en texto, de atrás hacia adelante
+    char saldo[24];
+    int pos = sizeof(saldo) - 1;
+    saldo[pos] = '\0';
+    uint64_t valor = cuenta.saldo < 0 ? 0 - (uint64_t)cuenta.saldo : (uint64_t)cuenta.saldo;
+    do {
+        saldo[--pos] = (char)('0' + valor % 10);
+        valor /= 10;
+    } while (valor > 0);
+    if (cuenta.saldo < 0) saldo[--pos] = '-';
+
+    int len = longitud(cedula) + longitud(cuenta.clave) + longitud(cuenta.nombre)
+            + longitud(saldo + pos) + 3 + 4;
+    char* linea = new char[len + 1];
+    linea[0] = '\0';
+    concatenar(linea, cedula);
+    concatenar(linea, ",");
+    concatenar(linea, cuenta.clave);
+    concatenar(linea, ",");
+    concatenar(linea, cuenta.nombre);
+    concatenar(linea, ",");
+    concatenar(linea, saldo + pos);
+    concatenar(linea, " COP");
+    return linea;
+}
+
+// ============================================================
+//  ARREGLOS
+// ============================================================
+
+void reservarCuentas(ListaCuentas& lista, int capacidad) {
+    if (capacidad <= lista.capacidad) return;
+    Cuenta* ampliada = new Cuenta[capacidad];
+    for (int i = 0; i < lista.cantidad; i++) ampliada[i] = lista.datos[i];
+    delete[] lista.datos;
+    lista.datos = ampliada;
+    lista.capacidad = capacidad;
+}
+
+int agregarCuenta(ListaCuentas& lista, const Cuenta& cuenta) {
+    if (lista.cantidad == lista.capacidad)
+        reservarCuentas(lista, lista.capacidad < 8 ? 8 : lista.capacidad * 2);
+    lista.datos[lista.cantidad] = cuenta;
+    return lista.cantidad++;
+}
+
+void liberarCuentas(ListaCuentas& lista) {
+    delete[] lista.datos;
+    lista.datos = nullptr;
+    lista.cantidad = 0;
+    lista.capacidad = 0;
+}
+
+bool cargarCuentas(char** lineas, int numLineas, ListaCuentas& cuentas) {
+    liberarCuentas(cuentas);
+    if (!lineas || numLineas <= 0) return false;
+
+    reservarCuentas(cuentas, numLineas);
+    for (int i = 0; i < numLineas; i++) {
+        if (!parsearCuenta(lineas[i], cuentas.datos[i])) {
+            cerr << "Registro de usuario inválido en la línea " << (i + 1) << ".\n";
+            liberarCuentas(cuentas);
+            return false;
+        }
+    }
+    cuentas.cantidad = numLineas;
+    return true;
+}
+
+char** serializarCuentas(const Cuenta* cuentas, int numCuentas) {
+    char** lineas = new char*[numCuentas > 0 ? numCuentas : 1];
+    for (int i = 0; i < numCuentas; i++)
+        lineas[i] = serializarCuenta(cuentas[i]);
+    return lineas;
+}
+
+int indexarCuentas(IndiceCedulas& indice, const Cuenta* cuentas, int numCuentas) {
+    liberarIndiceCedulas(indice);
+    reservarIndiceCedulas(indice, numCuentas);
+
+    int sinIndice = 0;
+    for (int i = 0; i < numCuentas; i++)
+        if (!insertarCedula(indice, cuentas[i].cedula, i)) sinIndice++;   // queda la primera
+    return sinIndice;
+}
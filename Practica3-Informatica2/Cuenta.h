@@ -0,0 +1,123 @@
+#ifndef CUENTA_H
+#define CUENTA_H
+
+#include <cstdint>
+#include "IndiceCedulas.h"
+
+// ===================== CUENTAS =====================
+
+/** Capacidad del campo clave, incluido el '\0'. */
+const int TAM_CLAVE_CUENTA = 32;
+
+/** Capacidad del campo nombre, incluido el '\0'. */
+const int TAM_NOMBRE_CUENTA = 100;
+
+/**
+ * @brief Cuenta de usuario ya interpretada.
+ *
+ * Se arma una sola vez al cargar a partir de la línea
+ * "cedula,clave,nombre,saldo COP" y las operaciones trabajan sobre los
+ * campos; la línea solo se vuelve a escribir al guardar. Quien cambie
+ * un campo marca `modificada` para que al guardar se cifre de nuevo.
+ */
+struct Cuenta {
+    uint64_t cedula = 0;                /**< Cédula empaquetada (ver empaquetarCedula()) */
+    char clave[TAM_CLAVE_CUENTA] = {};  /**< Clave terminada en '\0' */
+    char nombre[TAM_NOMBRE_CUENTA] = {};/**< Nombre terminado en '\0' */
+    int64_t saldo = 0;                  /**< Saldo en COP */
+    bool modificada = false;            /**< Cambió desde que se leyó o se guardó */
+};
+
+/**
+ * @brief Motivo de un cambio de cuenta (se registra en la bitácora).
+ */
+enum MotivoCambio {
+    MOTIVO_CONSULTA = 1,    /**< Cobro de la consulta de saldo */
+    MOTIVO_RETIRO   = 2,    /**< Retiro más su comisión */
+    MOTIVO_ALTA     = 3     /**< Cuenta nueva registrada por un administrador */
+};
+
+/**
+ * @brief Arma una cuenta a partir de sus campos.
+ *
+ * @param cedula Cédula en texto.
+ * @param clave Clave (se ignoran espacios al inicio y al final).
+ * @param nombre Nombre completo.
+ * @param saldo Saldo inicial.
+ * @param cuenta Destino (no se modifica si falla).
+ * @return false si la cédula es inválida, la clave tiene comas o la clave
+ *         o el nombre no caben.
+ */
+bool crearCuenta(const char* cedula, const char* clave, const char* nombre, int64_t saldo, Cuenta& cuenta);
+
+/**
+ * @brief Interpreta una línea "cedula,clave,nombre,saldo COP".
+ *
+ * La cédula y la clave son los dos primeros campos y el saldo el último;
+ * lo que queda entre ellos es el nombre, aunque contenga comas.
+ *
+ * @return false si la línea no tiene ese formato.
+ */
+bool parsearCuenta(const char* linea, Cuenta& cuenta);
+
+/**
+ * @brief Línea "cedula,clave,nombre,saldo COP" de una cuenta.
+ * @return Cadena dinámica terminada en '\0' (el llamador la libera).
+ */
+char* serializarCuenta(const Cuenta& cuenta);
+
+/**
+ * @brief Arreglo dinámico de cuentas con capacidad de sobra.
+ *
+ * Cuando se llena crece al doble, así que agregar una cuenta cuesta O(1)
+ * amortizado en vez de copiar todas las demás. `datos` puede cambiar al
+ * agregar: no se deben guardar punteros a sus cuentas.
+ */
+struct ListaCuentas {
+    Cuenta* datos = nullptr;            /**< Cuentas (las primeras `cantidad` son válidas) */
+    int cantidad = 0;                   /**< Cuentas en uso */
+    int capacidad = 0;                  /**< Cuentas reservadas */
+};
+
+/**
+ * @brief Asegura lugar para al menos `capacidad` cuentas sin volver a reservar.
+ */
+void reservarCuentas(ListaCuentas& lista, int capacidad);
+
+/**
+ * @brief Agrega una cuenta al final (duplica la capacidad si hace falta).
+ * @return Posición de la cuenta agregada.
+ */
+int agregarCuenta(ListaCuentas& lista, const Cuenta& cuenta);
+
+/**
+ * @brief Libera las cuentas; la lista queda vacía y reutilizable.
+ */
+void liberarCuentas(ListaCuentas& lista);
+
+/**
+ * @brief Interpreta todas las líneas de usuarios.
+ *
+ * La capacidad se reserva de una vez para los registros leídos.
+ *
+ * @param lineas Registros en texto plano.
+ * @param numLineas Cantidad de registros.
+ * @param cuentas Destino (se libera antes lo que tuviera).
+ * @return false si no hay registros o alguna línea es inválida.
+ */
+bool cargarCuentas(char** lineas, int numLineas, ListaCuentas& cuentas);
+
+/**
+ * @brief Vuelve a escribir las cuentas en el formato de línea original.
+ * @return Arreglo dinámico de líneas (el llamador libera cada una y el arreglo).
+ */
+char** serializarCuentas(const Cuenta* cuentas, int numCuentas);
+
+/**
+ * @brief Reconstruye un índice de cédulas a partir de las cuentas.
+ * @param indice Índice destino (se libera antes lo que tuviera).
+ * @return Cantidad de cuentas que no se indexaron (cédula repetida).
+ */
+int indexarCuentas(IndiceCedulas& indice, const Cuenta* cuentas, int numCuentas);
+
+#endif // CUENTA_H
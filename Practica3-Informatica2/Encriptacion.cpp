@@ -1,5 +1,10 @@
+#include <algorithm>
 #include <iostream>
+#include <utility>
 #include "Encriptacion.h"
+#include "CifradoEmpaquetado.h"
+#include "ConversionSIMD.h"
+#include "EncriptacionFija.h"
 #include "UtilidadesCadena.h"
 
 using namespace std;
@@ -11,6 +16,9 @@ using namespace std;
 /**
  * @brief Convierte una cadena binaria ('0' y '1') a texto ASCII.
  *
+ * Usa empaquetarBits(), que valida y empaqueta varios caracteres por
+ * instrucción cuando la CPU lo permite.
+ *
  * @param binario Cadena binaria (unsigned char*).
  * @param len Longitud total (múltiplo de 8 recomendado).
  * @return Puntero a texto ASCII nuevo o nullptr si hay error.
@@ -28,14 +36,9 @@ unsigned char* binarioAtexto(const unsigned char* binario, int len) {
         int numChars = bitsValidos / 8;
         unsigned char* texto = new unsigned char[numChars + 1];
 
-        for (int i = 0; i < numChars; i++) {
-            unsigned char c = 0;
-            for (int j = 0; j < 8; j++) {
-                if (binario[i * 8 + j] != '0' && binario[i * 8 + j] != '1')
-                    throw "Error: carácter no binario detectado.";
-                c = (c << 1) | (binario[i * 8 + j] - '0');
-            }
-            texto[i] = c;
+        if (!empaquetarBits(binario, bitsValidos, texto)) {
+            delete[] texto;
+            throw "Error: carácter no binario detectado.";
         }
 
         texto[numChars] = '\0';
@@ -49,6 +52,9 @@ unsigned char* binarioAtexto(const unsigned char* binario, int len) {
 /**
  * @brief Convierte texto ASCII a su representación binaria.
  *
+ * Usa expandirBits(), que genera varios caracteres por instrucción
+ * cuando la CPU lo permite.
+ *
  * @param text Texto ASCII.
  * @param size Número de caracteres.
  * @return Cadena binaria nueva o nullptr si hay error.
@@ -59,11 +65,7 @@ unsigned char* textoAbinario(unsigned char* text, int size) {
             throw "Error: texto nulo o tamaño inválido.";
 
         unsigned char* resultado = new unsigned char[size * 8 + 1];
-        for (int i = 0; i < size; i++) {
-            unsigned char c = text[i];
-            for (int j = 7; j >= 0; j--)
-                resultado[i * 8 + (7 - j)] = ((c >> j) & 1) ? '1' : '0';
-        }
+        expandirBits(text, size, resultado);
 
         resultado[size * 8] = '\0';
         return resultado;
@@ -77,6 +79,38 @@ unsigned char* textoAbinario(unsigned char* text, int size) {
 //  INVERSIÓN DE BITS
 // ============================================================
 
+/**
+ * @brief Invierte todos los bits de un bloque sobre un buffer del llamador.
+ */
+bool invertirBitsEn(const unsigned char* bloque, int len, unsigned char* salida) {
+    if (bloque == nullptr || salida == nullptr || len <= 0)
+        return false;
+
+    for (int i = 0; i < len; i++) {
+        if (bloque[i] == '0') salida[i] = '1';
+        else if (bloque[i] == '1') salida[i] = '0';
+        else return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Invierte los bits en grupos de N sobre un buffer del llamador.
+ */
+bool invertirCadaNBitsEn(const unsigned char* bloque, int len, int n, unsigned char* salida) {
+    if (bloque == nullptr || salida == nullptr || len <= 0 || n <= 0)
+        return false;
+
+    for (int i = 0; i < len; i += n) {
+        for (int j = 0; j < n && i + j < len; j++) {
+            if (bloque[i + j] != '0' && bloque[i + j] != '1')
+                return false;
+            salida[i + j] = (bloque[i + j] == '0') ? '1' : '0';
+        }
+    }
+    return true;
+}
+
 /**
  * @brief Invierte todos los bits ('0' ↔ '1') de un bloque.
  */
@@ -86,10 +120,9 @@ unsigned char* invertirBits(const unsigned char* bloque, int len) {
             throw "Error: bloque nulo o longitud inválida en invertirBits.";
 
         unsigned char* res = new unsigned char[len + 1];
-        for (int i = 0; i < len; i++) {
-            if (bloque[i] == '0') res[i] = '1';
-            else if (bloque[i] == '1') res[i] = '0';
-            else throw "Error: carácter no binario en invertirBits.";
+        if (!invertirBitsEn(bloque, len, res)) {
+            delete[] res;
+            throw "Error: carácter no binario en invertirBits.";
         }
         res[len] = '\0';
         return res;
@@ -108,17 +141,11 @@ unsigned char* invertirCadaNBits(unsigned char* bloque, int len, int n) {
             throw "Error: parámetros inválidos en invertirCadaNBits.";
 
         unsigned char* res = new unsigned char[len + 1];
-        copiarN(reinterpret_cast<char*>(res), reinterpret_cast<const char*>(bloque), len);
-        res[len] = '\0';
-
-        for (int i = 0; i < len; i += n) {
-            for (int j = 0; j < n && i + j < len; j++) {
-                if (res[i + j] != '0' && res[i + j] != '1')
-                    throw "Error: carácter no binario detectado en invertirCadaNBits.";
-                res[i + j] = (res[i + j] == '0') ? '1' : '0';
-            }
+        if (!invertirCadaNBitsEn(bloque, len, n, res)) {
+            delete[] res;
+            throw "Error: carácter no binario detectado en invertirCadaNBits.";
         }
-
+        res[len] = '\0';
         return res;
     } catch (const char* msg) {
         cerr << "[Excepción] " << msg << endl;
@@ -130,123 +157,590 @@ unsigned char* invertirCadaNBits(unsigned char* bloque, int len, int n) {
 //  ENCRIPTACIÓN Y DESENCRIPTACIÓN
 // ============================================================
 
+typedef bool (*EncriptadorFijo)(const unsigned char*, int, unsigned char*);
+
+/**
+ * @brief Construye la tabla de despacho semilla -> encriptarBitsFijo<S>.
+ */
+template <size_t... I>
+static const EncriptadorFijo* crearDespacho(index_sequence<I...>) {
+    static const EncriptadorFijo tabla[] = { &encriptarBitsFijo<(int)I + 1>... };
+    return tabla;
+}
+
+/**
+ * @brief Encripta una cadena binaria sobre un buffer del llamador.
+ *
+ * Para semillas entre 1 y SEMILLA_FIJA_MAX usa la versión especializada
+ * por semilla; para el resto recorre los bloques aplicando la
+ * regla directamente sobre `salida`, sin copias intermedias.
+ */
+bool encriptarBitsEn(const unsigned char* binary, int size, int semilla, unsigned char* salida) {
+    static const EncriptadorFijo* despacho = crearDespacho(make_index_sequence<SEMILLA_FIJA_MAX>{});
+
+    if (binary == nullptr || salida == nullptr || size <= 0 || semilla <= 0)
+        return false;
+    if (semilla <= SEMILLA_FIJA_MAX)
+        return despacho[semilla - 1](binary, size, salida);
+
+    ReglaBloque regla = INVERTIR_TODO;
+    for (int i = 0; i < size; i += semilla) {
+        int len = (i + semilla <= size) ? semilla : (size - i);
+
+        bool ok;
+        if (regla == INVERTIR_TODO)
+            ok = invertirBitsEn(binary + i, len, salida + i);
+        else if (regla == INVERTIR_CADA_2)
+            ok = invertirCadaNBitsEn(binary + i, len, 2, salida + i);
+        else
+            ok = invertirCadaNBitsEn(binary + i, len, 3, salida + i);
+        if (!ok) return false;
+
+        int unos = 0;
+        for (int j = 0; j < len; j++)
+            if (salida[i + j] == '1') unos++;
+        regla = reglaSegunBloque(unos, len);
+    }
+    return true;
+}
+
+/**
+ * @brief Encripta una cadena binaria usando el algoritmo de bloques.
+ *
+ * Reserva un único buffer para el resultado y delega en encriptarBitsEn().
+ */
 unsigned char* encriptarBits(const unsigned char* binary, int size, int semilla) {
     try {
         if (binary == nullptr || size <= 0 || semilla <= 0)
             throw "Error: parámetros inválidos en encriptarBits.";
 
         unsigned char* codificado = new unsigned char[size + 1];
-        int pos = 0;
-        unsigned char* anterior = nullptr;
-
-        for (int i = 0; i < size; i += semilla) {
-            int len = (i + semilla <= size) ? semilla : (size - i);
-            unsigned char* bloque = new unsigned char[len + 1];
-            copiarN(reinterpret_cast<char*>(bloque), reinterpret_cast<const char*>(binary + i), len);
-            bloque[len] = '\0';
-
-            unsigned char* procesado = nullptr;
-
-            if (i == 0) {
-                procesado = invertirBits(bloque, len);
-            } else {
-                int unos = 0, ceros = 0;
-                for (int j = 0; anterior[j] != '\0'; j++) {
-                    if (anterior[j] == '1') unos++;
-                    else if (anterior[j] == '0') ceros++;
-                }
-
-                if (unos == ceros)
-                    procesado = invertirBits(bloque, len);
-                else if (ceros > unos)
-                    procesado = invertirCadaNBits(bloque, len, 2);
-                else
-                    procesado = invertirCadaNBits(bloque, len, 3);
-            }
+        if (!encriptarBitsEn(binary, size, semilla, codificado)) {
+            delete[] codificado;
+            throw "Error: carácter no binario en encriptarBits.";
+        }
+        codificado[size] = '\0';
+        return codificado;
+    } catch (const char* msg) {
+        cerr << "[Excepción] " << msg << endl;
+        return nullptr;
+    }
+}
 
-            copiarN(reinterpret_cast<char*>(codificado + pos),
-                    reinterpret_cast<const char*>(procesado), len);
-            pos += len;
+/**
+ * @brief Desencripta una cadena binaria sobre un buffer del llamador.
+ *
+ * La regla de cada bloque depende del bloque cifrado anterior, que está
+ * en la entrada: los bloques se descifran de forma independiente. Se
+ * recorren de atrás hacia adelante para admitir binary == salida.
+ */
+bool desencriptarBitsEn(const unsigned char* binary, int size, int semilla, unsigned char* salida) {
+    if (binary == nullptr || salida == nullptr || size <= 0 || semilla <= 0)
+        return false;
+
+    for (int i = ((size - 1) / semilla) * semilla; i >= 0; i -= semilla) {
+        int len = (i + semilla <= size) ? semilla : (size - i);
 
-            delete[] bloque;
-            if (anterior) delete[] anterior;
-            anterior = procesado;
+        ReglaBloque regla = INVERTIR_TODO;
+        if (i > 0) {
+            int unos = 0;
+            for (int j = i - semilla; j < i; j++)
+                if (binary[j] == '1') unos++;
+            regla = reglaSegunBloque(unos, semilla);
         }
 
-        codificado[pos] = '\0';
-        if (anterior) delete[] anterior;
-        return codificado;
+        bool ok;
+        if (regla == INVERTIR_TODO)
+            ok = invertirBitsEn(binary + i, len, salida + i);
+        else if (regla == INVERTIR_CADA_2)
+            ok = invertirCadaNBitsEn(binary + i, len, 2, salida + i);
+        else
+            ok = invertirCadaNBitsEn(binary + i, len, 3, salida + i);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Desencripta una cadena binaria en un buffer nuevo.
+ */
+unsigned char* desencriptarBits(const unsigned char* binary, int size, int semilla) {
+    try {
+        if (binary == nullptr || size <= 0 || semilla <= 0)
+            throw "Error: parámetros inválidos en desencriptarBits.";
 
+        unsigned char* decodificado = new unsigned char[size + 1];
+        if (!desencriptarBitsEn(binary, size, semilla, decodificado)) {
+            delete[] decodificado;
+            throw "Error: carácter no binario en desencriptarBits.";
+        }
+        decodificado[size] = '\0';
+        return decodificado;
     } catch (const char* msg) {
         cerr << "[Excepción] " << msg << endl;
         return nullptr;
     }
 }
 
+// ============================================================
+//  ARENA DE TRABAJO
+// ============================================================
+
 /**
- * @brief Desencripta (idéntico al proceso de encriptar).
+ * @brief Garantiza que la arena tenga al menos `bytes` de capacidad.
+ *
+ * Crece al doble (o a lo pedido, si es mayor) para que varias llamadas
+ * consecutivas no vuelvan a reservar memoria.
  */
-unsigned char* desencriptarBits(const unsigned char* binary, int size, int semilla) {
-    return encriptarBits(binary, size, semilla);
+void reservarArena(ArenaCifrado& arena, int64_t bytes) {
+    if (bytes <= arena.capacidad) return;
+
+    int64_t nueva = arena.capacidad * 2;
+    if (nueva < bytes) nueva = bytes;
+
+    delete[] arena.buffer;
+    arena.buffer = new unsigned char[nueva];
+    arena.capacidad = nueva;
+    arena.reservas++;
+}
+
+/**
+ * @brief Libera la memoria de la arena y la deja vacía.
+ */
+void liberarArena(ArenaCifrado& arena) {
+    delete[] arena.buffer;
+    arena.buffer = nullptr;
+    arena.capacidad = 0;
+}
+
+// ============================================================
+//  FUNCIONES DE ALTO NIVEL
+// ============================================================
+
+/**
+ * @brief Longitud de la línea más larga del arreglo (en caracteres).
+ */
+static int longitudMaxima(char** datos, int numLineas) {
+    int maxLinea = 0;
+    for (int i = 0; i < numLineas; i++) {
+        int len = longitud(datos[i]);
+        if (len > maxLinea) maxLinea = len;
+    }
+    return maxLinea;
+}
+
+/**
+ * @brief Cifra una línea de `len` caracteres hacia `salida` ('0'/'1' + '\0').
+ * @param trabajo Zona de al menos `len` bytes para los bits empaquetados.
+ */
+static void encriptarLineaEn(const char* linea, int len, int semilla, unsigned char* trabajo, unsigned char* salida) {
+    if (len > 0) {
+        encriptarBitsEmpaquetados(reinterpret_cast<const unsigned char*>(linea), trabajo, len * 8, semilla);
+        expandirBits(trabajo, len, salida);
+    }
+    salida[len * 8] = '\0';
+}
+
+/// Mínimo de líneas en un lote para cifrarlo con encriptarLoteBinario();
+/// con menos, el lote se cifra línea por línea.
+const int MIN_LINEAS_LOTE = 16;
+
+/**
+ * @brief Ordena por longitud los índices de las líneas no vacías.
+ *
+ * Así cada lote de CARRILES_LOTE líneas agrupa longitudes parecidas y
+ * encriptarLoteBinario() no avanza mucho más allá de la más corta.
+ *
+ * @param longitudes Longitud de cada línea (ya calculada).
+ * @param semilla Semilla de encriptación; si no admite lotes no se ordena.
+ * @param orden Destino de los índices (numLineas enteros).
+ * @return Cantidad de líneas no vacías.
+ */
+static int ordenarPorLongitud(const int* longitudes, int numLineas, int semilla, int* orden) {
+    int cantidad = 0;
+    for (int i = 0; i < numLineas; i++)
+        if (longitudes[i] > 0) orden[cantidad++] = i;
+    if (semilla > SEMILLA_MAX_LOTE)
+        return cantidad;        // se cifran línea por línea: el orden no importa
+
+    sort(orden, orden + cantidad, [longitudes](int a, int b) {
+        return longitudes[a] != longitudes[b] ? longitudes[a] < longitudes[b] : a < b;
+    });
+    return cantidad;
+}
+
+/**
+ * @brief Cantidad de lotes en que se reparten `cantidad` líneas.
+ */
+static int numLotes(int cantidad) {
+    return (cantidad + CARRILES_LOTE - 1) / CARRILES_LOTE;
+}
+
+/**
+ * @brief Cifra el lote número `lote` de `orden` dejando cada línea en cifradas[i].
+ *
+ * Los lotes chicos, o con semillas mayores que SEMILLA_MAX_LOTE, se
+ * cifran línea por línea con encriptarLineaEn().
+ *
+ * @param trabajo Zona de al menos la longitud de la línea más larga.
+ */
+static void encriptarLoteEn(char** datos, const int* longitudes, const int* orden, int cantidad,
+                            int lote, int semilla, unsigned char* trabajo, char** cifradas) {
+    int inicio = lote * CARRILES_LOTE;
+    int n = cantidad - inicio < CARRILES_LOTE ? cantidad - inicio : CARRILES_LOTE;
+    const int* indices = orden + inicio;
+
+    if (n < MIN_LINEAS_LOTE || semilla <= 0 || semilla > SEMILLA_MAX_LOTE) {
+        for (int c = 0; c < n; c++) {
+            int i = indices[c];
+            encriptarLineaEn(datos[i], longitudes[i], semilla, trabajo, (unsigned char*)cifradas[i]);
+        }
+        return;
+    }
+
+    const unsigned char* entradas[CARRILES_LOTE];
+    int numBytes[CARRILES_LOTE];
+    unsigned char* salidas[CARRILES_LOTE];
+    for (int c = 0; c < n; c++) {
+        int i = indices[c];
+        entradas[c] = (const unsigned char*)datos[i];
+        numBytes[c] = longitudes[i];
+        salidas[c] = (unsigned char*)cifradas[i];
+    }
+
+    encriptarLoteBinario(entradas, numBytes, n, semilla, salidas);
+    for (int c = 0; c < n; c++)
+        salidas[c][numBytes[c] * 8] = '\0';
+}
+
+/**
+ * @brief Descifra datos[i] sobre su propio buffer; si no es binaria la deja intacta.
+ * @param trabajo Zona de al menos longitud(datos[i]) / 8 bytes.
+ */
+static void desencriptarLinea(char** datos, int i, int semilla, unsigned char* trabajo) {
+    int sizeEnc = longitud(datos[i]);
+    int numChars = sizeEnc / 8;
+    if (numChars <= 0) return;
+
+    unsigned char* linea = reinterpret_cast<unsigned char*>(datos[i]);
+    if (!empaquetarBits(linea, numChars * 8, trabajo)) {
+        cerr << "[Excepción] Error: carácter no binario detectado." << endl;
+        return;
+    }
+
+    try {
+        desencriptarBitsEmpaquetados(trabajo, trabajo, numChars * 8, semilla);
+    } catch (const char* msg) {
+        cerr << "[Excepción] " << msg << endl;
+        return;
+    }
+
+    copiarN(datos[i], reinterpret_cast<const char*>(trabajo), numChars);
+    linea[numChars] = '\0';
+}
+
+/**
+ * @brief Calcula dónde empieza cada línea cifrada dentro de la arena.
+ *
+ * Al inicio de la arena quedan la longitud de cada línea y el orden de
+ * los lotes (ver ordenarPorLongitud()); le sigue el texto cifrado de
+ * todas las líneas y `zonas` zonas de trabajo del tamaño de la línea más
+ * larga. Deja en cifradas[i] el puntero de destino de la línea i y en
+ * `zonasTrabajo` el inicio de las zonas. Los tamaños y desplazamientos
+ * van en 64 bits: el texto cifrado ocupa 8 veces el plano y un archivo
+ * de unos pocos millones de registros ya no cabe en un int.
+ *
+ * @return Longitud de la línea más larga (tamaño de cada zona de trabajo).
+ */
+static int prepararArenaCifrado(char** datos, int numLineas, ArenaCifrado& arena, char** cifradas, int zonas,
+                                int*& longitudes, int*& orden, unsigned char*& zonasTrabajo) {
+    int64_t total = 0;
+    int maxLinea = 0;
+    for (int i = 0; i < numLineas; i++) {
+        int len = longitud(datos[i]);
+        total += (int64_t)len * 8 + 1;
+        if (len > maxLinea) maxLinea = len;
+    }
+
+    int64_t indices = 2 * (int64_t)numLineas * (int64_t)sizeof(int);
+    reservarArena(arena, indices + total + (int64_t)maxLinea * zonas);
+
+    longitudes = (int*)arena.buffer;
+    orden = longitudes + numLineas;
+    int64_t pos = indices;
+    for (int i = 0; i < numLineas; i++) {
+        longitudes[i] = longitud(datos[i]);
+        cifradas[i] = reinterpret_cast<char*>(arena.buffer + pos);
+        cifradas[i][0] = '\0';
+        pos += (int64_t)longitudes[i] * 8 + 1;
+    }
+    zonasTrabajo = arena.buffer + pos;
+    return maxLinea;
+}
+
+/**
+ * @brief Encripta un arreglo de líneas dejando el resultado en una arena.
+ *
+ * Se calcula el tamaño total una sola vez, de modo que todo el archivo
+ * cabe en la arena: al final de ella queda una zona de trabajo del tamaño
+ * de la línea más larga para los bytes empaquetados. Las líneas se cifran
+ * de a CARRILES_LOTE, ordenadas por longitud, con encriptarLoteBinario().
+ * Cada cifrada[i] apunta dentro de la arena (terminada en '\0'); `datos`
+ * no se modifica. Con una arena ya dimensionada no se reserva memoria.
+ *
+ * Los errores no se atrapan aquí: quien guarda debe enterarse, porque
+ * `cifradas` quedaría con líneas vacías en lugar del texto cifrado.
+ */
+void encriptarArchivoEn(char** datos, int numLineas, int semilla, ArenaCifrado& arena, char** cifradas) {
+    if (datos == nullptr || cifradas == nullptr || numLineas <= 0)
+        throw "Error: parámetros inválidos en encriptarArchivoEn.";
+
+    int *longitudes, *orden;
+    unsigned char* trabajo;
+    prepararArenaCifrado(datos, numLineas, arena, cifradas, 1, longitudes, orden, trabajo);
+
+    int cantidad = ordenarPorLongitud(longitudes, numLineas, semilla, orden);
+    for (int lote = 0; lote < numLotes(cantidad); lote++)
+        encriptarLoteEn(datos, longitudes, orden, cantidad, lote, semilla, trabajo, cifradas);
+}
+
+/**
+ * @brief Versión paralela de encriptarArchivoEn().
+ *
+ * Las posiciones de salida se calculan antes de repartir el trabajo, así
+ * que cada hilo escribe solo en las líneas de sus lotes y en su propia
+ * zona de trabajo al final de la arena: el resultado es idéntico al de
+ * la versión secuencial. Un error en cualquier hilo llega a quien llama
+ * (PoolHilos::paraCadaTrozo() lo vuelve a lanzar).
+ */
+void encriptarArchivoEn(char** datos, int numLineas, int semilla, ArenaCifrado& arena, char** cifradas, PoolHilos& pool) {
+    if (datos == nullptr || cifradas == nullptr || numLineas <= 0)
+        throw "Error: parámetros inválidos en encriptarArchivoEn.";
+
+    int *longitudes, *orden;
+    unsigned char* zonas;
+    int maxLinea = prepararArenaCifrado(datos, numLineas, arena, cifradas, pool.numHilos(),
+                                        longitudes, orden, zonas);
+
+    int cantidad = ordenarPorLongitud(longitudes, numLineas, semilla, orden);
+    pool.paraCadaTrozo(numLotes(cantidad), 1,
+                       [=](int inicio, int fin, int hilo) {
+                           unsigned char* trabajo = zonas + (int64_t)hilo * maxLinea;
+                           for (int lote = inicio; lote < fin; lote++)
+                               encriptarLoteEn(datos, longitudes, orden, cantidad, lote, semilla, trabajo, cifradas);
+                       });
+}
+
+/**
+ * @brief Cambia cada línea no vacía por su versión cifrada de `cifradas`
+ *        (buffers propios de cada línea) y libera el arreglo.
+ */
+static void reemplazarLineas(char** datos, int numLineas, char** cifradas) {
+    for (int i = 0; i < numLineas; i++) {
+        if (cifradas[i] == nullptr) continue;
+        delete[] datos[i];
+        datos[i] = cifradas[i];
+    }
+    delete[] cifradas;
+}
+
+/**
+ * @brief Reserva el buffer de salida de cada línea no vacía.
+ */
+static char** reservarLineasCifradas(const int* longitudes, int numLineas) {
+    char** cifradas = new char*[numLineas];
+    for (int i = 0; i < numLineas; i++)
+        cifradas[i] = longitudes[i] > 0 ? new char[longitudes[i] * 8 + 1] : nullptr;
+    return cifradas;
+}
+
+/**
+ * @brief Libera los buffers de reservarLineasCifradas() sin usarlos.
+ */
+static void descartarLineasCifradas(char** cifradas, int numLineas) {
+    for (int i = 0; i < numLineas; i++) delete[] cifradas[i];
+    delete[] cifradas;
 }
 
 /**
  * @brief Encripta un arreglo de cadenas de texto.
+ *
+ * Cifra directamente los bytes de las líneas, de a CARRILES_LOTE y
+ * ordenadas por longitud, con encriptarLoteBinario(); solo reserva el
+ * buffer final de cada línea. El resultado es el mismo que
+ * encriptarBits(textoAbinario(linea)).
  */
 void encriptarArchivo(char** datos, int numLineas, int semilla) {
+    ArenaCifrado arena;
     try {
         if (datos == nullptr || numLineas <= 0)
             throw "Error: parámetros inválidos en encriptarArchivo.";
 
-        for (int i = 0; i < numLineas; i++) {
-            unsigned char* texto = reinterpret_cast<unsigned char*>(datos[i]);
-            int sizeTxt = longitud(datos[i]);
-            unsigned char* binario = textoAbinario(texto, sizeTxt);
-            if (!binario) continue;
-
-            int sizeBin = sizeTxt * 8;
-            unsigned char* encriptado = encriptarBits(binario, sizeBin, semilla);
-            if (!encriptado) {
-                delete[] binario;
-                continue;
-            }
+        int maxLinea = longitudMaxima(datos, numLineas);
+        reservarArena(arena, 2 * (int64_t)numLineas * (int64_t)sizeof(int) + maxLinea);
+        int* longitudes = (int*)arena.buffer;
+        int* orden = longitudes + numLineas;
+        unsigned char* trabajo = (unsigned char*)(orden + numLineas);
+        for (int i = 0; i < numLineas; i++) longitudes[i] = longitud(datos[i]);
+
+        char** cifradas = reservarLineasCifradas(longitudes, numLineas);
+        try {
+            int cantidad = ordenarPorLongitud(longitudes, numLineas, semilla, orden);
+            for (int lote = 0; lote < numLotes(cantidad); lote++)
+                encriptarLoteEn(datos, longitudes, orden, cantidad, lote, semilla, trabajo, cifradas);
+        } catch (const char*) {
+            descartarLineasCifradas(cifradas, numLineas);
+            throw;
+        }
+        reemplazarLineas(datos, numLineas, cifradas);
+    } catch (const char* msg) {
+        cerr << "[Excepción] " << msg << endl;
+    }
+    liberarArena(arena);
+}
 
-            delete[] datos[i];
-            datos[i] = reinterpret_cast<char*>(encriptado);
-            delete[] binario;
+/**
+ * @brief Versión paralela de encriptarArchivo(); cada hilo toma lotes
+ *        completos y usa su propia porción de la arena como zona de trabajo.
+ */
+void encriptarArchivo(char** datos, int numLineas, int semilla, PoolHilos& pool) {
+    ArenaCifrado arena;
+    try {
+        if (datos == nullptr || numLineas <= 0)
+            throw "Error: parámetros inválidos en encriptarArchivo.";
+
+        int maxLinea = longitudMaxima(datos, numLineas);
+        reservarArena(arena, 2 * (int64_t)numLineas * (int64_t)sizeof(int) + (int64_t)maxLinea * pool.numHilos());
+        int* longitudes = (int*)arena.buffer;
+        int* orden = longitudes + numLineas;
+        unsigned char* zonas = (unsigned char*)(orden + numLineas);
+        for (int i = 0; i < numLineas; i++) longitudes[i] = longitud(datos[i]);
+
+        char** cifradas = reservarLineasCifradas(longitudes, numLineas);
+        try {
+            int cantidad = ordenarPorLongitud(longitudes, numLineas, semilla, orden);
+            pool.paraCadaTrozo(numLotes(cantidad), 1,
+                               [=](int inicio, int fin, int hilo) {
+                                   for (int lote = inicio; lote < fin; lote++)
+                                       encriptarLoteEn(datos, longitudes, orden, cantidad, lote, semilla,
+                                                       zonas + hilo * maxLinea, cifradas);
+                               });
+        } catch (const char*) {
+            descartarLineasCifradas(cifradas, numLineas);
+            throw;
         }
+        reemplazarLineas(datos, numLineas, cifradas);
     } catch (const char* msg) {
         cerr << "[Excepción] " << msg << endl;
     }
+    liberarArena(arena);
 }
 
 /**
  * @brief Desencripta un arreglo de cadenas de texto.
+ *
+ * Los bytes se empaquetan y descifran en una arena compartida por todas
+ * las líneas y luego se copian sobre el propio buffer de la línea (el
+ * texto ocupa la octava parte de los caracteres '0'/'1'), así que el
+ * archivo completo se procesa con O(1) reservas de memoria. Solo se usan
+ * los bytes completos (múltiplo de 8 bits); una línea con caracteres no
+ * binarios se deja intacta.
  */
 void desencriptarArchivo(char** datos, int numLineas, int semilla) {
+    ArenaCifrado arena;
     try {
         if (datos == nullptr || numLineas <= 0)
             throw "Error: parámetros inválidos en desencriptarArchivo.";
 
-        for (int i = 0; i < numLineas; i++) {
-            unsigned char* encriptado = reinterpret_cast<unsigned char*>(datos[i]);
-            int sizeEnc = longitud(datos[i]);
-            unsigned char* binario = desencriptarBits(encriptado, sizeEnc, semilla);
-            if (!binario) continue;
-
-            int bitsValidos = (sizeEnc / 8) * 8;
-            unsigned char* textoASCII = binarioAtexto(binario, bitsValidos);
-            if (!textoASCII) {
-                delete[] binario;
-                continue;
-            }
+        reservarArena(arena, longitudMaxima(datos, numLineas) / 8);
+        for (int i = 0; i < numLineas; i++)
+            desencriptarLinea(datos, i, semilla, arena.buffer);
+    } catch (const char* msg) {
+        cerr << "[Excepción] " << msg << endl;
+    }
+    liberarArena(arena);
+}
 
-            delete[] datos[i];
-            datos[i] = reinterpret_cast<char*>(textoASCII);
-            delete[] binario;
+/**
+ * @brief Versión paralela de desencriptarArchivo(); cada hilo usa su
+ *        propia porción de la arena.
+ */
+void desencriptarArchivo(char** datos, int numLineas, int semilla, PoolHilos& pool) {
+    ArenaCifrado arena;
+    try {
+        if (datos == nullptr || numLineas <= 0)
+            throw "Error: parámetros inválidos en desencriptarArchivo.";
+
+        int maxChars = longitudMaxima(datos, numLineas) / 8;
+        reservarArena(arena, maxChars * pool.numHilos());
+        unsigned char* zonas = arena.buffer;
+
+        pool.paraCadaTrozo(numLineas, PoolHilos::trozoSugerido(numLineas, pool.numHilos()),
+                           [=](int inicio, int fin, int hilo) {
+                               for (int i = inicio; i < fin; i++)
+                                   desencriptarLinea(datos, i, semilla, zonas + hilo * maxChars);
+                           });
+    } catch (const char* msg) {
+        cerr << "[Excepción] " << msg << endl;
+    }
+    liberarArena(arena);
+}
+
+/**
+ * @brief Desencripta una vista hacia un buffer nuevo; igual que
+ *        desencriptarLinea(), si no es binaria la copia intacta.
+ */
+static char* desencriptarVista(VistaLinea vista, int semilla) {
+    int numChars = vista.longitud / 8;
+    char* salida;
+
+    if (numChars > 0) {
+        salida = new char[numChars + 1];
+        unsigned char* bytes = (unsigned char*)salida;
+        bool ok = empaquetarBits((const unsigned char*)vista.inicio, numChars * 8, bytes);
+        if (!ok) {
+            cerr << "[Excepción] Error: carácter no binario detectado." << endl;
+        } else {
+            try {
+                desencriptarBitsEmpaquetados(bytes, bytes, numChars * 8, semilla);
+                salida[numChars] = '\0';
+                return salida;
+            } catch (const char* msg) {
+                cerr << "[Excepción] " << msg << endl;
+            }
         }
+        delete[] salida;
+    }
+
+    salida = new char[vista.longitud + 1];
+    copiarN(salida, vista.inicio, vista.longitud);
+    salida[vista.longitud] = '\0';
+    return salida;
+}
+
+/**
+ * @brief Desencripta líneas vistas sin copia hacia un arreglo nuevo.
+ *
+ * Los bytes cifrados se empaquetan directamente en el buffer final de
+ * cada línea y se descifran ahí mismo: se reserva solo el texto plano,
+ * la octava parte de los caracteres '0'/'1'. Cada hilo escribe solo en
+ * las posiciones de su trozo.
+ */
+char** desencriptarVistas(const VistaLinea* vistas, int numLineas, int semilla, PoolHilos& pool) {
+    try {
+        if (vistas == nullptr || numLineas <= 0)
+            throw "Error: parámetros inválidos en desencriptarVistas.";
+
+        char** datos = new char*[numLineas];
+        pool.paraCadaTrozo(numLineas, PoolHilos::trozoSugerido(numLineas, pool.numHilos()),
+                           [=](int inicio, int fin, int) {
+                               for (int i = inicio; i < fin; i++)
+                                   datos[i] = desencriptarVista(vistas[i], semilla);
+                           });
+        return datos;
     } catch (const char* msg) {
         cerr << "[Excepción] " << msg << endl;
+        return nullptr;
     }
 }
 
@@ -271,3 +765,26 @@ bool verificarEstadoEncriptacion(char** usuarios, char** admins) {
         return false;
     }
 }
+
+/**
+ * @brief Verifica el estado de encriptación a partir de la primera línea
+ *        de cada archivo.
+ */
+bool verificarEstadoEncriptacion(VistaLinea primerUsuario, VistaLinea primerAdmin) {
+    try {
+        if (!primerAdmin.inicio || !primerUsuario.inicio)
+            throw "Error: punteros nulos detectados en verificación.";
+
+        bool adminsEnc = esBinarioN(primerAdmin.inicio, primerAdmin.longitud);
+        bool usuariosEnc = esBinarioN(primerUsuario.inicio, primerUsuario.longitud);
+
+        if (adminsEnc && usuariosEnc) return true;
+        if (!adminsEnc && !usuariosEnc) return false;
+
+        cerr << "[Advertencia] Estado inconsistente de encriptación.\n";
+        return false;
+    } catch (const char* msg) {
+        cerr << "[Excepción] " << msg << endl;
+        return false;
+    }
+}
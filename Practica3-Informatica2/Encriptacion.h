@@ -1,6 +1,10 @@
 #ifndef ENCRIPTACION_H
 #define ENCRIPTACION_H
 
+#include <cstdint>
+#include "ArchivoMapeado.h"
+#include "PoolHilos.h"
+
 /**
  * @brief Convierte una cadena binaria a texto ASCII.
  *
@@ -55,8 +59,40 @@ unsigned char* invertirBits(const unsigned char* bloque, int len);
  */
 unsigned char* invertirCadaNBits(unsigned char* bloque, int len, int n);
 
+/**
+ * @brief Versión de invertirBits() que escribe en un buffer del llamador.
+ * @param bloque Cadena binaria a invertir.
+ * @param len Longitud del bloque.
+ * @param salida Buffer de al menos `len` caracteres (puede ser `bloque`).
+ * @return false si hay parámetros inválidos o caracteres no binarios.
+ */
+bool invertirBitsEn(const unsigned char* bloque, int len, unsigned char* salida);
+
+/**
+ * @brief Versión de invertirCadaNBits() que escribe en un buffer del llamador.
+ * @param bloque Cadena binaria a procesar.
+ * @param len Longitud total de la cadena.
+ * @param n Tamaño de cada bloque a invertir.
+ * @param salida Buffer de al menos `len` caracteres (puede ser `bloque`).
+ * @return false si hay parámetros inválidos o caracteres no binarios.
+ */
+bool invertirCadaNBitsEn(const unsigned char* bloque, int len, int n, unsigned char* salida);
+
 // ===================== ENCRIPTACIÓN DE BITS =====================
 
+/**
+ * @brief Encripta una cadena binaria sobre un buffer del llamador.
+ *
+ * No reserva memoria y admite trabajar in-place (salida == binary).
+ *
+ * @param binary Cadena binaria a encriptar.
+ * @param size Tamaño de la cadena binaria.
+ * @param semilla Tamaño de los bloques para el procesamiento.
+ * @param salida Buffer de al menos `size` caracteres (no se añade '\0').
+ * @return false si hay parámetros inválidos o caracteres no binarios.
+ */
+bool encriptarBitsEn(const unsigned char* binary, int size, int semilla, unsigned char* salida);
+
 /**
  * @brief Encripta una cadena binaria usando el algoritmo de bloques.
  * @param binary Cadena binaria a encriptar.
@@ -67,7 +103,21 @@ unsigned char* invertirCadaNBits(unsigned char* bloque, int len, int n);
 unsigned char* encriptarBits(const unsigned char* binary, int size, int semilla);
 
 /**
- * @brief Desencripta una cadena binaria (proceso simétrico).
+ * @brief Desencripta una cadena binaria sobre un buffer del llamador.
+ *
+ * Cada bloque se descifra con la regla que indica el bloque cifrado
+ * anterior, sin depender del resultado de los demás bloques.
+ *
+ * @param binary Cadena binaria encriptada.
+ * @param size Tamaño de la cadena binaria.
+ * @param semilla Tamaño de los bloques usado en la encriptación.
+ * @param salida Buffer de al menos `size` caracteres (puede ser `binary`; no se añade '\0').
+ * @return false si hay parámetros inválidos o caracteres no binarios.
+ */
+bool desencriptarBitsEn(const unsigned char* binary, int size, int semilla, unsigned char* salida);
+
+/**
+ * @brief Desencripta una cadena binaria.
  * @param binary Cadena binaria encriptada.
  * @param size Tamaño de la cadena binaria.
  * @param semilla Tamaño de los bloques usado en la encriptación.
@@ -75,8 +125,64 @@ unsigned char* encriptarBits(const unsigned char* binary, int size, int semilla)
  */
 unsigned char* desencriptarBits(const unsigned char* binary, int size, int semilla);
 
+// ===================== ARENA DE TRABAJO =====================
+
+/**
+ * @brief Buffer de trabajo reutilizable entre líneas y entre llamadas.
+ *
+ * Evita reservar memoria por bloque o por línea: las funciones que la
+ * reciben solo piden memoria cuando la capacidad actual no alcanza.
+ */
+struct ArenaCifrado {
+    unsigned char* buffer = nullptr;  /**< Memoria de trabajo */
+    int64_t capacidad = 0;            /**< Bytes disponibles en buffer */
+    int reservas = 0;                 /**< Veces que se reservó memoria (diagnóstico) */
+};
+
+/**
+ * @brief Garantiza que la arena tenga al menos `bytes` de capacidad.
+ * @param arena Arena a dimensionar.
+ * @param bytes Capacidad mínima requerida.
+ */
+void reservarArena(ArenaCifrado& arena, int64_t bytes);
+
+/**
+ * @brief Libera la memoria de la arena.
+ * @param arena Arena a liberar (queda vacía y reutilizable).
+ */
+void liberarArena(ArenaCifrado& arena);
+
 // ===================== FUNCIONES DE ALTO NIVEL =====================
 
+/**
+ * @brief Encripta un arreglo de líneas dejando el resultado en una arena.
+ *
+ * No modifica `datos`: cada cifradas[i] apunta dentro de la arena a la
+ * línea cifrada (terminada en '\0'). Todo el archivo se procesa con a lo
+ * sumo una reserva de memoria, ninguna si la arena ya tiene capacidad.
+ * Los punteros dejan de ser válidos al volver a usar o liberar la arena.
+ *
+ * @param datos Arreglo de líneas en texto plano.
+ * @param numLineas Número de líneas en el arreglo.
+ * @param semilla Semilla para el algoritmo de encriptación.
+ * @param arena Arena donde quedan las líneas cifradas.
+ * @param cifradas Arreglo de `numLineas` punteros que recibe el resultado.
+ * @throws const char* Si los parámetros no son válidos o el cifrado
+ *         falla; en ese caso `cifradas` no sirve y no debe guardarse.
+ */
+void encriptarArchivoEn(char** datos, int numLineas, int semilla, ArenaCifrado& arena, char** cifradas);
+
+/**
+ * @brief Igual que encriptarArchivoEn(), repartiendo las líneas entre los hilos del pool.
+ *
+ * La arena reserva una zona de trabajo por hilo; el contenido de la
+ * arena es el mismo que en la versión secuencial.
+ *
+ * @param pool Pool de hilos a usar.
+ * @throws const char* Igual que la versión secuencial.
+ */
+void encriptarArchivoEn(char** datos, int numLineas, int semilla, ArenaCifrado& arena, char** cifradas, PoolHilos& pool);
+
 /**
  * @brief Encripta un arreglo de líneas: texto → binario → encriptación.
  * @param datos Arreglo de cadenas a encriptar (se modifica in-place).
@@ -85,6 +191,12 @@ unsigned char* desencriptarBits(const unsigned char* binary, int size, int semil
  */
 void encriptarArchivo(char** datos, int numLineas, int semilla);
 
+/**
+ * @brief Versión paralela de encriptarArchivo() (mismo resultado).
+ * @param pool Pool de hilos a usar.
+ */
+void encriptarArchivo(char** datos, int numLineas, int semilla, PoolHilos& pool);
+
 /**
  * @brief Desencripta un arreglo de líneas: desencriptación → binario → texto.
  * @param datos Arreglo de cadenas encriptadas (se modifica in-place).
@@ -93,6 +205,12 @@ void encriptarArchivo(char** datos, int numLineas, int semilla);
  */
 void desencriptarArchivo(char** datos, int numLineas, int semilla);
 
+/**
+ * @brief Versión paralela de desencriptarArchivo() (mismo resultado).
+ * @param pool Pool de hilos a usar.
+ */
+void desencriptarArchivo(char** datos, int numLineas, int semilla, PoolHilos& pool);
+
 /**
  * @brief Verifica si los archivos están encriptados.
  * @param usuarios Arreglo de líneas del archivo de usuarios.
@@ -101,4 +219,27 @@ void desencriptarArchivo(char** datos, int numLineas, int semilla);
  */
 bool verificarEstadoEncriptacion(char** usuarios, char** admins);
 
+/**
+ * @brief Igual que la anterior, a partir de la primera línea de cada archivo.
+ * @param primerUsuario Vista de la primera línea de usuarios.
+ * @param primerAdmin Vista de la primera línea de administradores.
+ */
+bool verificarEstadoEncriptacion(VistaLinea primerUsuario, VistaLinea primerAdmin);
+
+/**
+ * @brief Desencripta líneas vistas sin copia hacia un arreglo nuevo.
+ *
+ * El binario se lee directamente de las vistas (por ejemplo, las de
+ * cargarLineasMapeadas()) y solo se reserva el texto plano. Las líneas
+ * que no están en binario se copian tal cual. Reparte las líneas entre
+ * los hilos del pool.
+ *
+ * @param vistas Líneas cifradas.
+ * @param numLineas Número de líneas.
+ * @param semilla Semilla usada en la encriptación.
+ * @param pool Pool de hilos a usar.
+ * @return char** Arreglo de líneas en texto plano, o nullptr si hay error.
+ */
+char** desencriptarVistas(const VistaLinea* vistas, int numLineas, int semilla, PoolHilos& pool);
+
 #endif // ENCRIPTACION_H
@@ -0,0 +1,76 @@
+#ifndef ENCRIPTACION_FIJA_H
+#define ENCRIPTACION_FIJA_H
+
+#include <cstdint>
+#include "CifradoEmpaquetado.h"
+
+// ============================================================
+//  ENCRIPTACIÓN ESPECIALIZADA POR SEMILLA
+// ============================================================
+//
+// Para semillas pequeñas (1-16) el bloque completo cabe en un entero de
+// S bits. Las tres reglas de encriptarBits() invierten el bloque entero
+// (invertirCadaNBits() invierte completo cada grupo de n bits y los grupos
+// lo cubren), así que la regla que impone el bloque anterior no cambia el
+// resultado: cada bloque sale como ~bloque & mascaraBloque(S), sin tablas
+// por regla ni conteo de unos y ceros.
+
+/** Semilla máxima con versión especializada. */
+const int SEMILLA_FIJA_MAX = 16;
+
+/**
+ * @brief Máscara con los `len` bits bajos en 1.
+ */
+constexpr uint32_t mascaraBloque(int len) {
+    return (1u << len) - 1u;
+}
+
+/**
+ * @brief Encripta una cadena binaria con una semilla conocida en compilación.
+ *
+ * Produce exactamente lo mismo que encriptarBits(binary, size, S).
+ *
+ * @param binary Cadena binaria de entrada.
+ * @param size Número de bits.
+ * @param salida Buffer de al menos `size` caracteres (no se añade '\0').
+ * @return false si encuentra un carácter distinto de '0' o '1'; en ese caso
+ *         el llamador debe usar la ruta genérica y su manejo de errores.
+ */
+template <int S>
+bool encriptarBitsFijo(const unsigned char* binary, int size, unsigned char* salida) {
+    static_assert(S >= 1 && S <= SEMILLA_FIJA_MAX, "Semilla fuera del rango especializado.");
+    const int completos = size - size % S;
+
+    for (int i = 0; i < completos; i += S) {
+        uint32_t bloque = 0;
+        for (int j = 0; j < S; j++) {
+            unsigned char c = binary[i + j];
+            if (c != '0' && c != '1')
+                return false;
+            bloque = (bloque << 1) | (uint32_t)(c - '0');
+        }
+
+        uint32_t procesado = ~bloque & mascaraBloque(S);
+        for (int j = 0; j < S; j++)
+            salida[i + j] = (unsigned char)('0' + ((procesado >> (S - 1 - j)) & 1u));
+    }
+
+    // Último bloque incompleto: máscara de su longitud real.
+    int resto = size - completos;
+    if (resto > 0) {
+        uint32_t bloque = 0;
+        for (int j = 0; j < resto; j++) {
+            unsigned char c = binary[completos + j];
+            if (c != '0' && c != '1')
+                return false;
+            bloque = (bloque << 1) | (uint32_t)(c - '0');
+        }
+        uint32_t procesado = ~bloque & mascaraBloque(resto);
+        for (int j = 0; j < resto; j++)
+            salida[completos + j] = (unsigned char)('0' + ((procesado >> (resto - 1 - j)) & 1u));
+    }
+
+    return true;
+}
+
+#endif // ENCRIPTACION_FIJA_H
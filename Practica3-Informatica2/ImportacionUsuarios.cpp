@@ -0,0 +1,206 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "ArchivoMapeado.h"
+#include "ImportacionUsuarios.h"
+#include "Validaciones.h"
+
+using namespace std;
+
+/** Capacidad de los campos cédula, clave y saldo al validar una fila. */
+const int TAM_CAMPO_FILA = 32;
+
+/**
+ * @brief Quita espacios, tabulaciones y '\r' de los extremos de un campo.
+ */
+static void recortarCampo(const char*& inicio, int& len) {
+    while (len > 0 && (inicio[0] == ' ' || inicio[0] == '\t')) { inicio++; len--; }
+    while (len > 0 && (inicio[len - 1] == ' ' || inicio[len - 1] == '\t' || inicio[len - 1] == '\r')) len--;
+}
+
+/**
+ * @brief Copia un campo recortado a un buffer terminado en '\0'.
+ * @return false si no cabe.
+ */
+static bool copiarCampoFila(char* destino, int capacidad, const char* inicio, int len) {
+    recortarCampo(inicio, len);
+    if (len >= capacidad) return false;
+    memcpy(destino, inicio, len);
+    destino[len] = '\0';
+    return true;
+}
+
+/**
+ * @brief Indica si la fila es el encabezado del CSV.
+ */
+static bool esEncabezado(const VistaLinea& fila) {
+    const char* palabra = "cedula";
+    if (fila.longitud < 6) return false;
+    for (int k = 0; k < 6; k++)
+        if ((fila.inicio[k] | 0x20) != palabra[k]) return false;
+    return true;
+}
+
+/**
+ * @brief Valida una fila "cedula,clave,nombre,saldo" y arma la cuenta.
+ * @return nullptr si la fila es válida; si no, el motivo del rechazo.
+ */
+static const char* validarFila(const VistaLinea& fila, Cuenta& cuenta) {
+    // Dos primeras comas y la última: el nombre puede traer comas
+    int comas[3];
+    int encontradas = 0;
+    for (int i = 0; i < fila.longitud; i++) {
+        if (fila.inicio[i] != ',') continue;
+        if (encontradas < 2) comas[encontradas++] = i;
+        else {
+            comas[2] = i;
+            encontradas = 3;
+        }
+    }
+    if (encontradas < 3)
+        return "La fila no tiene los campos cedula,clave,nombre,saldo.";
+
+    char cedula[TAM_CAMPO_FILA], clave[TAM_CAMPO_FILA], saldo[TAM_CAMPO_FILA], nombre[TAM_NOMBRE_CUENTA];
+    if (!copiarCampoFila(cedula, TAM_CAMPO_FILA, fila.inicio, comas[0])
+        || !copiarCampoFila(clave, TAM_CAMPO_FILA, fila.inicio + comas[0] + 1, comas[1] - comas[0] - 1)
+        || !copiarCampoFila(saldo, TAM_CAMPO_FILA, fila.inicio + comas[2] + 1, fila.longitud - comas[2] - 1))
+        return "La fila tiene un campo demasiado largo.";
+
+    const char* error = errorCedula(cedula);
+    if (error == nullptr) error = errorContrasena(clave);
+    if (error == nullptr) error = errorSaldo(saldo);
+    if (error != nullptr) return error;
+
+    if (!copiarCampoFila(nombre, TAM_NOMBRE_CUENTA, fila.inicio + comas[1] + 1, comas[2] - comas[1] - 1)
+        || !crearCuenta(cedula, clave, nombre, atoll(saldo), cuenta))
+        return "El nombre es demasiado largo.";
+    if (nombre[0] == '\0')
+        return "El nombre está vacío.";
+    cuenta.modificada = true;   // aún no tiene texto cifrado
+    return nullptr;
+}
+
+bool importarUsuarios(const char* rutaCsv, ListaCuentas& cuentas, IndiceCedulas& indice, PoolHilos& pool,
+                      ResultadoImportacion& resultado) {
+    liberarResultadoImportacion(resultado);
+    resultado = ResultadoImportacion();
+
+    ArchivoMapeado archivo;
+    try {
+        abrirMapeo(archivo, rutaCsv);
+    }
+    catch (const char* e) {
+        cerr << "ERROR en importarUsuarios(): " << e << endl;
+        return false;
+    }
+
+    // Primera pasada: cuántas líneas hay, para reservar de una vez
+    const char* fin = archivo.datos + archivo.tamanio;
+    int maxFilas = 0;
+    for (const char* p = archivo.datos; p != nullptr && p < fin; maxFilas++) {
+        const char* salto = (const char*)memchr(p, '\n', fin - p);
+        p = salto ? salto + 1 : fin;
+    }
+
+    // Filas no vacías con su número de línea
+    VistaLinea* filas = new VistaLinea[maxFilas];
+    int* lineas = new int[maxFilas];
+    int n = 0, numLinea = 0;
+    for (const char* p = archivo.datos; p != nullptr && p < fin; ) {
+        const char* salto = (const char*)memchr(p, '\n', fin - p);
+        const char* finFila = salto ? salto : fin;
+        numLinea++;
+        VistaLinea fila;
+        fila.inicio = p;
+        fila.longitud = (int)(finFila - p);
+        const char* recortada = fila.inicio;
+        int largo = fila.longitud;
+        recortarCampo(recortada, largo);
+        if (largo > 0 && !(numLinea == 1 && esEncabezado(fila))) {
+            filas[n] = fila;
+            lineas[n] = numLinea;
+            n++;
+        }
+        p = finFila + 1;
+    }
+    resultado.filas = n;
+
+    // Validación en paralelo, escribiendo directamente en el lugar que
+    // ocuparía cada cuenta al final de la lista
+    auto inicioValidacion = chrono::steady_clock::now();
+    const int base = cuentas.cantidad;
+    reservarCuentas(cuentas, base + n);
+    const char** motivos = new const char*[n > 0 ? n : 1];
+    if (n > 0) {
+        Cuenta* destinos = cuentas.datos + base;
+        pool.paraCadaTrozo(n, PoolHilos::trozoSugerido(n, pool.numHilos()), [&](int inicio, int fin, int) {
+            for (int i = inicio; i < fin; i++)
+                motivos[i] = validarFila(filas[i], destinos[i]);
+        });
+    }
+    auto finValidacion = chrono::steady_clock::now();
+
+    // Duplicados, en orden de línea: gana la primera aparición. Las
+    // aceptadas se compactan hacia adelante (nunca pisan una fila sin leer)
+    reservarIndiceCedulas(indice, base + n);
+    int destino = base;
+    for (int i = 0; i < n; i++) {
+        if (motivos[i] == nullptr) {
+            int existente = buscarCedula(indice, cuentas.datos[base + i].cedula);
+            if (existente >= 0)
+                motivos[i] = existente < base ? "La cédula ya está registrada."
+                                              : "La cédula se repite en el archivo.";
+        }
+        if (motivos[i] != nullptr) {
+            resultado.numRechazos++;
+            continue;
+        }
+        if (destino != base + i)
+            cuentas.datos[destino] = cuentas.datos[base + i];
+        insertarCedula(indice, cuentas.datos[destino].cedula, destino);
+        destino++;
+    }
+    cuentas.cantidad = destino;
+    resultado.aceptadas = destino - base;
+    auto finDuplicados = chrono::steady_clock::now();
+
+    // Rechazos, ya con su cantidad exacta
+    if (resultado.numRechazos > 0) {
+        resultado.rechazos = new RechazoImportacion[resultado.numRechazos];
+        int r = 0;
+        for (int i = 0; i < n; i++) {
+            if (motivos[i] == nullptr) continue;
+            resultado.rechazos[r].linea = lineas[i];
+            resultado.rechazos[r].motivo = motivos[i];
+            r++;
+        }
+    }
+    delete[] motivos;
+    delete[] lineas;
+    delete[] filas;
+    cerrarMapeo(archivo);
+
+    resultado.segundosValidacion = chrono::duration<double>(finValidacion - inicioValidacion).count();
+    resultado.segundosDuplicados = chrono::duration<double>(finDuplicados - finValidacion).count();
+    return true;
+}
+
+bool guardarReporteRechazos(const char* ruta, const ResultadoImportacion& resultado) {
+    ofstream archivo(ruta, ios::trunc);
+    if (!archivo.is_open()) {
+        cerr << "ERROR en guardarReporteRechazos(): No se pudo crear " << ruta << endl;
+        return false;
+    }
+    archivo << "linea,motivo\n";
+    for (int i = 0; i < resultado.numRechazos; i++)
+        archivo << resultado.rechazos[i].linea << ',' << resultado.rechazos[i].motivo << '\n';
+    return (bool)archivo;
+}
+
+void liberarResultadoImportacion(ResultadoImportacion& resultado) {
+    delete[] resultado.rechazos;
+    resultado.rechazos = nullptr;
+    resultado.numRechazos = 0;
+}
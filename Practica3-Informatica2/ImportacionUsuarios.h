@@ -0,0 +1,63 @@
+#ifndef IMPORTACION_USUARIOS_H
+#define IMPORTACION_USUARIOS_H
+
+#include "Cuenta.h"
+#include "IndiceCedulas.h"
+#include "PoolHilos.h"
+
+// ===================== IMPORTACIÓN MASIVA DE USUARIOS =====================
+//
+// Un archivo CSV en texto plano con una fila "cedula,clave,nombre,saldo"
+// por usuario (una primera fila que empiece con "cedula" se toma como
+// encabezado). Las filas se validan en paralelo con las mismas reglas
+// del registro por menú; después, en orden, se descartan las cédulas que
+// ya existen o que se repiten dentro del archivo, buscándolas en el
+// índice de cédulas. Las cuentas aceptadas quedan al final de la lista
+// marcadas como modificadas, así que el siguiente guardado las cifra
+// (en paralelo) y las escribe de una vez.
+
+/**
+ * @brief Una fila del CSV que no se importó.
+ */
+struct RechazoImportacion {
+    int linea = 0;                      /**< Número de línea en el CSV (desde 1) */
+    const char* motivo = nullptr;       /**< Texto fijo con la causa */
+};
+
+/**
+ * @brief Resumen de una importación.
+ */
+struct ResultadoImportacion {
+    int filas = 0;                              /**< Filas de datos leídas */
+    int aceptadas = 0;                          /**< Cuentas agregadas */
+    RechazoImportacion* rechazos = nullptr;     /**< En orden de línea */
+    int numRechazos = 0;
+    double segundosValidacion = 0;
+    double segundosDuplicados = 0;
+};
+
+/**
+ * @brief Valida un CSV de usuarios y agrega las cuentas aceptadas.
+ *
+ * @param rutaCsv Ruta del archivo CSV.
+ * @param cuentas Cuentas actuales; las aceptadas se agregan al final.
+ * @param indice Índice de cédulas de `cuentas` (se actualiza).
+ * @param pool Pool de hilos para validar.
+ * @param resultado Recibe el resumen (liberarlo con liberarResultadoImportacion()).
+ * @return false si el archivo no se pudo leer (y entonces nada cambió).
+ */
+bool importarUsuarios(const char* rutaCsv, ListaCuentas& cuentas, IndiceCedulas& indice, PoolHilos& pool,
+                      ResultadoImportacion& resultado);
+
+/**
+ * @brief Escribe el reporte de rechazos ("linea,motivo" por fila).
+ * @return true si quedó escrito.
+ */
+bool guardarReporteRechazos(const char* ruta, const ResultadoImportacion& resultado);
+
+/**
+ * @brief Libera los rechazos; el resultado queda vacío.
+ */
+void liberarResultadoImportacion(ResultadoImportacion& resultado);
+
+#endif // IMPORTACION_USUARIOS_H
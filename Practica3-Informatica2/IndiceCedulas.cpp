@@ -0,0 +1,164 @@
+#include "IndiceCedulas.h"
+
+/** Longitudes que acepta errorCedula(); la cantidad de dígitos va en los 4 bits altos. */
+const int MIN_DIGITOS_CEDULA = 6;
+const int MAX_DIGITOS_CEDULA = 10;
+
+/** Capacidad mínima de la tabla (potencia de dos). */
+const int BITS_CAPACIDAD_MINIMA = 4;
+
+// ============================================================
+//  CLAVES
+// ============================================================
+
+uint64_t empaquetarCedula(const char* cedula, int len) {
+    if (!cedula) return 0;
+
+    int inicio = 0, fin = len;
+    while (inicio < fin && (cedula[inicio] == ' ' || cedula[inicio] == '\t')) inicio++;
+    while (fin > inicio && (cedula[fin - 1] == ' ' || cedula[fin - 1] == '\t' || cedula[fin - 1] == '\r')) fin--;
+
+    int digitos = fin - inicio;
+    if (digitos < MIN_DIGITOS_CEDULA || digitos > MAX_DIGITOS_CEDULA) return 0;
+
+    uint64_t valor = 0;
+    for (int i = inicio; i < fin; i++) {
+        if (cedula[i] < '0' || cedula[i] > '9') return 0;
+        valor = valor * 10 + (uint64_t)(cedula[i] - '0');
+    }
+    return ((uint64_t)digitos << 60) | valor;
+}
+
+uint64_t empaquetarCedula(const char* cedula) {
+    if (!cedula) return 0;
+    int len = 0;
+    while (cedula[len] != '\0') len++;
+    return empaquetarCedula(cedula, len);
+}
+
+void desempaquetarCedula(uint64_t clave, char* destino) {
+    int digitos = (int)(clave >> 60);
+    uint64_t valor = clave & ((1ULL << 60) - 1);
+    if (digitos < MIN_DIGITOS_CEDULA || digitos > MAX_DIGITOS_CEDULA) {
+        destino[0] = '\0';
+        return;
+    }
+
+    for (int i = digitos - 1; i >= 0; i--) {
+        destino[i] = (char)('0' + valor % 10);
+        valor /= 10;
+    }
+    destino[digitos] = '\0';
+}
+
+uint64_t cedulaDeLinea(const char* linea) {
+    if (!linea) return 0;
+    int coma = 0;
+    while (linea[coma] != '\0' && linea[coma] != ',') coma++;
+    if (linea[coma] != ',') return 0;
+    return empaquetarCedula(linea, coma);
+}
+
+// ============================================================
+//  TABLA
+// ============================================================
+
+/**
+ * @brief Casilla donde empieza el sondeo (hash multiplicativo de Fibonacci).
+ */
+static int casillaInicial(const IndiceCedulas& indice, uint64_t clave) {
+    return (int)((clave * 0x9E3779B97F4A7C15ULL) >> (64 - indice.bits));
+}
+
+/**
+ * @brief Cambia la tabla por una de al menos `nuevaCapacidad` casillas
+ *        y vuelve a insertar las entradas.
+ */
+static void redimensionar(IndiceCedulas& indice, long long nuevaCapacidad) {
+    int bits = BITS_CAPACIDAD_MINIMA;
+    while ((1LL << bits) < nuevaCapacidad) bits++;
+    if (bits > 30) throw "El indice de cedulas excede el tamano maximo.";
+
+    uint64_t* viejasClaves = indice.claves;
+    int* viejasPosiciones = indice.posiciones;
+    int viejaCapacidad = indice.capacidad;
+
+    indice.bits = bits;
+    indice.capacidad = 1 << bits;
+    indice.claves = new uint64_t[indice.capacidad];
+    indice.posiciones = new int[indice.capacidad];
+    for (int i = 0; i < indice.capacidad; i++) {
+        indice.claves[i] = 0;
+        indice.posiciones[i] = -1;
+    }
+    indice.usados = 0;
+
+    for (int i = 0; i < viejaCapacidad; i++)
+        if (viejasClaves[i] != 0) insertarCedula(indice, viejasClaves[i], viejasPosiciones[i]);
+
+    delete[] viejasClaves;
+    delete[] viejasPosiciones;
+}
+
+void reservarIndiceCedulas(IndiceCedulas& indice, int cantidad) {
+    long long necesaria = (cantidad > 0 ? (long long)cantidad : 1) * 2;
+    if (necesaria > indice.capacidad)
+        redimensionar(indice, necesaria);
+}
+
+int construirIndiceCedulas(IndiceCedulas& indice, char** lineas, int numLineas) {
+    liberarIndiceCedulas(indice);
+    reservarIndiceCedulas(indice, numLineas);
+
+    int sinIndice = 0;
+    for (int i = 0; i < numLineas; i++) {
+        uint64_t clave = lineas ? cedulaDeLinea(lineas[i]) : 0;
+        if (clave == 0) {
+            sinIndice++;
+            continue;
+        }
+        insertarCedula(indice, clave, i);   // si se repite, queda la primera
+    }
+    return sinIndice;
+}
+
+int buscarCedula(const IndiceCedulas& indice, uint64_t clave) {
+    if (clave == 0 || indice.capacidad == 0) return -1;
+
+    int mascara = indice.capacidad - 1;
+    for (int i = casillaInicial(indice, clave); ; i = (i + 1) & mascara) {
+        if (indice.claves[i] == clave) return indice.posiciones[i];
+        if (indice.claves[i] == 0) return -1;
+    }
+}
+
+int buscarCedula(const IndiceCedulas& indice, const char* cedula) {
+    return buscarCedula(indice, empaquetarCedula(cedula));
+}
+
+bool insertarCedula(IndiceCedulas& indice, uint64_t clave, int posicion) {
+    if (clave == 0) return false;
+    if ((long long)(indice.usados + 1) * 2 > indice.capacidad)
+        redimensionar(indice, (long long)indice.capacidad * 2);
+
+    int mascara = indice.capacidad - 1;
+    int i = casillaInicial(indice, clave);
+    while (indice.claves[i] != 0) {
+        if (indice.claves[i] == clave) return false;
+        i = (i + 1) & mascara;
+    }
+    indice.claves[i] = clave;
+    indice.posiciones[i] = posicion;
+    indice.usados++;
+    return true;
+}
+
+void liberarIndiceCedulas(IndiceCedulas& indice) {
+    delete[] indice.claves;
+    delete[] indice.posiciones;
+    indice.claves = nullptr;
+    indice.posiciones = nullptr;
+    indice.capacidad = 0;
+    indice.usados = 0;
+    indice.bits = 0;
+}
@@ -0,0 +1,99 @@
+#ifndef INDICE_CEDULAS_H
+#define INDICE_CEDULAS_H
+
+#include <cstdint>
+
+// ===================== ÍNDICE POR CÉDULA =====================
+
+/**
+ * @brief Índice hash cédula -> posición del registro.
+ *
+ * Direccionamiento abierto con sondeo lineal sobre una tabla de tamaño
+ * potencia de dos y ocupación máxima del 50 %, así que una búsqueda
+ * recorre en promedio una o dos casillas contiguas. La clave 0 marca una
+ * casilla libre. No se borran entradas: los registros solo se agregan.
+ */
+struct IndiceCedulas {
+    uint64_t* claves = nullptr;         /**< Cédulas empaquetadas (0 = libre) */
+    int* posiciones = nullptr;          /**< Posición del registro de cada casilla */
+    int capacidad = 0;                  /**< Casillas (potencia de dos) */
+    int usados = 0;                     /**< Casillas ocupadas */
+    int bits = 0;                       /**< log2(capacidad) */
+};
+
+/**
+ * @brief Empaqueta una cédula en un entero de 64 bits.
+ *
+ * Los 4 bits altos guardan la cantidad de dígitos y el resto su valor,
+ * así que cédulas con ceros a la izquierda siguen siendo distintas.
+ * Se ignoran los espacios al inicio y al final.
+ *
+ * @param cedula Texto de la cédula (6 a 10 dígitos, como en errorCedula()).
+ * @param len Caracteres de `cedula` a considerar.
+ * @return La clave, o 0 si el texto no es una cédula representable.
+ */
+uint64_t empaquetarCedula(const char* cedula, int len);
+
+/**
+ * @brief Igual que empaquetarCedula(), para una cadena terminada en '\0'.
+ */
+uint64_t empaquetarCedula(const char* cedula);
+
+/** Capacidad mínima del destino de desempaquetarCedula() (10 dígitos y '\0'). */
+const int TAM_TEXTO_CEDULA = 11;
+
+/**
+ * @brief Texto de una cédula empaquetada (inversa de empaquetarCedula()).
+ * @param clave Cédula empaquetada.
+ * @param destino Buffer de al menos TAM_TEXTO_CEDULA caracteres; queda
+ *        vacío si la clave es 0 o su longitud no es válida.
+ */
+void desempaquetarCedula(uint64_t clave, char* destino);
+
+/**
+ * @brief Clave de la cédula de un registro "cedula,clave,...".
+ * @return La clave del primer campo, o 0 si no es una cédula válida.
+ */
+uint64_t cedulaDeLinea(const char* linea);
+
+/**
+ * @brief Deja lugar para `cantidad` entradas sin volver a crecer.
+ */
+void reservarIndiceCedulas(IndiceCedulas& indice, int cantidad);
+
+/**
+ * @brief Reconstruye el índice a partir de registros "cedula,clave,...".
+ *
+ * Si una cédula se repite se conserva la primera aparición, igual que
+ * la búsqueda lineal que reemplaza.
+ *
+ * @param indice Índice destino (se libera antes lo que tuviera).
+ * @param lineas Registros en texto plano.
+ * @param numLineas Cantidad de registros.
+ * @return Cantidad de registros que no se pudieron indexar.
+ */
+int construirIndiceCedulas(IndiceCedulas& indice, char** lineas, int numLineas);
+
+/**
+ * @brief Posición del registro con esa clave, o -1 si no existe.
+ */
+int buscarCedula(const IndiceCedulas& indice, uint64_t clave);
+
+/**
+ * @brief Posición del registro con esa cédula, o -1 si no existe.
+ */
+int buscarCedula(const IndiceCedulas& indice, const char* cedula);
+
+/**
+ * @brief Agrega una entrada, creciendo la tabla si hace falta.
+ * @return false si la clave es inválida o ya estaba en el índice.
+ */
+bool insertarCedula(IndiceCedulas& indice, uint64_t clave, int posicion);
+
+/**
+ * @brief Libera la tabla.
+ * @param indice Índice a liberar (queda vacío y reutilizable).
+ */
+void liberarIndiceCedulas(IndiceCedulas& indice);
+
+#endif // INDICE_CEDULAS_H
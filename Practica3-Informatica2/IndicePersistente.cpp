@@ -0,0 +1,350 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "AlmacenSegmentado.h"
+#include "ArchivoRanuras.h"
+#include "IndiceCedulas.h"
+#include "IndicePersistente.h"
+#include "ManipulacionDeArchivos.h"
+#include "UtilidadesCadena.h"
+using namespace std;
+
+/** Primeros bytes de un índice de cédulas. */
+const char MAGIA_INDICE[4] = { 'P', '3', 'I', 'C' };
+
+// ============================================================
+//  FORMATO
+// ============================================================
+
+/**
+ * @brief Escribe un entero de `bytes` bytes en little-endian.
+ */
+static void escribirLE(char* destino, uint64_t valor, int bytes) {
+    for (int k = 0; k < bytes; k++)
+        destino[k] = (char)((valor >> (8 * k)) & 0xFF);
+}
+
+/**
+ * @brief Lee un entero de `bytes` bytes en little-endian.
+ */
+static uint64_t leerLE(const char* origen, int bytes) {
+    uint64_t valor = 0;
+    for (int k = bytes - 1; k >= 0; k--)
+        valor = (valor << 8) | (unsigned char)origen[k];
+    return valor;
+}
+
+/**
+ * @brief Lo que identifica a los datos con los que se escribió un índice.
+ */
+struct HuellaDatos {
+    uint64_t generacion = 0;
+    uint64_t bytes = 0;
+    int64_t modificacion = 0;
+};
+
+/**
+ * @brief Toma la huella actual del almacén (sin leer los registros).
+ */
+static bool tomarHuella(const char* rutaDatos, HuellaDatos& huella) {
+    error_code error;
+    huella.bytes = (uint64_t)filesystem::file_size(rutaDatos, error);
+    if (error) return false;
+    huella.modificacion = (int64_t)filesystem::last_write_time(rutaDatos, error).time_since_epoch().count();
+    if (error) return false;
+
+    huella.generacion = 0;
+    if (esManifiestoSegmentado(rutaDatos)) {
+        ManifiestoAlmacen manifiesto;
+        if (!leerManifiesto(rutaDatos, manifiesto)) return false;
+        huella.generacion = manifiesto.generacion;
+        liberarManifiesto(manifiesto);
+    }
+    return true;
+}
+
+/**
+ * @brief Tamaño de un archivo, o -1 si no se puede consultar.
+ */
+static int64_t tamanioArchivo(const char* ruta) {
+    error_code error;
+    uint64_t bytes = (uint64_t)filesystem::file_size(ruta, error);
+    return error ? -1 : (int64_t)bytes;
+}
+
+// ============================================================
+//  ESCRITURA
+// ============================================================
+
+/**
+ * @brief Recorre las líneas de un archivo suelto (o un segmento) con las
+ *        reglas con que se escribe y anota dónde queda cada registro.
+ * @return Bytes que ocupa el archivo según esas reglas.
+ */
+static uint64_t ubicarEnArchivo(char** lineas, int inicio, int fin, bool empaquetado, unsigned int segmento,
+                                UbicacionRegistro* ubicaciones) {
+    uint64_t pos = empaquetado ? TAM_CABECERA_EMPAQUETADO : 0;
+    for (int i = inicio; i < fin; i++) {
+        UbicacionRegistro& u = ubicaciones[i];
+        int len = longitud(lineas[i]);
+        u.registro = (unsigned int)i;
+        u.segmento = segmento;
+        if (empaquetado) {
+            if (len == 0) continue;
+            u.desplazamiento = pos + 4;
+            u.longitud = (unsigned int)(len / 8);
+            pos += 4 + u.longitud;
+        } else {
+            u.desplazamiento = pos;
+            u.longitud = (unsigned int)len;
+            pos += u.longitud + 1;
+        }
+    }
+    if (!empaquetado && fin > inicio) pos--;   // la última línea va sin '\n'
+    return pos;
+}
+
+/**
+ * @brief Calcula dónde quedó cada registro y lo contrasta con los
+ *        archivos reales.
+ * @return false si el formato no se reconoce o los tamaños no coinciden.
+ */
+static bool calcularUbicaciones(const char* rutaDatos, char** lineas, int numLineas, UbicacionRegistro* ubicaciones) {
+    if (esArchivoRanuras(rutaDatos)) {
+        char cabecera[16];
+        ifstream archivo(rutaDatos, ios::binary);
+        if (!archivo.read(cabecera, 16)) return false;
+        uint64_t registros = leerLE(cabecera + 8, 4);
+        uint64_t tamRanura = leerLE(cabecera + 12, 4);
+
+        uint64_t k = 0;
+        for (int i = 0; i < numLineas; i++) {
+            int len = longitud(lineas[i]);
+            if (len == 0) continue;
+            UbicacionRegistro& u = ubicaciones[i];
+            u.registro = (unsigned int)i;
+            u.desplazamiento = (++k) * tamRanura + 4;
+            u.longitud = (unsigned int)(len / 8);
+        }
+        return k == registros && tamanioArchivo(rutaDatos) >= (int64_t)((registros + 1) * tamRanura);
+    }
+
+    if (esManifiestoSegmentado(rutaDatos)) {
+        ManifiestoAlmacen manifiesto;
+        if (!leerManifiesto(rutaDatos, manifiesto)) return false;
+
+        bool ok = true;
+        int inicio = 0;
+        char rutaSeg[TAM_MAX_RUTA_SEGMENTO];
+        for (int s = 0; ok && s < manifiesto.numSegmentos; s++) {
+            // El segmento termina cuando ya tiene sus registros no vacíos
+            uint64_t registros = 0;
+            int fin = inicio;
+            while (fin < numLineas && (registros < manifiesto.segmentos[s].registros || lineas[fin][0] == '\0'))
+                if (lineas[fin++][0] != '\0') registros++;
+
+            uint64_t bytes = ubicarEnArchivo(lineas, inicio, fin, manifiesto.empaquetado, (unsigned int)s,
+                                             ubicaciones);
+            rutaSegmento(rutaDatos, manifiesto.generacion, s, rutaSeg);
+            ok = registros == manifiesto.segmentos[s].registros && bytes == manifiesto.segmentos[s].bytes
+                 && tamanioArchivo(rutaSeg) == (int64_t)bytes;
+            inicio = fin;
+        }
+        liberarManifiesto(manifiesto);
+        return ok && inicio == numLineas;
+    }
+
+    bool empaquetado = esArchivoEmpaquetado(rutaDatos);
+    uint64_t bytes = ubicarEnArchivo(lineas, 0, numLineas, empaquetado, 0, ubicaciones);
+    return tamanioArchivo(rutaDatos) == (int64_t)bytes;
+}
+
+/**
+ * @brief Una entrada del índice antes de codificarla.
+ */
+struct EntradaIndice {
+    uint64_t clave;
+    UbicacionRegistro ubicacion;
+};
+
+/**
+ * @brief Reparte el arreglo ordenado en orden de Eytzinger: el nodo k
+ *        (desde 1) tiene sus hijos en 2k y 2k + 1.
+ * @return Siguiente posición de `ordenadas` por tomar.
+ */
+static int llenarEytzinger(const EntradaIndice* ordenadas, int n, EntradaIndice* arbol, int siguiente, int64_t k) {
+    if (k <= n) {
+        siguiente = llenarEytzinger(ordenadas, n, arbol, siguiente, 2 * k);
+        arbol[k - 1] = ordenadas[siguiente++];
+        siguiente = llenarEytzinger(ordenadas, n, arbol, siguiente, 2 * k + 1);
+    }
+    return siguiente;
+}
+
+void rutaIndicePersistente(const char* rutaDatos, char* destino) {
+    copiar(destino, rutaDatos);
+    concatenar(destino, ".indice");
+}
+
+bool guardarIndicePersistente(const char* rutaDatos, const Cuenta* cuentas, char** lineas, int numCuentas) {
+    uint64_t* cedulas = new uint64_t[numCuentas > 0 ? numCuentas : 1];
+    for (int i = 0; i < numCuentas; i++) cedulas[i] = cuentas[i].cedula;
+    bool ok = guardarIndicePersistente(rutaDatos, cedulas, lineas, numCuentas);
+    delete[] cedulas;
+    return ok;
+}
+
+bool guardarIndicePersistente(const char* rutaDatos, const uint64_t* cedulas, char** lineas, int numCuentas) {
+    int largo = longitud(rutaDatos);
+    char* ruta = new char[largo + 8];
+    char* temporal = new char[largo + 12];
+    rutaIndicePersistente(rutaDatos, ruta);
+    copiar(temporal, ruta);
+    concatenar(temporal, ".tmp");
+
+    UbicacionRegistro* ubicaciones = new UbicacionRegistro[numCuentas > 0 ? numCuentas : 1];
+    EntradaIndice* ordenadas = new EntradaIndice[numCuentas > 0 ? numCuentas : 1];
+    EntradaIndice* arbol = new EntradaIndice[numCuentas > 0 ? numCuentas : 1];
+    char* contenido = nullptr;
+    bool ok = false;
+    try {
+        if (!calcularUbicaciones(rutaDatos, lineas, numCuentas, ubicaciones))
+            throw "Los datos no tienen la forma esperada; no se indexan.";
+
+        int n = 0;
+        for (int i = 0; i < numCuentas; i++)
+            if (cedulas[i] != 0 && lineas[i][0] != '\0')
+                ordenadas[n++] = { cedulas[i], ubicaciones[i] };
+        // Con cédulas repetidas queda la primera, igual que en memoria
+        stable_sort(ordenadas, ordenadas + n,
+                    [](const EntradaIndice& a, const EntradaIndice& b) { return a.clave < b.clave; });
+        n = (int)(unique(ordenadas, ordenadas + n,
+                         [](const EntradaIndice& a, const EntradaIndice& b) { return a.clave == b.clave; })
+                  - ordenadas);
+        llenarEytzinger(ordenadas, n, arbol, 0, 1);
+
+        HuellaDatos huella;
+        if (!tomarHuella(rutaDatos, huella))
+            throw "No se pudo consultar el archivo de datos.";
+
+        long total = TAM_CABECERA_INDICE + (long)n * TAM_ENTRADA_INDICE;
+        contenido = new char[total]();
+        for (int k = 0; k < 4; k++) contenido[k] = MAGIA_INDICE[k];
+        contenido[4] = (char)VERSION_INDICE_PERSISTENTE;
+        escribirLE(contenido + 8, huella.generacion, 8);
+        escribirLE(contenido + 16, huella.bytes, 8);
+        escribirLE(contenido + 24, (uint64_t)huella.modificacion, 8);
+        escribirLE(contenido + 32, (uint64_t)n, 4);
+        escribirLE(contenido + 36, TAM_ENTRADA_INDICE, 4);
+        for (int k = 0; k < n; k++) {
+            char* entrada = contenido + TAM_CABECERA_INDICE + (long)k * TAM_ENTRADA_INDICE;
+            escribirLE(entrada, arbol[k].clave, 8);
+            escribirLE(entrada + 8, arbol[k].ubicacion.registro, 4);
+            escribirLE(entrada + 12, arbol[k].ubicacion.segmento, 4);
+            escribirLE(entrada + 16, arbol[k].ubicacion.desplazamiento, 8);
+            escribirLE(entrada + 24, arbol[k].ubicacion.longitud, 4);
+        }
+
+        {
+            ofstream archivo(temporal, ios::trunc | ios::binary);
+            if (!archivo.is_open() || !archivo.write(contenido, total))
+                throw "No se pudo escribir el índice.";
+        }
+        if (!reemplazarArchivo(temporal, ruta))
+            throw "No se pudo reemplazar el índice.";
+        ok = true;
+    }
+    catch (const char* e) {
+        cerr << "ERROR en guardarIndicePersistente(): " << e << endl;
+        remove(temporal);
+    }
+
+    delete[] contenido;
+    delete[] arbol;
+    delete[] ordenadas;
+    delete[] ubicaciones;
+    delete[] temporal;
+    delete[] ruta;
+    return ok;
+}
+
+// ============================================================
+//  LECTURA
+// ============================================================
+
+bool abrirIndicePersistente(IndicePersistente& indice, const char* rutaDatos) {
+    cerrarIndicePersistente(indice);
+    char* ruta = new char[longitud(rutaDatos) + 8];
+    rutaIndicePersistente(rutaDatos, ruta);
+    try {
+        abrirMapeo(indice.archivo, ruta);
+    }
+    catch (const char*) {
+        delete[] ruta;
+        return false;
+    }
+    delete[] ruta;
+
+    const char* datos = indice.archivo.datos;
+    long tam = indice.archivo.tamanio;
+    HuellaDatos huella;
+    bool valido = datos != nullptr && tam >= TAM_CABECERA_INDICE;
+    for (int k = 0; valido && k < 4; k++)
+        valido = datos[k] == MAGIA_INDICE[k];
+    valido = valido && (unsigned char)datos[4] == VERSION_INDICE_PERSISTENTE
+             && leerLE(datos + 36, 4) == (uint64_t)TAM_ENTRADA_INDICE
+             && (uint64_t)tam == TAM_CABECERA_INDICE + leerLE(datos + 32, 4) * TAM_ENTRADA_INDICE
+             && tomarHuella(rutaDatos, huella)
+             && leerLE(datos + 8, 8) == huella.generacion
+             && leerLE(datos + 16, 8) == huella.bytes
+             && (int64_t)leerLE(datos + 24, 8) == huella.modificacion;
+    if (!valido) {
+        cerrarMapeo(indice.archivo);
+        return false;
+    }
+
+    indice.numEntradas = (int)leerLE(datos + 32, 4);
+    indice.entradas = datos + TAM_CABECERA_INDICE;
+    return true;
+}
+
+void cerrarIndicePersistente(IndicePersistente& indice) {
+    cerrarMapeo(indice.archivo);
+    indice.entradas = nullptr;
+    indice.numEntradas = 0;
+}
+
+bool buscarEnIndicePersistente(const IndicePersistente& indice, uint64_t clave, UbicacionRegistro& ubicacion) {
+    if (indice.entradas == nullptr || clave == 0) return false;
+
+    // Se baja por el árbol implícito; al salir, los bits finales de k
+    // dicen en qué nodo se giró a la izquierda por última vez, que es el
+    // primero con clave >= la buscada
+    int64_t k = 1;
+    while (k <= indice.numEntradas)
+        k = 2 * k + (leerLE(indice.entradas + (k - 1) * TAM_ENTRADA_INDICE, 8) < clave);
+    while (k & 1) k >>= 1;
+    k >>= 1;
+    if (k == 0) return false;
+
+    const char* entrada = indice.entradas + (k - 1) * TAM_ENTRADA_INDICE;
+    if (leerLE(entrada, 8) != clave) return false;
+    ubicacion.registro = (unsigned int)leerLE(entrada + 8, 4);
+    ubicacion.segmento = (unsigned int)leerLE(entrada + 12, 4);
+    ubicacion.desplazamiento = leerLE(entrada + 16, 8);
+    ubicacion.longitud = (unsigned int)leerLE(entrada + 24, 4);
+    return true;
+}
+
+bool buscarEnIndicePersistente(const IndicePersistente& indice, const char* cedula, UbicacionRegistro& ubicacion) {
+    return buscarEnIndicePersistente(indice, empaquetarCedula(cedula), ubicacion);
+}
+
+bool indicePersistenteVigente(const char* rutaDatos) {
+    IndicePersistente indice;
+    bool vigente = abrirIndicePersistente(indice, rutaDatos);
+    cerrarIndicePersistente(indice);
+    return vigente;
+}
@@ -0,0 +1,119 @@
+#ifndef INDICE_PERSISTENTE_H
+#define INDICE_PERSISTENTE_H
+
+#include <cstdint>
+#include "ArchivoMapeado.h"
+#include "Cuenta.h"
+
+// ===================== ÍNDICE DE CÉDULAS EN DISCO =====================
+//
+// Archivo junto al de usuarios ("<ruta>.indice") para saber si una
+// cédula existe y dónde está su registro sin cargar los datos. Se
+// proyecta en memoria y se busca directamente sobre la proyección.
+//
+// Cabecera (64 bytes, little-endian):
+//   [0..3]   "P3IC"
+//   [4]      versión (VERSION_INDICE_PERSISTENTE)
+//   [5..7]   reservado (0)
+//   [8..15]  generación del almacén (uint64)
+//   [16..23] bytes del archivo de datos (uint64)
+//   [24..31] hora de modificación del archivo de datos (int64)
+//   [32..35] número de entradas (uint32)
+//   [36..39] bytes por entrada (uint32, TAM_ENTRADA_INDICE)
+//   [40..63] reservado (0)
+// Cada entrada (32 bytes):
+//   [0..7]   cédula empaquetada (empaquetarCedula)
+//   [8..11]  posición del registro (uint32)
+//   [12..15] segmento (uint32; 0 si no es un almacén segmentado)
+//   [16..23] desplazamiento del registro en su archivo (uint64)
+//   [24..27] bytes del registro en el archivo (uint32)
+//   [28..31] reservado (0)
+//
+// Las entradas van en orden de Eytzinger (el arreglo ordenado recorrido
+// como un árbol binario por niveles), así los primeros pasos de una
+// búsqueda caen siempre en las mismas pocas líneas de caché.
+//
+// El índice vale solo para los datos con los que se escribió: se guarda
+// la generación del manifiesto (0 en un archivo suelto) y, como un
+// archivo de texto no tiene cabecera donde llevarla, también el tamaño y
+// la hora de modificación del archivo de datos.
+
+const int VERSION_INDICE_PERSISTENTE = 1;
+const int TAM_CABECERA_INDICE = 64;
+const int TAM_ENTRADA_INDICE = 32;
+
+/**
+ * @brief Dónde está el registro de una cédula.
+ */
+struct UbicacionRegistro {
+    unsigned int registro = 0;          /**< Posición entre los registros del almacén */
+    unsigned int segmento = 0;          /**< Segmento (almacén segmentado) */
+    uint64_t desplazamiento = 0;        /**< Byte donde empieza el registro en su archivo */
+    unsigned int longitud = 0;          /**< Bytes del registro en el archivo */
+};
+
+/**
+ * @brief Índice de cédulas proyectado en memoria.
+ */
+struct IndicePersistente {
+    ArchivoMapeado archivo;
+    const char* entradas = nullptr;     /**< Primera entrada (nullptr si está cerrado) */
+    int numEntradas = 0;
+};
+
+/**
+ * @brief Escribe en `destino` la ruta del índice de un almacén.
+ * @param destino Espacio para longitud(rutaDatos) + 8 caracteres.
+ */
+void rutaIndicePersistente(const char* rutaDatos, char* destino);
+
+/**
+ * @brief Escribe el índice de cédulas de un almacén recién guardado.
+ *
+ * Las ubicaciones se calculan con las mismas reglas con las que se
+ * escribió cada formato; si el tamaño resultante no coincide con el de
+ * los archivos (datos editados a mano, por ejemplo) no se escribe nada.
+ * Las cédulas inválidas o repetidas no entran al índice.
+ *
+ * @param rutaDatos Ruta del almacén de usuarios.
+ * @param cuentas Cuentas, en el orden de los registros.
+ * @param lineas Líneas cifradas tal como están en el almacén.
+ * @param numCuentas Cantidad de cuentas y de líneas.
+ * @return true si el índice quedó escrito.
+ */
+bool guardarIndicePersistente(const char* rutaDatos, const Cuenta* cuentas, char** lineas, int numCuentas);
+
+/**
+ * @brief Igual, a partir de las cédulas empaquetadas de cada registro
+ *        (el punto de control no tiene las cuentas en un solo arreglo).
+ */
+bool guardarIndicePersistente(const char* rutaDatos, const uint64_t* cedulas, char** lineas, int numCuentas);
+
+/**
+ * @brief Proyecta el índice de un almacén (cierra antes el que hubiera).
+ * @return false si no existe, está dañado o no corresponde a los datos actuales.
+ */
+bool abrirIndicePersistente(IndicePersistente& indice, const char* rutaDatos);
+
+/**
+ * @brief Libera la proyección del índice.
+ */
+void cerrarIndicePersistente(IndicePersistente& indice);
+
+/**
+ * @brief Busca una cédula empaquetada.
+ * @return true si existe (y entonces `ubicacion` queda completa).
+ */
+bool buscarEnIndicePersistente(const IndicePersistente& indice, uint64_t clave, UbicacionRegistro& ubicacion);
+
+/**
+ * @brief Igual que la anterior, con la cédula en texto.
+ */
+bool buscarEnIndicePersistente(const IndicePersistente& indice, const char* cedula, UbicacionRegistro& ubicacion);
+
+/**
+ * @brief Indica si el índice existe y corresponde a los datos actuales.
+ */
+bool indicePersistenteVigente(const char* rutaDatos);
+
+#endif // INDICE_PERSISTENTE_H
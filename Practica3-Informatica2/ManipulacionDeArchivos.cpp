@@ -1,19 +1,502 @@
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include "AlmacenSegmentado.h"
+#include "ArchivoRanuras.h"
+#include "ConversionSIMD.h"
+#include "ManipulacionDeArchivos.h"
+#include "UtilidadesCadena.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 
+const long MAX_FILE_SIZE = 10000000; // 10 MB por archivo o segmento
+
+/** Primeros bytes de un archivo en formato empaquetado. */
+const char MAGIA_EMPAQUETADO[4] = { 'P', '3', 'C', 'B' };
+
+// ============================================================
+//  LÍNEAS SIN COPIA
+// ============================================================
+
+/**
+ * @brief Agrega una vista al arreglo, duplicando su capacidad si hace falta.
+ */
+static void agregarVista(LineasMapeadas& lineas, const char* inicio, int longitud) {
+    if (lineas.numLineas == lineas.capacidadVistas) {
+        int nueva = lineas.capacidadVistas == 0 ? 16 : lineas.capacidadVistas * 2;
+        VistaLinea* vistas = new VistaLinea[nueva];
+        for (int i = 0; i < lineas.numLineas; i++) vistas[i] = lineas.vistas[i];
+        delete[] lineas.vistas;
+        lineas.vistas = vistas;
+        lineas.capacidadVistas = nueva;
+    }
+    lineas.vistas[lineas.numLineas].inicio = inicio;
+    lineas.vistas[lineas.numLineas].longitud = longitud;
+    lineas.numLineas++;
+}
+
+/**
+ * @brief Agrega al final las líneas no vacías de un archivo suelto.
+ *
+ * Una sola pasada sobre la proyección: memchr() (vectorizada en las
+ * bibliotecas estándar habituales) encuentra cada '\n' y las líneas no
+ * vacías quedan como vistas, sin reservar memoria por línea. Igual que
+ * getline() en modo binario, un '\r' final forma parte de la línea.
+ *
+ * @param rutaArchivo Ruta del archivo (o segmento).
+ * @param lineas Destino; `archivos` debe tener lugar para una proyección más.
+ * @return Cantidad de líneas agregadas, o -1 si hubo un error.
+ * @throws const char* Si el archivo no se puede abrir o está corrupto.
+ */
+static int agregarLineasArchivo(const char* rutaArchivo, LineasMapeadas& lineas) {
+    bool ranuras = esArchivoRanuras(rutaArchivo);
+    if (ranuras || esArchivoEmpaquetado(rutaArchivo)) {
+        int numLineas = 0;
+        char** propias = ranuras ? leerArchivoRanuras(rutaArchivo, numLineas)
+                                 : leerArchivoEmpaquetado(rutaArchivo, numLineas);
+        if (propias == nullptr) return -1;
+
+        char** todas = new char*[lineas.numPropias + numLineas];
+        for (int i = 0; i < lineas.numPropias; i++) todas[i] = lineas.propias[i];
+        for (int i = 0; i < numLineas; i++) {
+            todas[lineas.numPropias + i] = propias[i];
+            agregarVista(lineas, propias[i], longitud(propias[i]));
+        }
+        delete[] lineas.propias;
+        delete[] propias;
+        lineas.propias = todas;
+        lineas.numPropias += numLineas;
+        return numLineas;
+    }
+
+    try {
+        ArchivoMapeado& archivo = lineas.archivos[lineas.numArchivos++];
+        abrirMapeo(archivo, rutaArchivo);
+        const char* datos = archivo.datos;
+        int64_t fileSize = archivo.tamanio;
+        int previas = lineas.numLineas;
+
+        cout << "Leyendo archivo: " << rutaArchivo << " (" << fileSize << " bytes)" << endl;
+
+        if (fileSize > MAX_FILE_SIZE) {
+            throw "Archivo demasiado grande o corrupto.";
+        }
+
+        int64_t pos = 0;
+        while (pos < fileSize) {
+            const char* salto = (const char*)memchr(datos + pos, '\n', (size_t)(fileSize - pos));
+            int64_t fin = salto ? (int64_t)(salto - datos) : fileSize;
+            if (fin > pos) agregarVista(lineas, datos + pos, (int)(fin - pos));
+            pos = fin + 1;
+        }
+
+        int agregadas = lineas.numLineas - previas;
+        if (agregadas == 0) {
+            throw "El archivo está vacío.";
+        }
+
+        cout << "Archivo cargado correctamente: " << agregadas << " registros" << endl << endl;
+        return agregadas;
+    }
+    catch (const char* msg) {
+        cerr << "ERROR en cargarLineasMapeadas(): " << msg << endl;
+        return -1;
+    }
+}
+
+/**
+ * @brief Carga las líneas no vacías de un archivo o almacén como vistas.
+ */
+bool cargarLineasMapeadas(const char* rutaArchivo, LineasMapeadas& lineas) {
+    liberarLineasMapeadas(lineas);
+
+    if (!esManifiestoSegmentado(rutaArchivo)) {
+        lineas.archivos = new ArchivoMapeado[1];
+        if (agregarLineasArchivo(rutaArchivo, lineas) > 0) return true;
+        liberarLineasMapeadas(lineas);
+        return false;
+    }
+
+    ManifiestoAlmacen manifiesto;
+    try {
+        if (!leerManifiesto(rutaArchivo, manifiesto)) {
+            throw "Manifiesto inválido.";
+        }
+        // Las posiciones en memoria siguen siendo int en el resto del sistema
+        if (manifiesto.totalRegistros > 0x7FFFFFFF) {
+            throw "Demasiados registros para cargarlos juntos; use cargarSegmento().";
+        }
+
+        lineas.archivos = new ArchivoMapeado[manifiesto.numSegmentos];
+        char segmento[TAM_MAX_RUTA_SEGMENTO];
+        for (int i = 0; i < manifiesto.numSegmentos; i++) {
+            rutaSegmento(rutaArchivo, manifiesto.generacion, i, segmento);
+            int agregadas = agregarLineasArchivo(segmento, lineas);
+            if (agregadas < 0 || (uint64_t)agregadas != manifiesto.segmentos[i].registros) {
+                throw "Un segmento falta o no coincide con el manifiesto.";
+            }
+        }
+        liberarManifiesto(manifiesto);
+        return true;
+    }
+    catch (const char* msg) {
+        cerr << "ERROR en cargarLineasMapeadas(): " << msg << endl;
+        liberarManifiesto(manifiesto);
+        liberarLineasMapeadas(lineas);
+        return false;
+    }
+}
+
+/**
+ * @brief Copia las vistas a un arreglo de cadenas terminadas en '\0'.
+ */
+char** copiarLineas(const LineasMapeadas& lineas, int& numLineas) {
+    numLineas = lineas.numLineas;
+    if (numLineas == 0) return nullptr;
+
+    char** copia = new char*[numLineas];
+    for (int i = 0; i < numLineas; i++) {
+        copia[i] = new char[lineas.vistas[i].longitud + 1];
+        copiarN(copia[i], lineas.vistas[i].inicio, lineas.vistas[i].longitud);
+        copia[i][lineas.vistas[i].longitud] = '\0';
+    }
+    return copia;
+}
+
+/**
+ * @brief Libera la proyección, las vistas y las líneas propias.
+ */
+void liberarLineasMapeadas(LineasMapeadas& lineas) {
+    for (int i = 0; i < lineas.numPropias; i++) delete[] lineas.propias[i];
+    delete[] lineas.propias;
+    lineas.propias = nullptr;
+    lineas.numPropias = 0;
+    delete[] lineas.vistas;
+    lineas.vistas = nullptr;
+    lineas.numLineas = 0;
+    lineas.capacidadVistas = 0;
+    for (int i = 0; i < lineas.numArchivos; i++) cerrarMapeo(lineas.archivos[i]);
+    delete[] lineas.archivos;
+    lineas.archivos = nullptr;
+    lineas.numArchivos = 0;
+}
+
 /**
  * @brief Lee un archivo y devuelve sus líneas como un arreglo dinámico de cadenas.
  *
- * Cada línea se guarda como un `char*` en un arreglo de punteros (`char**`).
- * Incluye validación de tamaño para evitar cargar archivos corruptos.
+ * Proyecta el archivo y lo recorre una sola vez (ver cargarLineasMapeadas());
+ * cada línea se copia exactamente una vez a su buffer.
  *
  * @param rutaArchivo Ruta del archivo a leer (cadena tipo C).
  * @param numLineas Referencia donde se almacenará el número de líneas leídas.
  * @return char** Arreglo dinámico de líneas, o nullptr si ocurre un error.
- * @throws const char* Si el archivo no se puede abrir o está corrupto.
  */
 char** leerArchivoLineas(const char* rutaArchivo, int& numLineas) {
+    numLineas = 0;
+    LineasMapeadas lineas;
+    if (!cargarLineasMapeadas(rutaArchivo, lineas)) return nullptr;
+
+    char** copia = copiarLineas(lineas, numLineas);
+    liberarLineasMapeadas(lineas);
+    return copia;
+}
+
+/** Trozos por llamada a writev(); IOV_MAX vale 1024 en Linux y macOS. */
+const int TROZOS_POR_ESCRITURA = 1024;
+
+/**
+ * Desde este largo una línea se escribe desde su propio buffer; las más
+ * cortas se copian, porque cada trozo le cuesta al kernel más que copiar
+ * unos pocos bytes.
+ */
+const int TAM_LINEA_DIRECTA = 128;
+
+/** Buffer donde se juntan los separadores y las líneas cortas. */
+const int TAM_BUFFER_COPIAS = 64 * 1024;
+
+#ifndef _WIN32
+/**
+ * @brief Lote de iovec en armado para writev().
+ *
+ * Las líneas largas se apuntan directo, sin copiarlas; los separadores
+ * y las líneas cortas se copian juntos a `copias` y comparten trozo.
+ */
+struct EscrituraReunida {
+    int descriptor = -1;
+    iovec trozos[TROZOS_POR_ESCRITURA];
+    int numTrozos = 0;
+    char copias[TAM_BUFFER_COPIAS];
+    int usados = 0;
+    bool ok = true;
+};
+
+/**
+ * @brief Escribe el lote con writev() y lo deja vacío.
+ */
+static void vaciarEscritura(EscrituraReunida& escritura) {
+    // writev() puede escribir menos de lo pedido: se sigue desde ahí
+    int primero = 0;
+    while (escritura.ok && primero < escritura.numTrozos) {
+        ssize_t escritos = writev(escritura.descriptor, escritura.trozos + primero, escritura.numTrozos - primero);
+        if (escritos < 0) {
+            escritura.ok = false;
+            break;
+        }
+        size_t resto = (size_t)escritos;
+        while (primero < escritura.numTrozos && resto >= escritura.trozos[primero].iov_len)
+            resto -= escritura.trozos[primero++].iov_len;
+        if (resto > 0) {
+            escritura.trozos[primero].iov_base = (char*)escritura.trozos[primero].iov_base + resto;
+            escritura.trozos[primero].iov_len -= resto;
+        }
+    }
+    escritura.numTrozos = 0;
+    escritura.usados = 0;
+}
+
+/**
+ * @brief Agrega `len` bytes al lote (apuntados o copiados según el largo);
+ *        si el lote se llena, lo escribe.
+ */
+static void agregarAEscritura(EscrituraReunida& escritura, const char* datos, int len) {
+    if (len <= 0 || !escritura.ok) return;
+    if (len >= TAM_LINEA_DIRECTA) {
+        if (escritura.numTrozos == TROZOS_POR_ESCRITURA) vaciarEscritura(escritura);
+        escritura.trozos[escritura.numTrozos].iov_base = (char*)datos;
+        escritura.trozos[escritura.numTrozos++].iov_len = len;
+        return;
+    }
+
+    if (escritura.usados + len > TAM_BUFFER_COPIAS) vaciarEscritura(escritura);
+    char* destino = escritura.copias + escritura.usados;
+    iovec* ultimo = escritura.numTrozos > 0 ? &escritura.trozos[escritura.numTrozos - 1] : nullptr;
+    bool contiguo = ultimo != nullptr && (char*)ultimo->iov_base + ultimo->iov_len == destino;
+    if (!contiguo && escritura.numTrozos == TROZOS_POR_ESCRITURA) {
+        vaciarEscritura(escritura);
+        destino = escritura.copias;
+    }
+    copiarN(destino, datos, len);
+    escritura.usados += len;
+    if (contiguo) {
+        ultimo->iov_len += len;
+    } else {
+        escritura.trozos[escritura.numTrozos].iov_base = destino;
+        escritura.trozos[escritura.numTrozos++].iov_len = len;
+    }
+}
+#endif
+
+/**
+ * @brief Escribe las líneas separadas por '\n' en un archivo nuevo.
+ *
+ * En POSIX arma lotes de iovec (EscrituraReunida) y los escribe con unas
+ * pocas llamadas a writev(), sin copiar las líneas largas. En Windows
+ * junta todo en un buffer y lo escribe de una vez.
+ *
+ * @param rutaArchivo Archivo a crear (se trunca si existe).
+ * @param saltoFinal true para terminar también la última línea con '\n'.
+ * @return true si se escribió todo.
+ */
+static bool escribirLineasReunidas(const char* rutaArchivo, char** lineas, int numLineas, bool saltoFinal) {
+#ifdef _WIN32
+    int64_t total = 0;
+    for (int i = 0; i < numLineas; i++) total += longitud(lineas[i]) + 1;
+    char* contenido = new char[total + 1];
+    int64_t pos = 0;
+    for (int i = 0; i < numLineas; i++) {
+        int len = longitud(lineas[i]);
+        copiarN(contenido + pos, lineas[i], len);
+        pos += len;
+        if (saltoFinal || i < numLineas - 1) contenido[pos++] = '\n';
+    }
+
+    bool ok;
+    {
+        ofstream archivo(rutaArchivo, ios::trunc | ios::binary);
+        ok = archivo.is_open() && archivo.write(contenido, pos);
+        if (ok) {
+            archivo.close();
+            ok = !archivo.fail();
+        }
+    }
+    delete[] contenido;
+    return ok;
+#else
+    int descriptor = open(rutaArchivo, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (descriptor < 0) return false;
+
+    EscrituraReunida* escritura = new EscrituraReunida;   // ~80 KB: mejor fuera de la pila
+    escritura->descriptor = descriptor;
+    for (int i = 0; i < numLineas; i++) {
+        agregarAEscritura(*escritura, lineas[i], longitud(lineas[i]));
+        if (saltoFinal || i < numLineas - 1) agregarAEscritura(*escritura, "\n", 1);
+    }
+    vaciarEscritura(*escritura);
+    bool ok = escritura->ok;
+    delete escritura;
+
+    if (close(descriptor) != 0) ok = false;
+    return ok;
+#endif
+}
+
+#ifndef _WIN32
+/**
+ * @brief Abre una ruta y la sincroniza con el disco.
+ *
+ * fsync() sobre cualquier descriptor del archivo baja todo lo que esté
+ * pendiente, así que sirve para archivos escritos con ofstream.
+ */
+static bool sincronizarRuta(const char* ruta, int banderas) {
+    int descriptor = open(ruta, banderas);
+    if (descriptor < 0) return false;
+    bool ok = fsync(descriptor) == 0;
+    if (close(descriptor) != 0) ok = false;
+    return ok;
+}
+#endif
+
+bool reemplazarArchivo(const char* temporal, const char* rutaArchivo) {
+#ifdef _WIN32
+    HANDLE archivo = CreateFileA(temporal, GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    bool ok = archivo != INVALID_HANDLE_VALUE && FlushFileBuffers(archivo);
+    if (archivo != INVALID_HANDLE_VALUE) CloseHandle(archivo);
+    // MOVEFILE_WRITE_THROUGH no vuelve hasta que el cambio de nombre está en disco
+    ok = ok && MoveFileExA(temporal, rutaArchivo, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    // Carpeta del archivo: lo que va antes de la última '/', o "."
+    int largo = longitud(rutaArchivo);
+    int barra = largo - 1;
+    while (barra >= 0 && rutaArchivo[barra] != '/') barra--;
+    char* carpeta = new char[largo + 2];
+    if (barra < 0) {
+        copiar(carpeta, ".");
+    } else {
+        memcpy(carpeta, rutaArchivo, barra == 0 ? 1 : barra);
+        carpeta[barra == 0 ? 1 : barra] = '\0';
+    }
+
+    bool ok = sincronizarRuta(temporal, O_RDONLY)
+              && rename(temporal, rutaArchivo) == 0
+              && sincronizarRuta(carpeta, O_RDONLY | O_DIRECTORY);
+    delete[] carpeta;
+#endif
+    if (!ok) remove(temporal);
+    return ok;
+}
+
+/**
+ * @brief Escribe las líneas en "<ruta>.tmp" y lo reemplaza sobre `rutaArchivo`.
+ *
+ * @return true si el archivo quedó reemplazado.
+ */
+static bool reemplazarConLineas(const char* rutaArchivo, char** lineas, int numLineas, bool saltoFinal) {
+    char* temporal = new char[longitud(rutaArchivo) + 5];
+    copiar(temporal, rutaArchivo);
+    concatenar(temporal, ".tmp");
+
+    bool ok = escribirLineasReunidas(temporal, lineas, numLineas, saltoFinal);
+    if (ok)
+        ok = reemplazarArchivo(temporal, rutaArchivo);   // borra el temporal si falla
+    else
+        remove(temporal);
+
+    delete[] temporal;
+    return ok;
+}
+
+/**
+ * @brief Guarda un arreglo de líneas en un archivo.
+ *
+ * Escribe en "<ruta>.tmp" con escrituras reunidas y lo renombra sobre el
+ * archivo: si se corta a mitad queda el anterior completo.
+ *
+ * @param rutaArchivo Ruta del archivo donde guardar.
+ * @param lineas Arreglo de cadenas a guardar.
+ * @param numLineas Número de líneas en el arreglo.
+ * @param silencioso true para no informar en consola cuando todo sale bien.
+ * @return true si el archivo quedó reemplazado.
+ */
+bool guardarArchivoLineas(const char* rutaArchivo, char** lineas, int numLineas, bool silencioso) {
+    try {
+        if (lineas == nullptr && numLineas > 0) {
+            throw "Arreglo vacío o no inicializado.";
+        }
+        if (!reemplazarConLineas(rutaArchivo, lineas, numLineas, false)) {
+            throw "No se pudo escribir o reemplazar el archivo.";
+        }
+        if (!silencioso)
+            cout << "Archivo guardado: " << rutaArchivo << " (" << numLineas << " registros)" << endl;
+        return true;
+    }
+    catch (const char* msg) {
+        cerr << "ERROR en guardarArchivoLineas(): " << msg << endl;
+        return false;
+    }
+}
+
+// ============================================================
+//  FORMATO EMPAQUETADO
+// ============================================================
+
+/**
+ * @brief Escribe un entero de 32 bits en little-endian.
+ */
+static void escribirEntero32(char* destino, unsigned int valor) {
+    for (int k = 0; k < 4; k++)
+        destino[k] = (char)((valor >> (8 * k)) & 0xFF);
+}
+
+/**
+ * @brief Lee un entero de 32 bits en little-endian.
+ */
+static unsigned int leerEntero32(const char* origen) {
+    unsigned int valor = 0;
+    for (int k = 3; k >= 0; k--)
+        valor = (valor << 8) | (unsigned char)origen[k];
+    return valor;
+}
+
+/**
+ * @brief Compara los primeros 4 bytes con la marca del formato.
+ */
+static bool tieneMagia(const char* datos) {
+    for (int k = 0; k < 4; k++)
+        if (datos[k] != MAGIA_EMPAQUETADO[k]) return false;
+    return true;
+}
+
+/**
+ * @brief Indica si el archivo empieza con la cabecera del formato empaquetado.
+ */
+bool esArchivoEmpaquetado(const char* rutaArchivo) {
+    ifstream archivo(rutaArchivo, ios::binary);
+    char magia[4];
+    if (!archivo.read(magia, 4)) return false;
+    return tieneMagia(magia);
+}
+
+/**
+ * @brief Lee un archivo en formato empaquetado.
+ *
+ * Carga el archivo con una sola lectura y expande cada registro a
+ * '0'/'1': se leen 8 veces menos bytes que con el formato de texto.
+ *
+ * @throws const char* Si la cabecera o algún registro están corruptos.
+ */
+char** leerArchivoEmpaquetado(const char* rutaArchivo, int& numLineas) {
+    char* contenido = nullptr;
+    char** lineas = nullptr;
+    int creadas = 0;
     try {
         ifstream archivo(rutaArchivo, ios::binary);
         if (!archivo.is_open()) {
@@ -21,82 +504,179 @@ char** leerArchivoLineas(const char* rutaArchivo, int& numLineas) {
         }
 
         archivo.seekg(0, ios::end);
-        long fileSize = archivo.tellg();
+        int64_t fileSize = (int64_t)archivo.tellg();
         archivo.seekg(0, ios::beg);
 
-        cout << "Leyendo archivo: " << rutaArchivo << " (" << fileSize << " bytes)" << endl;
+        cout << "Leyendo archivo empaquetado: " << rutaArchivo << " (" << fileSize << " bytes)" << endl;
 
-        const long MAX_FILE_SIZE = 10000000; // 10 MB
         if (fileSize > MAX_FILE_SIZE) {
-            archivo.close();
             throw "Archivo demasiado grande o corrupto.";
         }
+        if (fileSize < TAM_CABECERA_EMPAQUETADO) {
+            throw "Cabecera incompleta.";
+        }
 
-        numLineas = 0;
-        string temp;
-        while (getline(archivo, temp)) {
-            if (!temp.empty()) numLineas++;
+        contenido = new char[fileSize];
+        if (!archivo.read(contenido, fileSize)) {
+            throw "No se pudo leer el archivo completo.";
         }
+        archivo.close();
 
-        if (numLineas == 0) {
-            archivo.close();
-            throw "El archivo está vacío.";
+        if (!tieneMagia(contenido)) {
+            throw "El archivo no está en formato empaquetado.";
+        }
+        if ((unsigned char)contenido[4] != VERSION_FORMATO_EMPAQUETADO) {
+            throw "Versión de formato no soportada.";
         }
 
-        char** lineas = new char*[numLineas];
-        archivo.clear();
-        archivo.seekg(0, ios::beg);
+        unsigned int registros = leerEntero32(contenido + 8);
+        // Cada registro ocupa al menos los 4 bytes de su longitud
+        if (registros == 0 || registros > (unsigned int)((fileSize - TAM_CABECERA_EMPAQUETADO) / 4)) {
+            throw "Número de registros inválido.";
+        }
 
-        int i = 0;
-        while (getline(archivo, temp) && i < numLineas) {
-            if (!temp.empty()) {
-                lineas[i] = new char[temp.size() + 1];
-                copy(temp.begin(), temp.end(), lineas[i]);
-                lineas[i][temp.size()] = '\0';
-                i++;
+        numLineas = (int)registros;
+        lineas = new char*[numLineas];
+
+        int64_t pos = TAM_CABECERA_EMPAQUETADO;
+        for (int i = 0; i < numLineas; i++) {
+            if (pos + 4 > fileSize) {
+                throw "Registro truncado.";
             }
+            unsigned int len = leerEntero32(contenido + pos);
+            pos += 4;
+            if ((int64_t)len > fileSize - pos) {
+                throw "Registro truncado.";
+            }
+
+            lineas[i] = new char[len * 8 + 1];
+            creadas++;
+            expandirBits((const unsigned char*)contenido + pos, (int)len, (unsigned char*)lineas[i]);
+            lineas[i][len * 8] = '\0';
+            pos += len;
         }
 
-        archivo.close();
-        cout << "Archivo cargado correctamente: " << i << " registros" << endl << endl;
+        delete[] contenido;
+        cout << "Archivo cargado correctamente: " << numLineas << " registros" << endl << endl;
         return lineas;
     }
     catch (const char* msg) {
-        cerr << "ERROR en leerArchivoLineas(): " << msg << endl;
+        cerr << "ERROR en leerArchivoEmpaquetado(): " << msg << endl;
+        for (int i = 0; i < creadas; i++) delete[] lineas[i];
+        delete[] lineas;
+        delete[] contenido;
         numLineas = 0;
         return nullptr;
     }
 }
 
 /**
- * @brief Guarda un arreglo de líneas en un archivo.
+ * @brief Guarda líneas binarias en formato empaquetado.
  *
- * Escribe todas las líneas del arreglo en el archivo especificado,
- * sobrescribiendo su contenido anterior.
+ * Arma el archivo completo (cabecera y registros) en un único buffer y
+ * lo escribe con una sola operación.
  *
- * @param rutaArchivo Ruta del archivo donde guardar.
- * @param lineas Arreglo de cadenas a guardar.
- * @param numLineas Número de líneas en el arreglo.
- * @throws const char* Si no se puede abrir el archivo.
+ * @throws const char* Si una línea no es binaria o no se puede escribir.
  */
-void guardarArchivoLineas(const char* rutaArchivo, char** lineas, int numLineas) {
+bool guardarArchivoEmpaquetado(const char* rutaArchivo, char** lineas, int numLineas, bool silencioso) {
+    char* contenido = nullptr;
     try {
-        ofstream archivo(rutaArchivo, ios::trunc | ios::binary);
-        if (!archivo.is_open()) {
-            throw "No se pudo abrir el archivo para escritura.";
+        if (lineas == nullptr || numLineas <= 0) {
+            throw "Arreglo vacío o no inicializado.";
         }
 
+        long total = TAM_CABECERA_EMPAQUETADO;
+        unsigned int registros = 0;
         for (int i = 0; i < numLineas; i++) {
-            archivo << lineas[i];
-            if (i < numLineas - 1) archivo << "\n";
+            int len = longitud(lineas[i]);
+            if (len == 0) continue;
+            if (len % 8 != 0) {
+                throw "Línea con longitud no múltiplo de 8: no se puede empaquetar.";
+            }
+            total += 4 + len / 8;
+            registros++;
+        }
+
+        contenido = new char[total];
+        for (int k = 0; k < TAM_CABECERA_EMPAQUETADO; k++) contenido[k] = 0;
+        for (int k = 0; k < 4; k++) contenido[k] = MAGIA_EMPAQUETADO[k];
+        contenido[4] = (char)VERSION_FORMATO_EMPAQUETADO;
+        escribirEntero32(contenido + 8, registros);
+
+        long pos = TAM_CABECERA_EMPAQUETADO;
+        for (int i = 0; i < numLineas; i++) {
+            int len = longitud(lineas[i]);
+            if (len == 0) continue;
+            escribirEntero32(contenido + pos, (unsigned int)(len / 8));
+            pos += 4;
+            if (!empaquetarBits((const unsigned char*)lineas[i], len, (unsigned char*)contenido + pos)) {
+                throw "Línea con caracteres no binarios: no se puede empaquetar.";
+            }
+            pos += len / 8;
         }
 
+        ofstream archivo(rutaArchivo, ios::trunc | ios::binary);
+        if (!archivo.is_open()) {
+            throw "No se pudo abrir el archivo para escritura.";
+        }
+        if (!archivo.write(contenido, total)) {
+            throw "Error al escribir el archivo.";
+        }
         archivo.close();
-        cout << "Archivo guardado: " << rutaArchivo << " (" << numLineas << " registros)" << endl;
+
+        delete[] contenido;
+        if (!silencioso)
+            cout << "Archivo guardado (empaquetado): " << rutaArchivo << " (" << registros << " registros, " << total << " bytes)" << endl;
+        return true;
     }
     catch (const char* msg) {
-        cerr << "ERROR en guardarArchivoLineas(): " << msg << endl;
+        cerr << "ERROR en guardarArchivoEmpaquetado(): " << msg << endl;
+        delete[] contenido;
+        return false;
+    }
+}
+
+/**
+ * @brief Convierte un archivo del formato de texto al empaquetado.
+ */
+bool migrarArchivoEmpaquetado(const char* rutaArchivo) {
+    if (esAlmacenEmpaquetado(rutaArchivo)) {
+        cout << "El archivo ya está empaquetado: " << rutaArchivo << endl;
+        return true;
+    }
+
+    int numLineas = 0;
+    char** lineas = leerArchivoLineas(rutaArchivo, numLineas);
+    if (lineas == nullptr) return false;
+
+    if (esManifiestoSegmentado(rutaArchivo)) {
+        // guardarSegmentado() ya reemplaza el manifiesto de forma atómica
+        bool ok = guardarSegmentado(rutaArchivo, lineas, numLineas, true);
+        for (int i = 0; i < numLineas; i++) delete[] lineas[i];
+        delete[] lineas;
+        return ok;
+    }
+
+    char* temporal = new char[longitud(rutaArchivo) + 5];
+    copiar(temporal, rutaArchivo);
+    concatenar(temporal, ".tmp");
+
+    bool ok = guardarArchivoEmpaquetado(temporal, lineas, numLineas);
+    for (int i = 0; i < numLineas; i++) delete[] lineas[i];
+    delete[] lineas;
+
+    if (ok && !reemplazarArchivo(temporal, rutaArchivo)) {
+        cerr << "ERROR en migrarArchivoEmpaquetado(): no se pudo reemplazar " << rutaArchivo << endl;
+        ok = false;
+    }
+    if (!ok) {
+        remove(temporal);
+    } else {
+        cout << "Archivo migrado al formato empaquetado: " << rutaArchivo << endl;
     }
+
+    delete[] temporal;
+    return ok;
 }
 
 /**
@@ -105,16 +685,10 @@ void guardarArchivoLineas(const char* rutaArchivo, char** lineas, int numLineas)
  */
 void guardarUsuariosEnArchivo(char** usuarios, int numUsuarios, const char* ruta) {
     try {
-        ofstream archivo(ruta, ios::trunc);
-        if (!archivo.is_open()) {
-            throw "No se pudo abrir el archivo de usuarios.";
-        }
-
-        for (int i = 0; i < numUsuarios; i++) {
-            archivo << usuarios[i] << "\n";
+        // Misma escritura que guardarArchivoLineas(), con '\n' también al final
+        if (!reemplazarConLineas(ruta, usuarios, numUsuarios, true)) {
+            throw "No se pudo escribir el archivo de usuarios.";
         }
-
-        archivo.close();
         cout << "Archivo guardado: " << numUsuarios << " usuarios" << endl;
     }
     catch (const char* msg) {
@@ -5,6 +5,7 @@
 #include <fstream>
 #include <string>
 #include <algorithm>
+#include "ArchivoMapeado.h"
 using namespace std;
 
 /**
@@ -12,6 +13,7 @@ using namespace std;
  *
  * Cada línea se guarda como un `char*` en un arreglo de punteros (`char**`).
  * Incluye validación de tamaño para evitar cargar archivos corruptos.
+ * Equivale a cargarLineasMapeadas() seguido de copiarLineas().
  *
  * @param rutaArchivo Ruta del archivo a leer (cadena tipo C).
  * @param numLineas Referencia donde se almacenará el número de líneas leídas.
@@ -19,17 +21,142 @@ using namespace std;
  */
 char** leerArchivoLineas(const char* rutaArchivo, int& numLineas);
 
+// ===================== LÍNEAS SIN COPIA =====================
+
+/**
+ * @brief Líneas de un archivo vistas sin copiarlas.
+ *
+ * Con el formato de texto cada vista apunta a la proyección del archivo;
+ * con el empaquetado, a las líneas expandidas en `propias`. Un almacén
+ * segmentado aporta una proyección (o sus líneas propias) por segmento.
+ * Las vistas valen hasta liberarLineasMapeadas().
+ */
+struct LineasMapeadas {
+    ArchivoMapeado* archivos = nullptr; /**< Proyecciones (formato de texto) */
+    int numArchivos = 0;                /**< Proyecciones abiertas */
+    char** propias = nullptr;           /**< Líneas expandidas (formato empaquetado) */
+    int numPropias = 0;                 /**< Cantidad de líneas propias */
+    VistaLinea* vistas = nullptr;       /**< Una vista por línea no vacía */
+    int numLineas = 0;                  /**< Cantidad de vistas */
+    int capacidadVistas = 0;            /**< Espacio reservado en `vistas` */
+};
+
+/**
+ * @brief Carga las líneas no vacías de un archivo como vistas, sin copiarlas.
+ *
+ * Proyecta el archivo y lo recorre una sola vez buscando los saltos de
+ * línea con memchr(). Si el archivo está en formato empaquetado usa
+ * leerArchivoEmpaquetado(). Si la ruta es el manifiesto de un almacén
+ * segmentado carga los segmentos uno tras otro: el límite de tamaño se
+ * aplica a cada segmento y no al total.
+ *
+ * @param rutaArchivo Ruta del archivo a leer.
+ * @param lineas Destino (se libera antes lo que tuviera).
+ * @return true si se cargó al menos una línea.
+ */
+bool cargarLineasMapeadas(const char* rutaArchivo, LineasMapeadas& lineas);
+
+/**
+ * @brief Copia las vistas a un arreglo de cadenas modificable.
+ *
+ * @param lineas Líneas cargadas con cargarLineasMapeadas().
+ * @param numLineas Referencia donde se almacenará el número de líneas.
+ * @return char** Arreglo dinámico de líneas terminadas en '\0'.
+ */
+char** copiarLineas(const LineasMapeadas& lineas, int& numLineas);
+
+/**
+ * @brief Libera la proyección, las vistas y las líneas propias.
+ * @param lineas Líneas a liberar (quedan vacías y reutilizables).
+ */
+void liberarLineasMapeadas(LineasMapeadas& lineas);
+
 /**
  * @brief Guarda un arreglo de líneas en un archivo.
  *
- * Escribe todas las líneas del arreglo en el archivo especificado,
- * sobrescribiendo su contenido anterior.
+ * Reemplaza el archivo de forma atómica (temporal y reemplazarArchivo());
+ * las líneas se escriben con escrituras reunidas (writev) sin copiarlas.
  *
  * @param rutaArchivo Ruta del archivo donde guardar.
  * @param lineas Arreglo de cadenas a guardar.
  * @param numLineas Número de líneas en el arreglo.
+ * @param silencioso true para no informar en consola cuando todo sale bien.
+ * @return true si el archivo quedó reemplazado.
+ */
+bool guardarArchivoLineas(const char* rutaArchivo, char** lineas, int numLineas, bool silencioso = false);
+
+/**
+ * @brief Reemplaza un archivo por su temporal de forma durable.
+ *
+ * Sincroniza el temporal con el disco, lo renombra sobre `rutaArchivo`
+ * y sincroniza la carpeta para que el rename() tampoco se pierda en un
+ * corte de energía. Lo que el archivo nuevo deja obsoleto (la bitácora,
+ * una generación anterior) solo se borra después de que vuelve true.
+ * Si falla, borra el temporal.
+ *
+ * @param temporal Archivo ya escrito y cerrado.
+ * @param rutaArchivo Archivo que se reemplaza.
+ * @return true si el archivo nuevo quedó en disco con su nombre final.
+ */
+bool reemplazarArchivo(const char* temporal, const char* rutaArchivo);
+
+// ===================== FORMATO EMPAQUETADO =====================
+//
+// Cabecera de 12 bytes seguida de los registros:
+//   [0..3]  "P3CB"
+//   [4]     versión del formato (VERSION_FORMATO_EMPAQUETADO)
+//   [5..7]  reservado (0)
+//   [8..11] número de registros (entero de 32 bits, little-endian)
+// Cada registro: longitud en bytes (32 bits, little-endian) y los bytes
+// cifrados, 8 bits por byte en lugar de 8 caracteres '0'/'1'.
+
+const int VERSION_FORMATO_EMPAQUETADO = 1;
+const int TAM_CABECERA_EMPAQUETADO = 12;
+
+/**
+ * @brief Indica si el archivo empieza con la cabecera del formato empaquetado.
+ * @param rutaArchivo Ruta del archivo.
+ * @return true si el archivo está en formato empaquetado.
+ */
+bool esArchivoEmpaquetado(const char* rutaArchivo);
+
+/**
+ * @brief Lee un archivo en formato empaquetado.
+ *
+ * Devuelve cada registro expandido a '0'/'1', igual que leerArchivoLineas()
+ * con el formato de texto.
+ *
+ * @param rutaArchivo Ruta del archivo a leer.
+ * @param numLineas Referencia donde se almacenará el número de registros.
+ * @return char** Arreglo dinámico de líneas, o nullptr si ocurre un error.
+ */
+char** leerArchivoEmpaquetado(const char* rutaArchivo, int& numLineas);
+
+/**
+ * @brief Guarda líneas binarias ('0'/'1') en formato empaquetado.
+ *
+ * Las líneas vacías se omiten; las demás deben ser binarias y de
+ * longitud múltiplo de 8.
+ *
+ * @param rutaArchivo Ruta del archivo donde guardar.
+ * @param lineas Arreglo de líneas binarias.
+ * @param numLineas Número de líneas en el arreglo.
+ * @param silencioso true para no informar en consola cuando todo sale bien.
+ * @return true si el archivo se escribió completo.
+ */
+bool guardarArchivoEmpaquetado(const char* rutaArchivo, char** lineas, int numLineas, bool silencioso = false);
+
+/**
+ * @brief Convierte un archivo del formato de texto al empaquetado.
+ *
+ * Escribe un archivo temporal y lo renombra sobre el original. Si el
+ * archivo ya está empaquetado no hace nada. Un almacén segmentado se
+ * reescribe con segmentos empaquetados.
+ *
+ * @param rutaArchivo Ruta del archivo a convertir.
+ * @return true si el archivo queda en formato empaquetado.
  */
-void guardarArchivoLineas(const char* rutaArchivo, char** lineas, int numLineas);
+bool migrarArchivoEmpaquetado(const char* rutaArchivo);
 
 /**
  * @brief Guarda el arreglo de usuarios en un archivo de texto plano.
@@ -1,5 +1,5 @@
 #include <iostream>
-#include "menu.h"
+#include "Menu.h"
 #include "UtilidadesCadena.h"
 #include "OperacionesUsuario.h"
 #include "Validaciones.h"  // Para validaciones de cédula, clave, saldo
@@ -7,33 +7,39 @@
 using namespace std;
 
 /**
- * @brief Maneja el flujo del menú de administrador con manejo básico de errores usando excepciones tipo C-string.
+ * @brief Pide cédula y clave de administrador y las verifica.
  */
-void menuAdministrador(char**& usuarios, int& numUsuarios, char** admins, int numAdmins) {
-    try {
-        char cedulaAdmin[50], claveIngresada[50];
-        cout << "\n=================================\n";
-        cout << "    ACCESO ADMINISTRADOR\n";
-        cout << "=================================\n";
-        cout << "Cedula de administrador: ";
-        cin >> cedulaAdmin;
-
-        bool valido = false;
-        for (int i = 0; i < numAdmins; i++) {
-            char cedulaArchivo[50], claveArchivo[50];
-            extraerCedulaYClave(admins[i], cedulaArchivo, sizeof(cedulaArchivo), claveArchivo, sizeof(claveArchivo));
-
-            if (cadenasIguales(cedulaArchivo, cedulaAdmin)) {
-                cout << "Contrasena: ";
-                cin >> claveIngresada;
-                if (cadenasIguales(claveArchivo, claveIngresada)) {
-                    valido = true;
-                }
-                break;
-            }
+bool autenticarAdministrador(char** admins, int numAdmins, const IndiceCedulas& indiceAdmins) {
+    char cedulaAdmin[50], claveIngresada[50];
+    cout << "\n=================================\n";
+    cout << "    ACCESO ADMINISTRADOR\n";
+    cout << "=================================\n";
+    cout << "Cedula de administrador: ";
+    cin >> cedulaAdmin;
+
+    bool valido = false;
+    int posAdmin = buscarCedula(indiceAdmins, cedulaAdmin);
+    if (posAdmin >= 0 && posAdmin < numAdmins) {
+        char cedulaArchivo[50], claveArchivo[50];
+        extraerCedulaYClave(admins[posAdmin], cedulaArchivo, sizeof(cedulaArchivo), claveArchivo, sizeof(claveArchivo));
+
+        cout << "Contrasena: ";
+        cin >> claveIngresada;
+        if (cadenasIguales(claveArchivo, claveIngresada)) {
+            valido = true;
         }
+    }
+    return valido;
+}
 
-        if (!valido) throw "Credenciales invalidas.";
+/**
+ * @brief Maneja el flujo del menú de administrador con manejo básico de errores usando excepciones tipo C-string.
+ */
+void menuAdministrador(ListaCuentas& usuarios, char** admins, int numAdmins,
+                       IndiceCedulas& indiceUsuarios, const IndiceCedulas& indiceAdmins,
+                       AlModificarCuenta alModificar, void* contexto) {
+    try {
+        if (!autenticarAdministrador(admins, numAdmins, indiceAdmins)) throw "Credenciales invalidas.";
 
         // Registro de nuevo usuario
         char cedula[50], clave[50], nombre[100], saldoStr[50];
@@ -52,11 +58,7 @@ void menuAdministrador(char**& usuarios, int& numUsuarios, char** admins, int nu
         } while (!validarCedula(cedula));
 
         // Verificar duplicado
-        for (int i = 0; i < numUsuarios; i++) {
-            char cedulaUsr[50], claveUsr[50];
-            extraerCedulaYClave(usuarios[i], cedulaUsr, sizeof(cedulaUsr), claveUsr, sizeof(claveUsr));
-            if (cadenasIguales(cedulaUsr, cedula)) throw "Ya existe un usuario con esa cedula.";
-        }
+        if (buscarCedula(indiceUsuarios, cedula) >= 0) throw "Ya existe un usuario con esa cedula.";
 
         // ===== Validar CONTRASEÑA =====
         do {
@@ -85,30 +87,19 @@ void menuAdministrador(char**& usuarios, int& numUsuarios, char** admins, int nu
 
         saldoInicial = atoi(saldoStr);
 
-        // Crear línea "cedula,clave,nombre,saldo COP"
-        char* nuevoUsuario = new char[300];
-        nuevoUsuario[0] = '\0';
-        concatenar(nuevoUsuario, cedula);
-        concatenar(nuevoUsuario, ",");
-        concatenar(nuevoUsuario, clave);
-        concatenar(nuevoUsuario, ",");
-        concatenar(nuevoUsuario, nombre);
-        concatenar(nuevoUsuario, ",");
-        concatenar(nuevoUsuario, saldoStr);
-        concatenar(nuevoUsuario, " COP");
-
-        // Expandir arreglo
-        char** nuevosUsuarios = new char*[numUsuarios + 1];
-        for (int i = 0; i < numUsuarios; i++) {
-            nuevosUsuarios[i] = usuarios[i];
-        }
-        nuevosUsuarios[numUsuarios] = nuevoUsuario;
+        // Crear la cuenta (la línea "cedula,clave,nombre,saldo COP" se arma al guardar)
+        Cuenta nuevoUsuario;
+        if (!crearCuenta(cedula, clave, nombre, saldoInicial, nuevoUsuario))
+            throw "La clave no puede tener comas y el nombre debe ser mas corto.";
+        nuevoUsuario.modificada = true;   // aún no tiene texto cifrado
 
-        delete[] usuarios;
-        usuarios = nuevosUsuarios;
-        numUsuarios++;
+        // Agregar al final (la lista crece al doble: no se copian las demás cuentas)
+        int posicion = agregarCuenta(usuarios, nuevoUsuario);
+        insertarCedula(indiceUsuarios, nuevoUsuario.cedula, posicion);
 
         cout << "\n Usuario agregado correctamente (en memoria).\n";
+        if (alModificar != nullptr)
+            alModificar(posicion, nuevoUsuario.saldo, MOTIVO_ALTA, contexto);
     }
     catch (const char* msg) {
         cerr << "\n[ERROR ADMINISTRADOR]: " << msg << "\n";
@@ -118,7 +109,8 @@ void menuAdministrador(char**& usuarios, int& numUsuarios, char** admins, int nu
 /**
  * @brief Menú de usuario con manejo básico de errores mediante excepciones tipo C-string.
  */
-void menuUsuario(char** usuarios, int numUsuarios) {
+void menuUsuario(ListaCuentas& usuarios, const IndiceCedulas& indiceUsuarios,
+                 AlModificarCuenta alModificar, void* contexto) {
     try {
         char cedula[50], claveIngresada[50];
 
@@ -130,60 +122,59 @@ void menuUsuario(char** usuarios, int numUsuarios) {
         cout << "Clave: ";
         cin >> claveIngresada;
 
-        bool encontrado = false;
-        for (int i = 0; i < numUsuarios; i++) {
-            char cedulaArchivo[100], claveArchivo[100];
-            extraerCedulaYClave(usuarios[i], cedulaArchivo, sizeof(cedulaArchivo), claveArchivo, sizeof(claveArchivo));
-
-            if (cadenasIguales(cedulaArchivo, cedula)) {
-                if (!cadenasIguales(claveArchivo, claveIngresada))
-                    throw "Clave incorrecta.";
-                encontrado = true;
-
-                bool continuar = true;
-                while (continuar) {
-                    int opcion;
-                    cout << "\n=================================\n";
-                    cout << "    OPERACIONES DISPONIBLES\n";
-                    cout << "=================================\n";
-                    cout << "1. Consultar saldo (Costo: 1000 COP)\n";
-                    cout << "2. Retirar dinero (Costo: 1000 COP + monto)\n";
-                    cout << "3. Volver al menu principal\n";
-                    cout << "=================================\n";
-                    cout << "Opcion: ";
-
-                    if (!(cin >> opcion)) {
-                        cin.clear();
-                        cin.ignore(10000, '\n');
-                        cout << "\n Entrada invalida. Ingrese un numero.\n";
-                        continue;
-                    }
-
-                    switch (opcion) {
-                    case 1:
-                        consultarSaldoUsuario(usuarios, numUsuarios, cedula);
-                        break;
-                    case 2: {
-                        int monto;
-                        cout << "\nMonto a retirar: ";
-                        cin >> monto;
-                        if (monto <= 0)
-                            throw "El monto debe ser mayor a cero.";
-                        modificarDineroUsuario(usuarios, numUsuarios, cedula, monto);
-                        break;
-                    }
-                    case 3:
-                        cout << "\n Volviendo al menu principal...\n";
-                        continuar = false;
-                        break;
-                    default:
-                        cout << "\n Opcion invalida.\n";
-                    }
-                }
+        int i = buscarCedula(indiceUsuarios, cedula);
+        if (i < 0 || i >= usuarios.cantidad) throw "Cedula no encontrada en el sistema.";
+
+        if (!cadenasIguales(usuarios.datos[i].clave, claveIngresada))
+            throw "Clave incorrecta.";
+
+        bool continuar = true;
+        while (continuar) {
+            int opcion;
+            cout << "\n=================================\n";
+            cout << "    OPERACIONES DISPONIBLES\n";
+            cout << "=================================\n";
+            cout << "1. Consultar saldo (Costo: 1000 COP)\n";
+            cout << "2. Retirar dinero (Costo: 1000 COP + monto)\n";
+            cout << "3. Volver al menu principal\n";
+            cout << "=================================\n";
+            cout << "Opcion: ";
+
+            if (!(cin >> opcion)) {
+                cin.clear();
+                cin.ignore(10000, '\n');
+                cout << "\n Entrada invalida. Ingrese un numero.\n";
+                continue;
+            }
+
+            int64_t saldoAntes = usuarios.datos[i].saldo;
+            MotivoCambio motivo = MOTIVO_CONSULTA;
+
+            switch (opcion) {
+            case 1:
+                consultarSaldoUsuario(usuarios.datos, usuarios.cantidad, indiceUsuarios, cedula);
+                break;
+            case 2: {
+                int monto;
+                cout << "\nMonto a retirar: ";
+                cin >> monto;
+                if (monto <= 0)
+                    throw "El monto debe ser mayor a cero.";
+                modificarDineroUsuario(usuarios.datos, usuarios.cantidad, indiceUsuarios, cedula, monto);
+                motivo = MOTIVO_RETIRO;
+                break;
+            }
+            case 3:
+                cout << "\n Volviendo al menu principal...\n";
+                continuar = false;
                 break;
+            default:
+                cout << "\n Opcion invalida.\n";
             }
+
+            if (alModificar != nullptr && usuarios.datos[i].saldo != saldoAntes)
+                alModificar(i, usuarios.datos[i].saldo - saldoAntes, motivo, contexto);
         }
-        if (!encontrado) throw "Cedula no encontrada en el sistema.";
     }
     catch (const char* msg) {
         cerr << "\n[ERROR USUARIO]: " << msg << "\n";
@@ -193,7 +184,9 @@ void menuUsuario(char** usuarios, int numUsuarios) {
 /**
  * @brief Menú principal del sistema bancario, con manejo de errores básicos.
  */
-void menuPrincipal(char**& usuarios, int& numUsuarios, char** admins, int numAdmins) {
+void menuPrincipal(ListaCuentas& usuarios, char** admins, int numAdmins,
+                   IndiceCedulas& indiceUsuarios, const IndiceCedulas& indiceAdmins,
+                   AlModificarCuenta alModificar, void* contexto) {
     int opcion;
     do {
         try {
@@ -214,10 +207,10 @@ void menuPrincipal(char**& usuarios, int& numUsuarios, char** admins, int numAdm
 
             switch (opcion) {
             case 1:
-                menuAdministrador(usuarios, numUsuarios, admins, numAdmins);
+                menuAdministrador(usuarios, admins, numAdmins, indiceUsuarios, indiceAdmins, alModificar, contexto);
                 break;
             case 2:
-                menuUsuario(usuarios, numUsuarios);
+                menuUsuario(usuarios, indiceUsuarios, alModificar, contexto);
                 break;
             case 3:
                 cout << "\n Gracias por usar el sistema. Hasta pronto!\n";
@@ -2,9 +2,21 @@
 #define MENU_H
 
 #include "UtilidadesCadena.h"
+#include "Cuenta.h"
 #include "OperacionesUsuario.h"
+#include "IndiceCedulas.h"
 #include "ManipulacionDeArchivos.h"
 
+/**
+ * @brief Aviso de que la cuenta `indice` cambio (saldo o registro nuevo).
+ *
+ * Se llama apenas termina la operacion con el cambio de saldo (`delta`,
+ * o el saldo inicial en un alta) y su motivo. La cuenta queda marcada
+ * como modificada; quien la persista completa en el momento puede
+ * limpiar la marca. `contexto` es el puntero que se paso al menu.
+ */
+typedef void (*AlModificarCuenta)(int indice, int64_t delta, MotivoCambio motivo, void* contexto);
+
 /**
  * @brief Elimina espacios, tabs, CR, LF al inicio y al final de una cadena (in-place).
  *
@@ -29,19 +41,34 @@ void trim(char* s);
  */
 void extraerCedulaYClave(const char* linea, char* cedula, int maxCedula, char* clave, int maxClave);
 
+/**
+ * @brief Pide por consola cedula y clave de administrador y las verifica.
+ *
+ * @param admins Arreglo de administradores.
+ * @param numAdmins Numero de administradores.
+ * @param indiceAdmins Indice de cedulas de administradores.
+ * @return true si las credenciales son correctas.
+ */
+bool autenticarAdministrador(char** admins, int numAdmins, const IndiceCedulas& indiceAdmins);
+
 /**
  * @brief Menu de administrador para registrar nuevos usuarios.
  *
- * Solicita credenciales de administrador, las valida contra el arreglo de admins,
+ * Solicita credenciales de administrador, las valida contra el indice de admins,
  * y si son correctas, permite agregar un nuevo usuario al sistema.
- * El nuevo usuario se agrega al arreglo dinamico y se guarda en el archivo.
+ * La nueva cuenta se agrega al arreglo dinamico y se guarda al salir.
  *
- * @param usuarios Arreglo de usuarios (se modifica por referencia si se anade un usuario).
- * @param numUsuarios Numero de usuarios (se incrementa si se anade uno nuevo).
+ * @param usuarios Cuentas de usuarios (la nueva se agrega al final).
  * @param admins Arreglo de administradores para validacion de acceso.
  * @param numAdmins Numero de administradores en el sistema.
+ * @param indiceUsuarios Indice de cedulas de usuarios (se actualiza al registrar).
+ * @param indiceAdmins Indice de cedulas de administradores.
+ * @param alModificar Aviso opcional con la posicion del usuario registrado.
+ * @param contexto Dato que se pasa tal cual a `alModificar`.
  */
-void menuAdministrador(char**& usuarios, int& numUsuarios, char** admins, int numAdmins);
+void menuAdministrador(ListaCuentas& usuarios, char** admins, int numAdmins,
+                       IndiceCedulas& indiceUsuarios, const IndiceCedulas& indiceAdmins,
+                       AlModificarCuenta alModificar = nullptr, void* contexto = nullptr);
 
 /**
  * @brief Menu de usuario para consultas y retiros.
@@ -52,10 +79,13 @@ void menuAdministrador(char**& usuarios, int& numUsuarios, char** admins, int nu
  * - Retirar dinero (con costo de transaccion de 1000 COP)
  * - Volver al menu principal
  *
- * @param usuarios Arreglo de usuarios.
- * @param numUsuarios Numero de usuarios en el sistema.
+ * @param usuarios Cuentas de usuarios.
+ * @param indiceUsuarios Indice de cedulas de usuarios.
+ * @param alModificar Aviso opcional cuando una operacion cambia el saldo.
+ * @param contexto Dato que se pasa tal cual a `alModificar`.
  */
-void menuUsuario(char** usuarios, int numUsuarios);
+void menuUsuario(ListaCuentas& usuarios, const IndiceCedulas& indiceUsuarios,
+                 AlModificarCuenta alModificar = nullptr, void* contexto = nullptr);
 
 /**
  * @brief Menu principal del sistema bancario.
@@ -67,11 +97,16 @@ void menuUsuario(char** usuarios, int numUsuarios);
  *
  * Incluye validacion de entrada y manejo de errores.
  *
- * @param usuarios Arreglo de usuarios (se puede modificar desde submenu de admin).
- * @param numUsuarios Numero de usuarios (se puede modificar desde submenu de admin).
+ * @param usuarios Cuentas de usuarios (crece desde el submenu de admin).
  * @param admins Arreglo de administradores.
  * @param numAdmins Numero de administradores.
+ * @param indiceUsuarios Indice de cedulas de usuarios.
+ * @param indiceAdmins Indice de cedulas de administradores.
+ * @param alModificar Aviso opcional cada vez que cambia una cuenta.
+ * @param contexto Dato que se pasa tal cual a `alModificar`.
  */
-void menuPrincipal(char**& usuarios, int& numUsuarios, char** admins, int numAdmins);
+void menuPrincipal(ListaCuentas& usuarios, char** admins, int numAdmins,
+                   IndiceCedulas& indiceUsuarios, const IndiceCedulas& indiceAdmins,
+                   AlModificarCuenta alModificar = nullptr, void* contexto = nullptr);
 
 #endif // MENU_H
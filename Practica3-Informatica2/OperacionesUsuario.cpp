@@ -1,4 +1,5 @@
 #include "UtilidadesCadena.h"
+#include "OperacionesUsuario.h"
 #include <iostream>
 using namespace std;
 
@@ -40,93 +41,72 @@ void extraerCedulaYClave(const char* linea, char* cedula, int maxCedula, char* c
     clave[j] = '\0';
 }
 
+// ==================================================
+// OPERACIONES SIN CONSOLA
+// ==================================================
+
+int64_t cobrarConsulta(Cuenta& cuenta) {
+    if (cuenta.saldo < COSTO_CONSULTA)
+        return 0;
+    cuenta.saldo -= COSTO_CONSULTA;
+    cuenta.modificada = true;
+    return COSTO_CONSULTA;
+}
+
+bool aplicarRetiro(Cuenta& cuenta, int montoRetiro) {
+    int64_t montoTotal = (int64_t)montoRetiro + COSTO_RETIRO;
+    if (montoRetiro <= 0 || cuenta.saldo < montoTotal)
+        return false;
+    cuenta.saldo -= montoTotal;
+    cuenta.modificada = true;
+    return true;
+}
+
 // ==================================================
 // CONSULTAR SALDO DE USUARIO
 // ==================================================
 
 /**
- * @brief Busca una cédula en la lista de usuarios y muestra su saldo.
+ * @brief Busca una cédula en el índice de usuarios y muestra su saldo.
  *
  * Si el usuario existe, cobra un costo fijo de consulta de 1000 COP y
  * actualiza el saldo en memoria. Si no existe, muestra un mensaje de error.
  *
- * @param lineas Arreglo de líneas con los datos de los usuarios.
- * @param numUsuarios Número total de usuarios en el arreglo.
+ * @param cuentas Arreglo de cuentas de los usuarios.
+ * @param numUsuarios Número total de cuentas en el arreglo.
+ * @param indice Índice de cédulas de `cuentas`.
  * @param cedulaBuscada Cédula del usuario a consultar.
  * @return `true` si se encontró y actualizó el saldo correctamente.
  * @return `false` si ocurrió un error o la cédula no existe.
  *
- * @throw const char* Si hay errores de punteros nulos o de separación de campos.
+ * @throw const char* Si hay errores de punteros nulos.
  */
-bool consultarSaldoUsuario(char** lineas, int numUsuarios, const char* cedulaBuscada) {
-    const int COSTO_CONSULTA = 1000;
-
+bool consultarSaldoUsuario(Cuenta* cuentas, int numUsuarios, const IndiceCedulas& indice, const char* cedulaBuscada) {
     try {
-        if (!lineas || numUsuarios <= 0 || !cedulaBuscada)
+        if (!cuentas || numUsuarios <= 0 || !cedulaBuscada)
             throw "Datos de entrada inválidos en consultarSaldoUsuario.";
 
-        for (int i = 0; i < numUsuarios; i++) {
-            // Comparar cédula hasta la coma
-            int j = 0;
-            while (cedulaBuscada[j] != '\0' && lineas[i][j] == cedulaBuscada[j]) j++;
-            if (cedulaBuscada[j] != '\0' || lineas[i][j] != ',') continue;
-
-            // Separar los campos de la línea
-            char* cedula; char* clave; char* nombre; char* dinero;
-            separarLinea(lineas[i], cedula, clave, nombre, dinero);
-
-            if (!dinero) throw "El campo dinero no se pudo separar correctamente.";
-
-            // Convertir dinero a entero
-            int saldo = 0;
-            int k = 0;
-            while (dinero[k] >= '0' && dinero[k] <= '9') {
-                saldo = saldo * 10 + (dinero[k] - '0');
-                k++;
-            }
+        // Buscar la cédula en el índice
+        int i = buscarCedula(indice, cedulaBuscada);
+        if (i >= 0 && i < numUsuarios) {
+            Cuenta& cuenta = cuentas[i];
+            char cedula[TAM_TEXTO_CEDULA];
+            desempaquetarCedula(cuenta.cedula, cedula);
 
             // Mostrar información
             cout << "\n=================================\n";
             cout << "  CONSULTA DE SALDO\n";
             cout << "=================================\n";
-            cout << "Usuario: " << nombre << endl;
+            cout << "Usuario: " << cuenta.nombre << endl;
             cout << "Cédula: " << cedula << endl;
-            cout << "Saldo actual: " << saldo << " COP" << endl;
+            cout << "Saldo actual: " << cuenta.saldo << " COP" << endl;
             cout << "Costo de consulta: " << COSTO_CONSULTA << " COP" << endl;
 
-            if (saldo < COSTO_CONSULTA) {
+            if (cobrarConsulta(cuenta) == 0)
                 cout << "\nAdvertencia: Fondos insuficientes para cobrar la consulta.\n";
-            } else {
-                saldo -= COSTO_CONSULTA;
-            }
 
-            cout << "Saldo después de consulta: " << saldo << " COP\n";
+            cout << "Saldo después de consulta: " << cuenta.saldo << " COP\n";
             cout << "=================================\n\n";
-
-            // Actualizar línea con nuevo saldo
-            delete[] lineas[i];
-            char nuevoDinero[50];
-            int idx = 0, temp = saldo;
-            char rev[20];
-            int rpos = 0;
-            if (temp == 0) rev[rpos++] = '0';
-            while (temp > 0) rev[rpos++] = (temp % 10) + '0', temp /= 10;
-            for (int t = rpos - 1; t >= 0; t--) nuevoDinero[idx++] = rev[t];
-            nuevoDinero[idx++] = ' '; nuevoDinero[idx++] = 'C'; nuevoDinero[idx++] = 'O'; nuevoDinero[idx++] = 'P';
-            nuevoDinero[idx] = '\0';
-
-            int newLen = longitud(cedula) + longitud(clave) + longitud(nombre) + longitud(nuevoDinero) + 4;
-            lineas[i] = new char[newLen];
-            lineas[i][0] = '\0';
-            concatenar(lineas[i], cedula);
-            concatenar(lineas[i], ",");
-            concatenar(lineas[i], clave);
-            concatenar(lineas[i], ",");
-            concatenar(lineas[i], nombre);
-            concatenar(lineas[i], ",");
-            concatenar(lineas[i], nuevoDinero);
-
-            delete[] cedula; delete[] clave; delete[] nombre; delete[] dinero;
             return true;
         }
 
@@ -148,85 +128,48 @@ bool consultarSaldoUsuario(char** lineas, int numUsuarios, const char* cedulaBus
  *
  * Si el usuario no tiene fondos suficientes o no se encuentra, no se modifica el saldo.
  *
- * @param lineas Arreglo de líneas con datos de usuarios.
- * @param numUsuarios Número total de usuarios.
+ * @param cuentas Arreglo de cuentas de los usuarios.
+ * @param numUsuarios Número total de cuentas.
+ * @param indice Índice de cédulas de `cuentas`.
  * @param cedulaBuscada Cédula del usuario.
  * @param montoRetiro Monto solicitado para retirar.
  * @return `true` si el retiro se realizó exitosamente.
  * @return `false` si hubo un error o fondos insuficientes.
  *
- * @throw const char* Si hay datos de entrada inválidos o falla la separación de campos.
+ * @throw const char* Si hay datos de entrada inválidos.
  */
-bool modificarDineroUsuario(char** lineas, int numUsuarios, const char* cedulaBuscada, int montoRetiro) {
-    const int COSTO_RETIRO = 1000;
-    int montoTotal = montoRetiro + COSTO_RETIRO;
+bool modificarDineroUsuario(Cuenta* cuentas, int numUsuarios, const IndiceCedulas& indice,
+                            const char* cedulaBuscada, int montoRetiro) {
+    int64_t montoTotal = (int64_t)montoRetiro + COSTO_RETIRO;
 
     try {
-        if (!lineas || numUsuarios <= 0 || !cedulaBuscada)
+        if (!cuentas || numUsuarios <= 0 || !cedulaBuscada)
             throw "Datos de entrada inválidos en modificarDineroUsuario.";
 
-        for (int i = 0; i < numUsuarios; i++) {
-            int j = 0;
-            while (cedulaBuscada[j] != '\0' && lineas[i][j] == cedulaBuscada[j]) j++;
-            if (cedulaBuscada[j] != '\0' || lineas[i][j] != ',') continue;
-
-            char* cedula; char* clave; char* nombre; char* dinero;
-            separarLinea(lineas[i], cedula, clave, nombre, dinero);
-            if (!dinero) throw "El campo dinero no se pudo separar correctamente.";
-
-            int saldo = 0;
-            int k = 0;
-            while (dinero[k] >= '0' && dinero[k] <= '9') {
-                saldo = saldo * 10 + (dinero[k] - '0');
-                k++;
-            }
+        // Buscar la cédula en el índice
+        int i = buscarCedula(indice, cedulaBuscada);
+        if (i >= 0 && i < numUsuarios) {
+            Cuenta& cuenta = cuentas[i];
 
             cout << "\n=================================\n";
             cout << "  RETIRO DE DINERO\n";
             cout << "=================================\n";
-            cout << "Usuario: " << nombre << endl;
-            cout << "Saldo actual: " << saldo << " COP" << endl;
+            cout << "Usuario: " << cuenta.nombre << endl;
+            cout << "Saldo actual: " << cuenta.saldo << " COP" << endl;
             cout << "Monto a retirar: " << montoRetiro << " COP" << endl;
             cout << "Costo de transacción: " << COSTO_RETIRO << " COP" << endl;
             cout << "Total a descontar: " << montoTotal << " COP" << endl;
 
-            if (saldo < montoTotal) {
+            if (!aplicarRetiro(cuenta, montoRetiro)) {
                 cout << "\nTransacción rechazada.\n";
                 cout << "Fondos insuficientes para realizar el retiro.\n";
                 cout << "=================================\n\n";
-                delete[] cedula; delete[] clave; delete[] nombre; delete[] dinero;
                 return false;
             }
 
-            saldo -= montoTotal;
-            cout << "Nuevo saldo: " << saldo << " COP\n";
+            cout << "Nuevo saldo: " << cuenta.saldo << " COP\n";
             cout << "Transacción exitosa.\n";
             cout << "=================================\n\n";
-
-            // Actualizar saldo
-            delete[] lineas[i];
-            char nuevoDinero[50];
-            int idx = 0, temp = saldo;
-            char rev[20];
-            int rpos = 0;
-            if (temp == 0) rev[rpos++] = '0';
-            while (temp > 0) rev[rpos++] = (temp % 10) + '0', temp /= 10;
-            for (int t = rpos - 1; t >= 0; t--) nuevoDinero[idx++] = rev[t];
-            nuevoDinero[idx++] = ' '; nuevoDinero[idx++] = 'C'; nuevoDinero[idx++] = 'O'; nuevoDinero[idx++] = 'P';
-            nuevoDinero[idx] = '\0';
-
-            int newLen = longitud(cedula) + longitud(clave) + longitud(nombre) + longitud(nuevoDinero) + 4;
-            lineas[i] = new char[newLen];
-            lineas[i][0] = '\0';
-            concatenar(lineas[i], cedula);
-            concatenar(lineas[i], ",");
-            concatenar(lineas[i], clave);
-            concatenar(lineas[i], ",");
-            concatenar(lineas[i], nombre);
-            concatenar(lineas[i], ",");
-            concatenar(lineas[i], nuevoDinero);
-
-            delete[] cedula; delete[] clave; delete[] nombre; delete[] dinero;
             return true;
         }
 
@@ -1,30 +1,60 @@
 #ifndef OPERACIONES_USUARIO_H
 #define OPERACIONES_USUARIO_H
 
+#include "Cuenta.h"
+#include "IndiceCedulas.h"
+
+/** Costo de una consulta de saldo en COP. */
+const int COSTO_CONSULTA = 1000;
+/** Costo de un retiro en COP (además del monto). */
+const int COSTO_RETIRO = 1000;
+
+/**
+ * @brief Cobra la consulta de saldo sin escribir nada.
+ *
+ * Si el saldo no alcanza para el costo no se cobra.
+ *
+ * @param cuenta Cuenta del usuario.
+ * @return Lo que se cobró (0 o COSTO_CONSULTA).
+ */
+int64_t cobrarConsulta(Cuenta& cuenta);
+
+/**
+ * @brief Descuenta un retiro y su costo sin escribir nada.
+ *
+ * @param cuenta Cuenta del usuario.
+ * @param montoRetiro Monto que desea retirar.
+ * @return false si el monto no es positivo o el saldo no alcanza (la cuenta no cambia).
+ */
+bool aplicarRetiro(Cuenta& cuenta, int montoRetiro);
+
 /**
  * @brief Consulta el saldo de un usuario por su cédula.
  *
  * Descuenta automáticamente el costo de consulta (1000 COP) si hay fondos suficientes.
  *
- * @param lineas Arreglo de usuarios (cada línea contiene: cedula,clave,nombre,saldo).
+ * @param cuentas Arreglo de cuentas de los usuarios.
  * @param numUsuarios Número de usuarios en el arreglo.
+ * @param indice Índice de cédulas de `cuentas`.
  * @param cedulaBuscada Cédula a buscar.
  * @return true si se encontró y actualizó el saldo, false si no existe.
  */
-bool consultarSaldoUsuario(char** lineas, int numUsuarios, const char* cedulaBuscada);
+bool consultarSaldoUsuario(Cuenta* cuentas, int numUsuarios, const IndiceCedulas& indice, const char* cedulaBuscada);
 
 /**
  * @brief Modifica el saldo de un usuario realizando un retiro.
  *
- * Aplica un costo fijo de transacción (1000 COP) y actualiza la línea del usuario.
+ * Aplica un costo fijo de transacción (1000 COP) y actualiza el saldo de la cuenta.
  *
- * @param lineas Arreglo de usuarios.
+ * @param cuentas Arreglo de cuentas de los usuarios.
  * @param numUsuarios Número de usuarios.
+ * @param indice Índice de cédulas de `cuentas`.
  * @param cedulaBuscada Cédula del usuario a modificar.
  * @param montoRetiro Monto que desea retirar.
  * @return true si el retiro fue exitoso, false en caso de fondos insuficientes o cédula inexistente.
  */
-bool modificarDineroUsuario(char** lineas, int numUsuarios, const char* cedulaBuscada, int montoRetiro);
+bool modificarDineroUsuario(Cuenta* cuentas, int numUsuarios, const IndiceCedulas& indice,
+                            const char* cedulaBuscada, int montoRetiro);
 
 /**
  * @brief Extrae la cédula y la clave de una línea de texto con formato delimitado.
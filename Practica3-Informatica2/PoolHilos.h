@@ -0,0 +1,77 @@
+#ifndef POOL_HILOS_H
+#define POOL_HILOS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+/**
+ * @brief Pool de hilos persistente con reparto dinámico por trozos.
+ *
+ * Los hilos se crean una sola vez y esperan trabajo. paraCadaTrozo()
+ * divide el rango [0, total) en trozos que cada hilo (incluido el que
+ * llama) va tomando de un contador atómico hasta agotarlos. Cada índice
+ * lo procesa exactamente un hilo, así que si la tarea solo escribe en
+ * las posiciones de su trozo el resultado es determinista.
+ */
+class PoolHilos {
+public:
+    /**
+     * @brief Tarea sobre el trozo [inicio, fin); `hilo` va de 0 a numHilos() - 1
+     *        y sirve para elegir buffers de trabajo propios de cada hilo.
+     */
+    typedef function<void(int inicio, int fin, int hilo)> Tarea;
+
+    /**
+     * @brief Crea el pool.
+     * @param numHilos Hilos totales (incluido el que llama); 0 o negativo = todos los núcleos.
+     */
+    explicit PoolHilos(int numHilos = 0);
+    ~PoolHilos();
+
+    PoolHilos(const PoolHilos&) = delete;
+    PoolHilos& operator=(const PoolHilos&) = delete;
+
+    /**
+     * @brief Número de hilos que participan en cada tarea.
+     */
+    int numHilos() const;
+
+    /**
+     * @brief Ejecuta `tarea` sobre [0, total) en trozos de `trozo` índices y
+     *        espera a que terminen todos. Si alguna tarea lanza una
+     *        excepción, se relanza aquí la primera al finalizar.
+     */
+    void paraCadaTrozo(int total, int trozo, const Tarea& tarea);
+
+    /**
+     * @brief Tamaño de trozo razonable: unas 4 porciones por hilo.
+     */
+    static int trozoSugerido(int total, int numHilos);
+
+private:
+    void bucleTrabajador(int indice);
+    void ejecutarTrozos(int hilo);
+
+    vector<thread> trabajadores;
+    mutex serializar;                 ///< Una sola tarea a la vez.
+    mutex m;
+    condition_variable hayTrabajo;
+    condition_variable trabajoTerminado;
+
+    const Tarea* tareaActual = nullptr;
+    int totalActual = 0;
+    int trozoActual = 1;
+    atomic<int> siguiente{0};
+    int pendientes = 0;               ///< Trabajadores aún ocupados en la tarea actual.
+    unsigned long generacion = 0;
+    bool detener = false;
+    exception_ptr error;
+};
+
+#endif // POOL_HILOS_H
@@ -1,23 +1,58 @@
 TEMPLATE = app
-CONFIG += console c++17
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
 SOURCES += \
+        AlmacenSegmentado.cpp \
+        ArchivoRanuras.cpp \
+        Bitacora.cpp \
+        PuntoControl.cpp \
+        ArchivoMapeado.cpp \
+        CifradoEmpaquetado.cpp \
+        CifradoFlujo.cpp \
+        ClienteCajero.cpp \
+        ConversionSIMD.cpp \
+        Cuenta.cpp \
         Encriptacion.cpp \
+        ImportacionUsuarios.cpp \
+        IndiceCedulas.cpp \
+        IndicePersistente.cpp \
         ManipulacionDeArchivos.cpp \
     Menu.cpp \
     OperacionesUsuario.cpp \
+    PoolHilos.cpp \
+    ProcesamientoLote.cpp \
+    ProtocoloCajero.cpp \
+    ServicioCajero.cpp \
     UtilidadesCadena.cpp \
         main.cpp \
     validaciones.cpp
 
 HEADERS += \
+    AlmacenSegmentado.h \
+    ArchivoRanuras.h \
+    Bitacora.h \
+    PuntoControl.h \
+    ArchivoMapeado.h \
+    CifradoEmpaquetado.h \
+    CifradoFlujo.h \
+    ClienteCajero.h \
+    ConversionSIMD.h \
+    Cuenta.h \
     Encriptacion.h \
+    EncriptacionFija.h \
+    ImportacionUsuarios.h \
+    IndiceCedulas.h \
+    IndicePersistente.h \
     Encriptacion.h \
     ManipulacionDeArchivos.h \
     Menu.h \
     OperacionesUsuario.h \
+    PoolHilos.h \
+    ProcesamientoLote.h \
+    ProtocoloCajero.h \
+    ServicioCajero.h \
     Sistema.h \
     UtilidadesCadena.h \
     Validaciones.h
@@ -0,0 +1,172 @@
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "ArchivoMapeado.h"
+#include "OperacionesUsuario.h"
+#include "ProcesamientoLote.h"
+
+using namespace std;
+
+/**
+ * @brief Indica si el carácter separa campos de una línea del lote.
+ */
+static bool esSeparador(char c) {
+    return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+/**
+ * @brief Separa el siguiente campo de [p, fin).
+ * @return El campo (longitud 0 si no quedan más); `p` queda detrás de él.
+ */
+static VistaLinea siguienteCampo(const char*& p, const char* fin) {
+    while (p < fin && esSeparador(*p)) p++;
+    VistaLinea campo;
+    campo.inicio = p;
+    while (p < fin && !esSeparador(*p)) p++;
+    campo.longitud = (int)(p - campo.inicio);
+    return campo;
+}
+
+/**
+ * @brief Compara un campo con una cadena terminada en '\0'.
+ */
+static bool campoIgual(const VistaLinea& campo, const char* texto) {
+    int k = 0;
+    while (k < campo.longitud && texto[k] != '\0' && campo.inicio[k] == texto[k]) k++;
+    return k == campo.longitud && texto[k] == '\0';
+}
+
+/**
+ * @brief Lee un monto entero positivo que quepa en un int.
+ * @return false si el campo no es un monto válido.
+ */
+static bool leerMonto(const VistaLinea& campo, int& monto) {
+    if (campo.longitud == 0) return false;
+    long long valor = 0;
+    for (int k = 0; k < campo.longitud; k++) {
+        char c = campo.inicio[k];
+        if (c < '0' || c > '9') return false;
+        valor = valor * 10 + (c - '0');
+        if (valor > INT_MAX) return false;
+    }
+    if (valor == 0) return false;
+    monto = (int)valor;
+    return true;
+}
+
+/**
+ * @brief Aplica una línea del lote.
+ * @return nullptr si la operación se aplicó; si no, el motivo del rechazo.
+ */
+static const char* aplicarLinea(const VistaLinea& cedula, const VistaLinea& operacion, const VistaLinea& argumento,
+                                ListaCuentas& cuentas, const IndiceCedulas& indice, bool* autenticadas,
+                                int& posicion, AlModificarCuenta alModificar, void* contexto,
+                                ResumenLote& resumen) {
+    posicion = buscarCedula(indice, empaquetarCedula(cedula.inicio, cedula.longitud));
+    if (posicion < 0 || posicion >= cuentas.cantidad)
+        return "cédula inexistente";
+    Cuenta& cuenta = cuentas.datos[posicion];
+
+    if (campoIgual(operacion, "auth")) {
+        resumen.autenticaciones++;
+        autenticadas[posicion] = campoIgual(argumento, cuenta.clave);
+        return autenticadas[posicion] ? nullptr : "clave incorrecta";
+    }
+    bool esConsulta = campoIgual(operacion, "consulta");
+    if (!esConsulta && !campoIgual(operacion, "retiro"))
+        return "operación desconocida";
+    if (esConsulta) resumen.consultas++;
+    else resumen.retiros++;
+    if (!autenticadas[posicion])
+        return "sin autenticar";
+
+    int64_t saldoAntes = cuenta.saldo;
+    MotivoCambio motivo = MOTIVO_CONSULTA;
+    if (esConsulta) {
+        resumen.totalCobrado += cobrarConsulta(cuenta);
+    } else {
+        int monto = 0;
+        if (!leerMonto(argumento, monto))
+            return "monto inválido";
+        if (!aplicarRetiro(cuenta, monto))
+            return "fondos insuficientes";
+        resumen.totalRetirado += monto;
+        resumen.totalCobrado += COSTO_RETIRO;
+        motivo = MOTIVO_RETIRO;
+    }
+
+    if (alModificar != nullptr && cuenta.saldo != saldoAntes)
+        alModificar(posicion, cuenta.saldo - saldoAntes, motivo, contexto);
+    return nullptr;
+}
+
+bool procesarLote(const char* rutaLote, const char* rutaResultados, ListaCuentas& cuentas,
+                  const IndiceCedulas& indice, AlModificarCuenta alModificar, void* contexto,
+                  ResumenLote& resumen) {
+    resumen = ResumenLote();
+
+    ArchivoMapeado archivo;
+    try {
+        abrirMapeo(archivo, rutaLote);
+    }
+    catch (const char* e) {
+        cerr << "ERROR en procesarLote(): " << e << endl;
+        return false;
+    }
+    ofstream resultados(rutaResultados, ios::trunc);
+    if (!resultados.is_open()) {
+        cerr << "ERROR en procesarLote(): No se pudo crear " << rutaResultados << endl;
+        cerrarMapeo(archivo);
+        return false;
+    }
+    resultados << "linea,cedula,operacion,resultado,saldo\n";
+
+    // Sesiones abiertas por cuenta (un auth correcto las abre)
+    bool* autenticadas = new bool[cuentas.cantidad > 0 ? cuentas.cantidad : 1]();
+
+    auto inicio = chrono::steady_clock::now();
+    const char* fin = archivo.datos + archivo.tamanio;
+    int numLinea = 0;
+    for (const char* p = archivo.datos; p != nullptr && p < fin; ) {
+        const char* salto = (const char*)memchr(p, '\n', fin - p);
+        const char* finFila = salto ? salto : fin;
+        numLinea++;
+
+        VistaLinea cedula = siguienteCampo(p, finFila);
+        if (cedula.longitud == 0 || cedula.inicio[0] == '#') {
+            p = finFila + 1;
+            continue;
+        }
+        VistaLinea operacion = siguienteCampo(p, finFila);
+        VistaLinea argumento = siguienteCampo(p, finFila);
+        bool sobran = siguienteCampo(p, finFila).longitud > 0;
+        p = finFila + 1;
+        resumen.operaciones++;
+
+        int posicion = -1;
+        const char* error = sobran ? "línea inválida"
+            : aplicarLinea(cedula, operacion, argumento, cuentas, indice, autenticadas, posicion,
+                           alModificar, contexto, resumen);
+        if (error != nullptr) resumen.rechazadas++;
+        else resumen.exitosas++;
+
+        resultados << numLinea << ',';
+        resultados.write(cedula.inicio, cedula.longitud) << ',';
+        resultados.write(operacion.inicio, operacion.longitud) << ',' << (error ? error : "ok") << ',';
+        if (posicion >= 0 && posicion < cuentas.cantidad)
+            resultados << cuentas.datos[posicion].saldo;
+        resultados << '\n';
+    }
+    resultados.flush();
+    resumen.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    delete[] autenticadas;
+    cerrarMapeo(archivo);
+
+    if (!resultados) {
+        cerr << "ERROR en procesarLote(): No se pudo escribir " << rutaResultados << endl;
+        return false;
+    }
+    return true;
+}
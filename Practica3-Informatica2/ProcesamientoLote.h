@@ -0,0 +1,58 @@
+#ifndef PROCESAMIENTO_LOTE_H
+#define PROCESAMIENTO_LOTE_H
+
+#include <cstdint>
+#include "Cuenta.h"
+#include "IndiceCedulas.h"
+#include "Menu.h"
+
+// ===================== OPERACIONES EN LOTE =====================
+//
+// Un archivo de texto con una operación por línea, sin pasar por el
+// menú ni escribir en la consola:
+//
+//   <cedula> auth <clave>
+//   <cedula> consulta
+//   <cedula> retiro <monto>
+//
+// Los campos se separan con espacios, tabulaciones o comas; las líneas
+// vacías y las que empiezan con '#' se ignoran. Como en el cajero, una
+// cédula debe autenticarse antes de consultar o retirar; un `auth`
+// fallido cierra su sesión. Las consultas y los retiros siguen las
+// mismas reglas que el menú de usuario (cobrarConsulta() y
+// aplicarRetiro()) y cada cambio se avisa con `alModificar`, igual que
+// desde el menú. El resultado de cada línea se escribe en
+// "linea,cedula,operacion,resultado,saldo".
+
+/**
+ * @brief Totales de un lote.
+ */
+struct ResumenLote {
+    int operaciones = 0;                /**< Líneas con una operación */
+    int exitosas = 0;
+    int rechazadas = 0;
+    int autenticaciones = 0;
+    int consultas = 0;
+    int retiros = 0;
+    int64_t totalRetirado = 0;          /**< Suma de los retiros aplicados (COP) */
+    int64_t totalCobrado = 0;           /**< Costos de consulta y retiro cobrados (COP) */
+    double segundos = 0;                /**< Tiempo de procesamiento */
+};
+
+/**
+ * @brief Aplica las operaciones de un archivo de lote.
+ *
+ * @param rutaLote Archivo de operaciones.
+ * @param rutaResultados Archivo donde se escribe el resultado de cada línea.
+ * @param cuentas Cuentas de usuarios.
+ * @param indice Índice de cédulas de `cuentas`.
+ * @param alModificar Aviso opcional cada vez que cambia una cuenta.
+ * @param contexto Dato que se pasa tal cual a `alModificar`.
+ * @param resumen Recibe los totales.
+ * @return false si no se pudo leer el lote o crear el archivo de resultados.
+ */
+bool procesarLote(const char* rutaLote, const char* rutaResultados, ListaCuentas& cuentas,
+                  const IndiceCedulas& indice, AlModificarCuenta alModificar, void* contexto,
+                  ResumenLote& resumen);
+
+#endif // PROCESAMIENTO_LOTE_H
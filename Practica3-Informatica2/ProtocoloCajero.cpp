@@ -0,0 +1,225 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "ProtocoloCajero.h"
+#include "UtilidadesCadena.h"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+bool conectarCajero(ConexionCajero& conexion, const char*) {
+    cerr << "ERROR en conectarCajero(): el servicio de cajeros solo está disponible en sistemas POSIX." << endl;
+    conexion.fd = -1;
+    return false;
+}
+void adoptarConexion(ConexionCajero& conexion, int) { conexion.fd = -1; }
+bool enviarLinea(ConexionCajero&, const char*) { return false; }
+int recibirLinea(ConexionCajero&, char*, int, int) { return 0; }
+void cerrarConexion(ConexionCajero& conexion) { conexion.fd = -1; }
+int escucharEn(const char*) {
+    cerr << "ERROR en escucharEn(): el servicio de cajeros solo está disponible en sistemas POSIX." << endl;
+    return -1;
+}
+void dejarDeEscuchar(int, const char*) {}
+int aceptarConexion(int, int) { return -1; }
+
+#else
+
+/**
+ * @brief Puerto de una dirección "tcp:PUERTO", o -1 si es la ruta de un socket Unix.
+ */
+static int puertoTcp(const char* direccion) {
+    if (direccion[0] != 't' || direccion[1] != 'c' || direccion[2] != 'p' || direccion[3] != ':')
+        return -1;
+    int puerto = atoi(direccion + 4);
+    return puerto > 0 && puerto < 65536 ? puerto : 0;
+}
+
+/**
+ * @brief Crea el socket y arma la dirección de destino o de escucha.
+ * @return El descriptor, o -1 si la dirección no sirve.
+ */
+static int crearSocket(const char* direccion, sockaddr_storage& destino, socklen_t& largo) {
+    memset(&destino, 0, sizeof(destino));
+    int puerto = puertoTcp(direccion);
+    if (puerto == 0) {
+        cerr << "ERROR: puerto inválido en " << direccion << endl;
+        return -1;
+    }
+    if (puerto > 0) {
+        sockaddr_in* tcp = (sockaddr_in*)&destino;
+        tcp->sin_family = AF_INET;
+        tcp->sin_port = htons((uint16_t)puerto);
+        tcp->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        largo = sizeof(sockaddr_in);
+        return socket(AF_INET, SOCK_STREAM, 0);
+    }
+    sockaddr_un* local = (sockaddr_un*)&destino;
+    int len = longitud(direccion);
+    if (len == 0 || len >= (int)sizeof(local->sun_path)) {
+        cerr << "ERROR: ruta de socket inválida: " << direccion << endl;
+        return -1;
+    }
+    local->sun_family = AF_UNIX;
+    copiar(local->sun_path, direccion);
+    largo = sizeof(sockaddr_un);
+    return socket(AF_UNIX, SOCK_STREAM, 0);
+}
+
+/**
+ * @brief Desactiva el algoritmo de Nagle: cada respuesta es una línea corta.
+ */
+static void sinRetardo(int fd) {
+    int uno = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &uno, sizeof(uno));
+}
+
+bool conectarCajero(ConexionCajero& conexion, const char* direccion) {
+    cerrarConexion(conexion);
+    sockaddr_storage destino;
+    socklen_t largo = 0;
+    conexion.fd = crearSocket(direccion, destino, largo);
+    if (conexion.fd < 0) return false;
+    if (connect(conexion.fd, (sockaddr*)&destino, largo) != 0) {
+        cerr << "ERROR: no se pudo conectar con " << direccion << ": " << strerror(errno) << endl;
+        cerrarConexion(conexion);
+        return false;
+    }
+    if (puertoTcp(direccion) > 0) sinRetardo(conexion.fd);
+    return true;
+}
+
+void adoptarConexion(ConexionCajero& conexion, int descriptor) {
+    cerrarConexion(conexion);
+    conexion.fd = descriptor;
+}
+
+bool enviarLinea(ConexionCajero& conexion, const char* linea) {
+    int len = longitud(linea);
+    if (conexion.fd < 0 || len > TAM_MAX_LINEA_PROTOCOLO) return false;
+    char mensaje[TAM_MAX_LINEA_PROTOCOLO + 1];
+    memcpy(mensaje, linea, len);
+    mensaje[len] = '\n';
+
+    int enviados = 0;
+    while (enviados < len + 1) {
+        ssize_t n = send(conexion.fd, mensaje + enviados, len + 1 - enviados, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        enviados += (int)n;
+    }
+    return true;
+}
+
+int recibirLinea(ConexionCajero& conexion, char* linea, int capacidad, int esperaMs) {
+    while (true) {
+        char* salto = (char*)memchr(conexion.pendiente, '\n', conexion.numPendiente);
+        if (salto != nullptr) {
+            int len = (int)(salto - conexion.pendiente);
+            int resto = conexion.numPendiente - len - 1;
+            if (len > 0 && conexion.pendiente[len - 1] == '\r') len--;
+            if (len >= capacidad) return 0;
+            memcpy(linea, conexion.pendiente, len);
+            linea[len] = '\0';
+            memmove(conexion.pendiente, salto + 1, resto);
+            conexion.numPendiente = resto;
+            return 1;
+        }
+        if (conexion.fd < 0 || conexion.numPendiente > TAM_MAX_LINEA_PROTOCOLO)
+            return 0;
+
+        pollfd espera = { conexion.fd, POLLIN, 0 };
+        int listo = poll(&espera, 1, esperaMs);
+        if (listo < 0 && errno == EINTR) return -1;
+        if (listo == 0) return -1;
+        if (listo < 0) return 0;
+
+        ssize_t n = recv(conexion.fd, conexion.pendiente + conexion.numPendiente,
+                         sizeof(conexion.pendiente) - conexion.numPendiente, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        conexion.numPendiente += (int)n;
+    }
+}
+
+bool peticionCajero(ConexionCajero& conexion, const char* linea, char* respuesta, int capacidad) {
+    return enviarLinea(conexion, linea) && recibirLinea(conexion, respuesta, capacidad) == 1;
+}
+
+void cerrarConexion(ConexionCajero& conexion) {
+    if (conexion.fd >= 0) close(conexion.fd);
+    conexion.fd = -1;
+    conexion.numPendiente = 0;
+}
+
+/**
+ * @brief Borra el socket Unix de `ruta` (el de esta ejecución o uno que quedó de otra).
+ *
+ * Solo borra la ruta si es un socket: una dirección mal escrita que
+ * apunte a un archivo de datos no lo toca.
+ *
+ * @return false si la ruta existe y no es un socket.
+ */
+static bool quitarSocket(const char* ruta) {
+    struct stat info;
+    if (lstat(ruta, &info) != 0) return errno == ENOENT;
+    if (!S_ISSOCK(info.st_mode)) return false;
+    unlink(ruta);
+    return true;
+}
+
+int escucharEn(const char* direccion) {
+    sockaddr_storage local;
+    socklen_t largo = 0;
+    int fd = crearSocket(direccion, local, largo);
+    if (fd < 0) return -1;
+
+    if (puertoTcp(direccion) > 0) {
+        int uno = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &uno, sizeof(uno));
+    } else if (!quitarSocket(direccion)) {
+        cerr << "ERROR en escucharEn(): " << direccion << " existe y no es un socket; no se reemplaza." << endl;
+        close(fd);
+        return -1;
+    }
+    if (bind(fd, (sockaddr*)&local, largo) != 0 || listen(fd, SOMAXCONN) != 0) {
+        cerr << "ERROR en escucharEn(): " << direccion << ": " << strerror(errno) << endl;
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void dejarDeEscuchar(int descriptor, const char* direccion) {
+    if (descriptor < 0) return;
+    close(descriptor);
+    if (puertoTcp(direccion) < 0) quitarSocket(direccion);
+}
+
+int aceptarConexion(int descriptor, int esperaMs) {
+    pollfd espera = { descriptor, POLLIN, 0 };
+    if (poll(&espera, 1, esperaMs) <= 0) return -1;
+    int fd = accept(descriptor, nullptr, nullptr);
+    if (fd >= 0) {
+        sockaddr_storage local;
+        socklen_t largo = sizeof(local);
+        if (getsockname(fd, (sockaddr*)&local, &largo) == 0 && local.ss_family == AF_INET)
+            sinRetardo(fd);
+    }
+    return fd;
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef PROTOCOLO_CAJERO_H
+#define PROTOCOLO_CAJERO_H
+
+// ===================== PROTOCOLO DE CAJEROS =====================
+//
+// Cada petición y cada respuesta es una línea de texto terminada en
+// '\n' (a lo sumo TAM_MAX_LINEA_PROTOCOLO caracteres):
+//
+//   auth <cedula> <clave>   ->  ok <nombre>
+//   consulta                ->  ok <saldo> <cobrado>
+//   retiro <monto>          ->  ok <saldo>
+//   salir                   ->  ok            (y se cierra la conexión)
+//
+// Si algo falla la respuesta es "error <motivo>". Igual que en el
+// cajero, consulta y retiro necesitan un auth correcto en la misma
+// conexión y un auth fallido cierra la sesión.
+//
+// La dirección del servicio es la ruta de un socket Unix o
+// "tcp:PUERTO" para escuchar solo en 127.0.0.1 (pruebas).
+
+const int TAM_MAX_LINEA_PROTOCOLO = 256;
+
+/**
+ * @brief Conexión de un cajero con el servicio (de cualquiera de los dos lados).
+ */
+struct ConexionCajero {
+    int fd = -1;
+    char pendiente[2 * TAM_MAX_LINEA_PROTOCOLO];    /**< Bytes recibidos después de la última línea */
+    int numPendiente = 0;
+};
+
+/**
+ * @brief Se conecta al servicio (cierra antes la conexión que hubiera).
+ * @return false si no se pudo (el motivo se informa por cerr).
+ */
+bool conectarCajero(ConexionCajero& conexion, const char* direccion);
+
+/**
+ * @brief Toma un socket ya conectado.
+ */
+void adoptarConexion(ConexionCajero& conexion, int descriptor);
+
+/**
+ * @brief Envía una línea (se le agrega el '\n').
+ * @return false si la conexión se cerró o la línea es demasiado larga.
+ */
+bool enviarLinea(ConexionCajero& conexion, const char* linea);
+
+/**
+ * @brief Lee la siguiente línea, sin el '\n'.
+ * @param linea Destino (terminado en '\0').
+ * @param capacidad Tamaño de `linea`.
+ * @param esperaMs Tiempo máximo de espera; negativo = sin límite.
+ * @return 1 si leyó una línea, 0 si la conexión se cerró o la línea no
+ *         cabe, -1 si pasó `esperaMs` sin una línea completa.
+ */
+int recibirLinea(ConexionCajero& conexion, char* linea, int capacidad, int esperaMs = -1);
+
+/**
+ * @brief Envía una petición y espera su respuesta.
+ * @return false si la conexión se cerró.
+ */
+bool peticionCajero(ConexionCajero& conexion, const char* linea, char* respuesta, int capacidad);
+
+void cerrarConexion(ConexionCajero& conexion);
+
+/**
+ * @brief Abre un socket que escucha en la dirección.
+ *
+ * Un socket Unix que haya quedado de una ejecución anterior se reemplaza.
+ *
+ * @return El descriptor, o -1 si no se pudo (el motivo se informa por cerr).
+ */
+int escucharEn(const char* direccion);
+
+/**
+ * @brief Cierra el socket de escucha y, si era Unix, borra su archivo.
+ */
+void dejarDeEscuchar(int descriptor, const char* direccion);
+
+/**
+ * @brief Espera una conexión entrante.
+ * @param esperaMs Tiempo máximo de espera.
+ * @return El socket conectado, o -1 si no llegó ninguna.
+ */
+int aceptarConexion(int descriptor, int esperaMs);
+
+#endif // PROTOCOLO_CAJERO_H
@@ -0,0 +1,216 @@
+#include <chrono>
+#include <cstdio>
+#include "AlmacenSegmentado.h"
+#include "Encriptacion.h"
+#include "IndicePersistente.h"
+#include "PuntoControl.h"
+
+using namespace std;
+
+/**
+ * @brief Cifra y guarda las páginas tomadas de la sombra; si se pudo,
+ *        borra la bitácora vieja.
+ *
+ * @param vistas Arreglo de cuentas de cada página, en orden.
+ */
+static bool guardarPuntoControl(PuntoControl& punto, Cuenta* const* vistas, int numCuentas) {
+    char** lineas = new char*[numCuentas > 0 ? numCuentas : 1];
+    uint64_t* cedulas = new uint64_t[numCuentas > 0 ? numCuentas : 1];
+    for (int p = 0, base = 0; base < numCuentas; p++, base += CUENTAS_POR_PAGINA_SOMBRA) {
+        int cuantas = numCuentas - base < CUENTAS_POR_PAGINA_SOMBRA ? numCuentas - base : CUENTAS_POR_PAGINA_SOMBRA;
+        char** pagina = serializarCuentas(vistas[p], cuantas);
+        for (int i = 0; i < cuantas; i++) {
+            lineas[base + i] = pagina[i];
+            cedulas[base + i] = vistas[p][i].cedula;
+        }
+        delete[] pagina;
+    }
+
+    encriptarArchivo(lineas, numCuentas, punto.semilla, *punto.pool);
+    bool ok = guardarAlmacen(punto.ruta, lineas, numCuentas, punto.empaquetado, true);
+    if (ok) guardarIndicePersistente(punto.ruta, cedulas, lineas, numCuentas);
+    for (int i = 0; i < numCuentas; i++) delete[] lineas[i];
+    delete[] lineas;
+    delete[] cedulas;
+
+    if (ok && punto.bitacora != nullptr)
+        remove(punto.rutaBitacoraVieja);
+    return ok;
+}
+
+/**
+ * @brief Agrega páginas a la sombra hasta que quepan `numCuentas` cuentas.
+ *
+ * Se llama con el candado del punto de control tomado.
+ */
+static void asegurarPaginas(PuntoControl& punto, int numCuentas) {
+    int necesarias = (numCuentas + CUENTAS_POR_PAGINA_SOMBRA - 1) / CUENTAS_POR_PAGINA_SOMBRA;
+    if (necesarias > punto.capacidadPaginas) {
+        int nueva = punto.capacidadPaginas == 0 ? 16 : punto.capacidadPaginas * 2;
+        while (nueva < necesarias) nueva *= 2;
+        PaginaSombra** ampliadas = new PaginaSombra*[nueva];
+        for (int p = 0; p < punto.numPaginas; p++) ampliadas[p] = punto.paginas[p];
+        delete[] punto.paginas;
+        punto.paginas = ampliadas;
+        punto.capacidadPaginas = nueva;
+    }
+    while (punto.numPaginas < necesarias) {
+        PaginaSombra* pagina = new PaginaSombra;
+        pagina->cuentas = new Cuenta[CUENTAS_POR_PAGINA_SOMBRA];
+        punto.paginas[punto.numPaginas++] = pagina;
+    }
+}
+
+/**
+ * @brief Libera todas las páginas de la sombra.
+ */
+static void liberarPaginas(PuntoControl& punto) {
+    for (int p = 0; p < punto.numPaginas; p++) {
+        delete[] punto.paginas[p]->cuentas;
+        delete punto.paginas[p];
+    }
+    delete[] punto.paginas;
+    punto.paginas = nullptr;
+    punto.numPaginas = punto.capacidadPaginas = 0;
+    punto.numSombra = 0;
+}
+
+/**
+ * @brief Copia la cuenta a su página bajo el candado de esa página.
+ *
+ * Si el punto de control en curso está leyendo la página, se escribe en
+ * una copia y el arreglo viejo queda para él (lo libera al terminar).
+ */
+static void copiarASombra(PuntoControl& punto, int indice, const Cuenta& cuenta) {
+    PaginaSombra& pagina = *punto.paginas[indice / CUENTAS_POR_PAGINA_SOMBRA];
+    lock_guard<mutex> lock(pagina.m);
+    if (pagina.compartida) {
+        Cuenta* copia = new Cuenta[CUENTAS_POR_PAGINA_SOMBRA];
+        for (int i = 0; i < CUENTAS_POR_PAGINA_SOMBRA; i++) copia[i] = pagina.cuentas[i];
+        pagina.cuentas = copia;
+        pagina.compartida = false;
+    }
+    pagina.cuentas[indice % CUENTAS_POR_PAGINA_SOMBRA] = cuenta;
+}
+
+/**
+ * @brief Bucle del hilo: espera el intervalo (o un pedido) y guarda si
+ *        hubo cambios.
+ */
+static void buclePuntoControl(PuntoControl* punto) {
+    unique_lock<mutex> lock(punto->m);
+    while (!punto->detener) {
+        auto listo = [punto] { return punto->detener || punto->solicitado; };
+        if (punto->intervaloSeg > 0)
+            punto->despertar.wait_for(lock, chrono::seconds(punto->intervaloSeg), listo);
+        else
+            punto->despertar.wait(lock, listo);
+        if (punto->detener) break;
+
+        bool pedido = punto->solicitado.exchange(false);
+        if (!punto->sucia && !pedido) continue;
+
+        // La bitácora se rota antes de tomar la sombra: lo que quede en la
+        // vieja ya está en la sombra. Si no se puede rotar (no hay
+        // entradas, o la vieja sigue de un intento fallido) se guarda igual
+        lock.unlock();
+        if (punto->bitacora != nullptr) rotarBitacora(*punto->bitacora, punto->rutaBitacoraVieja);
+        lock.lock();
+
+        // Las páginas no se liberan mientras el hilo corre: basta con
+        // anotar cuáles hay y soltar el candado general
+        int n = punto->numSombra;
+        int numPaginas = (n + CUENTAS_POR_PAGINA_SOMBRA - 1) / CUENTAS_POR_PAGINA_SOMBRA;
+        PaginaSombra** paginas = new PaginaSombra*[numPaginas > 0 ? numPaginas : 1];
+        for (int p = 0; p < numPaginas; p++) paginas[p] = punto->paginas[p];
+        punto->sucia = false;
+        lock.unlock();
+
+        // Copia al escribir: se toma el arreglo de cada página sin copiarlo
+        Cuenta** vistas = new Cuenta*[numPaginas > 0 ? numPaginas : 1];
+        for (int p = 0; p < numPaginas; p++) {
+            lock_guard<mutex> lockPagina(paginas[p]->m);
+            vistas[p] = paginas[p]->cuentas;
+            paginas[p]->compartida = true;
+        }
+
+        bool ok = guardarPuntoControl(*punto, vistas, n);
+
+        // Las páginas que alguien copió mientras tanto dejaron el arreglo
+        // viejo para liberarlo aquí
+        for (int p = 0; p < numPaginas; p++) {
+            lock_guard<mutex> lockPagina(paginas[p]->m);
+            if (paginas[p]->cuentas == vistas[p])
+                paginas[p]->compartida = false;
+            else
+                delete[] vistas[p];
+        }
+        delete[] vistas;
+        delete[] paginas;
+
+        lock.lock();
+        if (ok)
+            punto->guardados++;
+        else
+            punto->sucia = true;   // se reintenta en el próximo intervalo
+    }
+}
+
+void iniciarPuntoControl(PuntoControl& punto, const char* ruta, const Cuenta* cuentas, int numCuentas,
+                         int semilla, bool empaquetado, PoolHilos& pool, int intervaloSeg,
+                         Bitacora* bitacora, const char* rutaBitacoraVieja) {
+    detenerPuntoControl(punto);
+    punto.ruta = ruta;
+    punto.semilla = semilla;
+    punto.empaquetado = empaquetado;
+    punto.pool = &pool;
+    punto.intervaloSeg = intervaloSeg;
+    punto.bitacora = bitacora;
+    punto.rutaBitacoraVieja = rutaBitacoraVieja;
+
+    asegurarPaginas(punto, numCuentas > 0 ? numCuentas : 1);
+    for (int i = 0; i < numCuentas; i++)
+        punto.paginas[i / CUENTAS_POR_PAGINA_SOMBRA]->cuentas[i % CUENTAS_POR_PAGINA_SOMBRA] = cuentas[i];
+    punto.numSombra = numCuentas;
+    punto.sucia = false;
+    punto.solicitado = false;
+    punto.detener = false;
+    punto.guardados = 0;
+    punto.hilo = thread(buclePuntoControl, &punto);
+}
+
+void detenerPuntoControl(PuntoControl& punto) {
+    if (punto.hilo.joinable()) {
+        {
+            lock_guard<mutex> lock(punto.m);
+            punto.detener = true;
+        }
+        punto.despertar.notify_all();
+        punto.hilo.join();
+    }
+    liberarPaginas(punto);
+}
+
+void actualizarPuntoControl(PuntoControl& punto, int indice, const Cuenta& cuenta) {
+    if (indice < 0 || punto.paginas == nullptr) return;
+    if (indice < punto.numSombra) {
+        copiarASombra(punto, indice, cuenta);
+    } else {
+        lock_guard<mutex> lock(punto.m);
+        asegurarPaginas(punto, indice + 1);
+        copiarASombra(punto, indice, cuenta);
+        punto.numSombra = indice + 1;
+    }
+    // Solo se escribe si cambia, para no ir y venir entre núcleos
+    if (!punto.sucia.load(memory_order_relaxed))
+        punto.sucia = true;
+}
+
+void solicitarPuntoControl(PuntoControl& punto) {
+    // Solo el primer pedido despierta al hilo; los demás ya están incluidos
+    if (punto.solicitado.exchange(true)) return;
+    {
+        lock_guard<mutex> lock(punto.m);
+    }
+    punto.despertar.notify_all();
+}
@@ -0,0 +1,112 @@
+#ifndef PUNTO_CONTROL_H
+#define PUNTO_CONTROL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "Bitacora.h"
+#include "Cuenta.h"
+#include "PoolHilos.h"
+using namespace std;
+
+// ===================== PUNTOS DE CONTROL =====================
+//
+// Un hilo guarda periódicamente el snapshot de usuarios mientras el
+// menú sigue atendiendo. Cada cambio solo copia la cuenta a una tabla
+// sombra; el hilo toma la sombra tal como está, la cifra y la guarda con
+// guardarAlmacen(), que escribe en un temporal y lo reemplaza con
+// reemplazarArchivo(). Después rehace el índice de cédulas en disco. El
+// hilo no escribe en la consola: el menú está esperando una opción.
+//
+// La sombra está partida en páginas de CUENTAS_POR_PAGINA_SOMBRA cuentas,
+// cada una con su candado: los cajeros del servicio que cambian cuentas
+// de páginas distintas no se esperan entre sí. El punto de control no
+// copia la tabla (copia al escribir): anota el arreglo de cada página y
+// la marca compartida. Quien cambie una página compartida la copia antes
+// y sigue sobre la copia, así que lo que se está guardando no cambia y
+// nadie espera más que la copia de su página. En memoria queda una sola
+// tabla, más las páginas que cambiaron durante el punto de control. El
+// candado del punto de control solo se toma para agregar páginas, que es
+// cuando llega una cuenta nueva.
+//
+// Con bitácora, el punto de control la rota antes de tomar la sombra:
+// todo lo que quedó en la bitácora vieja ya estaba en la sombra, así que
+// cuando el snapshot está sincronizado con el disco la vieja se borra. Sin bitácora, un
+// corte pierde a lo sumo un intervalo.
+
+/** Cuentas por página de la tabla sombra (lo que se copia al escribir). */
+const int CUENTAS_POR_PAGINA_SOMBRA = 256;
+
+/**
+ * @brief Una página de la tabla sombra con su propio candado.
+ *
+ * Alineada a 64 bytes para que los candados de dos páginas no compartan
+ * línea de caché.
+ */
+struct alignas(64) PaginaSombra {
+    mutex m;
+    Cuenta* cuentas = nullptr;              /**< CUENTAS_POR_PAGINA_SOMBRA cuentas */
+    bool compartida = false;                /**< El punto de control en curso está leyendo `cuentas` */
+};
+
+/**
+ * @brief Hilo de puntos de control sobre una copia de las cuentas.
+ */
+struct PuntoControl {
+    const char* ruta = nullptr;
+    int semilla = 0;
+    bool empaquetado = false;
+    PoolHilos* pool = nullptr;
+    int intervaloSeg = 0;                   /**< 0 = solo a pedido */
+    Bitacora* bitacora = nullptr;           /**< Se rota en cada punto de control, o nullptr */
+    const char* rutaBitacoraVieja = nullptr;
+
+    thread hilo;
+    mutex m;                                /**< Estado del hilo y lista de páginas */
+    condition_variable despertar;
+    PaginaSombra** paginas = nullptr;       /**< Cuentas tal como las dejó el menú */
+    int numPaginas = 0;
+    int capacidadPaginas = 0;
+    atomic<int> numSombra{0};
+    atomic<bool> sucia{false};              /**< Hay cambios desde el último punto de control */
+    atomic<bool> solicitado{false};
+    bool detener = false;
+    int guardados = 0;
+};
+
+/**
+ * @brief Arranca el hilo con una copia de las cuentas actuales.
+ *
+ * Las rutas no se copian: deben vivir hasta detenerPuntoControl(). El
+ * pool no debe usarse a la vez desde otro hilo.
+ *
+ * @param intervaloSeg Segundos entre puntos de control; 0 = solo a pedido.
+ * @param bitacora Bitácora a rotar en cada punto de control, o nullptr.
+ * @param rutaBitacoraVieja Ruta a la que se rota la bitácora.
+ */
+void iniciarPuntoControl(PuntoControl& punto, const char* ruta, const Cuenta* cuentas, int numCuentas,
+                         int semilla, bool empaquetado, PoolHilos& pool, int intervaloSeg,
+                         Bitacora* bitacora = nullptr, const char* rutaBitacoraVieja = nullptr);
+
+/**
+ * @brief Detiene el hilo sin guardar lo pendiente (lo guarda main al salir).
+ */
+void detenerPuntoControl(PuntoControl& punto);
+
+/**
+ * @brief Copia a la sombra la cuenta `indice` (una cuenta nueva va al final).
+ *
+ * Solo toma el candado de la página de la cuenta. Una cuenta nueva
+ * puede agregar páginas, así que no debe coincidir con cambios desde
+ * otros hilos (el servicio no agrega cuentas). Con bitácora debe
+ * llamarse antes de registrar el movimiento.
+ */
+void actualizarPuntoControl(PuntoControl& punto, int indice, const Cuenta& cuenta);
+
+/**
+ * @brief Pide un punto de control sin esperar al intervalo.
+ */
+void solicitarPuntoControl(PuntoControl& punto);
+
+#endif // PUNTO_CONTROL_H
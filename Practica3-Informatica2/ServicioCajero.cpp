@@ -0,0 +1,218 @@
+#include <climits>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include "ArchivoMapeado.h"
+#include "OperacionesUsuario.h"
+#include "ServicioCajero.h"
+
+using namespace std;
+
+/** Cada cuánto revisan los hilos si deben terminar. */
+const int ESPERA_REVISION_MS = 250;
+
+/**
+ * SIGINT o SIGTERM recibida mientras se atiende. El manejador puede
+ * correr en cualquier hilo: un atómico sin bloqueo es seguro en él.
+ */
+static atomic<bool> senalRecibida{false};
+
+static void alRecibirSenal(int) {
+    senalRecibida = true;
+}
+
+/**
+ * @brief Separa el siguiente campo (separado por espacios) a partir de `p`.
+ * @return El campo (longitud 0 si no quedan más); `p` queda detrás de él.
+ */
+static VistaLinea siguienteCampo(const char*& p) {
+    while (*p == ' ') p++;
+    VistaLinea campo;
+    campo.inicio = p;
+    while (*p != '\0' && *p != ' ') p++;
+    campo.longitud = (int)(p - campo.inicio);
+    return campo;
+}
+
+/**
+ * @brief Compara un campo con una cadena terminada en '\0'.
+ */
+static bool campoIgual(const VistaLinea& campo, const char* texto) {
+    int k = 0;
+    while (k < campo.longitud && texto[k] != '\0' && campo.inicio[k] == texto[k]) k++;
+    return k == campo.longitud && texto[k] == '\0';
+}
+
+/**
+ * @brief Lee un monto entero positivo que quepa en un int.
+ * @return false si el campo no es un monto válido.
+ */
+static bool leerMonto(const VistaLinea& campo, int& monto) {
+    if (campo.longitud == 0) return false;
+    long long valor = 0;
+    for (int k = 0; k < campo.longitud; k++) {
+        char c = campo.inicio[k];
+        if (c < '0' || c > '9') return false;
+        valor = valor * 10 + (c - '0');
+        if (valor > INT_MAX) return false;
+    }
+    if (valor == 0) return false;
+    monto = (int)valor;
+    return true;
+}
+
+/**
+ * @brief Mutex de la franja que protege la cuenta.
+ *
+ * Usa el mismo hash multiplicativo que el índice de cédulas.
+ */
+static mutex& franjaDe(ServicioCajero& servicio, const Cuenta& cuenta) {
+    return servicio.franjas[(cuenta.cedula * 0x9E3779B97F4A7C15ULL) >> (64 - BITS_FRANJAS_CUENTAS)].m;
+}
+
+/**
+ * @brief Arma la respuesta a una petición.
+ *
+ * @param sesion Cuenta autenticada en la conexión, o -1.
+ * @param salir Se pone en true si la petición cierra la conexión.
+ */
+static void responder(ServicioCajero& servicio, const char* peticion, int& sesion, bool& salir,
+                      char* respuesta, int capacidad) {
+    const char* p = peticion;
+    VistaLinea orden = siguienteCampo(p);
+
+    if (campoIgual(orden, "auth")) {
+        VistaLinea cedula = siguienteCampo(p);
+        VistaLinea clave = siguienteCampo(p);
+        sesion = -1;
+        int i = buscarCedula(*servicio.indice, empaquetarCedula(cedula.inicio, cedula.longitud));
+        if (i < 0 || i >= servicio.cuentas->cantidad) {
+            snprintf(respuesta, capacidad, "error cédula inexistente");
+            return;
+        }
+        if (!campoIgual(clave, servicio.cuentas->datos[i].clave)) {
+            snprintf(respuesta, capacidad, "error clave incorrecta");
+            return;
+        }
+        sesion = i;
+        snprintf(respuesta, capacidad, "ok %s", servicio.cuentas->datos[i].nombre);
+        return;
+    }
+    if (campoIgual(orden, "salir")) {
+        salir = true;
+        snprintf(respuesta, capacidad, "ok");
+        return;
+    }
+    bool esConsulta = campoIgual(orden, "consulta");
+    if (!esConsulta && !campoIgual(orden, "retiro")) {
+        snprintf(respuesta, capacidad, "error operación desconocida");
+        return;
+    }
+    if (sesion < 0) {
+        snprintf(respuesta, capacidad, "error sin autenticar");
+        return;
+    }
+
+    int monto = 0;
+    if (!esConsulta && !leerMonto(siguienteCampo(p), monto)) {
+        snprintf(respuesta, capacidad, "error monto inválido");
+        return;
+    }
+
+    int64_t saldo = 0, cobrado = 0;
+    bool cambio = false;
+    {
+        Cuenta& cuenta = servicio.cuentas->datos[sesion];
+        lock_guard<mutex> lock(franjaDe(servicio, cuenta));
+        int64_t saldoAntes = cuenta.saldo;
+        if (esConsulta) {
+            cobrado = cobrarConsulta(cuenta);
+        } else if (!aplicarRetiro(cuenta, monto)) {
+            snprintf(respuesta, capacidad, "error fondos insuficientes");
+            return;
+        }
+        saldo = cuenta.saldo;
+        cambio = saldo != saldoAntes;
+        if (cambio && servicio.alModificar != nullptr)
+            servicio.alModificar(sesion, saldo - saldoAntes, esConsulta ? MOTIVO_CONSULTA : MOTIVO_RETIRO,
+                                 servicio.contexto);
+    }
+    if (cambio && servicio.esperarPersistencia != nullptr)
+        servicio.esperarPersistencia(servicio.contexto);
+
+    if (esConsulta)
+        snprintf(respuesta, capacidad, "ok %lld %lld", (long long)saldo, (long long)cobrado);
+    else
+        snprintf(respuesta, capacidad, "ok %lld", (long long)saldo);
+}
+
+/**
+ * @brief Atiende una conexión hasta que el cajero sale o el servicio se detiene.
+ */
+static void atenderSesion(ServicioCajero* servicio, int descriptor) {
+    ConexionCajero conexion;
+    adoptarConexion(conexion, descriptor);
+
+    int sesion = -1;
+    bool salir = false;
+    char peticion[TAM_MAX_LINEA_PROTOCOLO + 1];
+    char respuesta[TAM_MAX_LINEA_PROTOCOLO + 1];
+    while (!salir && !servicio->detenido) {
+        int leida = recibirLinea(conexion, peticion, sizeof(peticion), ESPERA_REVISION_MS);
+        if (leida < 0) continue;
+        if (leida == 0) break;
+        servicio->peticiones++;
+        responder(*servicio, peticion, sesion, salir, respuesta, sizeof(respuesta));
+        if (!enviarLinea(conexion, respuesta)) break;
+    }
+    cerrarConexion(conexion);
+
+    lock_guard<mutex> lock(servicio->sesionesMutex);
+    servicio->sesionesAbiertas--;
+    servicio->sesionTerminada.notify_all();
+}
+
+bool atenderCajeros(ServicioCajero& servicio, const char* direccion, ListaCuentas& cuentas,
+                    const IndiceCedulas& indice, AlModificarCuenta alModificar,
+                    EsperarPersistencia esperarPersistencia, void* contexto) {
+    servicio.cuentas = &cuentas;
+    servicio.indice = &indice;
+    servicio.alModificar = alModificar;
+    servicio.esperarPersistencia = esperarPersistencia;
+    servicio.contexto = contexto;
+
+    int escucha = escucharEn(direccion);
+    if (escucha < 0) return false;
+
+    senalRecibida = false;
+    void (*anteriorInt)(int) = signal(SIGINT, alRecibirSenal);
+    void (*anteriorTerm)(int) = signal(SIGTERM, alRecibirSenal);
+
+    while (!servicio.detenido && !senalRecibida) {
+        int fd = aceptarConexion(escucha, ESPERA_REVISION_MS);
+        if (fd < 0) continue;
+        {
+            lock_guard<mutex> lock(servicio.sesionesMutex);
+            servicio.sesionesAbiertas++;
+        }
+        servicio.sesiones++;
+        thread(atenderSesion, &servicio, fd).detach();
+    }
+    servicio.detenido = true;
+    dejarDeEscuchar(escucha, direccion);
+
+    // Las sesiones ven `detenido` en su siguiente revisión
+    unique_lock<mutex> lock(servicio.sesionesMutex);
+    while (servicio.sesionesAbiertas > 0)
+        servicio.sesionTerminada.wait(lock);
+    lock.unlock();
+
+    signal(SIGINT, anteriorInt);
+    signal(SIGTERM, anteriorTerm);
+    return true;
+}
+
+void detenerServicio(ServicioCajero& servicio) {
+    servicio.detenido = true;
+}
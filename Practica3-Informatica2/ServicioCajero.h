@@ -0,0 +1,91 @@
+#ifndef SERVICIO_CAJERO_H
+#define SERVICIO_CAJERO_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include "Cuenta.h"
+#include "IndiceCedulas.h"
+#include "Menu.h"
+#include "ProtocoloCajero.h"
+using namespace std;
+
+// ===================== SERVICIO DE CAJEROS =====================
+//
+// Las cuentas se cargan una sola vez y muchos cajeros se conectan a la
+// vez (protocolo en ProtocoloCajero.h); cada conexión se atiende en su
+// propio hilo. Las consultas y los retiros siguen las reglas del menú
+// de usuario y cada cambio se avisa con `alModificar` mientras la
+// cuenta está bloqueada. El bloqueo no es de toda la tabla: las cuentas
+// se reparten en franjas por el hash de la cédula, cada una con su
+// mutex en su propia línea de caché, así que los cajeros que operan
+// sobre cuentas distintas casi nunca se esperan (y `alModificar` puede
+// llamarse a la vez para cuentas de franjas distintas). La respuesta
+// sale después de `esperarPersistencia`, fuera del bloqueo: las esperas
+// de disco de varios cajeros se juntan en la misma sincronización de la
+// bitácora.
+
+/** Franjas de bloqueo de cuentas: 1 << BITS_FRANJAS_CUENTAS. */
+const int BITS_FRANJAS_CUENTAS = 8;
+
+/**
+ * @brief Se llama sin bloqueo antes de responder un cambio; vuelve
+ *        cuando el cambio ya es durable. Recibe el mismo `contexto` que
+ *        `alModificar`.
+ */
+typedef void (*EsperarPersistencia)(void* contexto);
+
+/**
+ * @brief Mutex de una franja de cuentas, solo en su línea de caché
+ *        (franjas vecinas no comparten línea).
+ */
+struct alignas(64) FranjaCuentas {
+    mutex m;
+};
+
+/**
+ * @brief Servicio que atiende cajeros remotos sobre las cuentas cargadas.
+ */
+struct ServicioCajero {
+    ListaCuentas* cuentas = nullptr;        /**< No se agregan cuentas mientras atiende */
+    const IndiceCedulas* indice = nullptr;
+    AlModificarCuenta alModificar = nullptr;/**< Se llama con la franja de la cuenta bloqueada */
+    EsperarPersistencia esperarPersistencia = nullptr;
+    void* contexto = nullptr;
+
+    FranjaCuentas franjas[1 << BITS_FRANJAS_CUENTAS];  /**< Protegen saldos y avisos de cambio */
+    mutex sesionesMutex;
+    condition_variable sesionTerminada;
+    int sesionesAbiertas = 0;
+    atomic<bool> detenido{false};
+    atomic<int> sesiones{0};                /**< Conexiones atendidas */
+    atomic<uint64_t> peticiones{0};         /**< Peticiones respondidas */
+};
+
+/**
+ * @brief Atiende conexiones hasta recibir SIGINT o SIGTERM (o detenerServicio()).
+ *
+ * Al terminar deja de aceptar, espera a que se cierren las sesiones
+ * abiertas y vuelve.
+ *
+ * @param servicio Servicio (se llenan las cuentas y los avisos).
+ * @param direccion Dirección donde escuchar.
+ * @param cuentas Cuentas de usuarios.
+ * @param indice Índice de cédulas de `cuentas`.
+ * @param alModificar Aviso opcional de cada cambio (debe admitir
+ *        llamadas simultáneas para cuentas distintas).
+ * @param esperarPersistencia Espera opcional antes de responder un cambio.
+ * @param contexto Dato que se pasa tal cual a los dos avisos.
+ * @return false si no se pudo escuchar en la dirección.
+ */
+bool atenderCajeros(ServicioCajero& servicio, const char* direccion, ListaCuentas& cuentas,
+                    const IndiceCedulas& indice, AlModificarCuenta alModificar,
+                    EsperarPersistencia esperarPersistencia, void* contexto);
+
+/**
+ * @brief Pide que atenderCajeros() termine.
+ */
+void detenerServicio(ServicioCajero& servicio);
+
+#endif // SERVICIO_CAJERO_H
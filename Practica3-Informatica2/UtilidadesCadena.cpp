@@ -222,3 +222,30 @@ bool esBinario(const char* texto) {
         return false;
     }
 }
+
+/**
+ * @brief Verifica si los primeros `len` caracteres son solo '0' y '1'.
+ *
+ * @param texto Caracteres a verificar (sin necesidad de '\0').
+ * @param len Cantidad de caracteres.
+ * @return `true` si es binaria, `false` en caso contrario.
+ *
+ * @throw const char* Si el puntero es nulo o `len` no es positivo.
+ */
+bool esBinarioN(const char* texto, int len) {
+    try {
+        if (!texto)
+            throw "Cadena nula en esBinarioN().";
+        if (len <= 0)
+            throw "Cadena vacía en esBinarioN().";
+
+        for (int i = 0; i < len; i++) {
+            if (texto[i] != '0' && texto[i] != '1')
+                return false;
+        }
+        return true;
+    } catch (const char* msg) {
+        cerr << "[Error] " << msg << endl;
+        return false;
+    }
+}
@@ -49,4 +49,10 @@ bool cadenasIguales(const char* a, const char* b);
  */
 bool esBinario(const char* texto);
 
+/**
+ * @brief Igual que esBinario(), sobre los primeros `len` caracteres
+ *        (la cadena no necesita terminar en '\0').
+ */
+bool esBinarioN(const char* texto, int len);
+
 #endif // UTILIDADES_CADENA_H
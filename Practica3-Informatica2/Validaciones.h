@@ -17,6 +17,12 @@ using namespace std;
  */
 bool validarCedula(const char cedula[]);
 
+/**
+ * @brief Igual que validarCedula(), sin escribir nada.
+ * @return nullptr si la cédula es válida; si no, el motivo del rechazo.
+ */
+const char* errorCedula(const char cedula[]);
+
 /**
  * @brief Verifica si una contraseña cumple con los requisitos de seguridad.
  *
@@ -30,6 +36,12 @@ bool validarCedula(const char cedula[]);
  */
 bool validarContrasena(const char password[]);
 
+/**
+ * @brief Igual que validarContrasena(), sin escribir nada.
+ * @return nullptr si la contraseña es válida; si no, el motivo del rechazo.
+ */
+const char* errorContrasena(const char password[]);
+
 /**
  * @brief Verifica si un saldo ingresado es válido.
  *
@@ -42,4 +54,10 @@ bool validarContrasena(const char password[]);
  */
 bool validarSaldo(const char saldo[]);
 
+/**
+ * @brief Igual que validarSaldo(), sin escribir nada.
+ * @return nullptr si el saldo es válido; si no, el motivo del rechazo.
+ */
+const char* errorSaldo(const char saldo[]);
+
 #endif // VALIDACIONES_H
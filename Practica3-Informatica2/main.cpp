@@ -6,56 +6,657 @@
  * y ejecución del menú principal usando manejo de errores manual con `throw` y `catch`.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <mutex>
 #include "Menu.h"
+#include "AlmacenSegmentado.h"
+#include "ArchivoRanuras.h"
+#include "Bitacora.h"
+#include "CifradoFlujo.h"
+#include "ClienteCajero.h"
+#include "Cuenta.h"
 #include "Encriptacion.h"
+#include "ImportacionUsuarios.h"
+#include "IndiceCedulas.h"
+#include "IndicePersistente.h"
 #include "ManipulacionDeArchivos.h"
+#include "PoolHilos.h"
+#include "ProcesamientoLote.h"
+#include "PuntoControl.h"
+#include "ServicioCajero.h"
+#include "UtilidadesCadena.h"
 
 using namespace std;
 
+const int SEMILLA = 4;                                  /**< Semilla de encriptación */
+
+/**
+ * @brief Encripta un arreglo de líneas y lo guarda sin modificarlo.
+ *
+ * Las líneas cifradas quedan en la arena (reutilizada entre archivos),
+ * de modo que guardar no reserva memoria por línea; el cifrado se
+ * reparte entre los hilos del pool.
+ *
+ * @param ruta Ruta del archivo destino.
+ * @param lineas Arreglo de líneas en texto plano.
+ * @param numLineas Número de líneas.
+ * @param semilla Semilla de encriptación.
+ * @param arena Arena de trabajo compartida.
+ * @param pool Pool de hilos.
+ * @param empaquetado true para el formato empaquetado, false para texto.
+ *
+ * Si los datos no caben en un archivo, guardarAlmacen() los reparte en
+ * segmentos.
+ *
+ * @throws const char* Si el cifrado o la escritura fallan.
+ */
+static void guardarEncriptado(const char* ruta, char** lineas, int numLineas, int semilla, ArenaCifrado& arena, PoolHilos& pool, bool empaquetado) {
+    char** cifradas = new char*[numLineas];
+    try {
+        encriptarArchivoEn(lineas, numLineas, semilla, arena, cifradas, pool);
+    } catch (const char*) {
+        delete[] cifradas;
+        throw;
+    }
+    bool ok = guardarAlmacen(ruta, cifradas, numLineas, empaquetado);
+    delete[] cifradas;
+    if (!ok)
+        throw "No se pudo guardar el archivo encriptado.";
+}
+
+/**
+ * @brief Amplía la caché de texto cifrado para que quepan `minimo` cuentas.
+ *
+ * Crece al doble, como la lista de cuentas: registrar cuentas una a una
+ * no copia la caché completa en cada registro. Las entradas nuevas
+ * quedan en nullptr.
+ *
+ * @param cifradas Caché de texto cifrado.
+ * @param numCifradas Entradas de la caché.
+ * @param minimo Entradas que debe tener como mínimo.
+ */
+static void ampliarCifradas(char**& cifradas, int& numCifradas, int minimo) {
+    if (numCifradas >= minimo) return;
+    int nueva = numCifradas < 8 ? 8 : numCifradas * 2;
+    if (nueva < minimo) nueva = minimo;
+    char** ampliada = new char*[nueva];
+    for (int i = 0; i < nueva; i++)
+        ampliada[i] = i < numCifradas ? cifradas[i] : nullptr;
+    delete[] cifradas;
+    cifradas = ampliada;
+    numCifradas = nueva;
+}
+
+/**
+ * @brief Guarda las cuentas cifrando solo las que cambiaron.
+ *
+ * `cifradas` guarda el texto cifrado de cada cuenta tal como está en el
+ * archivo. Las cuentas marcadas como modificadas (o sin texto cifrado,
+ * como las recién registradas) se serializan y se cifran en la arena;
+ * las demás reutilizan su texto cifrado. Si no hay cambios el archivo no
+ * se toca. Tras guardar, la caché queda al día y las marcas se limpian.
+ *
+ * @param ruta Ruta del almacén de usuarios.
+ * @param cuentas Cuentas en memoria.
+ * @param numCuentas Cantidad de cuentas.
+ * @param cifradas Caché de texto cifrado (se amplía si hay cuentas nuevas).
+ * @param numCifradas Entradas de la caché (las que sobran son nullptr).
+ * @param semilla Semilla de encriptación.
+ * @param arena Arena de trabajo compartida.
+ * @param pool Pool de hilos.
+ * @param empaquetado true para el formato empaquetado.
+ * @return Cantidad de cuentas cifradas de nuevo.
+ * @throws const char* Si el cifrado falla o no se pudo escribir el
+ *         almacén (las cuentas siguen marcadas como modificadas).
+ */
+static int guardarCuentas(const char* ruta, Cuenta* cuentas, int numCuentas, char**& cifradas, int& numCifradas,
+                          int semilla, ArenaCifrado& arena, PoolHilos& pool, bool empaquetado) {
+    ampliarCifradas(cifradas, numCifradas, numCuentas);
+
+    int* pendientes = new int[numCuentas];
+    int cantidad = 0;
+    for (int i = 0; i < numCuentas; i++)
+        if (cuentas[i].modificada || cifradas[i] == nullptr)
+            pendientes[cantidad++] = i;
+    if (cantidad == 0) {
+        delete[] pendientes;
+        return 0;
+    }
+
+    // Cifrar solo las cuentas pendientes y copiar el resultado a la caché
+    char** planas = new char*[cantidad];
+    char** nuevas = new char*[cantidad];
+    for (int j = 0; j < cantidad; j++)
+        planas[j] = serializarCuenta(cuentas[pendientes[j]]);
+    try {
+        encriptarArchivoEn(planas, cantidad, semilla, arena, nuevas, pool);
+    } catch (const char*) {
+        for (int j = 0; j < cantidad; j++) delete[] planas[j];
+        delete[] planas;
+        delete[] nuevas;
+        delete[] pendientes;
+        throw;
+    }
+    for (int j = 0; j < cantidad; j++) {
+        int i = pendientes[j];
+        delete[] cifradas[i];
+        cifradas[i] = new char[longitud(nuevas[j]) + 1];
+        copiar(cifradas[i], nuevas[j]);
+        delete[] planas[j];
+    }
+    delete[] planas;
+    delete[] nuevas;
+
+    bool ok = guardarAlmacen(ruta, cifradas, numCuentas, empaquetado);
+    if (ok)
+        for (int j = 0; j < cantidad; j++) cuentas[pendientes[j]].modificada = false;
+    delete[] pendientes;
+    if (!ok)
+        throw "No se pudo guardar el archivo de usuarios.";
+    return cantidad;
+}
+
+/**
+ * @brief Estado que necesita la escritura inmediata en ranuras fijas.
+ *
+ * Guarda referencias a las variables de main(): la lista de cuentas crece
+ * desde el menú de administrador y la caché crece al registrar.
+ */
+struct ContextoRanuras {
+    ArchivoRanuras archivo;
+    ListaCuentas& cuentas;
+    char**& cifradas;
+    int& numCifradas;
+    int semilla;
+    int escritas;
+    mutex m;                        /**< Turna la escritura; el cifrado va fuera */
+};
+
+/**
+ * @brief Cifra la cuenta `indice` y la escribe en su ranura.
+ *
+ * Si la escritura falla la cuenta sigue marcada como modificada y se
+ * guarda al salir con guardarCuentas(). En el servicio llegan cambios
+ * de varias cuentas a la vez: se cifran en paralelo y solo la escritura
+ * se turna.
+ *
+ * @param indice Posición de la cuenta.
+ * @param contexto Un ContextoRanuras.
+ */
+static void escribirCuentaEnRanura(int indice, int64_t, MotivoCambio, void* contexto) {
+    ContextoRanuras& ctx = *(ContextoRanuras*)contexto;
+    char* cifrada = serializarCuenta(ctx.cuentas.datos[indice]);
+    encriptarArchivo(&cifrada, 1, ctx.semilla);
+
+    lock_guard<mutex> lock(ctx.m);
+    if (!escribirRanura(ctx.archivo, indice, cifrada, longitud(cifrada))) {
+        cerr << "Advertencia: la cuenta no se pudo escribir en su ranura; se guardará al salir.\n";
+        delete[] cifrada;
+        return;
+    }
+
+    ampliarCifradas(ctx.cifradas, ctx.numCifradas, indice + 1);
+    delete[] ctx.cifradas[indice];
+    ctx.cifradas[indice] = cifrada;
+    ctx.cuentas.datos[indice].modificada = false;
+    ctx.escritas++;
+}
+
+/**
+ * @brief Estado de la reproducción de bitácoras al arrancar.
+ */
+struct ContextoReproduccion {
+    ListaCuentas* cuentas;
+    int numCargadas;                /**< Cuentas que venían en el snapshot */
+    bool* cambiadas;                /**< Cuentas del snapshot que cambiaron */
+    int numAltas;                   /**< Cuentas que no estaban en el snapshot */
+    IndiceCedulas* indice;
+    int huerfanas;                  /**< Movimientos de cuentas inexistentes */
+    uint64_t ultimaSecuencia;
+};
+
+/**
+ * @brief Aplica una entrada de la bitácora a las cuentas cargadas.
+ *
+ * La entrada trae la cuenta como quedó, así que si ya estaba en el
+ * snapshot no cambia nada; un alta que no está se agrega al final.
+ */
+static void aplicarMovimiento(const MovimientoCuenta& mov, void* contexto) {
+    ContextoReproduccion& ctx = *(ContextoReproduccion*)contexto;
+    ctx.ultimaSecuencia = mov.secuencia;
+
+    int i = buscarCedula(*ctx.indice, mov.cuenta.cedula);
+    if (i < 0) {
+        if (mov.motivo != MOTIVO_ALTA) {
+            ctx.huerfanas++;
+            return;
+        }
+        int posicion = agregarCuenta(*ctx.cuentas, mov.cuenta);
+        ctx.cuentas->datos[posicion].modificada = true;
+        insertarCedula(*ctx.indice, mov.cuenta.cedula, posicion);
+        ctx.numAltas++;
+        return;
+    }
+
+    Cuenta& cuenta = ctx.cuentas->datos[i];
+    if (cuenta.saldo != mov.cuenta.saldo) {
+        cuenta.saldo = mov.cuenta.saldo;
+        cuenta.modificada = true;
+        if (i < ctx.numCargadas) ctx.cambiadas[i] = true;
+    }
+}
+
+/**
+ * @brief Aplica sobre las cuentas cargadas las bitácoras que quedaron de
+ *        una sesión anterior.
+ *
+ * Se leen en orden la bitácora vieja (de una compactación que no
+ * terminó) y la actual. Las cuentas que cambian quedan marcadas como
+ * modificadas.
+ *
+ * @param rutas Bitácoras, de la más antigua a la más nueva.
+ * @param numRutas Cantidad de bitácoras.
+ * @param semilla Semilla de encriptación.
+ * @param cuentas Cuentas cargadas (las altas se agregan al final).
+ * @param indice Índice de cédulas de las cuentas.
+ * @param ultimaSecuencia Recibe la secuencia de la última entrada leída.
+ * @return Cantidad de cuentas que cambiaron.
+ * @throws const char* Si alguna bitácora está dañada.
+ */
+static int reproducirBitacoras(char** rutas, int numRutas, int semilla, ListaCuentas& cuentas,
+                               IndiceCedulas& indice, uint64_t& ultimaSecuencia) {
+    int numCargadas = cuentas.cantidad;
+    ContextoReproduccion ctx = { &cuentas, numCargadas, new bool[numCargadas > 0 ? numCargadas : 1](),
+                                 0, &indice, 0, 0 };
+    bool danada = false;
+    for (int r = 0; r < numRutas && !danada; r++)
+        danada = reproducirBitacora(rutas[r], semilla, aplicarMovimiento, &ctx) < 0;
+
+    int total = ctx.numAltas;
+    for (int i = 0; i < numCargadas; i++)
+        if (ctx.cambiadas[i]) total++;
+    delete[] ctx.cambiadas;
+
+    if (danada)
+        throw "La bitácora de movimientos está dañada; no se puede recuperar la sesión anterior.";
+    if (ctx.huerfanas > 0)
+        cerr << "Advertencia: " << ctx.huerfanas << " movimiento(s) de cuentas inexistentes se ignoraron.\n";
+
+    ultimaSecuencia = ctx.ultimaSecuencia;
+    return total;
+}
+
+/**
+ * @brief Estado del registro de movimientos: bitácora y puntos de control.
+ *
+ * Igual que ContextoRanuras, guarda referencias a las variables de main().
+ */
+struct ContextoBitacora {
+    Bitacora bitacora;
+    PuntoControl puntoControl;
+    ListaCuentas& cuentas;
+    int64_t tamPuntoControl;        /**< Bytes de bitácora antes de pedir un punto de control */
+    bool soloEncolar;               /**< Lote o servicio: se espera aparte, no en cada cambio */
+    atomic<uint64_t> ultimaEncolada;/**< Última entrada encolada sin esperar */
+};
+
+/**
+ * @brief Copia la cuenta a la sombra de los puntos de control y agrega
+ *        el movimiento a la bitácora, esperando a que esté en disco.
+ *
+ * Cuando la bitácora pasa de `tamPuntoControl` se pide un punto de
+ * control sin esperar al intervalo. En un lote o en el servicio la
+ * entrada solo se encola: el lote espera por `ultimaEncolada` al final
+ * y el servicio con esperarBitacora() antes de responder.
+ *
+ * @param indice Posición de la cuenta.
+ * @param delta Cambio de saldo.
+ * @param motivo Motivo del cambio.
+ * @param contexto Un ContextoBitacora.
+ */
+static void registrarEnBitacora(int indice, int64_t delta, MotivoCambio motivo, void* contexto) {
+    ContextoBitacora& ctx = *(ContextoBitacora*)contexto;
+    actualizarPuntoControl(ctx.puntoControl, indice, ctx.cuentas.datos[indice]);
+    if (!ctx.bitacora.escritor.joinable())
+        return;
+    uint64_t secuencia = registrarMovimiento(ctx.bitacora, motivo, delta, ctx.cuentas.datos[indice]);
+    if (secuencia != 0 && ctx.soloEncolar) {
+        // Con varios cajeros a la vez solo avanza: quien espera por la
+        // última encolada espera también por la suya
+        uint64_t anterior = ctx.ultimaEncolada;
+        while (anterior < secuencia && !ctx.ultimaEncolada.compare_exchange_weak(anterior, secuencia)) {}
+    } else if (secuencia == 0 || !esperarMovimiento(ctx.bitacora, secuencia)) {
+        cerr << "Advertencia: el movimiento no quedó en la bitácora; se guardará al salir.\n";
+        return;
+    }
+    if (tamanioBitacora(ctx.bitacora) >= ctx.tamPuntoControl)
+        solicitarPuntoControl(ctx.puntoControl);
+}
+
+/**
+ * @brief Espera a que la última entrada encolada esté en disco.
+ *
+ * El servicio la llama fuera del bloqueo de cuentas, así que varios
+ * cajeros esperan la misma sincronización de la bitácora.
+ *
+ * @param contexto Un ContextoBitacora.
+ */
+static void esperarBitacora(void* contexto) {
+    ContextoBitacora& ctx = *(ContextoBitacora*)contexto;
+    uint64_t secuencia = ctx.ultimaEncolada;
+    if (secuencia != 0 && !esperarMovimiento(ctx.bitacora, secuencia))
+        cerr << "Advertencia: el movimiento no quedó en la bitácora; se guardará al salir.\n";
+}
+
+/**
+ * @brief Procesa un archivo de lote e informa el resultado.
+ *
+ * Con la bitácora abierta, espera al final a que la última entrada
+ * encolada esté en disco.
+ *
+ * @param rutaLote Archivo de operaciones.
+ * @param cuentas Cuentas de usuarios.
+ * @param indice Índice de cédulas de `cuentas`.
+ * @param alModificar registrarEnBitacora, o nullptr si solo se guarda al final.
+ * @param bitacora Contexto de la bitácora.
+ */
+static void ejecutarLote(const char* rutaLote, ListaCuentas& cuentas, const IndiceCedulas& indice,
+                         AlModificarCuenta alModificar, ContextoBitacora* bitacora) {
+    char* rutaResultados = new char[longitud(rutaLote) + 12];
+    copiar(rutaResultados, rutaLote);
+    concatenar(rutaResultados, ".resultados");
+
+    ResumenLote resumen;
+    bool procesado = procesarLote(rutaLote, rutaResultados, cuentas, indice, alModificar, bitacora, resumen);
+    auto inicioBitacora = chrono::steady_clock::now();
+    bool confirmado = bitacora->ultimaEncolada == 0 || esperarMovimiento(bitacora->bitacora, bitacora->ultimaEncolada);
+    double segundosBitacora = chrono::duration<double>(chrono::steady_clock::now() - inicioBitacora).count();
+
+    cout << "Lote: " << resumen.operaciones << " operaciones en " << resumen.segundos << " s ("
+         << (resumen.segundos > 0 ? resumen.operaciones / resumen.segundos : 0) << " op/s).\n";
+    cout << "  " << resumen.exitosas << " exitosas, " << resumen.rechazadas << " rechazadas ("
+         << resumen.autenticaciones << " auth, " << resumen.consultas << " consultas, "
+         << resumen.retiros << " retiros).\n";
+    cout << "  Retirado " << resumen.totalRetirado << " COP, cobrado " << resumen.totalCobrado << " COP.\n";
+    if (bitacora->ultimaEncolada != 0)
+        cout << "  Bitácora " << (confirmado ? "confirmada" : "NO confirmada") << " en " << segundosBitacora << " s.\n";
+    if (procesado)
+        cout << "  Resultados en " << rutaResultados << "\n";
+    delete[] rutaResultados;
+}
+
+/**
+ * @brief Valor de una opción de la forma `prefijo=valor`.
+ *
+ * @return Lo que sigue a `prefijo`, o nullptr si `arg` no empieza con él.
+ */
+static const char* valorOpcion(const char* arg, const char* prefijo) {
+    int k = 0;
+    while (prefijo[k] != '\0' && arg[k] == prefijo[k]) k++;
+    return prefijo[k] == '\0' ? arg + k : nullptr;
+}
+
+/**
+ * @brief Lee el valor entero de una opción de la forma `prefijo=N`.
+ *
+ * @return true si `arg` empieza con `prefijo` (y entonces `valor` queda leído).
+ */
+static bool leerOpcionEntera(const char* arg, const char* prefijo, int& valor) {
+    const char* texto = valorOpcion(arg, prefijo);
+    if (texto == nullptr) return false;
+    valor = max(0, atoi(texto));
+    return true;
+}
+
+/**
+ * @brief Consulta una cédula en el índice en disco y trae solo su registro.
+ *
+ * En un almacén segmentado se ubica el registro en el manifiesto y se
+ * carga únicamente su segmento; un archivo suelto se proyecta completo.
+ * Del registro se muestran el titular y el saldo (nunca la clave).
+ *
+ * @return 0 si la cédula existe, 1 si no existe o el índice no sirve.
+ */
+static int consultarIndiceCedulas(const char* rutaUsuarios, const char* cedula) {
+    IndicePersistente indice;
+    if (!abrirIndicePersistente(indice, rutaUsuarios)) {
+        cerr << "El índice de cédulas no existe o está desactualizado (se rehace al iniciar el cajero).\n";
+        return 1;
+    }
+    UbicacionRegistro ubicacion;
+    bool existe = buscarEnIndicePersistente(indice, cedula, ubicacion);
+    cerrarIndicePersistente(indice);
+    if (!existe) {
+        cout << "Cédula " << cedula << ": no registrada.\n";
+        return 1;
+    }
+    cout << "Cédula " << cedula << ": registro " << ubicacion.registro << ", segmento " << ubicacion.segmento
+         << ", byte " << ubicacion.desplazamiento << " (" << ubicacion.longitud << " bytes).\n";
+
+    LineasMapeadas lineas;
+    uint64_t local = ubicacion.registro;
+    bool cargado;
+    if (esManifiestoSegmentado(rutaUsuarios)) {
+        ManifiestoAlmacen manifiesto;
+        int segmento = -1;
+        cargado = leerManifiesto(rutaUsuarios, manifiesto)
+                  && localizarRegistro(manifiesto, ubicacion.registro, segmento, local)
+                  && segmento == (int)ubicacion.segmento
+                  && cargarSegmento(rutaUsuarios, manifiesto, segmento, lineas);
+        liberarManifiesto(manifiesto);
+    } else {
+        cargado = cargarLineasMapeadas(rutaUsuarios, lineas);
+    }
+    if (!cargado || local >= (uint64_t)lineas.numLineas) {
+        cerr << "El registro no coincide con los datos (se rehace el índice al iniciar el cajero).\n";
+        liberarLineasMapeadas(lineas);
+        return 1;
+    }
+
+    PoolHilos pool(1);
+    char** plano = desencriptarVistas(&lineas.vistas[local], 1, SEMILLA, pool);
+    liberarLineasMapeadas(lineas);
+    Cuenta cuenta;
+    bool valida = plano != nullptr && parsearCuenta(plano[0], cuenta) && cuenta.cedula == empaquetarCedula(cedula);
+    if (plano != nullptr) {
+        delete[] plano[0];
+        delete[] plano;
+    }
+    if (!valida) {
+        cerr << "El registro no coincide con los datos (se rehace el índice al iniciar el cajero).\n";
+        return 1;
+    }
+    cout << "  Titular: " << cuenta.nombre << ", saldo " << cuenta.saldo << " COP.\n";
+    return 0;
+}
+
+/**
+ * @brief Indica si un archivo suelto de texto sigue en texto plano.
+ *
+ * Mira solo la primera línea no vacía: está en texto plano si trae algún
+ * caracter distinto de '0'/'1'. Un archivo que no existe o está en otro
+ * formato (empaquetado, ranuras o segmentos) no cuenta.
+ */
+static bool esTextoPlanoSuelto(const char* ruta) {
+    if (esManifiestoSegmentado(ruta) || esArchivoEmpaquetado(ruta) || esArchivoRanuras(ruta))
+        return false;
+    ifstream archivo(ruta, ios::binary);
+    bool vacia = true;
+    char c;
+    while (archivo.get(c)) {
+        if (c == '\r') continue;
+        if (c == '\n') {
+            if (!vacia) return false;
+            continue;
+        }
+        if (c != '0' && c != '1') return true;
+        vacia = false;
+    }
+    return false;
+}
+
 /**
  * @brief Función principal del sistema de cajero automático.
  *
  * Carga y verifica archivos, encripta/desencripta datos,
  * inicia el menú principal y guarda cambios de manera segura.
+ * Con el argumento `--migrar` solo convierte los archivos de datos
+ * al formato empaquetado; con `--ranuras` convierte el archivo de
+ * usuarios a ranuras fijas. Si el archivo de usuarios está en ranuras,
+ * cada cambio de una cuenta se escribe en el momento en su ranura;
+ * `--fsync=N` sincroniza a disco cada N escrituras (1 por defecto,
+ * 0 = solo al cerrar). En los demás formatos cada movimiento se agrega
+ * a una bitácora cifrada antes de seguir; al arrancar se reproduce la
+ * que haya quedado de una sesión interrumpida. Un hilo guarda un punto
+ * de control cada `--punto-control=S` segundos (30 por defecto, 0 = solo
+ * cuando la bitácora crece) sin detener el menú. Con `--sin-bitacora`
+ * no se registra cada movimiento y un corte pierde a lo sumo un
+ * intervalo. Junto al archivo de usuarios se mantiene un índice de
+ * cédulas en disco; `--buscar-cedula=X` lo consulta y trae solo ese
+ * registro (en un almacén segmentado, solo su segmento).
+ * En el primer arranque, si los dos archivos son de texto y siguen en
+ * texto plano, se cifran por flujo sin cargarlos
+ * (encriptarAlmacenFlujo()), así que su tamaño no está limitado por la
+ * carga; si el binario no cabe en un archivo queda en un almacén
+ * segmentado.
+ * Con `--importar=archivo.csv` se cargan en bloque usuarios
+ * "cedula,clave,nombre,saldo": se piden las credenciales de un
+ * administrador, se agregan las filas válidas, se guarda una sola vez y
+ * las rechazadas quedan en "archivo.csv.rechazos". Con `--lote=archivo`
+ * se aplican sin menú las operaciones del archivo (`auth`, `consulta`,
+ * `retiro <monto>` por cédula, ver ProcesamientoLote.h), el resultado de
+ * cada una queda en "archivo.resultados" y se informa el rendimiento;
+ * los cambios pasan por la misma bitácora que los del menú y se guardan
+ * al terminar.
+ *
+ * `--servicio=DIRECCION` carga las cuentas una vez y atiende muchos
+ * cajeros a la vez sobre un socket Unix (DIRECCION es su ruta) o sobre
+ * "tcp:PUERTO" en 127.0.0.1, hasta recibir Ctrl+C; al terminar guarda
+ * como el menú. `--cliente=DIRECCION` es el menú del cajero contra ese
+ * servicio y `--carga=DIRECCION` lo somete a carga (`--clientes=N`,
+ * `--peticiones=N`, `--credenciales=archivo.csv`, una cuenta por
+ * conexión como mínimo; con `--escalado` mide con 1, 2, 4, ... hasta N
+ * conexiones y termina con 1 si el rendimiento no crece con ellas, para
+ * lo que el servicio debe correr con `--sin-bitacora`). El protocolo está en
+ * ProtocoloCajero.h.
  *
  * @return 0 si la ejecución fue exitosa, 1 si ocurrió un error.
  */
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && cadenasIguales(argv[1], "--migrar")) {
+        bool ok = migrarArchivoEmpaquetado("../../Datos/usuarios.bin");
+        ok = migrarArchivoEmpaquetado("../../Datos/sudo.bin") && ok;
+        return ok ? 0 : 1;
+    }
+    if (argc > 1 && cadenasIguales(argv[1], "--ranuras"))
+        return migrarArchivoRanuras("../../Datos/usuarios.bin") ? 0 : 1;
+    if (argc > 1 && valorOpcion(argv[1], "--buscar-cedula=") != nullptr)
+        return consultarIndiceCedulas("../../Datos/usuarios.bin", valorOpcion(argv[1], "--buscar-cedula="));
+    if (argc > 1 && valorOpcion(argv[1], "--cliente=") != nullptr)
+        return menuCajeroRemoto(valorOpcion(argv[1], "--cliente="));
+    if (argc > 1 && valorOpcion(argv[1], "--carga=") != nullptr) {
+        OpcionesCarga carga;
+        carga.direccion = valorOpcion(argv[1], "--carga=");
+        carga.rutaCredenciales = "";
+        for (int a = 2; a < argc; a++) {
+            if (leerOpcionEntera(argv[a], "--clientes=", carga.clientes)) continue;
+            if (leerOpcionEntera(argv[a], "--peticiones=", carga.peticiones)) continue;
+            if (cadenasIguales(argv[a], "--escalado")) carga.escalado = true;
+            if (valorOpcion(argv[a], "--credenciales=") != nullptr)
+                carga.rutaCredenciales = valorOpcion(argv[a], "--credenciales=");
+        }
+        carga.clientes = max(1, carga.clientes);
+        carga.peticiones = max(1, carga.peticiones);
+        return generarCarga(carga);
+    }
+
+    int fsyncCada = 1;
+    int intervaloPuntoControl = 30;
+    bool usarBitacora = true;
+    const char* rutaImportacion = nullptr;
+    const char* rutaLote = nullptr;
+    const char* direccionServicio = nullptr;
+    for (int a = 1; a < argc; a++) {
+        if (leerOpcionEntera(argv[a], "--fsync=", fsyncCada)) continue;
+        if (leerOpcionEntera(argv[a], "--punto-control=", intervaloPuntoControl)) continue;
+        if (valorOpcion(argv[a], "--importar=") != nullptr) {
+            rutaImportacion = valorOpcion(argv[a], "--importar=");
+            continue;
+        }
+        if (valorOpcion(argv[a], "--lote=") != nullptr) {
+            rutaLote = valorOpcion(argv[a], "--lote=");
+            continue;
+        }
+        if (valorOpcion(argv[a], "--servicio=") != nullptr) {
+            direccionServicio = valorOpcion(argv[a], "--servicio=");
+            continue;
+        }
+        if (cadenasIguales(argv[a], "--sin-bitacora")) usarBitacora = false;
+    }
+
     try {
         char rutaUsuarios[] = "../../Datos/usuarios.bin";   /**< Ruta de usuarios */
         char rutaAdmins[]   = "../../Datos/sudo.bin";       /**< Ruta de administradores */
         int numUsuarios = 0, numAdmins = 0;                 /**< Contadores de registros */
-        const int SEMILLA = 4;                              /**< Semilla de encriptación */
+        const int NUM_HILOS = 0;                            /**< Hilos de cifrado (0 = todos los núcleos) */
+        const int64_t TAM_COMPACTAR_BITACORA = 1 << 20;     /**< Bytes de bitácora antes de un punto de control */
+        ArenaCifrado arena;                                 /**< Buffer reutilizado al cifrar */
+        PoolHilos pool(NUM_HILOS);                          /**< Hilos para cifrar/descifrar líneas */
 
         cout << "================================================\n";
         cout << "    SISTEMA DE CAJERO AUTOMATICO \n";
         cout << "         Carga Segura de Datos\n";
         cout << "================================================\n\n";
 
+        // Primer arranque con archivos de texto en texto plano: se cifran
+        // por flujo, sin cargarlos, y se cargan ya cifrados
+        if (esTextoPlanoSuelto(rutaUsuarios) && esTextoPlanoSuelto(rutaAdmins)) {
+            cout << "Archivos en texto plano → Encriptando por flujo con semilla " << SEMILLA << "...\n";
+            if (!encriptarAlmacenFlujo(rutaUsuarios, rutaUsuarios, SEMILLA) ||
+                !encriptarAlmacenFlujo(rutaAdmins, rutaAdmins, SEMILLA))
+                throw "Error al encriptar los archivos en texto plano.";
+            cout << "Archivos encriptados y guardados.\n\n";
+        }
+
         cout << "[1/5] Cargando archivos del sistema...\n";
-        char** usuarios = leerArchivoLineas(rutaUsuarios, numUsuarios);
-        char** admins   = leerArchivoLineas(rutaAdmins, numAdmins);
+        LineasMapeadas mapaUsuarios, mapaAdmins;            /**< Vistas sobre los archivos, sin copiar */
 
         // Validación manual
-        if (!usuarios || numUsuarios == 0)
+        if (!cargarLineasMapeadas(rutaUsuarios, mapaUsuarios))
             throw "Error: no se pudieron cargar los usuarios.";
-        if (!admins || numAdmins == 0)
+        if (!cargarLineasMapeadas(rutaAdmins, mapaAdmins)) {
+            liberarLineasMapeadas(mapaUsuarios);
             throw "Error: no se pudieron cargar los administradores.";
+        }
+        numUsuarios = mapaUsuarios.numLineas;
+        numAdmins = mapaAdmins.numLineas;
+
+        // Al guardar se respeta el formato en que estaba cada archivo
+        bool usuariosEmpaquetados = esAlmacenEmpaquetado(rutaUsuarios);
+        bool adminsEmpaquetados   = esAlmacenEmpaquetado(rutaAdmins);
 
         cout << "Archivos cargados correctamente.\n";
         cout << "  - Usuarios: " << numUsuarios << " registros\n";
         cout << "  - Admins: " << numAdmins << " registros\n\n";
 
         cout << "[2/5] Verificando estado de encriptacion...\n";
-        bool yaEncriptados = verificarEstadoEncriptacion(usuarios, admins);
+        bool yaEncriptados = verificarEstadoEncriptacion(mapaUsuarios.vistas[0], mapaAdmins.vistas[0]);
 
         if (!yaEncriptados) {
             cout << "Archivos en texto plano → Encriptando con semilla " << SEMILLA << "...\n";
-            encriptarArchivo(admins, numAdmins, SEMILLA);
-            encriptarArchivo(usuarios, numUsuarios, SEMILLA);
-            guardarArchivoLineas(rutaUsuarios, usuarios, numUsuarios);
-            guardarArchivoLineas(rutaAdmins, admins, numAdmins);
+            // Se van a sobrescribir: recién aquí se copian las líneas
+            char** usuarios = copiarLineas(mapaUsuarios, numUsuarios);
+            char** admins   = copiarLineas(mapaAdmins, numAdmins);
+            liberarLineasMapeadas(mapaUsuarios);
+            liberarLineasMapeadas(mapaAdmins);
+
+            guardarEncriptado(rutaUsuarios, usuarios, numUsuarios, SEMILLA, arena, pool, usuariosEmpaquetados);
+            guardarEncriptado(rutaAdmins, admins, numAdmins, SEMILLA, arena, pool, adminsEmpaquetados);
             cout << "Archivos encriptados y guardados.\n\n";
 
             // Liberar memoria
@@ -65,41 +666,195 @@ int main() {
             delete[] admins;
 
             // Recargar archivos
-            usuarios = leerArchivoLineas(rutaUsuarios, numUsuarios);
-            admins   = leerArchivoLineas(rutaAdmins, numAdmins);
-            if (!usuarios || !admins)
+            if (!cargarLineasMapeadas(rutaUsuarios, mapaUsuarios) || !cargarLineasMapeadas(rutaAdmins, mapaAdmins)) {
+                liberarLineasMapeadas(mapaUsuarios);
                 throw "Error al recargar los archivos encriptados.";
+            }
+            numUsuarios = mapaUsuarios.numLineas;
+            numAdmins = mapaAdmins.numLineas;
             cout << "Archivos recargados.\n\n";
         } else {
             cout << "Los archivos ya están encriptados.\n\n";
         }
 
+        // El binario se lee de la proyección; solo se reserva el texto plano
         cout << "[" << (yaEncriptados ? "3" : "4") << "/5] Desencriptando datos en memoria...\n";
-        desencriptarArchivo(admins, numAdmins, SEMILLA);
-        desencriptarArchivo(usuarios, numUsuarios, SEMILLA);
-        cout << "Datos desencriptados y listos para usar.\n\n";
+        char** admins   = desencriptarVistas(mapaAdmins.vistas, numAdmins, SEMILLA, pool);
+        char** usuarios = desencriptarVistas(mapaUsuarios.vistas, numUsuarios, SEMILLA, pool);
+        // El texto cifrado se conserva: al guardar solo se cifran las
+        // cuentas que cambiaron
+        int numCifradas = 0;
+        char** cifradasUsuarios = copiarLineas(mapaUsuarios, numCifradas);
+        liberarLineasMapeadas(mapaUsuarios);   // al final se sobrescriben los archivos
+        liberarLineasMapeadas(mapaAdmins);
+        if (!usuarios || !admins)
+            throw "Error al desencriptar los datos.";
+        cout << "Datos desencriptados y listos para usar.\n";
 
-        cout << "--- DEPURACION: Usuarios desencriptados ---\n";
-        mostrarLineas(usuarios, numUsuarios);
-        cout << "--- DEPURACION: Administradores desencriptados ---\n";
-        mostrarLineas(admins, numAdmins);
+        // Modo depuración (solo con el menú local)
+        if (rutaImportacion == nullptr && rutaLote == nullptr && direccionServicio == nullptr) {
+            cout << "--- DEPURACION: Usuarios desencriptados ---\n";
+            mostrarLineas(usuarios, numUsuarios);
+            cout << "--- DEPURACION: Administradores desencriptados ---\n";
+            mostrarLineas(admins, numAdmins);
+        }
+
+        // Las cuentas se interpretan una sola vez; las líneas se vuelven a
+        // armar solo al guardar
+        ListaCuentas cuentas;
+        bool cargadas = cargarCuentas(usuarios, numUsuarios, cuentas);
+        for (int i = 0; i < numUsuarios; i++) delete[] usuarios[i];
+        delete[] usuarios;
+        if (!cargadas)
+            throw "Los registros de usuarios tienen un formato inválido.";
+
+        // Índices por cédula: las búsquedas del menú dejan de recorrer
+        // todos los registros
+        IndiceCedulas indiceUsuarios, indiceAdmins;
+        int sinIndice = indexarCuentas(indiceUsuarios, cuentas.datos, cuentas.cantidad)
+                      + construirIndiceCedulas(indiceAdmins, admins, numAdmins);
+        if (sinIndice > 0)
+            cerr << "Advertencia: " << sinIndice << " registro(s) con cédula inválida o repetida no se indexaron.\n";
+        cout << "\n";
+
+        // Bitácora: lo que una sesión interrumpida no llegó a guardar se
+        // aplica y se guarda antes de empezar
+        char rutaBitacora[sizeof(rutaUsuarios) + 10], rutaBitacoraVieja[sizeof(rutaUsuarios) + 16];
+        copiar(rutaBitacora, rutaUsuarios);
+        concatenar(rutaBitacora, ".bitacora");
+        copiar(rutaBitacoraVieja, rutaBitacora);
+        concatenar(rutaBitacoraVieja, ".vieja");
+        char* rutasBitacora[] = { rutaBitacoraVieja, rutaBitacora };
+
+        uint64_t ultimaSecuencia = 0;
+        int recuperadas = reproducirBitacoras(rutasBitacora, 2, SEMILLA, cuentas, indiceUsuarios, ultimaSecuencia);
+        if (recuperadas > 0) {
+            guardarCuentas(rutaUsuarios, cuentas.datos, cuentas.cantidad, cifradasUsuarios, numCifradas, SEMILLA,
+                           arena, pool, usuariosEmpaquetados);
+            cout << "Bitácora: " << recuperadas << " cuenta(s) recuperadas de la sesión anterior.\n\n";
+        }
+        remove(rutaBitacoraVieja);
+        remove(rutaBitacora);
+
+        // Índice en disco: se rehace si falta o no corresponde a los datos
+        if (!indicePersistenteVigente(rutaUsuarios))
+            guardarIndicePersistente(rutaUsuarios, cuentas.datos, cifradasUsuarios, cuentas.cantidad);
+
+        // Importación masiva: en lugar del menú se agregan las filas
+        // aceptadas del CSV y se guarda una sola vez
+        if (rutaImportacion != nullptr) {
+            if (!autenticarAdministrador(admins, numAdmins, indiceAdmins))
+                throw "Credenciales inválidas.";
+            ResultadoImportacion resultado;
+            if (!importarUsuarios(rutaImportacion, cuentas, indiceUsuarios, pool, resultado))
+                throw "No se pudo leer el archivo de importación.";
+
+            auto inicioGuardado = chrono::steady_clock::now();
+            guardarCuentas(rutaUsuarios, cuentas.datos, cuentas.cantidad, cifradasUsuarios, numCifradas, SEMILLA,
+                           arena, pool, usuariosEmpaquetados);
+            guardarIndicePersistente(rutaUsuarios, cuentas.datos, cifradasUsuarios, cuentas.cantidad);
+            double segundosGuardado = chrono::duration<double>(chrono::steady_clock::now() - inicioGuardado).count();
+
+            char* rutaRechazos = new char[longitud(rutaImportacion) + 10];
+            copiar(rutaRechazos, rutaImportacion);
+            concatenar(rutaRechazos, ".rechazos");
+            cout << "\nImportación: " << resultado.filas << " filas, " << resultado.aceptadas << " aceptadas, "
+                 << resultado.numRechazos << " rechazadas.\n";
+            cout << "  Validación " << resultado.segundosValidacion << " s, duplicados "
+                 << resultado.segundosDuplicados << " s, cifrado y guardado " << segundosGuardado << " s.\n";
+            if (resultado.numRechazos > 0 && guardarReporteRechazos(rutaRechazos, resultado))
+                cout << "  Rechazos en " << rutaRechazos << "\n";
+            delete[] rutaRechazos;
+            liberarResultadoImportacion(resultado);
+
+            liberarIndiceCedulas(indiceUsuarios);
+            liberarIndiceCedulas(indiceAdmins);
+            liberarArena(arena);
+            liberarCuentas(cuentas);
+            for (int i = 0; i < numCifradas; i++) delete[] cifradasUsuarios[i];
+            delete[] cifradasUsuarios;
+            for (int i = 0; i < numAdmins; i++) delete[] admins[i];
+            delete[] admins;
+            return 0;
+        }
 
         cout << "[" << (yaEncriptados ? "4" : "5") << "/5] Iniciando sistema de cajero...\n";
         cout << "\n\n\n\n\n\n\n\n\n\n";
 
+        // Con ranuras fijas cada cambio se cifra y se escribe de inmediato
+        // en la ranura de la cuenta; un lote sobre ranuras no escribe
+        // cuenta por cuenta: se guarda una sola vez al terminar
+        ContextoRanuras ranuras = { ArchivoRanuras(), cuentas, cifradasUsuarios, numCifradas, SEMILLA, 0, {} };
+        bool usuariosEnRanuras = esArchivoRanuras(rutaUsuarios);
+        if (usuariosEnRanuras && rutaLote == nullptr)
+            abrirRanuras(ranuras.archivo, rutaUsuarios, fsyncCada);
+
+        // En los demás formatos el snapshot lo reescribe el hilo de puntos
+        // de control; cada movimiento se agrega antes a la bitácora
+        ContextoBitacora bitacora = { Bitacora(), PuntoControl(), cuentas, TAM_COMPACTAR_BITACORA,
+                                      rutaLote != nullptr || direccionServicio != nullptr, 0 };
+        if (!usuariosEnRanuras) {
+            if (usarBitacora)
+                abrirBitacora(bitacora.bitacora, rutaBitacora, SEMILLA, ultimaSecuencia + 1);
+            iniciarPuntoControl(bitacora.puntoControl, rutaUsuarios, cuentas.datos, cuentas.cantidad, SEMILLA,
+                                usuariosEmpaquetados, pool, intervaloPuntoControl,
+                                usarBitacora ? &bitacora.bitacora : nullptr, rutaBitacoraVieja);
+        }
+
         // Ejecución principal
-        menuPrincipal(usuarios, numUsuarios, admins, numAdmins);
+        if (rutaLote != nullptr)
+            ejecutarLote(rutaLote, cuentas, indiceUsuarios,
+                         usuariosEnRanuras ? nullptr : registrarEnBitacora, &bitacora);
+        else if (direccionServicio != nullptr) {
+            ServicioCajero servicio;
+            cout << "Servicio de cajeros en " << direccionServicio << " (Ctrl+C para terminar)." << endl;
+            bool atendido = ranurasAbiertas(ranuras.archivo)
+                ? atenderCajeros(servicio, direccionServicio, cuentas, indiceUsuarios,
+                                 escribirCuentaEnRanura, nullptr, &ranuras)
+                : atenderCajeros(servicio, direccionServicio, cuentas, indiceUsuarios,
+                                 registrarEnBitacora, esperarBitacora, &bitacora);
+            if (atendido)
+                cout << "\nServicio detenido: " << servicio.sesiones << " sesiones, "
+                     << servicio.peticiones << " peticiones.\n";
+            else
+                cerr << "\n[Error] No se pudo iniciar el servicio de cajeros.\n";
+        }
+        else if (ranurasAbiertas(ranuras.archivo))
+            menuPrincipal(cuentas, admins, numAdmins, indiceUsuarios, indiceAdmins,
+                          escribirCuentaEnRanura, &ranuras);
+        else
+            menuPrincipal(cuentas, admins, numAdmins, indiceUsuarios, indiceAdmins,
+                          registrarEnBitacora, &bitacora);
+        cerrarRanuras(ranuras.archivo);
+        detenerPuntoControl(bitacora.puntoControl);
+        cerrarBitacora(bitacora.bitacora);
+        liberarIndiceCedulas(indiceUsuarios);
+        liberarIndiceCedulas(indiceAdmins);
 
+        // Los administradores no cambian durante la sesión: su archivo no
+        // se reescribe
         cout << "\nGuardando cambios de forma segura...\n";
-        encriptarArchivo(admins, numAdmins, SEMILLA);
-        encriptarArchivo(usuarios, numUsuarios, SEMILLA);
-        guardarArchivoLineas(rutaUsuarios, usuarios, numUsuarios);
-        guardarArchivoLineas(rutaAdmins, admins, numAdmins);
-        cout << "Datos guardados y encriptados correctamente.\n";
+        int recifradas = guardarCuentas(rutaUsuarios, cuentas.datos, cuentas.cantidad, cifradasUsuarios, numCifradas,
+                                        SEMILLA, arena, pool, usuariosEmpaquetados);
+        if (!indicePersistenteVigente(rutaUsuarios))
+            guardarIndicePersistente(rutaUsuarios, cuentas.datos, cifradasUsuarios, cuentas.cantidad);
+        liberarArena(arena);
+        // El snapshot ya tiene todo y está en disco (guardarCuentas() lanza
+        // si no): la bitácora sobra
+        remove(rutaBitacoraVieja);
+        remove(rutaBitacora);
+        if (recifradas > 0)
+            cout << "Datos guardados y encriptados correctamente (" << recifradas
+                 << " de " << cuentas.cantidad << " cuentas cifradas de nuevo).\n";
+        else if (ranuras.escritas > 0)
+            cout << "Cambios ya escritos en sus ranuras: " << ranuras.escritas << ".\n";
+        else
+            cout << "No hubo cambios: los archivos no se reescribieron.\n";
 
         // Liberar memoria
-        for (int i = 0; i < numUsuarios; i++) delete[] usuarios[i];
-        delete[] usuarios;
+        liberarCuentas(cuentas);
+        for (int i = 0; i < numCifradas; i++) delete[] cifradasUsuarios[i];
+        delete[] cifradasUsuarios;
         for (int i = 0; i < numAdmins; i++) delete[] admins[i];
         delete[] admins;
 
@@ -16,35 +16,40 @@ using namespace std;
  * - No puede comenzar con '0'.
  *
  * @param cedula La cadena que representa la cédula.
- * @return `true` si la cédula es válida, `false` en caso contrario.
+ * @return nullptr si la cédula es válida; si no, el motivo del rechazo.
  */
-bool validarCedula(const char* cedula) {
-    try {
-        if (cedula == nullptr)
-            throw "Puntero nulo recibido en validarCedula.";
-
-        int longitud = 0;
-
-        if (cedula[0] == '0')
-            throw "La cédula no puede comenzar con 0.";
-
-        while (cedula[longitud] != '\0') {
-            char c = cedula[longitud];
-            if (c < '0' || c > '9')
-                throw "La cédula contiene caracteres no numéricos.";
-            longitud++;
-            if (longitud > 10)
-                throw "La cédula excede los 10 dígitos permitidos.";
-        }
-
-        if (longitud < 6 || longitud > 10)
-            throw "La cédula debe tener entre 6 y 10 dígitos.";
-
-        return true;
-    } catch (const char* msg) {
-        cerr << "Error en validarCedula: " << msg << endl;
-        return false;
+const char* errorCedula(const char* cedula) {
+    if (cedula == nullptr)
+        return "Puntero nulo recibido en validarCedula.";
+
+    int longitud = 0;
+
+    if (cedula[0] == '0')
+        return "La cédula no puede comenzar con 0.";
+
+    while (cedula[longitud] != '\0') {
+        char c = cedula[longitud];
+        if (c < '0' || c > '9')
+            return "La cédula contiene caracteres no numéricos.";
+        longitud++;
+        if (longitud > 10)
+            return "La cédula excede los 10 dígitos permitidos.";
     }
+
+    if (longitud < 6 || longitud > 10)
+        return "La cédula debe tener entre 6 y 10 dígitos.";
+
+    return nullptr;
+}
+
+/**
+ * @brief Igual que errorCedula(), informando el motivo por cerr.
+ */
+bool validarCedula(const char* cedula) {
+    const char* error = errorCedula(cedula);
+    if (error != nullptr)
+        cerr << "Error en validarCedula: " << error << endl;
+    return error == nullptr;
 }
 
 // ================================
@@ -61,46 +66,51 @@ bool validarCedula(const char* cedula) {
  * - Solo caracteres imprimibles ASCII.
  *
  * @param clave La cadena de la contraseña.
- * @return `true` si es válida, `false` si no lo es.
+ * @return nullptr si la contraseña es válida; si no, el motivo del rechazo.
  */
-bool validarContrasena(const char* clave) {
-    try {
-        if (clave == nullptr)
-            throw "Puntero nulo recibido en validarContrasena.";
-
-        int longitud = 0;
-        bool tieneNumero = false;
-        bool tieneMayuscula = false;
-        bool tieneMinuscula = false;
-        bool tieneEspecial = false;
-
-        while (clave[longitud] != '\0') {
-            unsigned char c = clave[longitud];
-
-            if (c >= '0' && c <= '9') tieneNumero = true;
-            else if (c >= 'A' && c <= 'Z') tieneMayuscula = true;
-            else if (c >= 'a' && c <= 'z') tieneMinuscula = true;
-            else if (c == ' ' || c == '\t')
-                throw "La contraseña contiene espacios o tabulaciones.";
-            else if (c >= 33 && c <= 126)
-                tieneEspecial = true;
-            else
-                throw "La contraseña contiene caracteres no válidos.";
-
-            longitud++;
-        }
-
-        if (longitud < 8 || longitud > 20)
-            throw "La contraseña debe tener entre 8 y 20 caracteres.";
-
-        if (!(tieneNumero && tieneMayuscula && tieneMinuscula && tieneEspecial))
-            throw "La contraseña no cumple con los requisitos de complejidad.";
-
-        return true;
-    } catch (const char* msg) {
-        cerr << "Error en validarContrasena: " << msg << endl;
-        return false;
+const char* errorContrasena(const char* clave) {
+    if (clave == nullptr)
+        return "Puntero nulo recibido en validarContrasena.";
+
+    int longitud = 0;
+    bool tieneNumero = false;
+    bool tieneMayuscula = false;
+    bool tieneMinuscula = false;
+    bool tieneEspecial = false;
+
+    while (clave[longitud] != '\0') {
+        unsigned char c = clave[longitud];
+
+        if (c >= '0' && c <= '9') tieneNumero = true;
+        else if (c >= 'A' && c <= 'Z') tieneMayuscula = true;
+        else if (c >= 'a' && c <= 'z') tieneMinuscula = true;
+        else if (c == ' ' || c == '\t')
+            return "La contraseña contiene espacios o tabulaciones.";
+        else if (c >= 33 && c <= 126)
+            tieneEspecial = true;
+        else
+            return "La contraseña contiene caracteres no válidos.";
+
+        longitud++;
     }
+
+    if (longitud < 8 || longitud > 20)
+        return "La contraseña debe tener entre 8 y 20 caracteres.";
+
+    if (!(tieneNumero && tieneMayuscula && tieneMinuscula && tieneEspecial))
+        return "La contraseña no cumple con los requisitos de complejidad.";
+
+    return nullptr;
+}
+
+/**
+ * @brief Igual que errorContrasena(), informando el motivo por cerr.
+ */
+bool validarContrasena(const char* clave) {
+    const char* error = errorContrasena(clave);
+    if (error != nullptr)
+        cerr << "Error en validarContrasena: " << error << endl;
+    return error == nullptr;
 }
 
 // ================================
@@ -116,33 +126,38 @@ bool validarContrasena(const char* clave) {
  * - Valor entre 0 y 1,000,000.
  *
  * @param saldoStr La cadena del saldo.
- * @return `true` si es válido, `false` si no lo es.
+ * @return nullptr si el saldo es válido; si no, el motivo del rechazo.
  */
-bool validarSaldo(const char* saldoStr) {
-    try {
-        if (saldoStr == nullptr)
-            throw "Puntero nulo recibido en validarSaldo.";
-
-        int i = 0;
-        long saldo = 0;
-
-        while (saldoStr[i] != '\0') {
-            char c = saldoStr[i];
-            if (c < '0' || c > '9')
-                throw "El saldo contiene caracteres no numéricos.";
-
-            saldo = saldo * 10 + (c - '0');
-            if (saldo > 1000000)
-                throw "El saldo excede el máximo permitido (1,000,000).";
-            i++;
-        }
-
-        if (i == 0)
-            throw "El saldo está vacío.";
-
-        return (saldo >= 0 && saldo <= 1000000);
-    } catch (const char* msg) {
-        cerr << "Error en validarSaldo: " << msg << endl;
-        return false;
+const char* errorSaldo(const char* saldoStr) {
+    if (saldoStr == nullptr)
+        return "Puntero nulo recibido en validarSaldo.";
+
+    int i = 0;
+    long saldo = 0;
+
+    while (saldoStr[i] != '\0') {
+        char c = saldoStr[i];
+        if (c < '0' || c > '9')
+            return "El saldo contiene caracteres no numéricos.";
+
+        saldo = saldo * 10 + (c - '0');
+        if (saldo > 1000000)
+            return "El saldo excede el máximo permitido (1,000,000).";
+        i++;
     }
+
+    if (i == 0)
+        return "El saldo está vacío.";
+
+    return nullptr;
+}
+
+/**
+ * @brief Igual que errorSaldo(), informando el motivo por cerr.
+ */
+bool validarSaldo(const char* saldoStr) {
+    const char* error = errorSaldo(saldoStr);
+    if (error != nullptr)
+        cerr << "Error en validarSaldo: " << error << endl;
+    return error == nullptr;
 }
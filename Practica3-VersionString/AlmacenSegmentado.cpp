@@ -0,0 +1,310 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "AlmacenSegmentado.h"
+#include "ArchivoRanuras.h"
+using namespace std;
+
+/// Primeros bytes de un manifiesto.
+static const char MAGIA_MANIFIESTO[4] = { 'P', '3', 'S', 'M' };
+
+/**
+ * @brief Escribe un entero de `bytes` bytes en little-endian.
+ */
+static void escribirLE(char* destino, uint64_t valor, int bytes) {
+    for (int k = 0; k < bytes; k++)
+        destino[k] = static_cast<char>((valor >> (8 * k)) & 0xFF);
+}
+
+/**
+ * @brief Lee un entero de `bytes` bytes en little-endian.
+ */
+static uint64_t leerLE(const char* origen, int bytes) {
+    uint64_t valor = 0;
+    for (int k = bytes - 1; k >= 0; k--)
+        valor = (valor << 8) | static_cast<unsigned char>(origen[k]);
+    return valor;
+}
+
+bool esManifiestoSegmentado(const string& ruta) {
+    ifstream archivo(ruta, ios::binary);
+    char magia[4];
+    if (!archivo.read(magia, 4)) return false;
+    return memcmp(magia, MAGIA_MANIFIESTO, 4) == 0;
+}
+
+bool esAlmacenEmpaquetado(const string& ruta) {
+    if (!esManifiestoSegmentado(ruta)) return esArchivoEmpaquetado(ruta);
+    ManifiestoAlmacen manifiesto;
+    return leerManifiesto(ruta, manifiesto) && manifiesto.empaquetado;
+}
+
+/**
+ * @brief Lee y valida un manifiesto.
+ *
+ * @throws const char* Si la cabecera o las entradas no son coherentes.
+ */
+bool leerManifiesto(const string& ruta, ManifiestoAlmacen& manifiesto) {
+    manifiesto = ManifiestoAlmacen();
+    try {
+        ifstream archivo(ruta, ios::binary);
+        if (!archivo.is_open()) {
+            throw "No se pudo abrir el manifiesto.";
+        }
+
+        char cabecera[TAM_CABECERA_MANIFIESTO];
+        if (!archivo.read(cabecera, TAM_CABECERA_MANIFIESTO)) {
+            throw "Cabecera incompleta.";
+        }
+        if (memcmp(cabecera, MAGIA_MANIFIESTO, 4) != 0) {
+            throw "El archivo no es un manifiesto.";
+        }
+        if (static_cast<uint8_t>(cabecera[4]) != VERSION_MANIFIESTO) {
+            throw "Versión de manifiesto no soportada.";
+        }
+
+        manifiesto.empaquetado = cabecera[5] != 0;
+        manifiesto.generacion = static_cast<uint32_t>(leerLE(&cabecera[8], 4));
+        uint32_t numSegmentos = static_cast<uint32_t>(leerLE(&cabecera[12], 4));
+        manifiesto.totalRegistros = leerLE(&cabecera[16], 8);
+        if (numSegmentos == 0) {
+            throw "Manifiesto sin segmentos.";
+        }
+
+        vector<char> entradas(static_cast<size_t>(numSegmentos) * TAM_ENTRADA_MANIFIESTO);
+        if (!archivo.read(entradas.data(), entradas.size())) {
+            throw "Manifiesto truncado.";
+        }
+
+        uint64_t suma = 0;
+        manifiesto.segmentos.resize(numSegmentos);
+        for (uint32_t i = 0; i < numSegmentos; i++) {
+            const char* entrada = &entradas[static_cast<size_t>(i) * TAM_ENTRADA_MANIFIESTO];
+            manifiesto.segmentos[i].registros = leerLE(entrada, 8);
+            manifiesto.segmentos[i].bytes = leerLE(entrada + 8, 8);
+            suma += manifiesto.segmentos[i].registros;
+        }
+        if (suma != manifiesto.totalRegistros) {
+            throw "El total de registros no coincide con los segmentos.";
+        }
+        return true;
+    }
+    catch (const char* e) {
+        cerr << "ERROR en leerManifiesto(): " << e << endl;
+        manifiesto = ManifiestoAlmacen();
+        return false;
+    }
+}
+
+string rutaSegmento(const string& ruta, uint32_t generacion, size_t indice) {
+    char sufijo[32];
+    snprintf(sufijo, sizeof(sufijo), ".g%u.%04zu", static_cast<unsigned>(generacion), indice);
+    return ruta + sufijo;
+}
+
+/**
+ * @brief Ubica un registro global recorriendo los conteos del manifiesto.
+ */
+bool localizarRegistro(const ManifiestoAlmacen& manifiesto, uint64_t indice, size_t& segmento, uint64_t& indiceLocal) {
+    for (size_t i = 0; i < manifiesto.segmentos.size(); i++) {
+        if (indice < manifiesto.segmentos[i].registros) {
+            segmento = i;
+            indiceLocal = indice;
+            return true;
+        }
+        indice -= manifiesto.segmentos[i].registros;
+    }
+    return false;
+}
+
+bool cargarSegmento(const string& ruta, const ManifiestoAlmacen& manifiesto, size_t indice, LineasMapeadas& lineas) {
+    lineas.cerrar();
+    if (indice >= manifiesto.segmentos.size()) {
+        cerr << "ERROR en cargarSegmento(): segmento fuera de rango." << endl;
+        return false;
+    }
+    if (!cargarLineasMapeadas(rutaSegmento(ruta, manifiesto.generacion, indice), lineas)) {
+        return false;
+    }
+    if (lineas.vistas.size() != manifiesto.segmentos[indice].registros) {
+        cerr << "ERROR en cargarSegmento(): el segmento no coincide con el manifiesto." << endl;
+        lineas.cerrar();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Bytes que ocupa una línea dentro de un segmento.
+ */
+static uint64_t bytesRegistro(const string& linea, bool empaquetado) {
+    return empaquetado ? 4 + linea.size() / 8 : linea.size() + 1;
+}
+
+/**
+ * @brief Borra los segmentos [0, numSegmentos) de una generación.
+ */
+static void borrarSegmentos(const string& ruta, uint32_t generacion, size_t numSegmentos) {
+    for (size_t i = 0; i < numSegmentos; i++)
+        remove(rutaSegmento(ruta, generacion, i).c_str());
+}
+
+/**
+ * @brief Escribe un archivo suelto, de texto o empaquetado, por temporal
+ *        y reemplazarArchivo().
+ */
+static bool guardarArchivoSuelto(const string& ruta, const string* lineas, int numLineas, bool empaquetado,
+                                 bool silencioso) {
+    // guardarArchivoLineas() ya pasa por su propio temporal
+    if (!empaquetado)
+        return guardarArchivoLineas(ruta, lineas, numLineas, silencioso);
+    const string temporal = ruta + ".tmp";
+    if (!guardarArchivoEmpaquetado(temporal, lineas, numLineas, silencioso)) {
+        remove(temporal.c_str());
+        return false;
+    }
+    if (!reemplazarArchivo(temporal, ruta)) {
+        cerr << "ERROR: no se pudo reemplazar " << ruta << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Escribe el manifiesto en un temporal, lo reemplaza con
+ *        reemplazarArchivo() y recién entonces borra la generación anterior.
+ */
+bool publicarManifiesto(const string& ruta, const ManifiestoAlmacen& manifiesto) {
+    ManifiestoAlmacen anterior;
+    bool habiaManifiesto = esManifiestoSegmentado(ruta) && leerManifiesto(ruta, anterior);
+
+    vector<char> contenido(TAM_CABECERA_MANIFIESTO + manifiesto.segmentos.size() * TAM_ENTRADA_MANIFIESTO, 0);
+    memcpy(contenido.data(), MAGIA_MANIFIESTO, 4);
+    contenido[4] = static_cast<char>(VERSION_MANIFIESTO);
+    contenido[5] = manifiesto.empaquetado ? 1 : 0;
+    escribirLE(&contenido[8], manifiesto.generacion, 4);
+    escribirLE(&contenido[12], manifiesto.segmentos.size(), 4);
+    escribirLE(&contenido[16], manifiesto.totalRegistros, 8);
+    for (size_t i = 0; i < manifiesto.segmentos.size(); i++) {
+        char* entrada = &contenido[TAM_CABECERA_MANIFIESTO + i * TAM_ENTRADA_MANIFIESTO];
+        escribirLE(entrada, manifiesto.segmentos[i].registros, 8);
+        escribirLE(entrada + 8, manifiesto.segmentos[i].bytes, 8);
+    }
+
+    const string temporal = ruta + ".tmp";
+    {
+        ofstream archivo(temporal, ios::trunc | ios::binary);
+        if (!archivo.is_open() || !archivo.write(contenido.data(), contenido.size())) {
+            remove(temporal.c_str());
+            return false;
+        }
+    }
+    if (!reemplazarArchivo(temporal, ruta)) {
+        return false;
+    }
+
+    if (habiaManifiesto && anterior.generacion != manifiesto.generacion)
+        borrarSegmentos(ruta, anterior.generacion, anterior.segmentos.size());
+    return true;
+}
+
+uint32_t siguienteGeneracion(const string& ruta) {
+    ManifiestoAlmacen anterior;
+    if (esManifiestoSegmentado(ruta) && leerManifiesto(ruta, anterior))
+        return anterior.generacion + 1;
+    return 1;
+}
+
+/**
+ * @brief Guarda líneas en segmentos de una generación nueva.
+ *
+ * Corta un segmento nuevo cada vez que el siguiente registro haría
+ * pasar el actual de tamMaxSegmento. Los segmentos se escriben como un
+ * archivo suelto; el manifiesto va al final, por temporal y
+ * reemplazarArchivo(), y solo entonces se borra la generación anterior.
+ *
+ * @throws const char* Si un registro no cabe en un segmento o falla la escritura.
+ */
+bool guardarSegmentado(const string& ruta, const string* lineas, int64_t numLineas, bool empaquetado,
+                       uint64_t tamMaxSegmento, bool silencioso) {
+    ManifiestoAlmacen nuevo;
+    nuevo.generacion = siguienteGeneracion(ruta);
+    nuevo.empaquetado = empaquetado;
+
+    try {
+        if (!lineas || numLineas <= 0) {
+            throw "Arreglo vacío o no inicializado.";
+        }
+
+        const uint64_t base = empaquetado ? TAM_CABECERA_EMPAQUETADO : 0;
+        int64_t inicio = 0;
+        while (inicio < numLineas) {
+            SegmentoAlmacen segmento;
+            segmento.bytes = base;
+            int64_t fin = inicio;
+            for (; fin < numLineas; fin++) {
+                if (lineas[fin].empty()) {
+                    if (!empaquetado) segmento.bytes++;  // el texto conserva su '\n'
+                    continue;
+                }
+                uint64_t bytes = bytesRegistro(lineas[fin], empaquetado);
+                if (segmento.registros > 0 && segmento.bytes + bytes > tamMaxSegmento) break;
+                if (base + bytes > tamMaxSegmento) {
+                    throw "Registro más grande que un segmento.";
+                }
+                segmento.bytes += bytes;
+                segmento.registros++;
+            }
+            if (segmento.registros == 0) break;          // solo quedaban líneas vacías
+            if (!empaquetado) segmento.bytes--;          // la última línea va sin '\n'
+
+            const string destino = rutaSegmento(ruta, nuevo.generacion, nuevo.segmentos.size());
+            nuevo.segmentos.push_back(segmento);
+            nuevo.totalRegistros += segmento.registros;
+
+            if (!guardarArchivoSuelto(destino, lineas + inicio, static_cast<int>(fin - inicio), empaquetado,
+                                      silencioso)) {
+                throw "No se pudo escribir un segmento.";
+            }
+            inicio = fin;
+        }
+
+        if (nuevo.segmentos.empty()) {
+            throw "No hay registros para guardar.";
+        }
+
+        if (!publicarManifiesto(ruta, nuevo)) {
+            throw "No se pudo escribir el manifiesto.";
+        }
+
+        if (!silencioso)
+            cout << "Almacén segmentado guardado: " << ruta << " (" << nuevo.totalRegistros << " registros, "
+                 << nuevo.segmentos.size() << " segmentos)" << endl;
+        return true;
+    }
+    catch (const char* e) {
+        cerr << "ERROR en guardarSegmentado(): " << e << endl;
+        borrarSegmentos(ruta, nuevo.generacion, nuevo.segmentos.size());
+        return false;
+    }
+}
+
+bool guardarAlmacen(const string& ruta, const string* lineas, int64_t numLineas, bool empaquetado,
+                    bool silencioso) {
+    // Las ranuras fijas se eligen a mano (--ranuras) y se conservan
+    if (esArchivoRanuras(ruta))
+        return guardarArchivoRanuras(ruta, lineas, static_cast<int>(numLineas), 0, silencioso);
+
+    bool segmentar = esManifiestoSegmentado(ruta);
+    if (!segmentar && lineas) {
+        uint64_t total = empaquetado ? TAM_CABECERA_EMPAQUETADO : 0;
+        for (int64_t i = 0; i < numLineas && total <= TAM_MAX_SEGMENTO; i++)
+            if (!lineas[i].empty()) total += bytesRegistro(lineas[i], empaquetado);
+        segmentar = total > TAM_MAX_SEGMENTO;
+    }
+
+    if (segmentar)
+        return guardarSegmentado(ruta, lineas, numLineas, empaquetado, TAM_MAX_SEGMENTO, silencioso);
+    return guardarArchivoSuelto(ruta, lineas, static_cast<int>(numLineas), empaquetado, silencioso);
+}
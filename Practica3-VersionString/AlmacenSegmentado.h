@@ -0,0 +1,162 @@
+#ifndef ALMACEN_SEGMENTADO_H
+#define ALMACEN_SEGMENTADO_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ManipulacionArchivos.h"
+using namespace std;
+
+// ================================================================
+// === Almacén segmentado =========================================
+// ================================================================
+//
+// Cuando los datos no caben en un solo archivo, la ruta original (por
+// ejemplo usuarios.bin) pasa a ser un manifiesto y los registros se
+// reparten en segmentos "<ruta>.g<generación>.<índice>", cada uno un
+// archivo normal (texto o empaquetado) de a lo sumo TAM_MAX_SEGMENTO
+// bytes.
+//
+// Manifiesto (little-endian):
+//   [0..3]   "P3SM"
+//   [4]      versión (VERSION_MANIFIESTO)
+//   [5]      1 si los segmentos están empaquetados, 0 si son de texto
+//   [6..7]   reservado (0)
+//   [8..11]  generación (uint32)
+//   [12..15] número de segmentos (uint32)
+//   [16..23] total de registros (uint64)
+// Por cada segmento: registros (uint64) y bytes (uint64).
+//
+// Guardar escribe los segmentos de una generación nueva y recién después
+// reemplaza el manifiesto con un rename(), así que una falla a mitad de
+// camino deja intacta la generación anterior.
+//
+// Alcance: el almacén solo levanta el tope de 10 MB por archivo; no
+// carga los datos por partes. Al arrancar, cargarLineasMapeadas()
+// proyecta todos los segmentos en un único arreglo de vistas y el resto
+// del programa sigue contando cuentas con int, así que el total queda
+// acotado por la memoria y por INT32_MAX registros. Solo --buscar-cedula
+// lee un único segmento bajo demanda, con cargarSegmento().
+
+const uint8_t VERSION_MANIFIESTO = 1;
+const int TAM_CABECERA_MANIFIESTO = 24;
+const int TAM_ENTRADA_MANIFIESTO = 16;
+
+/// Bytes máximos de un segmento (por debajo del límite por archivo del cargador).
+const uint64_t TAM_MAX_SEGMENTO = 8'000'000;
+
+/**
+ * @brief Entrada del manifiesto para un segmento.
+ */
+struct SegmentoAlmacen {
+    uint64_t registros = 0;     ///< Líneas no vacías del segmento
+    uint64_t bytes = 0;         ///< Tamaño del archivo del segmento
+};
+
+/**
+ * @brief Contenido de un manifiesto.
+ */
+struct ManifiestoAlmacen {
+    uint32_t generacion = 0;
+    bool empaquetado = false;
+    uint64_t totalRegistros = 0;
+    vector<SegmentoAlmacen> segmentos;
+};
+
+/**
+ * @brief Indica si el archivo es el manifiesto de un almacén segmentado.
+ */
+bool esManifiestoSegmentado(const string& ruta);
+
+/**
+ * @brief Indica si los datos de la ruta están empaquetados, sea un archivo
+ *        suelto o un almacén segmentado.
+ */
+bool esAlmacenEmpaquetado(const string& ruta);
+
+/**
+ * @brief Lee y valida un manifiesto.
+ *
+ * @param ruta Ruta del manifiesto.
+ * @param manifiesto Destino.
+ * @return true si el manifiesto es válido.
+ */
+bool leerManifiesto(const string& ruta, ManifiestoAlmacen& manifiesto);
+
+/**
+ * @brief Ruta del archivo de un segmento.
+ *
+ * @param ruta Ruta del manifiesto.
+ * @param generacion Generación del almacén.
+ * @param indice Índice del segmento.
+ */
+string rutaSegmento(const string& ruta, uint32_t generacion, size_t indice);
+
+/**
+ * @brief Ubica un registro global dentro de los segmentos.
+ *
+ * @param manifiesto Manifiesto del almacén.
+ * @param indice Índice global del registro (0 .. totalRegistros - 1).
+ * @param segmento Índice del segmento que lo contiene.
+ * @param indiceLocal Posición del registro dentro de ese segmento.
+ * @return false si el índice está fuera de rango.
+ */
+bool localizarRegistro(const ManifiestoAlmacen& manifiesto, uint64_t indice, size_t& segmento, uint64_t& indiceLocal);
+
+/**
+ * @brief Carga bajo demanda un solo segmento como vistas.
+ *
+ * Permite recorrer o consultar almacenes más grandes que la memoria
+ * disponible, de a un segmento por vez.
+ *
+ * @return true si el segmento existe y coincide con el manifiesto.
+ */
+bool cargarSegmento(const string& ruta, const ManifiestoAlmacen& manifiesto, size_t indice, LineasMapeadas& lineas);
+
+/**
+ * @brief Generación que le toca al próximo guardado en `ruta` (1 si no
+ *        es un manifiesto).
+ */
+uint32_t siguienteGeneracion(const string& ruta);
+
+/**
+ * @brief Reemplaza el manifiesto de `ruta` por `manifiesto`.
+ *
+ * Los segmentos de `manifiesto` ya deben estar escritos. Se escribe por
+ * temporal y reemplazarArchivo(); solo después se borran los segmentos
+ * de la generación anterior, si la había.
+ *
+ * @return false si no se pudo escribir (la generación anterior queda intacta).
+ */
+bool publicarManifiesto(const string& ruta, const ManifiestoAlmacen& manifiesto);
+
+/**
+ * @brief Guarda líneas en segmentos de una generación nueva.
+ *
+ * @param ruta Ruta del manifiesto.
+ * @param lineas Líneas a guardar.
+ * @param numLineas Número de líneas.
+ * @param empaquetado true para segmentos en formato empaquetado.
+ * @param tamMaxSegmento Bytes máximos por segmento.
+ * @param silencioso true para no informar en consola cuando todo sale bien.
+ * @return true si todos los segmentos y el manifiesto quedaron escritos.
+ */
+bool guardarSegmentado(const string& ruta, const string* lineas, int64_t numLineas, bool empaquetado,
+                       uint64_t tamMaxSegmento = TAM_MAX_SEGMENTO, bool silencioso = false);
+
+/**
+ * @brief Guarda líneas eligiendo entre archivo suelto y almacén segmentado.
+ *
+ * Usa segmentos si la ruta ya es un manifiesto o si los datos no caben
+ * en TAM_MAX_SEGMENTO; si no, escribe un archivo normal en un temporal
+ * y lo reemplaza con reemplazarArchivo().
+ * Un archivo de ranuras fijas (ArchivoRanuras.h) se reescribe en ranuras.
+ *
+ * @param silencioso true para no informar en consola cuando todo sale
+ *        bien (los puntos de control guardan mientras se usa el menú).
+ * @return true si los datos quedaron escritos y sincronizados con el disco.
+ */
+bool guardarAlmacen(const string& ruta, const string* lineas, int64_t numLineas, bool empaquetado,
+                    bool silencioso = false);
+
+#endif // ALMACEN_SEGMENTADO_H
@@ -0,0 +1,105 @@
+#include "ArchivoMapeado.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+ArchivoMapeado::~ArchivoMapeado() {
+    cerrar();
+}
+
+#ifdef _WIN32
+
+void ArchivoMapeado::abrir(const string& ruta) {
+    cerrar();
+
+    HANDLE archivo = CreateFileA(ruta.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                 OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (archivo == INVALID_HANDLE_VALUE)
+        throw "No se pudo abrir el archivo para lectura.";
+
+    LARGE_INTEGER tamArchivo;
+    if (!GetFileSizeEx(archivo, &tamArchivo)) {
+        CloseHandle(archivo);
+        throw "No se pudo obtener el tamaño del archivo.";
+    }
+    if (tamArchivo.QuadPart == 0) {     // no se puede proyectar un archivo vacío
+        CloseHandle(archivo);
+        return;
+    }
+
+    HANDLE mapeo = CreateFileMappingA(archivo, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapeo == nullptr) {
+        CloseHandle(archivo);
+        throw "No se pudo proyectar el archivo en memoria.";
+    }
+
+    void* vista = MapViewOfFile(mapeo, FILE_MAP_READ, 0, 0, 0);
+    if (vista == nullptr) {
+        CloseHandle(mapeo);
+        CloseHandle(archivo);
+        throw "No se pudo proyectar el archivo en memoria.";
+    }
+
+    manejadorArchivo = archivo;
+    manejadorMapeo = mapeo;
+    inicio = static_cast<const char*>(vista);
+    tam = static_cast<size_t>(tamArchivo.QuadPart);
+}
+
+void ArchivoMapeado::cerrar() {
+    if (inicio) UnmapViewOfFile(inicio);
+    if (manejadorMapeo) CloseHandle(manejadorMapeo);
+    if (manejadorArchivo) CloseHandle(manejadorArchivo);
+    inicio = nullptr;
+    tam = 0;
+    manejadorMapeo = nullptr;
+    manejadorArchivo = nullptr;
+}
+
+#else
+
+void ArchivoMapeado::abrir(const string& ruta) {
+    cerrar();
+
+    int fd = open(ruta.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw "No se pudo abrir el archivo para lectura.";
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw "No se pudo obtener el tamaño del archivo.";
+    }
+    if (info.st_size == 0) {            // mmap no acepta longitud 0
+        close(fd);
+        return;
+    }
+
+    void* vista = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);                          // la proyección sigue siendo válida
+    if (vista == MAP_FAILED)
+        throw "No se pudo proyectar el archivo en memoria.";
+
+#ifdef MADV_SEQUENTIAL
+    madvise(vista, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+#endif
+
+    inicio = static_cast<const char*>(vista);
+    tam = static_cast<size_t>(info.st_size);
+}
+
+void ArchivoMapeado::cerrar() {
+    if (inicio) munmap(const_cast<char*>(inicio), tam);
+    inicio = nullptr;
+    tam = 0;
+}
+
+#endif
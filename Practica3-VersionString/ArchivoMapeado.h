@@ -0,0 +1,55 @@
+#ifndef ARCHIVO_MAPEADO_H
+#define ARCHIVO_MAPEADO_H
+
+#include <cstddef>
+#include <string>
+using namespace std;
+
+/**
+ * @brief Archivo de solo lectura proyectado en memoria.
+ *
+ * Usa mmap() en sistemas POSIX y MapViewOfFile() en Windows. El
+ * contenido se lee directamente desde la caché de páginas del sistema,
+ * sin copiarlo a un buffer propio. La proyección dura hasta cerrar() o
+ * hasta que se destruye el objeto; no se debe sobrescribir el archivo
+ * mientras está abierta.
+ */
+class ArchivoMapeado {
+public:
+    ArchivoMapeado() = default;
+    ~ArchivoMapeado();
+
+    ArchivoMapeado(const ArchivoMapeado&) = delete;
+    ArchivoMapeado& operator=(const ArchivoMapeado&) = delete;
+
+    /**
+     * @brief Proyecta el archivo completo (cierra antes el que hubiera).
+     * @throw const char* Si el archivo no se puede abrir o proyectar.
+     */
+    void abrir(const string& ruta);
+
+    /**
+     * @brief Libera la proyección; datos() deja de ser válido.
+     */
+    void cerrar();
+
+    /**
+     * @brief Inicio del contenido (nullptr si el archivo está vacío).
+     */
+    const char* datos() const { return inicio; }
+
+    /**
+     * @brief Tamaño del contenido en bytes.
+     */
+    size_t tamanio() const { return tam; }
+
+private:
+    const char* inicio = nullptr;
+    size_t tam = 0;
+#ifdef _WIN32
+    void* manejadorArchivo = nullptr;
+    void* manejadorMapeo = nullptr;
+#endif
+};
+
+#endif // ARCHIVO_MAPEADO_H
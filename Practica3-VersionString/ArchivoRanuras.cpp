@@ -0,0 +1,380 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include "AlmacenSegmentado.h"
+#include "ArchivoRanuras.h"
+#include "ConversionSIMD.h"
+#include "ManipulacionArchivos.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/// Primeros bytes de un archivo de ranuras fijas.
+static const char MAGIA_RANURAS[4] = { 'P', '3', 'R', 'F' };
+
+/// Límites aceptados para el tamaño de ranura.
+static const uint32_t TAM_RANURA_MINIMO = 64;
+static const uint32_t TAM_RANURA_MAXIMO = 1 << 20;
+
+/**
+ * @brief Escribe un entero de 32 bits en little-endian.
+ */
+static void escribirU32(char* destino, uint32_t valor) {
+    for (int k = 0; k < 4; k++)
+        destino[k] = static_cast<char>((valor >> (8 * k)) & 0xFF);
+}
+
+/**
+ * @brief Lee un entero de 32 bits en little-endian.
+ */
+static uint32_t leerU32(const char* origen) {
+    uint32_t valor = 0;
+    for (int k = 3; k >= 0; k--)
+        valor = (valor << 8) | static_cast<unsigned char>(origen[k]);
+    return valor;
+}
+
+/**
+ * @brief Valida la cabecera y devuelve registros y tamaño de ranura.
+ *
+ * @param cabecera Al menos 16 bytes del inicio del archivo.
+ * @param tamArchivo Tamaño total del archivo.
+ * @throws const char* Si la cabecera no es coherente con el archivo.
+ */
+static void validarCabecera(const char* cabecera, uint64_t tamArchivo, uint32_t& registros, uint32_t& tamRanura) {
+    if (memcmp(cabecera, MAGIA_RANURAS, 4) != 0)
+        throw "El archivo no está en formato de ranuras fijas.";
+    if (static_cast<uint8_t>(cabecera[4]) != VERSION_FORMATO_RANURAS)
+        throw "Versión de formato no soportada.";
+
+    registros = leerU32(cabecera + 8);
+    tamRanura = leerU32(cabecera + 12);
+    if (tamRanura < TAM_RANURA_MINIMO || tamRanura > TAM_RANURA_MAXIMO)
+        throw "Tamaño de ranura inválido.";
+    if (registros > static_cast<uint32_t>(INT32_MAX))
+        throw "Número de registros inválido.";
+    // Puede sobrar una ranura al final si se cortó un agregado
+    if (tamArchivo < (static_cast<uint64_t>(registros) + 1) * tamRanura)
+        throw "El archivo es más corto que lo que indica la cabecera.";
+}
+
+/**
+ * @brief Tamaño de ranura del archivo existente, o 0 si no es de ranuras.
+ */
+static uint32_t tamRanuraActual(const string& rutaArchivo) {
+    ifstream archivo(rutaArchivo, ios::binary);
+    char cabecera[16];
+    if (!archivo.read(cabecera, sizeof(cabecera))) return 0;
+    if (memcmp(cabecera, MAGIA_RANURAS, 4) != 0) return 0;
+    return leerU32(cabecera + 12);
+}
+
+bool esArchivoRanuras(const string& rutaArchivo) {
+    ifstream archivo(rutaArchivo, ios::binary);
+    char magia[4];
+    if (!archivo.read(magia, 4)) return false;
+    return memcmp(magia, MAGIA_RANURAS, 4) == 0;
+}
+
+string* leerArchivoRanuras(const string& rutaArchivo, int& numLineas) {
+    string* lineas = nullptr;
+    try {
+        ifstream archivo(rutaArchivo, ios::binary);
+        if (!archivo.is_open()) {
+            throw "No se pudo abrir el archivo para lectura.";
+        }
+
+        archivo.seekg(0, ios::end);
+        int64_t fileSize = static_cast<int64_t>(archivo.tellg());
+        archivo.seekg(0, ios::beg);
+
+        cout << "Leyendo archivo de ranuras: " << rutaArchivo << " (" << fileSize << " bytes)" << endl;
+
+        char cabecera[16];
+        if (fileSize < static_cast<int64_t>(sizeof(cabecera)) || !archivo.read(cabecera, sizeof(cabecera))) {
+            throw "Cabecera incompleta.";
+        }
+        uint32_t registros = 0, tamRanura = 0;
+        validarCabecera(cabecera, static_cast<uint64_t>(fileSize), registros, tamRanura);
+        if (registros == 0) {
+            throw "El archivo está vacío.";
+        }
+
+        numLineas = static_cast<int>(registros);
+        lineas = new string[numLineas];
+
+        // Se lee de a una ranura: el tamaño del archivo no está acotado
+        vector<char> ranura(tamRanura);
+        archivo.seekg(tamRanura, ios::beg);
+        for (int i = 0; i < numLineas; i++) {
+            if (!archivo.read(ranura.data(), tamRanura)) {
+                throw "Registro truncado.";
+            }
+            uint32_t len = leerU32(ranura.data());
+            if (len == 0 || len > tamRanura - 4) {
+                throw "Longitud de registro inválida.";
+            }
+            lineas[i].resize(static_cast<size_t>(len) * 8);
+            expandirBits(reinterpret_cast<const uint8_t*>(ranura.data() + 4), len, &lineas[i][0]);
+        }
+
+        cout << "Archivo cargado correctamente: " << numLineas << " líneas" << endl << endl;
+        return lineas;
+    }
+    catch (const char* e) {
+        cerr << "ERROR en leerArchivoRanuras(): " << e << endl;
+        delete[] lineas;
+        numLineas = 0;
+        return nullptr;
+    }
+}
+
+bool guardarArchivoRanuras(const string& rutaArchivo, const string* lineas, int numLineas, uint32_t tamRanura,
+                           bool silencioso) {
+    const string temporal = rutaArchivo + ".tmp";
+    try {
+        if (!lineas || numLineas <= 0) {
+            throw "Arreglo vacío o no inicializado.";
+        }
+
+        if (tamRanura == 0) tamRanura = tamRanuraActual(rutaArchivo);
+        if (tamRanura == 0) tamRanura = TAM_RANURA_PREDETERMINADO;
+        if (tamRanura < TAM_RANURA_MINIMO) tamRanura = TAM_RANURA_MINIMO;
+
+        uint32_t registros = 0;
+        for (int i = 0; i < numLineas; i++) {
+            if (lineas[i].empty()) continue;
+            if (lineas[i].size() % 8 != 0) {
+                throw "Línea con longitud no múltiplo de 8: no se puede empaquetar.";
+            }
+            size_t necesario = 4 + lineas[i].size() / 8;
+            if (necesario > TAM_RANURA_MAXIMO) {
+                throw "Registro demasiado largo para una ranura.";
+            }
+            while (necesario > tamRanura) tamRanura += 64;
+            registros++;
+        }
+
+        ofstream archivo(temporal, ios::trunc | ios::binary);
+        if (!archivo.is_open()) {
+            throw "No se pudo abrir el archivo para escritura.";
+        }
+
+        vector<char> ranura(tamRanura, 0);
+        memcpy(ranura.data(), MAGIA_RANURAS, 4);
+        ranura[4] = static_cast<char>(VERSION_FORMATO_RANURAS);
+        escribirU32(&ranura[8], registros);
+        escribirU32(&ranura[12], tamRanura);
+        archivo.write(ranura.data(), tamRanura);
+
+        for (int i = 0; i < numLineas && archivo; i++) {
+            if (lineas[i].empty()) continue;
+            fill(ranura.begin(), ranura.end(), 0);
+            size_t len = lineas[i].size() / 8;
+            escribirU32(&ranura[0], static_cast<uint32_t>(len));
+            if (!empaquetarBits(lineas[i].data(), lineas[i].size(), reinterpret_cast<uint8_t*>(&ranura[4]))) {
+                throw "Línea con caracteres no binarios: no se puede empaquetar.";
+            }
+            archivo.write(ranura.data(), tamRanura);
+        }
+
+        archivo.close();
+        if (!archivo) {
+            throw "Error al escribir el archivo.";
+        }
+        if (!reemplazarArchivo(temporal, rutaArchivo)) {
+            throw "No se pudo reemplazar el archivo original.";
+        }
+
+        if (!silencioso)
+            cout << "Archivo guardado (ranuras de " << tamRanura << " bytes): " << registros << " líneas" << endl;
+        return true;
+    }
+    catch (const char* e) {
+        cerr << "ERROR en guardarArchivoRanuras(): " << e << endl;
+        remove(temporal.c_str());
+        return false;
+    }
+}
+
+bool migrarArchivoRanuras(const string& rutaArchivo) {
+    if (esArchivoRanuras(rutaArchivo)) {
+        cout << "El archivo ya está en ranuras fijas: " << rutaArchivo << endl;
+        return true;
+    }
+
+    if (esManifiestoSegmentado(rutaArchivo)) {
+        cerr << "ERROR en migrarArchivoRanuras(): un almacén segmentado no se puede pasar a ranuras." << endl;
+        return false;
+    }
+
+    int numLineas = 0;
+    string* lineas = leerArchivoLineas(rutaArchivo, numLineas);
+    if (!lineas) return false;
+
+    bool ok = guardarArchivoRanuras(rutaArchivo, lineas, numLineas, TAM_RANURA_PREDETERMINADO);
+    delete[] lineas;
+    if (ok) cout << "Archivo migrado a ranuras fijas: " << rutaArchivo << endl;
+    return ok;
+}
+
+// ================================================================
+// === Actualización en el lugar ==================================
+// ================================================================
+
+ArchivoRanuras::~ArchivoRanuras() {
+    cerrar();
+}
+
+bool ArchivoRanuras::escribir(int indice, string_view lineaBinaria) {
+    if (!abierto() || indice < 0 || static_cast<uint32_t>(indice) > registros) return false;
+    if (lineaBinaria.empty() || lineaBinaria.size() % 8 != 0) return false;
+
+    size_t len = lineaBinaria.size() / 8;
+    if (4 + len > tamRanura) {
+        cerr << "ERROR en ArchivoRanuras::escribir(): el registro no cabe en la ranura." << endl;
+        return false;
+    }
+
+    vector<char> ranura(tamRanura, 0);
+    escribirU32(&ranura[0], static_cast<uint32_t>(len));
+    if (!empaquetarBits(lineaBinaria.data(), lineaBinaria.size(), reinterpret_cast<uint8_t*>(&ranura[4])))
+        return false;
+
+    uint64_t desplazamiento = (static_cast<uint64_t>(indice) + 1) * tamRanura;
+    if (!escribirEn(desplazamiento, ranura.data(), ranura.size()))
+        return false;
+
+    if (static_cast<uint32_t>(indice) == registros) {
+        char cuenta[4];
+        escribirU32(cuenta, registros + 1);
+        if (!escribirEn(8, cuenta, sizeof(cuenta)))
+            return false;
+        registros++;
+    }
+
+    if (fsyncCada > 0 && ++sinSincronizar >= fsyncCada)
+        return sincronizar();
+    return true;
+}
+
+#ifdef _WIN32
+
+void ArchivoRanuras::abrir(const string& ruta, int fsync) {
+    cerrar();
+
+    HANDLE archivo = CreateFileA(ruta.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (archivo == INVALID_HANDLE_VALUE)
+        throw "No se pudo abrir el archivo de ranuras.";
+
+    LARGE_INTEGER tamArchivo;
+    char cabecera[16];
+    DWORD leidos = 0;
+    if (!GetFileSizeEx(archivo, &tamArchivo) ||
+        !ReadFile(archivo, cabecera, sizeof(cabecera), &leidos, nullptr) || leidos != sizeof(cabecera)) {
+        CloseHandle(archivo);
+        throw "Cabecera incompleta.";
+    }
+    try {
+        validarCabecera(cabecera, static_cast<uint64_t>(tamArchivo.QuadPart), registros, tamRanura);
+    } catch (const char*) {
+        CloseHandle(archivo);
+        throw;
+    }
+
+    manejador = archivo;
+    fsyncCada = fsync;
+    sinSincronizar = 0;
+}
+
+void ArchivoRanuras::cerrar() {
+    if (!abierto()) return;
+    if (sinSincronizar > 0) sincronizar();
+    CloseHandle(manejador);
+    manejador = nullptr;
+}
+
+bool ArchivoRanuras::escribirEn(uint64_t desplazamiento, const char* datos, size_t bytes) {
+    OVERLAPPED posicion = {};
+    posicion.Offset = static_cast<DWORD>(desplazamiento & 0xFFFFFFFF);
+    posicion.OffsetHigh = static_cast<DWORD>(desplazamiento >> 32);
+    DWORD escritos = 0;
+    if (!WriteFile(manejador, datos, static_cast<DWORD>(bytes), &escritos, &posicion) || escritos != bytes) {
+        cerr << "ERROR en ArchivoRanuras: escritura incompleta." << endl;
+        return false;
+    }
+    return true;
+}
+
+bool ArchivoRanuras::sincronizar() {
+    sinSincronizar = 0;
+    return abierto() && FlushFileBuffers(manejador);
+}
+
+#else
+
+void ArchivoRanuras::abrir(const string& ruta, int fsync) {
+    cerrar();
+
+    int fd = open(ruta.c_str(), O_RDWR);
+    if (fd < 0)
+        throw "No se pudo abrir el archivo de ranuras.";
+
+    char cabecera[16];
+    off_t tamArchivo = lseek(fd, 0, SEEK_END);
+    if (tamArchivo < 0 || pread(fd, cabecera, sizeof(cabecera), 0) != static_cast<ssize_t>(sizeof(cabecera))) {
+        close(fd);
+        throw "Cabecera incompleta.";
+    }
+    try {
+        validarCabecera(cabecera, static_cast<uint64_t>(tamArchivo), registros, tamRanura);
+    } catch (const char*) {
+        close(fd);
+        throw;
+    }
+
+    manejador = fd;
+    fsyncCada = fsync;
+    sinSincronizar = 0;
+}
+
+void ArchivoRanuras::cerrar() {
+    if (!abierto()) return;
+    if (sinSincronizar > 0) sincronizar();
+    close(manejador);
+    manejador = -1;
+}
+
+bool ArchivoRanuras::escribirEn(uint64_t desplazamiento, const char* datos, size_t bytes) {
+    while (bytes > 0) {
+        ssize_t escritos = pwrite(manejador, datos, bytes, static_cast<off_t>(desplazamiento));
+        if (escritos <= 0) {
+            cerr << "ERROR en ArchivoRanuras: escritura incompleta." << endl;
+            return false;
+        }
+        datos += escritos;
+        bytes -= static_cast<size_t>(escritos);
+        desplazamiento += static_cast<uint64_t>(escritos);
+    }
+    return true;
+}
+
+bool ArchivoRanuras::sincronizar() {
+    sinSincronizar = 0;
+#if defined(__APPLE__)
+    return abierto() && fsync(manejador) == 0;
+#else
+    return abierto() && fdatasync(manejador) == 0;
+#endif
+}
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef ARCHIVO_RANURAS_H
+#define ARCHIVO_RANURAS_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+using namespace std;
+
+// ================================================================
+// === Formato de registros de ancho fijo =========================
+// ================================================================
+//
+// El archivo se divide en ranuras de `tamRanura` bytes. La ranura 0 es
+// la cabecera:
+//   [0..3]   "P3RF"
+//   [4]      versión del formato (VERSION_FORMATO_RANURAS)
+//   [5..7]   reservado (0)
+//   [8..11]  número de registros (uint32, little-endian)
+//   [12..15] tamaño de cada ranura en bytes (uint32, little-endian)
+// El registro i ocupa la ranura i + 1: longitud en bytes (uint32,
+// little-endian), los bytes cifrados empaquetados (8 bits por byte) y
+// ceros hasta completar la ranura. Como cada registro está en una
+// posición conocida, un cambio se escribe en su lugar sin reescribir
+// el archivo.
+
+const uint8_t VERSION_FORMATO_RANURAS = 1;
+
+/// Ranura por omisión: cabe cualquier Cuenta serializada, y al ser
+/// divisor de 4096 ninguna ranura cruza un límite de página.
+const uint32_t TAM_RANURA_PREDETERMINADO = 256;
+
+/**
+ * @brief Indica si el archivo empieza con la cabecera de ranuras fijas.
+ */
+bool esArchivoRanuras(const string& rutaArchivo);
+
+/**
+ * @brief Lee un archivo de ranuras fijas.
+ *
+ * Devuelve cada registro expandido a '0'/'1', igual que
+ * leerArchivoEmpaquetado().
+ *
+ * @param rutaArchivo Ruta del archivo a leer.
+ * @param numLineas Referencia donde se almacenará el número de registros.
+ * @return string* Arreglo dinámico de líneas, o nullptr si ocurre un error.
+ */
+string* leerArchivoRanuras(const string& rutaArchivo, int& numLineas);
+
+/**
+ * @brief Guarda líneas binarias ('0'/'1') en ranuras fijas.
+ *
+ * Escribe un archivo temporal y lo renombra sobre el original. Si algún
+ * registro no cabe en `tamRanura`, la ranura se agranda (en múltiplos de
+ * 64 bytes) para todo el archivo. Las líneas vacías se omiten.
+ *
+ * @param rutaArchivo Ruta del archivo destino.
+ * @param lineas Arreglo de líneas binarias.
+ * @param numLineas Número de líneas.
+ * @param tamRanura Tamaño mínimo de ranura; 0 conserva el del archivo
+ *        actual (o TAM_RANURA_PREDETERMINADO si no hay).
+ * @param silencioso true para no informar en consola cuando todo sale bien.
+ * @return true si el archivo se escribió completo.
+ */
+bool guardarArchivoRanuras(const string& rutaArchivo, const string* lineas, int numLineas, uint32_t tamRanura = 0,
+                           bool silencioso = false);
+
+/**
+ * @brief Convierte un archivo o almacén al formato de ranuras fijas.
+ * @return true si el archivo queda en ranuras fijas.
+ */
+bool migrarArchivoRanuras(const string& rutaArchivo);
+
+/**
+ * @brief Archivo de ranuras abierto para actualizar registros en su lugar.
+ *
+ * Cada escritura es una sola escritura posicionada (pwrite() en POSIX,
+ * WriteFile() con desplazamiento en Windows) de la ranura completa.
+ * `fsyncCada` decide cuándo se fuerza a disco: 0 deja la descarga al
+ * sistema operativo (y al cierre), 1 sincroniza tras cada escritura y
+ * N > 1 cada N escrituras.
+ */
+class ArchivoRanuras {
+public:
+    ArchivoRanuras() = default;
+    ~ArchivoRanuras();
+
+    ArchivoRanuras(const ArchivoRanuras&) = delete;
+    ArchivoRanuras& operator=(const ArchivoRanuras&) = delete;
+
+    /**
+     * @brief Abre el archivo para lectura y escritura (cierra antes el que hubiera).
+     * @throw const char* Si no se puede abrir o la cabecera es inválida.
+     */
+    void abrir(const string& ruta, int fsyncCada);
+
+    /**
+     * @brief Sincroniza lo pendiente y cierra el archivo.
+     */
+    void cerrar();
+
+    bool abierto() const { return manejador != MANEJADOR_INVALIDO; }
+
+    /**
+     * @brief Número de registros según la cabecera.
+     */
+    int numRegistros() const { return static_cast<int>(registros); }
+
+    /**
+     * @brief Escribe el registro `indice` en su ranura.
+     *
+     * Con `indice == numRegistros()` agrega un registro al final: primero
+     * la ranura y después la cabecera, así que un corte entre ambas solo
+     * deja una ranura sobrante que se ignora.
+     *
+     * @param indice Posición del registro.
+     * @param lineaBinaria Registro cifrado en '0'/'1'.
+     * @return false si no cabe en la ranura o la escritura falló.
+     */
+    bool escribir(int indice, string_view lineaBinaria);
+
+    /**
+     * @brief Fuerza a disco las escrituras hechas.
+     */
+    bool sincronizar();
+
+private:
+    bool escribirEn(uint64_t desplazamiento, const char* datos, size_t bytes);
+
+#ifdef _WIN32
+    static constexpr void* MANEJADOR_INVALIDO = nullptr;
+    void* manejador = nullptr;
+#else
+    static constexpr int MANEJADOR_INVALIDO = -1;
+    int manejador = -1;
+#endif
+    uint32_t registros = 0;
+    uint32_t tamRanura = 0;
+    int fsyncCada = 1;
+    int sinSincronizar = 0;
+};
+
+#endif // ARCHIVO_RANURAS_H
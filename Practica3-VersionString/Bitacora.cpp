@@ -0,0 +1,360 @@
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "Bitacora.h"
+#include "ConversionSIMD.h"
+#include "Encriptacion.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/// Primeros bytes de una bitácora.
+static const char MAGIA_BITACORA[4] = { 'P', '3', 'B', 'J' };
+
+/// Bytes de la cabecera de cada entrada (longitud, suma y secuencia).
+static const size_t TAM_CABECERA_ENTRADA = 16;
+
+/// Bytes de la cabecera de una entrada de la versión 1 (sin secuencia).
+static const size_t TAM_CABECERA_ENTRADA_V1 = 8;
+
+/**
+ * @brief Escribe un entero de 32 bits en little-endian.
+ */
+static void escribirU32(char* destino, uint32_t valor) {
+    for (int k = 0; k < 4; k++)
+        destino[k] = static_cast<char>((valor >> (8 * k)) & 0xFF);
+}
+
+/**
+ * @brief Lee un entero de 32 bits en little-endian.
+ */
+static uint32_t leerU32(const char* origen) {
+    uint32_t valor = 0;
+    for (int k = 3; k >= 0; k--)
+        valor = (valor << 8) | static_cast<unsigned char>(origen[k]);
+    return valor;
+}
+
+/**
+ * @brief Escribe un entero de 64 bits en little-endian.
+ */
+static void escribirU64(char* destino, uint64_t valor) {
+    for (int k = 0; k < 8; k++)
+        destino[k] = static_cast<char>((valor >> (8 * k)) & 0xFF);
+}
+
+/**
+ * @brief Lee un entero de 64 bits en little-endian.
+ */
+static uint64_t leerU64(const char* origen) {
+    uint64_t valor = 0;
+    for (int k = 7; k >= 0; k--)
+        valor = (valor << 8) | static_cast<unsigned char>(origen[k]);
+    return valor;
+}
+
+/**
+ * @brief Suma FNV-1a de 32 bits.
+ *
+ * @param suma Suma de los bytes anteriores, para continuarla.
+ */
+static uint32_t sumaFNV(const char* datos, size_t bytes, uint32_t suma = 2166136261u) {
+    for (size_t i = 0; i < bytes; i++) {
+        suma ^= static_cast<unsigned char>(datos[i]);
+        suma *= 16777619u;
+    }
+    return suma;
+}
+
+/**
+ * @brief Vacía los buffers y sincroniza el archivo con el disco.
+ */
+static bool sincronizarArchivo(FILE* archivo) {
+    if (fflush(archivo) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(archivo)) == 0;
+#elif defined(__APPLE__)
+    return fsync(fileno(archivo)) == 0;
+#else
+    return fdatasync(fileno(archivo)) == 0;
+#endif
+}
+
+/**
+ * @brief Interpreta "motivo,delta,<cuenta>" o, en la versión 1,
+ *        "secuencia,motivo,delta,<cuenta>".
+ *
+ * @param conSecuencia true si la línea empieza por la secuencia; si no,
+ *        `movimiento.secuencia` ya viene de la cabecera de la entrada.
+ * @return false si la línea no tiene ese formato.
+ */
+static bool parsearMovimiento(string_view linea, bool conSecuencia, MovimientoCuenta& movimiento) {
+    if (conSecuencia) {
+        size_t coma = linea.find(',');
+        if (coma == 0 || coma == string_view::npos) return false;
+        uint64_t secuencia = 0;
+        for (size_t i = 0; i < coma; i++) {
+            if (linea[i] < '0' || linea[i] > '9') return false;
+            secuencia = secuencia * 10 + static_cast<uint64_t>(linea[i] - '0');
+        }
+        movimiento.secuencia = secuencia;
+        linea.remove_prefix(coma + 1);
+    }
+
+    size_t campos[2];
+    size_t pos = 0;
+    for (int k = 0; k < 2; k++) {
+        campos[k] = linea.find(',', pos);
+        if (campos[k] == string_view::npos) return false;
+        pos = campos[k] + 1;
+    }
+
+    string_view motivo = linea.substr(0, campos[0]);
+    if (motivo.size() != 1 || motivo[0] < '1' || motivo[0] > '3') return false;
+
+    string_view delta = linea.substr(campos[0] + 1, campos[1] - campos[0] - 1);
+    bool negativo = !delta.empty() && delta[0] == '-';
+    if (negativo) delta.remove_prefix(1);
+    if (delta.empty() || delta.size() > 18) return false;
+    int64_t valor = 0;
+    for (char c : delta) {
+        if (c < '0' || c > '9') return false;
+        valor = valor * 10 + (c - '0');
+    }
+
+    if (movimiento.secuencia == 0 || !parsearCuenta(linea.substr(campos[1] + 1), movimiento.cuenta))
+        return false;
+    movimiento.motivo = static_cast<MotivoCambio>(motivo[0] - '0');
+    movimiento.delta = negativo ? -valor : valor;
+    return true;
+}
+
+int64_t Bitacora::reproducir(const string& ruta, int semilla,
+                             const function<void(const MovimientoCuenta&)>& aplicar,
+                             uint64_t* finValido) {
+    if (finValido) *finValido = 0;
+    ifstream archivo(ruta, ios::binary);
+    if (!archivo.is_open()) return 0;
+
+    vector<char> contenido((istreambuf_iterator<char>(archivo)), istreambuf_iterator<char>());
+    if (contenido.empty()) return 0;
+    if (contenido.size() < static_cast<size_t>(TAM_CABECERA_BITACORA) ||
+        memcmp(contenido.data(), MAGIA_BITACORA, 4) != 0 ||
+        (static_cast<uint8_t>(contenido[4]) != VERSION_BITACORA && contenido[4] != 1)) {
+        cerr << "ERROR en Bitacora::reproducir(): " << ruta << " no es una bitácora válida." << endl;
+        return -1;
+    }
+
+    const bool version1 = contenido[4] == 1;
+    const size_t cabecera = version1 ? TAM_CABECERA_ENTRADA_V1 : TAM_CABECERA_ENTRADA;
+    int64_t aplicadas = 0;
+    uint64_t ultimaSecuencia = 0;
+    size_t pos = TAM_CABECERA_BITACORA;
+    string bits;
+    while (pos + cabecera <= contenido.size()) {
+        uint32_t len = leerU32(&contenido[pos]);
+        uint32_t suma = leerU32(&contenido[pos + 4]);
+        const char* datos = &contenido[pos + cabecera];
+        if (len == 0 || len > contenido.size() - pos - cabecera)
+            break;
+        uint32_t calculada = sumaFNV(datos, len);
+        if (!version1) calculada = sumaFNV(&contenido[pos + 8], 8, calculada);
+        if (calculada != suma)
+            break;
+
+        bits.resize(static_cast<size_t>(len) * 8);
+        expandirBits(reinterpret_cast<const uint8_t*>(datos), len, &bits[0]);
+        MovimientoCuenta movimiento;
+        if (!version1) movimiento.secuencia = leerU64(&contenido[pos + 8]);
+        try {
+            if (!parsearMovimiento(desencriptarCadena(bits, semilla), version1, movimiento)) break;
+        } catch (const char*) {
+            break;
+        }
+        if (movimiento.secuencia <= ultimaSecuencia) break;
+
+        aplicar(movimiento);
+        ultimaSecuencia = movimiento.secuencia;
+        aplicadas++;
+        pos += cabecera + len;
+    }
+
+    if (pos < contenido.size())
+        cerr << "Advertencia: la bitácora " << ruta << " termina en una entrada incompleta; se descarta.\n";
+    if (finValido) *finValido = pos;
+    return aplicadas;
+}
+
+Bitacora::~Bitacora() {
+    cerrar();
+}
+
+void Bitacora::abrir(const string& rutaBitacora, int semillaCifrado, uint64_t primeraSecuencia, int esperaMs) {
+    cerrar();
+
+    uint64_t ultima = 0, finValido = 0;
+    int64_t entradas = reproducir(rutaBitacora, semillaCifrado,
+                                  [&](const MovimientoCuenta& mov) { ultima = mov.secuencia; }, &finValido);
+    if (entradas < 0)
+        throw "La bitácora existente está dañada.";
+    if (finValido > 0) {
+        // Las entradas nuevas no pueden quedar detrás de una cabecera vieja
+        ifstream existente(rutaBitacora, ios::binary);
+        char cabecera[TAM_CABECERA_BITACORA] = {};
+        existente.read(cabecera, TAM_CABECERA_BITACORA);
+        if (static_cast<uint8_t>(cabecera[4]) != VERSION_BITACORA)
+            throw "La bitácora existente es de otra versión; debe reproducirse antes de abrirla.";
+    }
+
+    // Lo que sigue a la última entrada válida se descarta para que las
+    // nuevas no queden detrás de basura
+    error_code error;
+    uint64_t tamActual = filesystem::exists(rutaBitacora, error) ? filesystem::file_size(rutaBitacora, error) : 0;
+    if (!error && tamActual > finValido) {
+        filesystem::resize_file(rutaBitacora, finValido, error);
+        if (error) throw "No se pudo descartar el final incompleto de la bitácora.";
+    }
+
+    ruta = rutaBitacora;
+    semilla = semillaCifrado;
+    esperaGrupoMs = esperaMs;
+    bytes = finValido;
+    siguiente = max(primeraSecuencia, ultima + 1);
+    ultimaEncolada = ultimaConfirmada = siguiente - 1;
+    pendiente.clear();
+    escribiendo = detener = fallo = false;
+    escritor = thread(&Bitacora::bucleEscritor, this);
+}
+
+void Bitacora::cerrar() {
+    if (!escritor.joinable()) return;
+    {
+        lock_guard<mutex> lock(m);
+        detener = true;
+    }
+    hayPendientes.notify_all();
+    escritor.join();
+    if (archivo) {
+        fclose(archivo);
+        archivo = nullptr;
+    }
+}
+
+uint64_t Bitacora::registrar(MotivoCambio motivo, int64_t delta, const Cuenta& cuenta) {
+    // El registro "motivo,delta,<cuenta>" se arma, se cifra y se empaqueta
+    // sin el candado: los cajeros cifran en paralelo y solo se turnan para
+    // numerarlo y copiarlo
+    string linea = to_string(static_cast<int>(motivo)) + "," + to_string(delta) + "," + serializarCuenta(cuenta);
+    string cifrada = encriptarCadena(linea, semilla);
+    string registro(cifrada.size() / 8, '\0');
+    if (!empaquetarBits(cifrada.data(), cifrada.size(), reinterpret_cast<uint8_t*>(&registro[0])))
+        return 0;
+    uint32_t sumaRegistro = sumaFNV(registro.data(), registro.size());
+
+    lock_guard<mutex> lock(m);
+    if (!escritor.joinable() || detener || fallo) return 0;
+
+    uint64_t secuencia = siguiente++;
+    char cabecera[TAM_CABECERA_ENTRADA];
+    escribirU32(cabecera, static_cast<uint32_t>(registro.size()));
+    escribirU64(cabecera + 8, secuencia);
+    escribirU32(cabecera + 4, sumaFNV(cabecera + 8, 8, sumaRegistro));
+    pendiente.append(cabecera, TAM_CABECERA_ENTRADA);
+    pendiente.append(registro);
+
+    ultimaEncolada = secuencia;
+    hayPendientes.notify_one();
+    return secuencia;
+}
+
+bool Bitacora::esperar(uint64_t secuencia) {
+    unique_lock<mutex> lock(m);
+    hayConfirmadas.wait(lock, [&] { return ultimaConfirmada >= secuencia || fallo; });
+    return ultimaConfirmada >= secuencia;
+}
+
+uint64_t Bitacora::tamanio() {
+    return bytes;
+}
+
+bool Bitacora::rotar(const string& rutaVieja) {
+    unique_lock<mutex> lock(m);
+    hayConfirmadas.wait(lock, [&] { return (pendiente.empty() && !escribiendo) || fallo; });
+    if (fallo || bytes == 0) return false;
+
+    error_code error;
+    if (filesystem::exists(rutaVieja, error)) return false;
+
+    if (archivo) {
+        fclose(archivo);
+        archivo = nullptr;
+    }
+    if (rename(ruta.c_str(), rutaVieja.c_str()) != 0) {
+        cerr << "ERROR en Bitacora::rotar(): no se pudo renombrar " << ruta << endl;
+        return false;
+    }
+    bytes = 0;
+    return true;
+}
+
+void Bitacora::bucleEscritor() {
+    unique_lock<mutex> lock(m);
+    while (true) {
+        hayPendientes.wait(lock, [&] { return detener || !pendiente.empty(); });
+        if (pendiente.empty()) break;   // detener y nada más que escribir
+
+        // Confirmación en grupo: se da un momento para que lleguen más
+        // entradas y se sincronizan todas juntas
+        if (esperaGrupoMs > 0 && !detener)
+            hayPendientes.wait_for(lock, chrono::milliseconds(esperaGrupoMs), [&] { return detener; });
+
+        string lote;
+        lote.swap(pendiente);
+        uint64_t hasta = ultimaEncolada;
+        escribiendo = true;
+        lock.unlock();
+
+        bool ok = escribirLote(lote);
+
+        lock.lock();
+        escribiendo = false;
+        if (ok) ultimaConfirmada = hasta;
+        else fallo = true;
+        hayConfirmadas.notify_all();
+    }
+}
+
+bool Bitacora::escribirLote(const string& lote) {
+    string cabecera;
+    if (!archivo) {
+        archivo = fopen(ruta.c_str(), "ab");
+        if (!archivo) {
+            cerr << "ERROR en Bitacora: no se pudo abrir " << ruta << endl;
+            return false;
+        }
+        if (bytes == 0) {
+            cabecera.assign(TAM_CABECERA_BITACORA, '\0');
+            memcpy(&cabecera[0], MAGIA_BITACORA, 4);
+            cabecera[4] = static_cast<char>(VERSION_BITACORA);
+        }
+    }
+
+    bool ok = (cabecera.empty() || fwrite(cabecera.data(), 1, cabecera.size(), archivo) == cabecera.size())
+           && fwrite(lote.data(), 1, lote.size(), archivo) == lote.size()
+           && sincronizarArchivo(archivo);
+    if (!ok) {
+        cerr << "ERROR en Bitacora: no se pudo escribir en " << ruta << endl;
+        return false;
+    }
+
+    bytes += cabecera.size() + lote.size();
+    return true;
+}
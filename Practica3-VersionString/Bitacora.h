@@ -0,0 +1,168 @@
+#ifndef BITACORA_H
+#define BITACORA_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Cuenta.h"
+using namespace std;
+
+// ================================================================
+// === Bitácora de movimientos ====================================
+// ================================================================
+//
+// Archivo de solo agregado junto al de usuarios ("<ruta>.bitacora"):
+//   [0..3]   "P3BJ"
+//   [4]      versión (VERSION_BITACORA)
+//   [5..7]   reservado (0)
+// Cada entrada (little-endian):
+//   [0..3]   bytes del registro (uint32)
+//   [4..7]   suma FNV-1a del registro seguido de la secuencia (uint32)
+//   [8..15]  secuencia (uint64)
+//   registro: la línea "motivo,delta,<cuenta serializada>" cifrada con
+//   la semilla del sistema y empaquetada a 8 bits por byte.
+//
+// La secuencia va fuera del registro cifrado para que cada cajero cifre
+// su entrada antes de tomar el candado: bajo el candado solo se numera y
+// se copia al final de lo pendiente. En la versión 1 la secuencia iba al
+// comienzo de la línea cifrada; esas bitácoras se siguen reproduciendo.
+//
+// Cada entrada lleva la cuenta tal como quedó, no solo el delta, así
+// que volver a aplicar una entrada que ya está en el snapshot no cambia
+// nada: reproducir es idempotente. Una entrada incompleta o con la suma
+// inválida (corte a mitad de una escritura) marca el final de la
+// bitácora.
+
+const uint8_t VERSION_BITACORA = 2;
+const int TAM_CABECERA_BITACORA = 8;
+
+/**
+ * @brief Un cambio de cuenta registrado en la bitácora.
+ */
+struct MovimientoCuenta {
+    uint64_t secuencia = 0;                     ///< Orden global, empieza en 1
+    MotivoCambio motivo = MotivoCambio::Consulta;
+    int64_t delta = 0;                          ///< Cambio de saldo en COP
+    Cuenta cuenta;                              ///< La cuenta después del cambio
+};
+
+/**
+ * @brief Bitácora cifrada de solo agregado con confirmación en grupo.
+ *
+ * registrar() solo encola la entrada; un hilo escritor junta todo lo
+ * encolado durante `esperaGrupoMs` y lo escribe con un único write y un
+ * único fsync, así que varias transacciones comparten la misma
+ * sincronización. esperar() bloquea hasta que la entrada está en disco.
+ * El archivo se crea con la primera entrada.
+ */
+class Bitacora {
+public:
+    Bitacora() = default;
+    ~Bitacora();
+
+    Bitacora(const Bitacora&) = delete;
+    Bitacora& operator=(const Bitacora&) = delete;
+
+    /**
+     * @brief Empieza a registrar en `ruta` (cierra antes la que hubiera).
+     *
+     * Si el archivo existe se descarta una entrada final incompleta y las
+     * nuevas entradas continúan detrás de las válidas.
+     *
+     * @param ruta Ruta de la bitácora.
+     * @param semilla Semilla de encriptación.
+     * @param primeraSecuencia Secuencia de la próxima entrada (como mínimo).
+     * @param esperaGrupoMs Ventana para juntar entradas antes de sincronizar.
+     * @throw const char* Si la bitácora existente no se puede leer.
+     */
+    void abrir(const string& ruta, int semilla, uint64_t primeraSecuencia = 1, int esperaGrupoMs = 2);
+
+    /**
+     * @brief Escribe lo pendiente, detiene el escritor y cierra el archivo.
+     */
+    void cerrar();
+
+    bool abierta() const { return escritor.joinable(); }
+
+    /**
+     * @brief Encola una entrada.
+     *
+     * El registro se cifra sin el candado, así que varios hilos pueden
+     * registrar a la vez; la secuencia se asigna al encolar.
+     *
+     * @return Su secuencia, o 0 si la bitácora no está abierta o falló antes.
+     */
+    uint64_t registrar(MotivoCambio motivo, int64_t delta, const Cuenta& cuenta);
+
+    /**
+     * @brief Espera a que la entrada `secuencia` esté sincronizada en disco.
+     * @return false si la escritura falló.
+     */
+    bool esperar(uint64_t secuencia);
+
+    /**
+     * @brief registrar() y esperar() en un solo paso.
+     */
+    bool confirmar(MotivoCambio motivo, int64_t delta, const Cuenta& cuenta) {
+        uint64_t secuencia = registrar(motivo, delta, cuenta);
+        return secuencia != 0 && esperar(secuencia);
+    }
+
+    /**
+     * @brief Bytes del archivo actual (para decidir cuándo compactar).
+     */
+    uint64_t tamanio();
+
+    /**
+     * @brief Renombra la bitácora actual a `rutaVieja`; las entradas
+     *        siguientes van a un archivo nuevo.
+     *
+     * Espera a que se escriba lo pendiente. No pisa una bitácora vieja
+     * que todavía exista.
+     *
+     * @return false si no había nada que rotar o `rutaVieja` ya existe.
+     */
+    bool rotar(const string& rutaVieja);
+
+    /**
+     * @brief Lee una bitácora y entrega cada entrada válida en orden.
+     *
+     * @param ruta Ruta de la bitácora (si no existe no hay entradas).
+     * @param semilla Semilla de encriptación.
+     * @param aplicar Recibe cada entrada.
+     * @param finValido Si no es nulo, recibe el byte donde terminan las entradas válidas.
+     * @return Entradas entregadas, o -1 si el archivo no es una bitácora.
+     */
+    static int64_t reproducir(const string& ruta, int semilla,
+                              const function<void(const MovimientoCuenta&)>& aplicar,
+                              uint64_t* finValido = nullptr);
+
+private:
+    void bucleEscritor();
+    bool escribirLote(const string& lote);
+
+    string ruta;
+    int semilla = 0;
+    int esperaGrupoMs = 2;
+    FILE* archivo = nullptr;            ///< Se abre con la primera escritura
+    atomic<uint64_t> bytes{0};          ///< Tamaño del archivo actual (se lee sin el candado)
+
+    thread escritor;
+    mutex m;
+    condition_variable hayPendientes;
+    condition_variable hayConfirmadas;
+    string pendiente;                   ///< Entradas encoladas, ya codificadas
+    uint64_t siguiente = 1;
+    uint64_t ultimaEncolada = 0;
+    uint64_t ultimaConfirmada = 0;
+    bool escribiendo = false;
+    bool detener = false;
+    bool fallo = false;
+};
+
+#endif // BITACORA_H
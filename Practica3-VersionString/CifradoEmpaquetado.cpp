@@ -0,0 +1,264 @@
+#include "CifradoEmpaquetado.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+using namespace std;
+
+// ================================================================
+// === Utilidades de bits sobre palabras de 64 bits ===============
+// ================================================================
+
+/**
+ * @brief Lee 8 bytes a partir de `byte` como un entero big-endian
+ *        (el primer bit del flujo queda en el bit 63). Los bytes que
+ *        caen fuera del arreglo se leen como cero.
+ */
+static inline uint64_t leerVentana(const uint8_t* datos, size_t numBytes, size_t byte) {
+    uint64_t w = 0;
+    if (byte + 8 <= numBytes) {
+        memcpy(&w, datos + byte, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        w = __builtin_bswap64(w);
+#elif !defined(__BYTE_ORDER__)
+        w = 0;
+        for (int k = 0; k < 8; k++) w = (w << 8) | datos[byte + k];
+#endif
+        return w;
+    }
+    for (int k = 0; k < 8; k++) {
+        w <<= 8;
+        if (byte + k < numBytes) w |= datos[byte + k];
+    }
+    return w;
+}
+
+/**
+ * @brief Invierte los bits del rango [inicio, inicio + len).
+ */
+static void invertirRango(uint8_t* datos, size_t inicio, size_t len) {
+    if (len == 0) return;
+    size_t fin = inicio + len;
+    size_t b0 = inicio >> 3;
+    size_t b1 = (fin - 1) >> 3;
+    uint8_t mascaraIni = static_cast<uint8_t>(0xFF >> (inicio & 7));
+    uint8_t mascaraFin = static_cast<uint8_t>(0xFF << (7 - ((fin - 1) & 7)));
+
+    if (b0 == b1) {
+        datos[b0] ^= (mascaraIni & mascaraFin);
+        return;
+    }
+
+    datos[b0] ^= mascaraIni;
+    size_t b = b0 + 1;
+    for (; b + 8 <= b1; b += 8) {
+        uint64_t w;
+        memcpy(&w, datos + b, 8);
+        w = ~w;
+        memcpy(datos + b, &w, 8);
+    }
+    for (; b < b1; b++) datos[b] ^= 0xFF;
+    datos[b1] ^= mascaraFin;
+}
+
+// ================================================================
+// === Motor de cifrado ===========================================
+// ================================================================
+
+/**
+ * @brief Elige la regla del siguiente bloque según el balance de bits.
+ *
+ * @param unos Cantidad de bits en 1 del bloque anterior.
+ * @param longitud Longitud del bloque anterior.
+ * @return ReglaBloque Regla a aplicar.
+ */
+ReglaBloque reglaSegunBloque(int unos, int longitud) {
+    int ceros = longitud - unos;
+    if (unos == ceros) return INVERTIR_TODO;
+    if (ceros > unos)  return INVERTIR_CADA_2;
+    return INVERTIR_CADA_3;
+}
+
+/**
+ * @brief Encripta bits empaquetados con las mismas reglas que encriptarBits().
+ *
+ * invertirCadaNBits() invierte por completo cada grupo de n bits y los
+ * grupos cubren el bloque entero, así que las tres reglas invierten el
+ * bloque completo: la regla que elige reglaSegunBloque() no cambia el
+ * resultado y el cifrado es un NOT de todo el rango, sin contar unos.
+ *
+ * @param entrada Bytes de entrada (bit más significativo primero).
+ * @param salida Bytes de salida; puede coincidir con `entrada`.
+ * @param numBits Número de bits a procesar.
+ * @param semilla Tamaño de bloque.
+ *
+ * @throw const char* Si la semilla es inválida o los punteros son nulos.
+ */
+void encriptarBitsEmpaquetados(const uint8_t* entrada, uint8_t* salida,
+                               size_t numBits, int semilla) {
+    if (semilla <= 0)
+        throw "Error: semilla inválida (debe ser > 0).";
+    if (numBits == 0)
+        return;
+    if (!entrada || !salida)
+        throw "Error: puntero nulo en encriptarBitsEmpaquetados.";
+
+    size_t numBytes = (numBits + 7) / 8;
+    if (entrada != salida)
+        memmove(salida, entrada, numBytes);
+    invertirRango(salida, 0, numBits);
+}
+
+/**
+ * @brief Desencripta bits empaquetados.
+ *
+ * Como todas las reglas invierten el bloque completo (ver
+ * encriptarBitsEmpaquetados()), descifrar es el mismo NOT de todo el
+ * rango y no hace falta leer la regla del bloque cifrado anterior.
+ *
+ * @throw const char* Si la semilla es inválida o los punteros son nulos.
+ */
+void desencriptarBitsEmpaquetados(const uint8_t* entrada, uint8_t* salida,
+                                  size_t numBits, int semilla) {
+    if (semilla <= 0)
+        throw "Error: semilla inválida (debe ser > 0).";
+    if (numBits == 0)
+        return;
+    if (!entrada || !salida)
+        throw "Error: puntero nulo en desencriptarBitsEmpaquetados.";
+
+    if (entrada != salida)
+        memcpy(salida, entrada, (numBits + 7) / 8);
+    invertirRango(salida, 0, numBits);
+}
+
+/**
+ * @brief Desencripta bits empaquetados repartiendo los bloques entre hilos.
+ *
+ * Cada trozo abarca un múltiplo de 8 bloques, así que empieza en un
+ * límite de byte y ningún par de hilos escribe en el mismo byte. Con
+ * entrada == salida, o registros cortos, usa la versión secuencial.
+ */
+void desencriptarBitsEmpaquetados(const uint8_t* entrada, uint8_t* salida,
+                                  size_t numBits, int semilla, PoolHilos& pool) {
+    if (entrada == salida || numBits < BITS_MIN_PARALELO || pool.numHilos() <= 1) {
+        desencriptarBitsEmpaquetados(entrada, salida, numBits, semilla);
+        return;
+    }
+    if (semilla <= 0)
+        throw "Error: semilla inválida (debe ser > 0).";
+    if (!entrada || !salida)
+        throw "Error: puntero nulo en desencriptarBitsEmpaquetados.";
+
+    size_t numBloques = (numBits + semilla - 1) / semilla;
+    size_t numGrupos = (numBloques + 7) / 8;          // grupos de 8 bloques
+    int trozo = PoolHilos::trozoSugerido(static_cast<int>(numGrupos), pool.numHilos());
+
+    pool.paraCadaTrozo(static_cast<int>(numGrupos), trozo, [=](int inicio, int fin, int) {
+        size_t primero = static_cast<size_t>(inicio) * 8;
+        size_t ultimo = min(static_cast<size_t>(fin) * 8, numBloques);
+        size_t bitIni = primero * semilla;
+        size_t bitFin = min(ultimo * semilla, numBits);
+        size_t byteIni = bitIni / 8;
+        memcpy(salida + byteIni, entrada + byteIni, (bitFin + 7) / 8 - byteIni);
+        invertirRango(salida, bitIni, bitFin - bitIni);
+    });
+}
+
+// ================================================================
+// === Lotes de registros =========================================
+// ================================================================
+//
+// Se procesan hasta 64 registros a la vez. Como en
+// encriptarBitsEmpaquetados(), las tres reglas invierten el bloque
+// completo, así que la regla elegida por el balance del bloque anterior
+// no cambia el resultado y el lote se reduce a un NOT de cada palabra de 64 bits de cada registro:
+// no hace falta transponer a bit-slicing ni contar unos por carril.
+
+/**
+ * @brief Los 8 caracteres '0'/'1' de cada byte posible.
+ *
+ * El lote escribe de a 8 bytes por carril, muy poco para que
+ * expandirBits() aproveche sus núcleos SIMD.
+ */
+struct TablaCaracteres {
+    char v[256][8];
+    constexpr TablaCaracteres() : v() {
+        for (int i = 0; i < 256; i++)
+            for (int j = 0; j < 8; j++)
+                v[i][j] = static_cast<char>('0' + ((i >> (7 - j)) & 1));
+    }
+};
+static constexpr TablaCaracteres CARACTERES{};
+
+/**
+ * @brief Encripta hasta CARRILES_LOTE registros a la vez.
+ *
+ * Recorre los registros en tramos de 64 bits, los invierte con una sola
+ * operación de palabra y escribe cada carril ya expandido a '0'/'1'. La
+ * salida es idéntica a encriptarBitsEmpaquetados() sobre cada registro.
+ *
+ * @throw const char* Si la semilla es inválida o hay demasiados carriles.
+ */
+void encriptarLoteBinario(const uint8_t* const* entradas, const size_t* numBytes,
+                          int numCarriles, int semilla, char* const* salidas) {
+    if (semilla <= 0)
+        throw "Error: semilla inválida (debe ser > 0).";
+    if (numCarriles > CARRILES_LOTE)
+        throw "Error: demasiados registros en un lote.";
+    if (numCarriles <= 0)
+        return;
+
+    size_t maxBytes = 0;
+    for (int c = 0; c < numCarriles; c++)
+        maxBytes = max(maxBytes, numBytes[c]);
+
+    for (size_t byte = 0; byte < maxBytes; byte += 8) {
+        for (int c = 0; c < numCarriles; c++) {
+            if (byte >= numBytes[c]) continue;
+            uint64_t w = ~leerVentana(entradas[c], numBytes[c], byte);
+            size_t n = min<size_t>(8, numBytes[c] - byte);
+            char* destino = salidas[c] + byte * 8;
+            for (size_t k = 0; k < n; k++)
+                memcpy(destino + 8 * k, CARACTERES.v[static_cast<uint8_t>(w >> (56 - 8 * k))], 8);
+        }
+    }
+}
+
+// ================================================================
+// === Helpers sobre texto ========================================
+// ================================================================
+
+/**
+ * @brief Encripta un texto sin construir la cadena binaria intermedia.
+ *
+ * @param texto Texto plano.
+ * @param semilla Semilla de encriptación.
+ * @return string Cadena de '0'/'1' cifrada.
+ */
+string encriptarTextoEmpaquetado(const string& texto, int semilla) {
+    string bytes = texto;
+    uint8_t* datos = reinterpret_cast<uint8_t*>(&bytes[0]);
+    encriptarBitsEmpaquetados(datos, datos, bytes.size() * 8, semilla);
+
+    string resultado(bytes.size() * 8, '0');
+    expandirBits(datos, bytes.size(), &resultado[0]);
+    return resultado;
+}
+
+/**
+ * @brief Desencripta una cadena de '0'/'1' devolviendo los bytes originales.
+ *
+ * @throw const char* Si la longitud no es múltiplo de 8 o hay caracteres inválidos.
+ */
+string desencriptarTextoEmpaquetado(string_view binario, int semilla) {
+    if (binario.size() % 8 != 0)
+        throw "Error: longitud binaria no es múltiplo de 8.";
+
+    string bytes(binario.size() / 8, '\0');
+    uint8_t* datos = reinterpret_cast<uint8_t*>(&bytes[0]);
+    if (!empaquetarBits(binario.data(), binario.size(), datos))
+        throw "Error: caracter inválido en cadena binaria.";
+
+    desencriptarBitsEmpaquetados(datos, datos, binario.size(), semilla);
+    return bytes;
+}
@@ -0,0 +1,100 @@
+#ifndef CIFRADO_EMPAQUETADO_H
+#define CIFRADO_EMPAQUETADO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "ConversionSIMD.h"
+#include "PoolHilos.h"
+using namespace std;
+
+// ================================================================
+// === Motor de cifrado sobre bits empaquetados ===================
+// ================================================================
+//
+// Aplica exactamente las mismas reglas por bloque que encriptarBits(),
+// pero sobre bytes reales (8 bits por byte, bit más significativo
+// primero, igual que textoAbinario()) en lugar de cadenas de '0'/'1'.
+// Los resultados son idénticos bit a bit a la versión por caracteres.
+
+/**
+ * Regla de transformación de un bloque, elegida a partir del
+ * balance de unos y ceros del bloque de salida anterior.
+ */
+enum ReglaBloque {
+    INVERTIR_TODO,      ///< unos == ceros (y siempre el primer bloque)
+    INVERTIR_CADA_2,    ///< ceros > unos
+    INVERTIR_CADA_3     ///< unos > ceros
+};
+
+/**
+ * Decide la regla del siguiente bloque a partir de la cantidad de unos
+ * de un bloque de longitud `longitud`.
+ */
+ReglaBloque reglaSegunBloque(int unos, int longitud);
+
+/**
+ * Encripta `numBits` bits empaquetados de `entrada` y deja el resultado
+ * en `salida` (ambos de al menos (numBits + 7) / 8 bytes). Puede
+ * trabajar in-place (entrada == salida).
+ */
+void encriptarBitsEmpaquetados(const uint8_t* entrada, uint8_t* salida,
+                               size_t numBits, int semilla);
+
+/**
+ * Desencripta bits empaquetados. Mismo contrato que desencriptarBits():
+ * la regla de cada bloque se toma del bloque cifrado anterior, por lo que
+ * los bloques se descifran de forma independiente. Puede trabajar in-place.
+ */
+void desencriptarBitsEmpaquetados(const uint8_t* entrada, uint8_t* salida,
+                                  size_t numBits, int semilla);
+
+/**
+ * Registros con menos bits que esto se descifran en un solo hilo: repartirlos
+ * cuesta más que procesarlos.
+ */
+const size_t BITS_MIN_PARALELO = 1u << 16;
+
+/**
+ * Igual que la anterior, pero reparte los bloques entre los hilos del pool.
+ * Pensada para registros muy largos; requiere entrada != salida para
+ * paralelizar (si coinciden, se procesa en un solo hilo).
+ */
+void desencriptarBitsEmpaquetados(const uint8_t* entrada, uint8_t* salida,
+                                  size_t numBits, int semilla, PoolHilos& pool);
+
+/**
+ * Registros que procesa a la vez encriptarLoteBinario().
+ */
+const int CARRILES_LOTE = 64;
+
+/**
+ * Semilla máxima con la que se usa encriptarLoteBinario(); con semillas
+ * mayores las líneas van por el motor escalar, una a una.
+ */
+const int SEMILLA_MAX_LOTE = 7;
+
+/**
+ * Encripta hasta CARRILES_LOTE registros a la vez y deja cada uno
+ * expandido a '0'/'1' en `salidas[c]` (numBytes[c] * 8
+ * caracteres, sin terminador). El resultado de cada carril es idéntico
+ * a encriptarBitsEmpaquetados(); conviene agrupar registros de longitud
+ * parecida, porque el lote avanza hasta el más largo.
+ */
+void encriptarLoteBinario(const uint8_t* const* entradas, const size_t* numBytes,
+                          int numCarriles, int semilla, char* const* salidas);
+
+/**
+ * Encripta un texto plano directamente desde sus bytes y devuelve la
+ * cadena de '0'/'1' equivalente a encriptarBits(textoAbinario(texto)).
+ */
+string encriptarTextoEmpaquetado(const string& texto, int semilla);
+
+/**
+ * Operación inversa: recibe la cadena de '0'/'1' cifrada y devuelve los
+ * bytes del texto original. Lanza const char* si la cadena es inválida.
+ */
+string desencriptarTextoEmpaquetado(string_view binario, int semilla);
+
+#endif // CIFRADO_EMPAQUETADO_H
@@ -0,0 +1,352 @@
+#include "CifradoFlujo.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+/// Bytes leídos del archivo en cada paso de los helpers de archivo.
+static const size_t TAM_TROZO_FLUJO = 64 * 1024;
+
+// ================================================================
+// === CifradorFlujo ==============================================
+// ================================================================
+
+/**
+ * @brief Crea un cifrador en el inicio de un registro.
+ *
+ * @param semilla Tamaño de bloque.
+ * @param modo ENCRIPTAR o DESENCRIPTAR.
+ *
+ * @throw const char* Si la semilla no es positiva.
+ */
+CifradorFlujo::CifradorFlujo(int semilla, Modo modo)
+    : semilla(semilla), modo(modo) {
+    if (semilla <= 0)
+        throw "Error: semilla inválida (debe ser > 0).";
+    reiniciar();
+}
+
+void CifradorFlujo::reiniciar() {
+    totalBits = 0;
+}
+
+size_t CifradorFlujo::bitsProcesados() const {
+    return totalBits;
+}
+
+/**
+ * @brief Procesa el siguiente trozo del registro.
+ *
+ * Las tres reglas invierten el bloque completo (ver
+ * encriptarBitsEmpaquetados()), así que ningún byte depende de los
+ * anteriores: cifrar y descifrar son el mismo NOT byte a byte y el
+ * trozo puede cortar el registro en cualquier lugar.
+ *
+ * @param entrada Bytes de entrada.
+ * @param numBytes Cantidad de bytes.
+ * @param salida Bytes de salida (puede ser `entrada`).
+ */
+void CifradorFlujo::procesar(const uint8_t* entrada, size_t numBytes, uint8_t* salida) {
+    for (size_t b = 0; b < numBytes; b++)
+        salida[b] = static_cast<uint8_t>(~entrada[b]);
+    totalBits += numBytes * 8;
+}
+
+// ================================================================
+// === Archivos por flujo =========================================
+// ================================================================
+
+/**
+ * @brief Cifra cada línea no vacía de `rutaOrigen` y reparte los
+ *        registros entre varios destinos.
+ *
+ * Lee trozos de TAM_TROZO_FLUJO bytes; cada línea no vacía se cifra como
+ * un registro independiente aunque quede partida entre trozos. En cada
+ * destino las líneas se separan con '\n' (sin salto final), igual que
+ * guardarArchivoLineas().
+ *
+ * @param destinos Archivos de salida, en orden.
+ * @param registros Registros que van a cada destino salvo el último,
+ *        que recibe el resto.
+ *
+ * @throw const char* Si no se puede leer o escribir.
+ */
+static void encriptarLineasFlujo(const string& rutaOrigen, int semilla, const vector<string>& destinos,
+                                 const vector<uint64_t>& registros) {
+    CifradorFlujo cifrador(semilla, CifradorFlujo::ENCRIPTAR);
+
+    ifstream origen(rutaOrigen, ios::binary);
+    if (!origen.is_open())
+        throw "No se pudo abrir el archivo de origen.";
+
+    ofstream destino;
+    size_t actual = 0;
+    uint64_t enActual = 0;
+    auto abrir = [&](size_t k) {
+        if (destino.is_open()) {
+            destino.close();
+            if (!destino)
+                throw "Error de escritura en el archivo de destino.";
+        }
+        destino.open(destinos[k], ios::trunc | ios::binary);
+        if (!destino.is_open())
+            throw "No se pudo abrir el archivo de destino.";
+        actual = k;
+        enActual = 0;
+    };
+    abrir(0);
+
+    vector<char> lectura(TAM_TROZO_FLUJO);
+    vector<uint8_t> cifrado(TAM_TROZO_FLUJO);
+    vector<char> bits(TAM_TROZO_FLUJO * 8);
+    bool enRegistro = false;
+
+    while (origen.read(lectura.data(), lectura.size()) || origen.gcount() > 0) {
+        size_t leidos = static_cast<size_t>(origen.gcount());
+        size_t i = 0;
+        while (i < leidos) {
+            if (lectura[i] == '\n') {
+                if (enRegistro) cifrador.reiniciar();
+                enRegistro = false;
+                i++;
+                continue;
+            }
+
+            const char* salto = static_cast<const char*>(memchr(&lectura[i], '\n', leidos - i));
+            size_t fin = salto ? static_cast<size_t>(salto - lectura.data()) : leidos;
+            size_t n = fin - i;
+
+            if (!enRegistro) {
+                if (actual + 1 < destinos.size() && enActual == registros[actual]) abrir(actual + 1);
+                if (enActual > 0) destino.put('\n');
+                enRegistro = true;
+                enActual++;
+            }
+
+            cifrador.procesar(reinterpret_cast<const uint8_t*>(&lectura[i]), n, cifrado.data());
+            expandirBits(cifrado.data(), n, bits.data());
+            destino.write(bits.data(), n * 8);
+            i = fin;
+        }
+    }
+
+    destino.close();
+    if (!destino)
+        throw "Error de escritura en el archivo de destino.";
+}
+
+/**
+ * @brief Encripta un archivo de texto plano sin cargarlo completo.
+ *
+ * @param rutaOrigen Archivo de texto plano.
+ * @param rutaDestino Archivo donde se escribe el binario cifrado.
+ * @param semilla Semilla de encriptación.
+ * @return true si todo el archivo se procesó.
+ */
+bool encriptarArchivoFlujo(const string& rutaOrigen, const string& rutaDestino, int semilla) {
+    try {
+        encriptarLineasFlujo(rutaOrigen, semilla, { rutaDestino }, {});
+        return true;
+    }
+    catch (const char* e) {
+        cerr << "ERROR en encriptarArchivoFlujo(): " << e << endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Reparte los registros de un texto plano en segmentos según el
+ *        tamaño que tendrán cifrados, con las reglas de guardarSegmentado().
+ *
+ * Solo recorre el archivo midiendo líneas: cada registro de n caracteres
+ * ocupa 8n bytes más su '\n'.
+ *
+ * @throw const char* Si no se puede leer, no hay registros o uno no cabe en un segmento.
+ */
+static vector<SegmentoAlmacen> planificarSegmentos(const string& rutaOrigen, uint64_t tamMaxSegmento) {
+    ifstream origen(rutaOrigen, ios::binary);
+    if (!origen.is_open())
+        throw "No se pudo abrir el archivo de origen.";
+
+    vector<SegmentoAlmacen> segmentos(1);
+    uint64_t largo = 0;
+    auto cerrarRegistro = [&]() {
+        if (largo == 0) return;
+        uint64_t bytes = largo * 8 + 1;
+        if (bytes > tamMaxSegmento)
+            throw "Registro más grande que un segmento.";
+        if (segmentos.back().registros > 0 && segmentos.back().bytes + bytes > tamMaxSegmento)
+            segmentos.emplace_back();
+        segmentos.back().bytes += bytes;
+        segmentos.back().registros++;
+        largo = 0;
+    };
+
+    vector<char> lectura(TAM_TROZO_FLUJO);
+    while (origen.read(lectura.data(), lectura.size()) || origen.gcount() > 0) {
+        size_t leidos = static_cast<size_t>(origen.gcount());
+        size_t i = 0;
+        while (i < leidos) {
+            const char* salto = static_cast<const char*>(memchr(&lectura[i], '\n', leidos - i));
+            size_t fin = salto ? static_cast<size_t>(salto - lectura.data()) : leidos;
+            largo += fin - i;
+            i = fin;
+            if (salto) {
+                cerrarRegistro();
+                i++;
+            }
+        }
+    }
+    cerrarRegistro();
+
+    if (segmentos.back().registros == 0)
+        throw "No hay registros para cifrar.";
+    for (SegmentoAlmacen& segmento : segmentos)
+        segmento.bytes--;      // la última línea va sin '\n'
+    return segmentos;
+}
+
+/**
+ * @brief Encripta un texto plano hacia un almacén sin cargarlo.
+ *
+ * Primero mide las líneas para saber dónde cortar y luego cifra en una
+ * sola pasada, escribiendo cada archivo por temporal y
+ * reemplazarArchivo(). Si hay un solo segmento y el destino no era ya
+ * un manifiesto, el resultado es un archivo suelto, como en
+ * guardarAlmacen(); si no, los segmentos de una generación nueva y su
+ * manifiesto.
+ */
+bool encriptarAlmacenFlujo(const string& rutaOrigen, const string& rutaAlmacen, int semilla,
+                           uint64_t tamMaxSegmento) {
+    vector<string> destinos;
+    ManifiestoAlmacen manifiesto;
+    try {
+        vector<SegmentoAlmacen> segmentos = planificarSegmentos(rutaOrigen, tamMaxSegmento);
+
+        // Un almacén que ya era segmentado sigue siéndolo, como en guardarAlmacen()
+        bool segmentar = segmentos.size() > 1 || esManifiestoSegmentado(rutaAlmacen);
+        manifiesto.generacion = siguienteGeneracion(rutaAlmacen);
+        manifiesto.empaquetado = false;
+        vector<uint64_t> registros;
+        for (const SegmentoAlmacen& segmento : segmentos) {
+            registros.push_back(segmento.registros);
+            manifiesto.totalRegistros += segmento.registros;
+            destinos.push_back(segmentar
+                                   ? rutaSegmento(rutaAlmacen, manifiesto.generacion, destinos.size()) + ".tmp"
+                                   : rutaAlmacen + ".tmp");
+        }
+        encriptarLineasFlujo(rutaOrigen, semilla, destinos, registros);
+
+        if (!segmentar) {
+            if (!reemplazarArchivo(destinos[0], rutaAlmacen))
+                throw "No se pudo reemplazar el archivo.";
+            return true;
+        }
+
+        for (size_t k = 0; k < destinos.size(); k++) {
+            if (!reemplazarArchivo(destinos[k], rutaSegmento(rutaAlmacen, manifiesto.generacion, k)))
+                throw "No se pudo escribir un segmento.";
+            destinos[k].clear();
+            manifiesto.segmentos.push_back(segmentos[k]);
+        }
+        if (!publicarManifiesto(rutaAlmacen, manifiesto))
+            throw "No se pudo escribir el manifiesto.";
+        return true;
+    }
+    catch (const char* e) {
+        cerr << "ERROR en encriptarAlmacenFlujo(): " << e << endl;
+        for (const string& temporal : destinos)
+            if (!temporal.empty()) remove(temporal.c_str());
+        for (size_t k = 0; k < manifiesto.segmentos.size(); k++)
+            remove(rutaSegmento(rutaAlmacen, manifiesto.generacion, k).c_str());
+        return false;
+    }
+}
+
+/**
+ * @brief Desencripta un archivo binario sin cargarlo completo.
+ *
+ * Los caracteres '0'/'1' se empaquetan de a 8; si un byte queda partido
+ * entre dos trozos, sus primeros bits se guardan hasta el siguiente.
+ *
+ * @param rutaOrigen Archivo binario cifrado.
+ * @param rutaDestino Archivo donde se escribe el texto plano.
+ * @param semilla Semilla usada al encriptar.
+ * @return true si todo el archivo se procesó.
+ */
+bool desencriptarArchivoFlujo(const string& rutaOrigen, const string& rutaDestino, int semilla) {
+    try {
+        CifradorFlujo descifrador(semilla, CifradorFlujo::DESENCRIPTAR);
+
+        ifstream origen(rutaOrigen, ios::binary);
+        if (!origen.is_open())
+            throw "No se pudo abrir el archivo de origen.";
+        ofstream destino(rutaDestino, ios::trunc | ios::binary);
+        if (!destino.is_open())
+            throw "No se pudo abrir el archivo de destino.";
+
+        vector<char> lectura(TAM_TROZO_FLUJO);
+        vector<uint8_t> bytes(TAM_TROZO_FLUJO / 8 + 1);
+        char pendiente[8];
+        size_t numPendiente = 0;
+        bool enRegistro = false, hayRegistros = false;
+
+        auto descifrar = [&](const char* bits, size_t n) {
+            if (!empaquetarBits(bits, n, bytes.data()))
+                throw "Caracter inválido en el archivo cifrado.";
+            descifrador.procesar(bytes.data(), n / 8, bytes.data());
+            destino.write(reinterpret_cast<const char*>(bytes.data()), n / 8);
+        };
+
+        while (origen.read(lectura.data(), lectura.size()) || origen.gcount() > 0) {
+            size_t leidos = static_cast<size_t>(origen.gcount());
+            size_t i = 0;
+            while (i < leidos) {
+                if (lectura[i] == '\n') {
+                    if (numPendiente != 0)
+                        throw "Línea cifrada con longitud no múltiplo de 8.";
+                    if (enRegistro) descifrador.reiniciar();
+                    enRegistro = false;
+                    i++;
+                    continue;
+                }
+
+                const char* salto = static_cast<const char*>(memchr(&lectura[i], '\n', leidos - i));
+                size_t fin = salto ? static_cast<size_t>(salto - lectura.data()) : leidos;
+
+                if (!enRegistro) {
+                    if (hayRegistros) destino.put('\n');
+                    enRegistro = hayRegistros = true;
+                }
+
+                // Completar el byte que quedó partido en el trozo anterior
+                while (numPendiente > 0 && numPendiente < 8 && i < fin)
+                    pendiente[numPendiente++] = lectura[i++];
+                if (numPendiente == 8) {
+                    descifrar(pendiente, 8);
+                    numPendiente = 0;
+                }
+
+                size_t completos = (fin - i) / 8 * 8;
+                if (completos > 0)
+                    descifrar(&lectura[i], completos);
+                i += completos;
+
+                while (i < fin)
+                    pendiente[numPendiente++] = lectura[i++];
+            }
+        }
+
+        if (numPendiente != 0)
+            throw "Línea cifrada con longitud no múltiplo de 8.";
+        if (!destino)
+            throw "Error de escritura en el archivo de destino.";
+        return true;
+    }
+    catch (const char* e) {
+        cerr << "ERROR en desencriptarArchivoFlujo(): " << e << endl;
+        return false;
+    }
+}
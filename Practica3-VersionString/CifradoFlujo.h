@@ -0,0 +1,88 @@
+#ifndef CIFRADO_FLUJO_H
+#define CIFRADO_FLUJO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "AlmacenSegmentado.h"
+#include "CifradoEmpaquetado.h"
+using namespace std;
+
+// ================================================================
+// === Cifrado por flujo (trozos de tamaño arbitrario) ============
+// ================================================================
+//
+// Aplica las mismas reglas por bloque que encriptarBits() pero sin
+// necesitar el registro completo en memoria. Como las tres reglas
+// invierten el bloque entero, la regla que elige el balance del bloque
+// anterior no cambia el resultado y no hay estado de bloque que arrastrar
+// entre trozos: un registro puede llegar partido en cualquier lugar y
+// procesarlo de una vez o en trozos da el mismo resultado.
+
+/**
+ * Cifrador / descifrador incremental de un registro de bits empaquetados
+ * (8 bits por byte, bit más significativo primero).
+ */
+class CifradorFlujo {
+public:
+    enum Modo {
+        ENCRIPTAR,
+        DESENCRIPTAR
+    };
+
+    /**
+     * Crea el cifrador. Lanza const char* si la semilla no es positiva.
+     */
+    CifradorFlujo(int semilla, Modo modo);
+
+    /**
+     * Procesa los siguientes `numBytes` bytes del registro. `salida` debe
+     * tener el mismo tamaño y puede coincidir con `entrada`.
+     */
+    void procesar(const uint8_t* entrada, size_t numBytes, uint8_t* salida);
+
+    /**
+     * Termina el registro actual: el siguiente byte procesado empieza un
+     * registro nuevo.
+     */
+    void reiniciar();
+
+    /**
+     * Bits procesados desde el último reiniciar().
+     */
+    size_t bitsProcesados() const;
+
+private:
+    int semilla;
+    Modo modo;              ///< Cifrar y descifrar hacen lo mismo (un NOT).
+    size_t totalBits;
+};
+
+/**
+ * Encripta un archivo de texto línea por línea con memoria constante.
+ * Cada línea no vacía es un registro independiente; la salida tiene el
+ * mismo formato que guardarArchivoLineas() tras encriptarArchivo().
+ * Retorna false (y lo informa por cerr) si algo falla.
+ */
+bool encriptarArchivoFlujo(const string& rutaOrigen, const string& rutaDestino, int semilla);
+
+/**
+ * Operación inversa de encriptarArchivoFlujo(). Falla si alguna línea
+ * trae caracteres distintos de '0'/'1' o una longitud no múltiplo de 8.
+ */
+bool desencriptarArchivoFlujo(const string& rutaOrigen, const string& rutaDestino, int semilla);
+
+/**
+ * Encripta un archivo de texto plano hacia un almacén (AlmacenSegmentado.h)
+ * con memoria constante, sin el límite de tamaño de cargarLineasMapeadas().
+ * Si el binario cabe en `tamMaxSegmento` (y `rutaAlmacen` no era ya un
+ * manifiesto) queda en un archivo suelto; si no, en segmentos de una
+ * generación nueva con su manifiesto, cortados igual que en
+ * guardarSegmentado(). `rutaAlmacen` puede ser la misma
+ * `rutaOrigen`: se reemplaza solo al final. Retorna false (y lo informa
+ * por cerr) si algo falla; en ese caso `rutaAlmacen` queda intacta.
+ */
+bool encriptarAlmacenFlujo(const string& rutaOrigen, const string& rutaAlmacen, int semilla,
+                           uint64_t tamMaxSegmento = TAM_MAX_SEGMENTO);
+
+#endif // CIFRADO_FLUJO_H
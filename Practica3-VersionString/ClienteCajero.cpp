@@ -0,0 +1,330 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "ClienteCajero.h"
+#include "OperacionesUsuario.h"
+#include "ProtocoloCajero.h"
+
+using namespace std;
+
+/**
+ * @brief Motivo de una respuesta "error <motivo>" (o la respuesta completa).
+ */
+static string motivoError(const string& respuesta) {
+    return respuesta.compare(0, 6, "error ") == 0 ? respuesta.substr(6) : respuesta;
+}
+
+/**
+ * @brief Submenú de operaciones de un usuario ya autenticado.
+ * @return false si se perdió la conexión.
+ */
+static bool operacionesRemotas(ConexionCajero& conexion, const string& nombre) {
+    string respuesta;
+    while (true) {
+        int opcion;
+        cout << "\n=================================\n";
+        cout << "    OPERACIONES DISPONIBLES\n";
+        cout << "=================================\n";
+        cout << "1. Consultar saldo (Costo: " << COSTO_CONSULTA << " COP)\n";
+        cout << "2. Retirar dinero (Costo: " << COSTO_RETIRO << " COP + monto)\n";
+        cout << "3. Volver al menú principal\n";
+        cout << "=================================\n";
+        cout << "Opción: ";
+
+        if (!(cin >> opcion)) {
+            if (cin.eof()) return true;
+            cin.clear();
+            cin.ignore(10000, '\n');
+            cout << "\n[Error] Entrada inválida. Debe ingresar un número.\n";
+            continue;
+        }
+
+        if (opcion == 1) {
+            if (!conexion.peticion("consulta", respuesta)) return false;
+            long long saldo = 0, cobrado = 0;
+            if (sscanf(respuesta.c_str(), "ok %lld %lld", &saldo, &cobrado) != 2) {
+                cout << "\n[Error] " << motivoError(respuesta) << "\n";
+                continue;
+            }
+            cout << "\n---------------------------------\n";
+            cout << "Usuario: " << nombre << endl;
+            cout << "Costo de la consulta: " << cobrado << " COP\n";
+            cout << "Saldo después del cobro: " << saldo << " COP\n";
+            cout << "---------------------------------\n";
+        } else if (opcion == 2) {
+            int monto;
+            cout << "\nMonto a retirar: ";
+            if (!(cin >> monto) || monto <= 0) {
+                if (cin.eof()) return true;
+                cin.clear();
+                cin.ignore(10000, '\n');
+                cout << "\n[Error] El monto debe ser mayor a cero.\n";
+                continue;
+            }
+            if (!conexion.peticion("retiro " + to_string(monto), respuesta)) return false;
+            long long saldo = 0;
+            if (sscanf(respuesta.c_str(), "ok %lld", &saldo) != 1) {
+                cout << "\n---------------------------------\n";
+                cout << "Retiro rechazado: " << motivoError(respuesta) << ".\n";
+                cout << "---------------------------------\n";
+                continue;
+            }
+            cout << "\n---------------------------------\n";
+            cout << "Retiro exitoso.\n";
+            cout << "Monto retirado: " << monto << " COP\n";
+            cout << "Costo de operación: " << COSTO_RETIRO << " COP\n";
+            cout << "Saldo restante: " << saldo << " COP\n";
+            cout << "---------------------------------\n";
+        } else if (opcion == 3) {
+            cout << "\n Volviendo al menú principal...\n";
+            return true;
+        } else {
+            cout << "\n[Error] Opción inválida. Debe ser 1, 2 o 3.\n";
+        }
+    }
+}
+
+int menuCajeroRemoto(const string& direccion) {
+    ConexionCajero conexion;
+    if (!conexion.conectar(direccion))
+        return 1;
+
+    int opcion = 0;
+    string respuesta;
+    do {
+        cout << "\n===================================\n";
+        cout << "||      SISTEMA BANCARIO         ||\n";
+        cout << "===================================\n";
+        cout << "|| 1. Administrador              ||\n";
+        cout << "|| 2. Usuario                    ||\n";
+        cout << "|| 3. Salir                      ||\n";
+        cout << "===================================\n";
+        cout << "Seleccione una opción: ";
+
+        if (!(cin >> opcion)) {
+            if (cin.eof()) break;
+            cin.clear();
+            cin.ignore(10000, '\n');
+            cout << "\n[Error] Entrada inválida. Ingrese un número.\n";
+            continue;
+        }
+
+        if (opcion == 1) {
+            cout << "\n[Error] El registro de usuarios solo está disponible en el cajero local.\n";
+        } else if (opcion == 2) {
+            string cedula, clave;
+            cout << "\n=================================\n";
+            cout << "        MENÚ USUARIO\n";
+            cout << "=================================\n";
+            cout << "Cédula: ";
+            cin >> cedula;
+            cout << "Clave: ";
+            cin >> clave;
+            if (!conexion.peticion("auth " + cedula + " " + clave, respuesta)) {
+                cerr << "\n[Error] Se perdió la conexión con el servicio.\n";
+                return 1;
+            }
+            if (respuesta.compare(0, 3, "ok ") != 0) {
+                cout << "\n[Error] " << motivoError(respuesta) << "\n";
+                continue;
+            }
+            if (!operacionesRemotas(conexion, respuesta.substr(3))) {
+                cerr << "\n[Error] Se perdió la conexión con el servicio.\n";
+                return 1;
+            }
+        } else if (opcion == 3) {
+            cout << "\n Gracias por usar el sistema. Hasta pronto!\n";
+        } else {
+            cout << "\n[Error] Opción inválida. Seleccione 1, 2 o 3.\n";
+        }
+    } while (opcion != 3);
+
+    conexion.peticion("salir", respuesta);
+    return 0;
+}
+
+/**
+ * @brief Lee pares (cédula, clave) de un CSV "cedula,clave,...".
+ */
+static vector<pair<string, string>> leerCredenciales(const string& ruta) {
+    vector<pair<string, string>> credenciales;
+    ifstream archivo(ruta);
+    string linea;
+    while (getline(archivo, linea)) {
+        size_t c1 = linea.find(',');
+        if (c1 == string::npos) continue;
+        size_t c2 = linea.find(',', c1 + 1);
+        string cedula = linea.substr(0, c1);
+        if (cedula.empty() || cedula[0] < '0' || cedula[0] > '9') continue;   // encabezado
+        credenciales.emplace_back(cedula, linea.substr(c1 + 1, c2 == string::npos ? string::npos : c2 - c1 - 1));
+    }
+    return credenciales;
+}
+
+/**
+ * @brief Resultado de una conexión del generador de carga.
+ */
+struct ResultadoCliente {
+    vector<int64_t> latenciasNs;    ///< Una por petición respondida
+    int rechazadas = 0;             ///< Respuestas "error ..."
+    bool fallo = false;             ///< Se perdió o no se abrió la conexión
+};
+
+/**
+ * @brief Una conexión del generador: ciclos de auth, consulta y retiro.
+ *
+ * La conexión `numero` de `clientes` recorre solo su porción de las
+ * credenciales: dos conexiones nunca operan sobre la misma cuenta.
+ */
+static void clienteCarga(const OpcionesCarga& opciones, const vector<pair<string, string>>& credenciales,
+                         int clientes, int numero, ResultadoCliente& resultado) {
+    const size_t desde = credenciales.size() * static_cast<size_t>(numero) / static_cast<size_t>(clientes);
+    const size_t hasta = credenciales.size() * static_cast<size_t>(numero + 1) / static_cast<size_t>(clientes);
+    ConexionCajero conexion;
+    if (!conexion.conectar(opciones.direccion)) {
+        resultado.fallo = true;
+        return;
+    }
+    resultado.latenciasNs.reserve(opciones.peticiones);
+
+    string peticion, respuesta;
+    size_t siguiente = desde;
+    for (int k = 0; k < opciones.peticiones; k++) {
+        switch (k % 3) {
+        case 0: {
+            const pair<string, string>& cuenta = credenciales[siguiente];
+            if (++siguiente == hasta) siguiente = desde;
+            peticion = "auth " + cuenta.first + " " + cuenta.second;
+            break;
+        }
+        case 1:
+            peticion = "consulta";
+            break;
+        default:
+            peticion = "retiro " + to_string(1 + (k + numero) % 100);
+        }
+
+        auto inicio = chrono::steady_clock::now();
+        if (!conexion.peticion(peticion, respuesta)) {
+            resultado.fallo = true;
+            return;
+        }
+        resultado.latenciasNs.push_back(chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now() - inicio).count());
+        if (respuesta.compare(0, 2, "ok") != 0) resultado.rechazadas++;
+    }
+    conexion.peticion("salir", respuesta);
+}
+
+/**
+ * @brief Totales de una corrida del generador.
+ */
+struct MedicionCarga {
+    size_t peticiones = 0;          ///< Peticiones respondidas
+    double segundos = 0;
+    double p50 = 0, p99 = 0, maximo = 0;    ///< Latencias en us
+    int rechazadas = 0;
+    int fallidas = 0;               ///< Conexiones que se perdieron
+
+    double porSegundo() const { return segundos > 0 ? peticiones / segundos : 0; }
+};
+
+/**
+ * @brief Corre el generador con `clientes` conexiones simultáneas.
+ */
+static MedicionCarga medirCarga(const OpcionesCarga& opciones, const vector<pair<string, string>>& credenciales,
+                                int clientes) {
+    vector<ResultadoCliente> resultados(clientes);
+    vector<thread> hilos;
+    auto inicio = chrono::steady_clock::now();
+    for (int c = 0; c < clientes; c++)
+        hilos.emplace_back(clienteCarga, cref(opciones), cref(credenciales), clientes, c, ref(resultados[c]));
+    for (thread& hilo : hilos) hilo.join();
+
+    MedicionCarga medicion;
+    medicion.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    vector<int64_t> latencias;
+    for (const ResultadoCliente& r : resultados) {
+        latencias.insert(latencias.end(), r.latenciasNs.begin(), r.latenciasNs.end());
+        medicion.rechazadas += r.rechazadas;
+        if (r.fallo) medicion.fallidas++;
+    }
+    sort(latencias.begin(), latencias.end());
+    auto percentil = [&](double p) {
+        return latencias.empty() ? 0.0 : latencias[static_cast<size_t>(p * (latencias.size() - 1))] / 1000.0;
+    };
+    medicion.peticiones = latencias.size();
+    medicion.p50 = percentil(0.50);
+    medicion.p99 = percentil(0.99);
+    medicion.maximo = percentil(1.0);
+    return medicion;
+}
+
+int generarCarga(const OpcionesCarga& opciones) {
+    vector<pair<string, string>> credenciales = leerCredenciales(opciones.rutaCredenciales);
+    if (credenciales.empty()) {
+        cerr << "ERROR en generarCarga(): no hay credenciales en " << opciones.rutaCredenciales << endl;
+        return 1;
+    }
+    if (credenciales.size() < static_cast<size_t>(opciones.clientes)) {
+        cerr << "ERROR en generarCarga(): " << opciones.clientes << " conexiones necesitan al menos "
+             << opciones.clientes << " credenciales (una cuenta propia cada una); hay " << credenciales.size() << endl;
+        return 1;
+    }
+
+    if (!opciones.escalado) {
+        MedicionCarga m = medirCarga(opciones, credenciales, opciones.clientes);
+        cout << "Carga: " << opciones.clientes << " conexiones, " << m.peticiones << " peticiones en "
+             << m.segundos << " s (" << m.porSegundo() << " pet/s).\n";
+        cout << "  Latencia p50 " << m.p50 << " us, p99 " << m.p99 << " us, max " << m.maximo << " us.\n";
+        cout << "  Respuestas de error: " << m.rechazadas << "; conexiones fallidas: " << m.fallidas << ".\n";
+        return m.fallidas == 0 ? 0 : 1;
+    }
+
+    // Escalado: 1, 2, 4, ... conexiones sobre cuentas disjuntas; si el
+    // servicio no serializa cuentas distintas, pet/s crece con ellas
+    // hasta agotar los núcleos. El servicio solo escucha en esta máquina
+    // y cada conexión ocupa un hilo de cada lado, así que al servicio le
+    // toca la mitad de los núcleos. Más aceleración que núcleos hay en la
+    // máquina no sale de la CPU: las conexiones están esperando el disco
+    // (la bitácora) y la medición no sirve
+    const int todos = max(1, static_cast<int>(thread::hardware_concurrency()));
+    const int nucleos = max(1, todos / 2);
+    cout << "Escalado (" << opciones.peticiones << " peticiones por conexión, " << nucleos
+         << " núcleo(s) para el servicio; mínimo " << FRACCION_MINIMA_ESCALADO << " del ideal):\n";
+    // Una corrida descartada calienta el servicio para que la base no
+    // salga baja
+    medirCarga(opciones, credenciales, 1);
+    double base = 0;
+    int fallidas = 0;
+    bool alcanzado = true, esperandoDisco = false;
+    for (int clientes = 1; ; clientes = min(clientes * 2, opciones.clientes)) {
+        MedicionCarga m = medirCarga(opciones, credenciales, clientes);
+        if (clientes == 1) base = m.porSegundo();
+        fallidas += m.fallidas;
+        double minimo = FRACCION_MINIMA_ESCALADO * min(clientes, nucleos) * base;
+        cout << "  " << clientes << " conexiones: " << m.porSegundo() << " pet/s (x"
+             << (base > 0 ? m.porSegundo() / base : 0) << "), p99 " << m.p99 << " us";
+        if (m.rechazadas > 0 || m.fallidas > 0)
+            cout << ", " << m.rechazadas << " errores, " << m.fallidas << " conexiones fallidas";
+        if (clientes > 1 && m.porSegundo() < minimo) {
+            cout << ", por debajo de " << minimo << " pet/s";
+            alcanzado = false;
+        }
+        if (m.porSegundo() > LIMITE_ACELERACION_NUCLEOS * todos * base) {
+            cout << ", más que los " << todos << " núcleo(s)";
+            esperandoDisco = true;
+        }
+        cout << "\n";
+        if (clientes >= opciones.clientes) break;
+    }
+    if (esperandoDisco)
+        cout << "La aceleración supera a los núcleos: se midió la espera de la bitácora; corra el servicio con --sin-bitacora.\n";
+    else if (!alcanzado)
+        cout << "El servicio no escala: hay cuentas distintas que se esperan entre sí.\n";
+    return fallidas == 0 && alcanzado && !esperandoDisco ? 0 : 1;
+}
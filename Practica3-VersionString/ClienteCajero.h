@@ -0,0 +1,66 @@
+#ifndef CLIENTE_CAJERO_H
+#define CLIENTE_CAJERO_H
+
+#include <string>
+using namespace std;
+
+// ================================================================
+// === Cajero remoto y generador de carga =========================
+// ================================================================
+//
+// Clientes del servicio de cajeros (ServicioCajero.h): el menú del
+// cajero sin cuentas propias, que manda cada operación al servicio, y
+// un generador de carga que abre varias conexiones a la vez para medir
+// el rendimiento del servicio.
+
+/**
+ * @brief Menú de cajero que opera contra un servicio.
+ *
+ * Las mismas opciones del menú principal; el registro de usuarios
+ * (administrador) solo está disponible en el cajero local.
+ *
+ * @param direccion Dirección del servicio.
+ * @return 0 si terminó normalmente, 1 si no se pudo conectar.
+ */
+int menuCajeroRemoto(const string& direccion);
+
+/// Fracción de la aceleración ideal que debe alcanzar `--escalado`.
+const double FRACCION_MINIMA_ESCALADO = 0.5;
+
+/// Aceleración por núcleo de la máquina por encima de la cual `--escalado`
+/// da la medición por inválida (ver generarCarga()).
+const double LIMITE_ACELERACION_NUCLEOS = 2.0;
+
+/**
+ * @brief Parámetros del generador de carga.
+ */
+struct OpcionesCarga {
+    string direccion;               ///< Dirección del servicio
+    string rutaCredenciales;        ///< CSV "cedula,clave,..." (la primera fila puede ser encabezado)
+    int clientes = 8;               ///< Conexiones simultáneas
+    int peticiones = 3000;          ///< Peticiones por conexión
+    bool escalado = false;          ///< Medir con 1, 2, 4, ... hasta `clientes` conexiones
+};
+
+/**
+ * @brief Genera carga sobre el servicio e informa rendimiento y latencias.
+ *
+ * Cada conexión repite auth, consulta y un retiro pequeño sobre su
+ * propia porción del archivo de credenciales, así que dos conexiones
+ * nunca comparten cuenta (hace falta al menos una credencial por
+ * conexión). Con `escalado` informa el rendimiento para cada cantidad
+ * de conexiones y su aceleración respecto a una sola, y exige que con N
+ * conexiones se llegue al menos a FRACCION_MINIMA_ESCALADO de N veces
+ * el rendimiento de una, con N limitado a los núcleos que le tocan al
+ * servicio. Para medir el servicio y no el disco, el servicio debe
+ * correr con `--sin-bitacora` (o sobre ranuras con `--fsync=N`): con la
+ * bitácora cada retiro espera un fdatasync, y una aceleración mayor que
+ * LIMITE_ACELERACION_NUCLEOS por núcleo de la máquina también se da por
+ * fallida, porque solo puede venir de esas esperas.
+ *
+ * @return 0 si todas las conexiones terminaron (y, con `escalado`, el
+ *         rendimiento alcanzó el mínimo), 1 si no.
+ */
+int generarCarga(const OpcionesCarga& opciones);
+
+#endif // CLIENTE_CAJERO_H
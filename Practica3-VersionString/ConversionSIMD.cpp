@@ -0,0 +1,271 @@
+#include "ConversionSIMD.h"
+#include <cstring>
+using namespace std;
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CONVERSION_X86 1
+#include <immintrin.h>
+#endif
+
+// ================================================================
+// === Versión escalar ============================================
+// ================================================================
+
+/**
+ * @brief Expande bytes a caracteres '0'/'1', un bit a la vez.
+ */
+void expandirBitsEscalar(const uint8_t* bytes, size_t numBytes, char* salida) {
+    for (size_t i = 0; i < numBytes; i++) {
+        uint8_t c = bytes[i];
+        for (int j = 0; j < 8; j++)
+            salida[i * 8 + j] = static_cast<char>('0' + ((c >> (7 - j)) & 1));
+    }
+}
+
+/**
+ * @brief Empaqueta caracteres '0'/'1' en bytes, un bit a la vez.
+ */
+bool empaquetarBitsEscalar(const char* bits, size_t numBits, uint8_t* salida) {
+    for (size_t i = 0; i < numBits / 8; i++) {
+        uint8_t c = 0;
+        for (int j = 0; j < 8; j++) {
+            char b = bits[i * 8 + j];
+            if (b != '0' && b != '1')
+                return false;
+            c = static_cast<uint8_t>((c << 1) | (b - '0'));
+        }
+        salida[i] = c;
+    }
+    return true;
+}
+
+#ifdef CONVERSION_X86
+
+// ================================================================
+// === SSE2 =======================================================
+// ================================================================
+
+/**
+ * @brief Tabla de inversión del orden de bits de un byte.
+ *
+ * movemask deja el primer carácter en el bit 0, pero en textoAbinario()
+ * el primer carácter es el bit más significativo.
+ */
+struct TablaReverso {
+    uint8_t v[256];
+    constexpr TablaReverso() : v() {
+        for (int i = 0; i < 256; i++) {
+            int r = 0;
+            for (int j = 0; j < 8; j++)
+                if (i & (1 << j)) r |= 1 << (7 - j);
+            v[i] = static_cast<uint8_t>(r);
+        }
+    }
+};
+static constexpr TablaReverso REVERSO{};
+
+/**
+ * @brief Convierte 16 bytes que repiten un mismo byte cada 8 posiciones
+ *        en sus 16 caracteres '0'/'1'.
+ */
+__attribute__((target("sse2")))
+static inline __m128i bitsAcaracteresSSE2(__m128i repetidos, __m128i pesos) {
+    __m128i activos = _mm_cmpeq_epi8(_mm_and_si128(repetidos, pesos), pesos);
+    return _mm_sub_epi8(_mm_set1_epi8('0'), activos);   // activo = -1 -> '1'
+}
+
+/**
+ * @brief Expande 16 bytes por iteración replicando cada byte con unpack.
+ */
+__attribute__((target("sse2")))
+static void expandirBitsSSE2(const uint8_t* bytes, size_t numBytes, char* salida) {
+    const __m128i pesos = _mm_setr_epi8(
+        static_cast<char>(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+        static_cast<char>(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+
+    size_t i = 0;
+    for (; i + 16 <= numBytes; i += 16) {
+        __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        __m128i x2[2] = { _mm_unpacklo_epi8(v, v), _mm_unpackhi_epi8(v, v) };
+        char* destino = salida + i * 8;
+
+        for (int h = 0; h < 2; h++) {
+            __m128i x4a = _mm_unpacklo_epi16(x2[h], x2[h]);
+            __m128i x4b = _mm_unpackhi_epi16(x2[h], x2[h]);
+            __m128i x8[4] = {
+                _mm_unpacklo_epi32(x4a, x4a), _mm_unpackhi_epi32(x4a, x4a),
+                _mm_unpacklo_epi32(x4b, x4b), _mm_unpackhi_epi32(x4b, x4b)
+            };
+            for (int k = 0; k < 4; k++)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destino + (h * 4 + k) * 16),
+                                 bitsAcaracteresSSE2(x8[k], pesos));
+        }
+    }
+    expandirBitsEscalar(bytes + i, numBytes - i, salida + i * 8);
+}
+
+/**
+ * @brief Empaqueta 16 caracteres por iteración con movemask.
+ *
+ * La validación es vectorial: se acumulan los bits distintos del bit 0 de
+ * (c - '0') y se revisan una sola vez al final.
+ */
+__attribute__((target("sse2")))
+static bool empaquetarBitsSSE2(const char* bits, size_t numBits, uint8_t* salida) {
+    const __m128i cero = _mm_set1_epi8('0');
+    const __m128i altos = _mm_set1_epi8(static_cast<char>(0xFE));
+    __m128i malos = _mm_setzero_si128();
+
+    size_t numBytes = numBits / 8;
+    size_t i = 0;
+    for (; i + 2 <= numBytes; i += 2) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bits + i * 8));
+        __m128i d = _mm_sub_epi8(v, cero);
+        malos = _mm_or_si128(malos, _mm_and_si128(d, altos));
+
+        int m = _mm_movemask_epi8(_mm_slli_epi16(d, 7));
+        salida[i]     = REVERSO.v[m & 0xFF];
+        salida[i + 1] = REVERSO.v[(m >> 8) & 0xFF];
+    }
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(malos, _mm_setzero_si128())) != 0xFFFF)
+        return false;
+    return empaquetarBitsEscalar(bits + i * 8, (numBytes - i) * 8, salida + i);
+}
+
+// ================================================================
+// === AVX2 =======================================================
+// ================================================================
+
+/**
+ * @brief Expande 16 bytes por iteración: cada shuffle reparte 4 bytes
+ *        en 32 posiciones (8 copias de cada uno).
+ */
+__attribute__((target("avx2")))
+static void expandirBitsAVX2(const uint8_t* bytes, size_t numBytes, char* salida) {
+    const __m256i pesos = _mm256_set1_epi64x(0x0102040810204080LL);
+    const __m256i base = _mm256_setr_epi8(
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+        2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i caracterCero = _mm256_set1_epi8('0');
+
+    size_t i = 0;
+    for (; i + 16 <= numBytes; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        __m256i ambos = _mm256_broadcastsi128_si256(v);
+        char* destino = salida + i * 8;
+
+        for (int g = 0; g < 4; g++) {
+            __m256i control = _mm256_add_epi8(base, _mm256_set1_epi8(static_cast<char>(g * 4)));
+            __m256i repetidos = _mm256_shuffle_epi8(ambos, control);
+            __m256i activos = _mm256_cmpeq_epi8(_mm256_and_si256(repetidos, pesos), pesos);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destino + g * 32),
+                                _mm256_sub_epi8(caracterCero, activos));
+        }
+    }
+    expandirBitsEscalar(bytes + i, numBytes - i, salida + i * 8);
+}
+
+/**
+ * @brief Empaqueta 32 caracteres por iteración: un shuffle invierte cada
+ *        grupo de 8 para que movemask deje los bits en orden de byte.
+ */
+__attribute__((target("avx2")))
+static bool empaquetarBitsAVX2(const char* bits, size_t numBits, uint8_t* salida) {
+    const __m256i cero = _mm256_set1_epi8('0');
+    const __m256i altos = _mm256_set1_epi8(static_cast<char>(0xFE));
+    const __m256i reverso = _mm256_setr_epi8(
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+        7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    __m256i malos = _mm256_setzero_si256();
+
+    size_t numBytes = numBits / 8;
+    size_t i = 0;
+    for (; i + 4 <= numBytes; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + i * 8));
+        __m256i d = _mm256_sub_epi8(v, cero);
+        malos = _mm256_or_si256(malos, _mm256_and_si256(d, altos));
+
+        uint32_t m = static_cast<uint32_t>(
+            _mm256_movemask_epi8(_mm256_slli_epi16(_mm256_shuffle_epi8(d, reverso), 7)));
+        memcpy(salida + i, &m, 4);
+    }
+
+    if (!_mm256_testz_si256(malos, malos))
+        return false;
+    return empaquetarBitsEscalar(bits + i * 8, (numBytes - i) * 8, salida + i);
+}
+
+#endif // CONVERSION_X86
+
+// ================================================================
+// === Despacho en tiempo de ejecución ============================
+// ================================================================
+
+/**
+ * @brief Detecta una sola vez el mejor núcleo disponible en esta CPU.
+ */
+static NucleoConversion nucleoDisponible() {
+    static const NucleoConversion nucleo = [] {
+#ifdef CONVERSION_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return NUCLEO_AVX2;
+        if (__builtin_cpu_supports("sse2")) return NUCLEO_SSE2;
+#endif
+        return NUCLEO_ESCALAR;
+    }();
+    return nucleo;
+}
+
+bool nucleoConversionSoportado(NucleoConversion nucleo) {
+    return nucleo <= nucleoDisponible();
+}
+
+void expandirBitsCon(NucleoConversion nucleo, const uint8_t* bytes, size_t numBytes, char* salida) {
+    switch (nucleo) {
+#ifdef CONVERSION_X86
+    case NUCLEO_AVX2: expandirBitsAVX2(bytes, numBytes, salida); return;
+    case NUCLEO_SSE2: expandirBitsSSE2(bytes, numBytes, salida); return;
+#endif
+    default:          expandirBitsEscalar(bytes, numBytes, salida); return;
+    }
+}
+
+bool empaquetarBitsCon(NucleoConversion nucleo, const char* bits, size_t numBits, uint8_t* salida) {
+    switch (nucleo) {
+#ifdef CONVERSION_X86
+    case NUCLEO_AVX2: return empaquetarBitsAVX2(bits, numBits, salida);
+    case NUCLEO_SSE2: return empaquetarBitsSSE2(bits, numBits, salida);
+#endif
+    default:          return empaquetarBitsEscalar(bits, numBits, salida);
+    }
+}
+
+/**
+ * @brief Expande bytes a '0'/'1' con el núcleo más rápido disponible.
+ */
+void expandirBits(const uint8_t* bytes, size_t numBytes, char* salida) {
+    expandirBitsCon(nucleoDisponible(), bytes, numBytes, salida);
+}
+
+/**
+ * @brief Empaqueta '0'/'1' en bytes con el núcleo más rápido disponible.
+ */
+bool empaquetarBits(const char* bits, size_t numBits, uint8_t* salida) {
+    return empaquetarBitsCon(nucleoDisponible(), bits, numBits, salida);
+}
+
+/**
+ * @brief Nombre del núcleo activo, útil para diagnósticos y benchmarks.
+ */
+const char* nucleoConversionActivo() {
+    return nombreNucleoConversion(nucleoDisponible());
+}
+
+const char* nombreNucleoConversion(NucleoConversion nucleo) {
+    switch (nucleo) {
+    case NUCLEO_AVX2: return "avx2";
+    case NUCLEO_SSE2: return "sse2";
+    default:          return "escalar";
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef CONVERSION_SIMD_H
+#define CONVERSION_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+// ================================================================
+// === Conversión bytes <-> caracteres '0'/'1' ====================
+// ================================================================
+//
+// Núcleos de textoAbinario() / binarioAtexto(). En x86 se elige en
+// tiempo de ejecución entre AVX2, SSE2 y la versión escalar según lo que
+// soporte la CPU; en otras arquitecturas se usa siempre la escalar.
+
+/**
+ * Expande `numBytes` bytes a caracteres '0'/'1' (8 por byte, bit más
+ * significativo primero) en `salida`. No añade terminador.
+ */
+void expandirBits(const uint8_t* bytes, size_t numBytes, char* salida);
+
+/**
+ * Empaqueta `numBits` caracteres '0'/'1' en bytes (se procesan
+ * numBits / 8 bytes completos). Retorna false si encuentra un carácter
+ * distinto de '0' o '1'.
+ */
+bool empaquetarBits(const char* bits, size_t numBits, uint8_t* salida);
+
+/**
+ * Versiones escalares de referencia (siempre disponibles).
+ */
+void expandirBitsEscalar(const uint8_t* bytes, size_t numBytes, char* salida);
+bool empaquetarBitsEscalar(const char* bits, size_t numBits, uint8_t* salida);
+
+/**
+ * Nombre del núcleo elegido para esta CPU: "avx2", "sse2" o "escalar".
+ */
+const char* nucleoConversionActivo();
+
+/**
+ * Núcleos de conversión, del más lento al más rápido.
+ */
+enum NucleoConversion { NUCLEO_ESCALAR, NUCLEO_SSE2, NUCLEO_AVX2 };
+
+/**
+ * Indica si `nucleo` puede ejecutarse en esta CPU.
+ */
+bool nucleoConversionSoportado(NucleoConversion nucleo);
+
+/**
+ * expandirBits() / empaquetarBits() con un núcleo concreto, para
+ * comparar núcleos entre sí. `nucleo` debe estar soportado.
+ */
+void expandirBitsCon(NucleoConversion nucleo, const uint8_t* bytes, size_t numBytes, char* salida);
+bool empaquetarBitsCon(NucleoConversion nucleo, const char* bits, size_t numBits, uint8_t* salida);
+
+/**
+ * Nombre de un núcleo: "avx2", "sse2" o "escalar".
+ */
+const char* nombreNucleoConversion(NucleoConversion nucleo);
+
+#endif // CONVERSION_SIMD_H
@@ -0,0 +1,116 @@
+#include <iostream>
+#include <cctype>
+#include <cstring>
+#include "Cuenta.h"
+using namespace std;
+
+/**
+ * @brief Quita espacios en blanco al inicio y al final.
+ */
+static string_view recortar(string_view texto) {
+    size_t inicio = 0, fin = texto.size();
+    while (inicio < fin && isspace(static_cast<unsigned char>(texto[inicio]))) inicio++;
+    while (fin > inicio && isspace(static_cast<unsigned char>(texto[fin - 1]))) fin--;
+    return texto.substr(inicio, fin - inicio);
+}
+
+/**
+ * @brief Copia `texto` a un campo de capacidad fija.
+ * @return false si no cabe junto con el '\0'.
+ */
+static bool copiarCampo(char* destino, size_t capacidad, string_view texto) {
+    if (texto.size() >= capacidad) return false;
+    memcpy(destino, texto.data(), texto.size());
+    destino[texto.size()] = '\0';
+    return true;
+}
+
+bool crearCuenta(string_view cedula, string_view clave, string_view nombre, int64_t saldo, Cuenta& cuenta) {
+    Cuenta nueva;
+    nueva.cedula = empaquetarCedula(cedula);
+    nueva.saldo = saldo;
+    if (nueva.cedula == 0) return false;
+    if (clave.find(',') != string_view::npos) return false;
+    if (!copiarCampo(nueva.clave, TAM_CLAVE_CUENTA, recortar(clave))) return false;
+    if (!copiarCampo(nueva.nombre, TAM_NOMBRE_CUENTA, nombre)) return false;
+
+    cuenta = nueva;
+    return true;
+}
+
+bool parsearCuenta(string_view linea, Cuenta& cuenta) {
+    size_t p1 = linea.find(',');
+    if (p1 == string_view::npos) return false;
+    size_t p2 = linea.find(',', p1 + 1);
+    if (p2 == string_view::npos) return false;
+    // El saldo va después de la última coma; si el nombre trae comas
+    // quedan dentro del nombre y la línea se reescribe igual
+    size_t p3 = linea.rfind(',');
+    if (p3 == p2) return false;
+
+    // Saldo: entero al inicio del último campo ("25000 COP")
+    string_view saldoStr = recortar(linea.substr(p3 + 1));
+    size_t k = 0;
+    bool negativo = false;
+    if (k < saldoStr.size() && saldoStr[k] == '-') {
+        negativo = true;
+        k++;
+    }
+    if (k >= saldoStr.size() || saldoStr[k] < '0' || saldoStr[k] > '9') return false;
+
+    int64_t saldo = 0;
+    for (; k < saldoStr.size() && saldoStr[k] >= '0' && saldoStr[k] <= '9'; k++) {
+        if (saldo > (INT64_MAX - 9) / 10) return false;
+        saldo = saldo * 10 + (saldoStr[k] - '0');
+    }
+
+    return crearCuenta(linea.substr(0, p1),
+                       linea.substr(p1 + 1, p2 - p1 - 1),
+                       linea.substr(p2 + 1, p3 - p2 - 1),
+                       negativo ? -saldo : saldo, cuenta);
+}
+
+string serializarCuenta(const Cuenta& cuenta) {
+    string linea = desempaquetarCedula(cuenta.cedula);
+    linea += ',';
+    linea += cuenta.clave;
+    linea += ',';
+    linea += cuenta.nombre;
+    linea += ',';
+    linea += to_string(cuenta.saldo);
+    linea += " COP";
+    return linea;
+}
+
+bool cargarCuentas(const string* lineas, int numLineas, vector<Cuenta>& cuentas) {
+    cuentas.clear();
+    if (!lineas || numLineas <= 0) return false;
+
+    cuentas.reserve(numLineas);
+    cuentas.resize(numLineas);
+    for (int i = 0; i < numLineas; i++) {
+        if (!parsearCuenta(lineas[i], cuentas[i])) {
+            cerr << "Registro de usuario invalido en la linea " << (i + 1) << ".\n";
+            cuentas.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+string* serializarCuentas(const Cuenta* cuentas, int numCuentas) {
+    string* lineas = new string[numCuentas > 0 ? numCuentas : 1];
+    for (int i = 0; i < numCuentas; i++)
+        lineas[i] = serializarCuenta(cuentas[i]);
+    return lineas;
+}
+
+int indexarCuentas(IndiceCedulas& indice, const Cuenta* cuentas, int numCuentas) {
+    indice = IndiceCedulas();
+    indice.reservar(numCuentas > 0 ? numCuentas : 1);
+
+    int sinIndice = 0;
+    for (int i = 0; i < numCuentas; i++)
+        if (!indice.insertar(cuentas[i].cedula, i)) sinIndice++;   // queda la primera
+    return sinIndice;
+}
@@ -0,0 +1,89 @@
+#ifndef CUENTA_H
+#define CUENTA_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "IndiceCedulas.h"
+using namespace std;
+
+/// Capacidad del campo clave, incluido el '\0'.
+const size_t TAM_CLAVE_CUENTA = 32;
+
+/// Capacidad del campo nombre, incluido el '\0'.
+const size_t TAM_NOMBRE_CUENTA = 100;
+
+/**
+ * @brief Cuenta de usuario ya interpretada.
+ *
+ * Se arma una sola vez al cargar a partir de la línea
+ * "cedula,clave,nombre,saldo COP" y las operaciones trabajan sobre los
+ * campos; la línea solo se vuelve a escribir al guardar. Quien cambie
+ * un campo marca `modificada` para que al guardar se cifre de nuevo.
+ */
+struct Cuenta {
+    uint64_t cedula = 0;                /**< Cédula empaquetada (ver empaquetarCedula()) */
+    char clave[TAM_CLAVE_CUENTA] = {};  /**< Clave terminada en '\0' */
+    char nombre[TAM_NOMBRE_CUENTA] = {};/**< Nombre terminado en '\0' */
+    int64_t saldo = 0;                  /**< Saldo en COP */
+    bool modificada = false;            /**< Cambió desde que se leyó o se guardó */
+};
+
+/**
+ * @brief Motivo de un cambio de cuenta (se registra en la bitácora).
+ */
+enum class MotivoCambio : uint8_t {
+    Consulta = 1,   ///< Cobro de la consulta de saldo
+    Retiro   = 2,   ///< Retiro más su comisión
+    Alta     = 3    ///< Cuenta nueva registrada por un administrador
+};
+
+/**
+ * @brief Arma una cuenta a partir de sus campos.
+ * @return false si la cédula es inválida, la clave tiene comas o la clave
+ *         o el nombre no caben.
+ */
+bool crearCuenta(string_view cedula, string_view clave, string_view nombre, int64_t saldo, Cuenta& cuenta);
+
+/**
+ * @brief Interpreta una línea "cedula,clave,nombre,saldo COP".
+ *
+ * La cédula y la clave son los dos primeros campos y el saldo el último;
+ * lo que queda entre ellos es el nombre, aunque contenga comas.
+ *
+ * @return false si la línea no tiene ese formato.
+ */
+bool parsearCuenta(string_view linea, Cuenta& cuenta);
+
+/**
+ * @brief Línea "cedula,clave,nombre,saldo COP" de una cuenta.
+ */
+string serializarCuenta(const Cuenta& cuenta);
+
+/**
+ * @brief Interpreta todas las líneas de usuarios.
+ *
+ * La capacidad se reserva de una vez para los registros leídos; las
+ * cuentas que se registren después se agregan con push_back().
+ *
+ * @param lineas Registros en texto plano.
+ * @param numLineas Cantidad de registros.
+ * @param cuentas Destino (se reemplaza su contenido).
+ * @return false si no hay registros o alguna línea es inválida.
+ */
+bool cargarCuentas(const string* lineas, int numLineas, vector<Cuenta>& cuentas);
+
+/**
+ * @brief Vuelve a escribir las cuentas en el formato de línea original.
+ * @return Arreglo dinámico de líneas (el llamador lo libera).
+ */
+string* serializarCuentas(const Cuenta* cuentas, int numCuentas);
+
+/**
+ * @brief Reconstruye un índice de cédulas a partir de las cuentas.
+ * @return Cantidad de cuentas que no se indexaron (cédula repetida).
+ */
+int indexarCuentas(IndiceCedulas& indice, const Cuenta* cuentas, int numCuentas);
+
+#endif // CUENTA_H
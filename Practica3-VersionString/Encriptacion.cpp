@@ -1,7 +1,13 @@
 #include "Encriptacion.h"
+#include "CifradoEmpaquetado.h"
+#include "ConversionSIMD.h"
+#include "EncriptacionFija.h"
 #include <iostream>
 #include <string>
 #include <cctype>
+#include <utility>
+#include <vector>
+#include <algorithm>
 using namespace std;
 
 // ================================================================
@@ -11,6 +17,9 @@ using namespace std;
 /**
  * @brief Convierte una cadena binaria en texto ASCII.
  *
+ * Usa empaquetarBits(), que valida y empaqueta varios caracteres por
+ * instrucción cuando la CPU lo permite.
+ *
  * @param binario Cadena de bits ('0' y '1') a convertir.
  * @return string Texto ASCII resultante.
  *
@@ -24,19 +33,9 @@ string binarioAtexto(const string& binario) {
         if (binario.size() % 8 != 0)
             throw "Error: longitud binaria no es múltiplo de 8.";
 
-        string texto;
-        texto.reserve(binario.size() / 8);
-
-        for (size_t i = 0; i < binario.size(); i += 8) {
-            unsigned char c = 0;
-            for (int j = 0; j < 8; j++) {
-                char bit = binario[i + j];
-                if (bit != '0' && bit != '1')
-                    throw "Error: caracter inválido en cadena binaria.";
-                c = (c << 1) | static_cast<unsigned char>(bit - '0');
-            }
-            texto.push_back(static_cast<char>(c));
-        }
+        string texto(binario.size() / 8, '\0');
+        if (!empaquetarBits(binario.data(), binario.size(), reinterpret_cast<uint8_t*>(&texto[0])))
+            throw "Error: caracter inválido en cadena binaria.";
 
         return texto;
     } catch (const char* msg) {
@@ -48,6 +47,9 @@ string binarioAtexto(const string& binario) {
 /**
  * @brief Convierte un texto ASCII a su representación binaria.
  *
+ * Usa expandirBits(), que genera varios caracteres por instrucción
+ * cuando la CPU lo permite.
+ *
  * @param texto Texto plano a convertir.
  * @return string Cadena binaria resultante.
  *
@@ -58,15 +60,8 @@ string textoAbinario(const string& texto) {
         if (texto.empty())
             throw "Error: texto vacío al convertir a binario.";
 
-        string resultado;
-        resultado.reserve(texto.size() * 8);
-
-        for (unsigned char c : texto) {
-            for (int j = 7; j >= 0; j--) {
-                resultado.push_back(((c >> j) & 1) ? '1' : '0');
-            }
-        }
-
+        string resultado(texto.size() * 8, '0');
+        expandirBits(reinterpret_cast<const uint8_t*>(texto.data()), texto.size(), &resultado[0]);
         return resultado;
     } catch (const char* msg) {
         cerr << "[Error] " << msg << endl;
@@ -135,7 +130,7 @@ string invertirCadaNBits(const string& binario, int n) {
 // ================================================================
 
 /**
- * @brief Encripta una cadena binaria usando una semilla de bloques.
+ * @brief Ruta genérica de encriptarBits(): válida para cualquier semilla.
  *
  * @param binario Cadena binaria de entrada.
  * @param semilla Tamaño de bloque para aplicar inversión condicional.
@@ -143,7 +138,7 @@ string invertirCadaNBits(const string& binario, int n) {
  *
  * @throw const char* Si la semilla es inválida o la cadena está vacía.
  */
-string encriptarBits(const string& binario, int semilla) {
+static string encriptarBitsGenerico(const string& binario, int semilla) {
     try {
         if (semilla <= 0)
             throw "Error: semilla inválida (debe ser > 0).";
@@ -190,15 +185,94 @@ string encriptarBits(const string& binario, int semilla) {
     }
 }
 
+typedef bool (*EncriptadorFijo)(const string&, string&);
+
+/**
+ * @brief Construye la tabla de despacho semilla -> encriptarBitsFijo<S>.
+ */
+template <size_t... I>
+static const EncriptadorFijo* crearDespacho(index_sequence<I...>) {
+    static const EncriptadorFijo tabla[] = { &encriptarBitsFijo<static_cast<int>(I) + 1>... };
+    return tabla;
+}
+
 /**
- * @brief Desencripta una cadena binaria. Es simétrico a encriptarBits().
+ * @brief Encripta una cadena binaria usando una semilla de bloques.
+ *
+ * Para semillas entre 1 y SEMILLA_FIJA_MAX usa la versión especializada
+ * por semilla; para el resto (o si la cadena trae caracteres
+ * inválidos) usa la ruta genérica.
+ *
+ * @param binario Cadena binaria de entrada.
+ * @param semilla Tamaño de bloque para aplicar inversión condicional.
+ * @return string Cadena encriptada.
+ */
+string encriptarBits(const string& binario, int semilla) {
+    static const EncriptadorFijo* despacho = crearDespacho(make_index_sequence<SEMILLA_FIJA_MAX>{});
+
+    if (semilla >= 1 && semilla <= SEMILLA_FIJA_MAX && !binario.empty()) {
+        string codificado;
+        if (despacho[semilla - 1](binario, codificado))
+            return codificado;
+    }
+    return encriptarBitsGenerico(binario, semilla);
+}
+
+/**
+ * @brief Desencripta una cadena binaria.
+ *
+ * encriptarBits() elige la regla de cada bloque según el bloque *cifrado*
+ * anterior, que aquí es la propia entrada: todas las reglas se conocen de
+ * antemano y cada bloque se descifra sin depender de los demás.
  *
  * @param binario Cadena encriptada.
  * @param semilla Semilla usada durante la encriptación.
  * @return string Cadena binaria original.
+ *
+ * @throw const char* Si la semilla es inválida o la cadena está vacía.
  */
 string desencriptarBits(const string& binario, int semilla) {
-    return encriptarBits(binario, semilla);
+    try {
+        if (semilla <= 0)
+            throw "Error: semilla inválida (debe ser > 0).";
+        if (binario.empty())
+            throw "Error: cadena binaria vacía en desencriptarBits.";
+
+        string decodificado;
+        decodificado.reserve(binario.size());
+
+        for (size_t i = 0; i < binario.size(); i += semilla) {
+            int len = (i + semilla <= binario.size())
+            ? semilla
+            : static_cast<int>(binario.size() - i);
+
+            ReglaBloque regla = INVERTIR_TODO;
+            if (i > 0) {
+                int unos = 0;
+                for (size_t j = i - semilla; j < i; j++)
+                    if (binario[j] == '1') unos++;
+                regla = reglaSegunBloque(unos, semilla);
+            }
+
+            string bloque = binario.substr(i, len);
+            string procesado;
+            if (regla == INVERTIR_TODO)
+                procesado = invertirBits(bloque);
+            else if (regla == INVERTIR_CADA_2)
+                procesado = invertirCadaNBits(bloque, 2);
+            else
+                procesado = invertirCadaNBits(bloque, 3);
+
+            if (procesado.empty())
+                throw "Error: caracter inválido en desencriptarBits.";
+            decodificado += procesado;
+        }
+
+        return decodificado;
+    } catch (const char* msg) {
+        cerr << "[Error] " << msg << endl;
+        return "";
+    }
 }
 
 // ================================================================
@@ -208,6 +282,10 @@ string desencriptarBits(const string& binario, int semilla) {
 /**
  * @brief Encripta una cadena de texto plano.
  *
+ * Usa el motor empaquetado: cifra directamente los bytes del texto y solo
+ * al final los expande a '0'/'1', con el mismo resultado que
+ * encriptarBits(textoAbinario(textoPlano), semilla).
+ *
  * @param textoPlano Texto original a encriptar.
  * @param semilla Semilla de encriptación.
  * @return string Texto encriptado en binario.
@@ -217,8 +295,7 @@ string encriptarCadena(const string& textoPlano, int semilla) {
         if (textoPlano.empty())
             throw "Error: texto vacío en encriptarCadena.";
 
-        string binario = textoAbinario(textoPlano);
-        return encriptarBits(binario, semilla);
+        return encriptarTextoEmpaquetado(textoPlano, semilla);
     } catch (const char* msg) {
         cerr << "[Error] " << msg << endl;
         return "";
@@ -228,19 +305,21 @@ string encriptarCadena(const string& textoPlano, int semilla) {
 /**
  * @brief Desencripta una cadena binaria a texto ASCII legible.
  *
+ * Empaqueta la cadena cifrada en bytes y la procesa con el motor
+ * empaquetado, sin pasar por la cadena binaria intermedia.
+ *
  * @param textoEncriptado Cadena en binario encriptado.
  * @param semilla Semilla de desencriptación.
  * @return string Texto plano desencriptado.
  *
  * @throw const char* Si el texto está vacío o los caracteres resultantes son ilegibles.
  */
-string desencriptarCadena(const string& textoEncriptado, int semilla) {
+string desencriptarCadena(string_view textoEncriptado, int semilla) {
     try {
         if (textoEncriptado.empty())
             throw "Error: texto encriptado vacío.";
 
-        string binario = desencriptarBits(textoEncriptado, semilla);
-        string texto = binarioAtexto(binario);
+        string texto = desencriptarTextoEmpaquetado(textoEncriptado, semilla);
 
         int ilegibles = 0;
         for (unsigned char c : texto) {
@@ -262,9 +341,121 @@ string desencriptarCadena(const string& textoEncriptado, int semilla) {
 // === Implementaciones que el .h espera: sobre arreglos ==========
 // ================================================================
 
+/// Mínimo de líneas en un lote para cifrarlo con encriptarLoteBinario();
+/// con menos, el lote se cifra línea por línea.
+static const int MIN_LINEAS_LOTE = 16;
+
+/**
+ * @brief Indica si la línea ya está en binario ('0'/'1').
+ */
+static bool esLineaBinaria(string_view linea) {
+    for (char c : linea)
+        if (c != '0' && c != '1') return false;
+    return true;
+}
+
+/**
+ * @brief Encripta la línea `i` si aún no está en binario.
+ *
+ * Las líneas no comparten estado, así que puede llamarse desde varios
+ * hilos a la vez siempre que cada uno trabaje sobre índices distintos.
+ */
+static void encriptarLinea(string* datos, int i, int semilla) {
+    if (datos[i].empty()) return;
+
+    if (!esLineaBinaria(datos[i])) {
+        try {
+            datos[i] = encriptarCadena(datos[i], semilla);
+        } catch (const char* msg) {
+            cerr << "Error en línea " << i << ": " << msg << endl;
+        }
+    }
+}
+
+/**
+ * @brief Índices de las líneas que faltan por encriptar.
+ *
+ * Si la semilla admite lotes (ver SEMILLA_MAX_LOTE) se ordenan por
+ * longitud para que cada lote agrupe líneas parecidas.
+ */
+static vector<int> lineasPorEncriptar(const string* datos, int numLineas, int semilla) {
+    vector<int> pendientes;
+    pendientes.reserve(numLineas);
+    for (int i = 0; i < numLineas; ++i)
+        if (!datos[i].empty() && !esLineaBinaria(datos[i]))
+            pendientes.push_back(i);
+
+    if (semilla > SEMILLA_MAX_LOTE)
+        return pendientes;
+
+    stable_sort(pendientes.begin(), pendientes.end(),
+                [datos](int a, int b) { return datos[a].size() < datos[b].size(); });
+    return pendientes;
+}
+
+/**
+ * @brief Encripta el lote número `lote` de `pendientes` (hasta CARRILES_LOTE líneas).
+ *
+ * @throw const char* Si la semilla es inválida.
+ */
+static void encriptarLoteLineas(string* datos, const vector<int>& pendientes, int lote, int semilla) {
+    int inicio = lote * CARRILES_LOTE;
+    int cantidad = min(CARRILES_LOTE, static_cast<int>(pendientes.size()) - inicio);
+    const int* indices = &pendientes[inicio];
+
+    if (cantidad < MIN_LINEAS_LOTE || semilla <= 0 || semilla > SEMILLA_MAX_LOTE) {
+        for (int c = 0; c < cantidad; ++c)
+            encriptarLinea(datos, indices[c], semilla);
+        return;
+    }
+
+    const uint8_t* entradas[CARRILES_LOTE];
+    size_t numBytes[CARRILES_LOTE];
+    string cifradas[CARRILES_LOTE];
+    char* salidas[CARRILES_LOTE];
+    for (int c = 0; c < cantidad; ++c) {
+        const string& linea = datos[indices[c]];
+        entradas[c] = reinterpret_cast<const uint8_t*>(linea.data());
+        numBytes[c] = linea.size();
+        cifradas[c].resize(linea.size() * 8);
+        salidas[c] = &cifradas[c][0];
+    }
+
+    encriptarLoteBinario(entradas, numBytes, cantidad, semilla, salidas);
+
+    for (int c = 0; c < cantidad; ++c)
+        datos[indices[c]] = move(cifradas[c]);
+}
+
+/**
+ * @brief Cantidad de lotes en que se reparten las líneas pendientes.
+ */
+static int numLotes(const vector<int>& pendientes) {
+    return static_cast<int>((pendientes.size() + CARRILES_LOTE - 1) / CARRILES_LOTE);
+}
+
+/**
+ * @brief Desencripta la línea `i` si está en binario válido.
+ */
+static void desencriptarLinea(string* datos, int i, int semilla) {
+    if (datos[i].empty()) return;
+
+    if (esLineaBinaria(datos[i]) && (datos[i].size() % 8 == 0)) {
+        try {
+            datos[i] = desencriptarCadena(datos[i], semilla);
+        } catch (const char* msg) {
+            cerr << "Error en línea " << i << ": " << msg << endl;
+        }
+    }
+}
+
 /**
  * @brief Encripta cada línea de un arreglo de texto.
  *
+ * Con semillas chicas las líneas pendientes se ordenan por longitud y se
+ * cifran de a CARRILES_LOTE con encriptarLoteBinario(); el resultado es
+ * el mismo que cifrar cada línea con encriptarCadena().
+ *
  * @param datos Arreglo de cadenas.
  * @param numLineas Número de líneas a procesar.
  * @param semilla Semilla de encriptación.
@@ -278,21 +469,9 @@ void encriptarArchivo(string* datos, int numLineas, int semilla) {
         if (numLineas <= 0)
             throw "Error: número de líneas inválido.";
 
-        for (int i = 0; i < numLineas; ++i) {
-            if (datos[i].empty()) continue;
-
-            bool esBin = true;
-            for (char c : datos[i])
-                if (c != '0' && c != '1') { esBin = false; break; }
-
-            if (!esBin) {
-                try {
-                    datos[i] = encriptarCadena(datos[i], semilla);
-                } catch (const char* msg) {
-                    cerr << "Error en línea " << i << ": " << msg << endl;
-                }
-            }
-        }
+        vector<int> pendientes = lineasPorEncriptar(datos, numLineas, semilla);
+        for (int lote = 0; lote < numLotes(pendientes); ++lote)
+            encriptarLoteLineas(datos, pendientes, lote, semilla);
     } catch (const char* msg) {
         cerr << "[Error] " << msg << endl;
     }
@@ -314,26 +493,110 @@ void desencriptarArchivo(string* datos, int numLineas, int semilla) {
         if (numLineas <= 0)
             throw "Error: número de líneas inválido.";
 
-        for (int i = 0; i < numLineas; ++i) {
-            if (datos[i].empty()) continue;
+        for (int i = 0; i < numLineas; ++i)
+            desencriptarLinea(datos, i, semilla);
+    } catch (const char* msg) {
+        cerr << "[Error] " << msg << endl;
+    }
+}
 
-            bool esBin = true;
-            for (char c : datos[i])
-                if (c != '0' && c != '1') { esBin = false; break; }
+/**
+ * @brief Encripta las líneas repartiéndolas entre los hilos del pool.
+ *
+ * Cada hilo toma lotes completos (ver encriptarArchivo()) y solo escribe
+ * en sus líneas, por lo que el resultado es idéntico al de la versión
+ * secuencial.
+ *
+ * @param datos Arreglo de cadenas.
+ * @param numLineas Número de líneas a procesar.
+ * @param semilla Semilla de encriptación.
+ * @param pool Pool de hilos a usar.
+ */
+void encriptarArchivo(string* datos, int numLineas, int semilla, PoolHilos& pool) {
+    try {
+        if (!datos)
+            throw "Error: puntero nulo en encriptarArchivo.";
+        if (numLineas <= 0)
+            throw "Error: número de líneas inválido.";
 
-            if (esBin && (datos[i].size() % 8 == 0)) {
-                try {
-                    datos[i] = desencriptarCadena(datos[i], semilla);
-                } catch (const char* msg) {
-                    cerr << "Error en línea " << i << ": " << msg << endl;
-                }
-            }
-        }
+        vector<int> pendientes = lineasPorEncriptar(datos, numLineas, semilla);
+        pool.paraCadaTrozo(numLotes(pendientes), 1,
+                           [&](int inicio, int fin, int) {
+                               for (int lote = inicio; lote < fin; ++lote)
+                                   encriptarLoteLineas(datos, pendientes, lote, semilla);
+                           });
+    } catch (const char* msg) {
+        cerr << "[Error] " << msg << endl;
+    }
+}
+
+/**
+ * @brief Desencripta las líneas repartiéndolas entre los hilos del pool.
+ *
+ * @param datos Arreglo de cadenas (binario).
+ * @param numLineas Número de líneas.
+ * @param semilla Semilla usada en la encriptación.
+ * @param pool Pool de hilos a usar.
+ */
+void desencriptarArchivo(string* datos, int numLineas, int semilla, PoolHilos& pool) {
+    try {
+        if (!datos)
+            throw "Error: puntero nulo en desencriptarArchivo.";
+        if (numLineas <= 0)
+            throw "Error: número de líneas inválido.";
+
+        pool.paraCadaTrozo(numLineas, PoolHilos::trozoSugerido(numLineas, pool.numHilos()),
+                           [=](int inicio, int fin, int) {
+                               for (int i = inicio; i < fin; ++i)
+                                   desencriptarLinea(datos, i, semilla);
+                           });
     } catch (const char* msg) {
         cerr << "[Error] " << msg << endl;
     }
 }
 
+/**
+ * @brief Desencripta una vista si está en binario válido; si no, la copia.
+ */
+static string desencriptarVista(string_view vista, int semilla) {
+    if (!vista.empty() && esLineaBinaria(vista) && vista.size() % 8 == 0)
+        return desencriptarCadena(vista, semilla);
+    return string(vista);
+}
+
+/**
+ * @brief Desencripta líneas vistas sin copia hacia un arreglo nuevo.
+ *
+ * El binario se lee directamente de las vistas, así que solo se reserva
+ * el texto plano (la octava parte). Cada hilo escribe solo en las
+ * posiciones de su trozo.
+ *
+ * @param vistas Líneas cifradas.
+ * @param numLineas Número de líneas.
+ * @param semilla Semilla usada en la encriptación.
+ * @param pool Pool de hilos a usar.
+ * @return string* Arreglo de texto plano, o nullptr si los parámetros son inválidos.
+ */
+string* desencriptarVistas(const string_view* vistas, int numLineas, int semilla, PoolHilos& pool) {
+    try {
+        if (!vistas)
+            throw "Error: puntero nulo en desencriptarVistas.";
+        if (numLineas <= 0)
+            throw "Error: número de líneas inválido.";
+
+        string* datos = new string[numLineas];
+        pool.paraCadaTrozo(numLineas, PoolHilos::trozoSugerido(numLineas, pool.numHilos()),
+                           [=](int inicio, int fin, int) {
+                               for (int i = inicio; i < fin; ++i)
+                                   datos[i] = desencriptarVista(vistas[i], semilla);
+                           });
+        return datos;
+    } catch (const char* msg) {
+        cerr << "[Error] " << msg << endl;
+        return nullptr;
+    }
+}
+
 /**
  * @brief Verifica si los arreglos de usuarios y admins están encriptados.
  *
@@ -345,19 +608,27 @@ void desencriptarArchivo(string* datos, int numLineas, int semilla) {
  * @throw const char* Si hay inconsistencia entre los dos o punteros nulos.
  */
 bool verificarEstadoEncriptacion(const string* usuarios, const string* admins) {
+    if (!usuarios || !admins) {
+        cerr << "[Error] Error: punteros nulos al verificar estado de encriptación." << endl;
+        return false;
+    }
+    return verificarEstadoEncriptacion(string_view(usuarios[0]), string_view(admins[0]));
+}
+
+/**
+ * @brief Verifica el estado de encriptación a partir de la primera línea
+ *        de cada archivo.
+ *
+ * @param primerUsuario Primera línea de usuarios.
+ * @param primerAdmin Primera línea de administradores.
+ * @return true Si ambas están en binario.
+ *
+ * @throw const char* Si una parece binaria y la otra no.
+ */
+bool verificarEstadoEncriptacion(string_view primerUsuario, string_view primerAdmin) {
     try {
-        if (!usuarios || !admins)
-            throw "Error: punteros nulos al verificar estado de encriptación.";
-
-        auto esBinario = [](const string& s) {
-            if (s.empty()) return false;
-            for (char c : s)
-                if (c != '0' && c != '1') return false;
-            return true;
-        };
-
-        bool usuariosEnc = esBinario(usuarios[0]);
-        bool adminsEnc   = esBinario(admins[0]);
+        bool usuariosEnc = !primerUsuario.empty() && esLineaBinaria(primerUsuario);
+        bool adminsEnc   = !primerAdmin.empty() && esLineaBinaria(primerAdmin);
 
         if (usuariosEnc && adminsEnc) return true;
         if (!usuariosEnc && !adminsEnc) return false;
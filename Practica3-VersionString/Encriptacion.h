@@ -2,6 +2,8 @@
 #define ENCRIPTACION_H
 
 #include <string>
+#include <string_view>
+#include "PoolHilos.h"
 using namespace std;
 
 // ================================================================
@@ -45,7 +47,7 @@ string encriptarBits(const string& binario, int semilla);
 
 /**
  * Desencripta una cadena binaria previamente encriptada.
- * (El algoritmo es simétrico, aplica la misma operación.)
+ * La regla de cada bloque se deduce del bloque cifrado anterior.
  */
 string desencriptarBits(const string& binario, int semilla);
 
@@ -61,8 +63,9 @@ string encriptarCadena(const string& textoPlano, int semilla);
 
 /**
  * Desencripta una cadena binaria encriptada, devolviendo el texto plano.
+ * Acepta también vistas sobre un archivo proyectado.
  */
-string desencriptarCadena(const string& textoEncriptado, int semilla);
+string desencriptarCadena(string_view textoEncriptado, int semilla);
 
 // ================================================================
 // === Funciones que operan sobre arreglos (archivos en memoria) ===
@@ -78,10 +81,34 @@ void encriptarArchivo(string* datos, int numLineas, int semilla);
  */
 void desencriptarArchivo(string* datos, int numLineas, int semilla);
 
+/**
+ * Igual que encriptarArchivo(), pero reparte las líneas entre los hilos
+ * del pool. El resultado es el mismo que en la versión secuencial.
+ */
+void encriptarArchivo(string* datos, int numLineas, int semilla, PoolHilos& pool);
+
+/**
+ * Igual que desencriptarArchivo(), pero en paralelo sobre el pool.
+ */
+void desencriptarArchivo(string* datos, int numLineas, int semilla, PoolHilos& pool);
+
 /**
  * Verifica si ambos arreglos (usuarios y administradores)
  * están o no encriptados. Retorna true si ambos lo están.
  */
 bool verificarEstadoEncriptacion(const string* usuarios, const string* admins);
 
+/**
+ * Igual que la anterior, a partir de la primera línea de cada archivo.
+ */
+bool verificarEstadoEncriptacion(string_view primerUsuario, string_view primerAdmin);
+
+/**
+ * Desencripta líneas vistas sin copia (por ejemplo, las de
+ * cargarLineasMapeadas()) hacia un arreglo nuevo de texto plano,
+ * repartiéndolas entre los hilos del pool. Las líneas que no están en
+ * binario se copian tal cual. Retorna el arreglo (liberar con delete[]).
+ */
+string* desencriptarVistas(const string_view* vistas, int numLineas, int semilla, PoolHilos& pool);
+
 #endif // ENCRIPTACION_H
@@ -0,0 +1,78 @@
+#ifndef ENCRIPTACION_FIJA_H
+#define ENCRIPTACION_FIJA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "CifradoEmpaquetado.h"
+using namespace std;
+
+// ================================================================
+// === encriptarBits especializado en tiempo de compilación =======
+// ================================================================
+//
+// Para semillas pequeñas (1-16) el bloque completo cabe en un entero de
+// S bits. Las tres reglas de encriptarBits() invierten el bloque entero
+// (invertirCadaNBits() invierte completo cada grupo de n bits y los grupos
+// lo cubren), así que la regla que impone el bloque anterior no cambia el
+// resultado: cada bloque sale como ~bloque & mascaraBloque(S), sin tablas
+// por regla ni conteo de unos y ceros.
+
+/// Semilla máxima con versión especializada.
+const int SEMILLA_FIJA_MAX = 16;
+
+/**
+ * Máscara con los `len` bits bajos en 1.
+ */
+constexpr uint32_t mascaraBloque(int len) {
+    return (1u << len) - 1u;
+}
+
+/**
+ * Encripta una cadena binaria con una semilla conocida en compilación.
+ *
+ * Produce exactamente lo mismo que encriptarBits(binario, S). Retorna
+ * false (sin tocar `salida`) si encuentra un carácter distinto de '0' o
+ * '1', para que el llamador use la ruta genérica y su manejo de errores.
+ */
+template <int S>
+bool encriptarBitsFijo(const string& binario, string& salida) {
+    static_assert(S >= 1 && S <= SEMILLA_FIJA_MAX, "Semilla fuera del rango especializado.");
+    const size_t n = binario.size();
+    const size_t completos = n - n % S;
+    string codificado(n, '0');
+
+    for (size_t i = 0; i < completos; i += S) {
+        uint32_t bloque = 0;
+        for (int j = 0; j < S; j++) {
+            char c = binario[i + j];
+            if (c != '0' && c != '1')
+                return false;
+            bloque = (bloque << 1) | static_cast<uint32_t>(c - '0');
+        }
+
+        uint32_t procesado = ~bloque & mascaraBloque(S);
+        for (int j = 0; j < S; j++)
+            codificado[i + j] = static_cast<char>('0' + ((procesado >> (S - 1 - j)) & 1u));
+    }
+
+    // Último bloque incompleto: máscara de su longitud real.
+    int resto = static_cast<int>(n - completos);
+    if (resto > 0) {
+        uint32_t bloque = 0;
+        for (int j = 0; j < resto; j++) {
+            char c = binario[completos + j];
+            if (c != '0' && c != '1')
+                return false;
+            bloque = (bloque << 1) | static_cast<uint32_t>(c - '0');
+        }
+        uint32_t procesado = ~bloque & mascaraBloque(resto);
+        for (int j = 0; j < resto; j++)
+            codificado[completos + j] = static_cast<char>('0' + ((procesado >> (resto - 1 - j)) & 1u));
+    }
+
+    salida.swap(codificado);
+    return true;
+}
+
+#endif // ENCRIPTACION_FIJA_H
@@ -0,0 +1,149 @@
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include "ArchivoMapeado.h"
+#include "ImportacionUsuarios.h"
+#include "Validaciones.h"
+
+using namespace std;
+
+/**
+ * @brief Quita espacios, tabulaciones y '\r' de los extremos.
+ */
+static string_view recortarCampo(string_view texto) {
+    size_t inicio = 0, fin = texto.size();
+    while (inicio < fin && (texto[inicio] == ' ' || texto[inicio] == '\t')) inicio++;
+    while (fin > inicio && (texto[fin - 1] == ' ' || texto[fin - 1] == '\t' || texto[fin - 1] == '\r')) fin--;
+    return texto.substr(inicio, fin - inicio);
+}
+
+/**
+ * @brief Indica si la fila es el encabezado del CSV.
+ */
+static bool esEncabezado(string_view fila) {
+    const char* palabra = "cedula";
+    if (fila.size() < 6) return false;
+    for (size_t k = 0; k < 6; k++)
+        if ((fila[k] | 0x20) != palabra[k]) return false;
+    return true;
+}
+
+/**
+ * @brief Valida una fila "cedula,clave,nombre,saldo" y arma la cuenta.
+ * @return nullptr si la fila es válida; si no, el motivo del rechazo.
+ */
+static const char* validarFila(string_view fila, Cuenta& cuenta) {
+    size_t p1 = fila.find(',');
+    size_t p2 = p1 == string_view::npos ? p1 : fila.find(',', p1 + 1);
+    // El saldo va después de la última coma: el nombre puede traer comas
+    size_t p3 = fila.rfind(',');
+    if (p2 == string_view::npos || p3 == p2)
+        return "La fila no tiene los campos cedula,clave,nombre,saldo.";
+
+    string cedula(recortarCampo(fila.substr(0, p1)));
+    string clave(recortarCampo(fila.substr(p1 + 1, p2 - p1 - 1)));
+    string_view nombre = recortarCampo(fila.substr(p2 + 1, p3 - p2 - 1));
+    string saldo(recortarCampo(fila.substr(p3 + 1)));
+
+    const char* error = errorCedula(cedula);
+    if (!error) error = errorContrasena(clave);
+    if (!error) error = errorSaldo(saldo);
+    if (error) return error;
+    if (nombre.empty())
+        return "El nombre está vacío.";
+
+    if (!crearCuenta(cedula, clave, nombre, stoll(saldo), cuenta))
+        return "El nombre es demasiado largo.";
+    cuenta.modificada = true;   // aún no tiene texto cifrado
+    return nullptr;
+}
+
+bool importarUsuarios(const string& rutaCsv, vector<Cuenta>& cuentas, IndiceCedulas& indice, PoolHilos& pool,
+                      ResultadoImportacion& resultado) {
+    resultado = ResultadoImportacion();
+
+    ArchivoMapeado archivo;
+    try {
+        archivo.abrir(rutaCsv);
+    }
+    catch (const char* e) {
+        cerr << "ERROR en importarUsuarios(): " << e << endl;
+        return false;
+    }
+
+    // Filas no vacías con su número de línea (se recorre una sola vez)
+    vector<string_view> filas;
+    vector<int> lineas;
+    const char* datos = archivo.datos();
+    const char* fin = datos + archivo.tamanio();
+    int numLinea = 0;
+    for (const char* p = datos; p < fin; ) {
+        const char* salto = static_cast<const char*>(memchr(p, '\n', fin - p));
+        const char* finFila = salto ? salto : fin;
+        numLinea++;
+        string_view fila(p, finFila - p);
+        if (!recortarCampo(fila).empty() && !(numLinea == 1 && esEncabezado(fila))) {
+            filas.push_back(fila);
+            lineas.push_back(numLinea);
+        }
+        p = finFila + 1;
+    }
+    const int n = static_cast<int>(filas.size());
+    resultado.filas = n;
+
+    // Validación en paralelo, escribiendo directamente en el lugar que
+    // ocuparía cada cuenta al final del vector
+    auto inicioValidacion = chrono::steady_clock::now();
+    const size_t base = cuentas.size();
+    cuentas.resize(base + n);
+    vector<const char*> motivos(n, nullptr);
+    if (n > 0) {
+        pool.paraCadaTrozo(n, PoolHilos::trozoSugerido(n, pool.numHilos()), [&](int inicio, int fin, int) {
+            for (int i = inicio; i < fin; i++)
+                motivos[i] = validarFila(filas[i], cuentas[base + i]);
+        });
+    }
+    auto finValidacion = chrono::steady_clock::now();
+
+    // Duplicados, en orden de línea: gana la primera aparición. Las
+    // aceptadas se compactan hacia adelante (nunca pisan una fila sin leer)
+    indice.reservar(static_cast<int>(base) + n);
+    size_t destino = base;
+    for (int i = 0; i < n; i++) {
+        if (!motivos[i]) {
+            int existente = indice.buscar(cuentas[base + i].cedula);
+            if (existente >= 0)
+                motivos[i] = static_cast<size_t>(existente) < base ? "La cédula ya está registrada."
+                                                                   : "La cédula se repite en el archivo.";
+        }
+        if (motivos[i]) {
+            resultado.rechazos.push_back({ lineas[i], motivos[i] });
+            continue;
+        }
+        if (destino != base + i)
+            cuentas[destino] = cuentas[base + i];
+        indice.insertar(cuentas[destino].cedula, static_cast<int>(destino));
+        destino++;
+    }
+    cuentas.resize(destino);
+    resultado.aceptadas = static_cast<int>(destino - base);
+    auto finDuplicados = chrono::steady_clock::now();
+
+    resultado.segundosValidacion = chrono::duration<double>(finValidacion - inicioValidacion).count();
+    resultado.segundosDuplicados = chrono::duration<double>(finDuplicados - finValidacion).count();
+    return true;
+}
+
+bool guardarReporteRechazos(const string& ruta, const ResultadoImportacion& resultado) {
+    ofstream archivo(ruta, ios::trunc);
+    if (!archivo.is_open()) {
+        cerr << "ERROR en guardarReporteRechazos(): No se pudo crear " << ruta << endl;
+        return false;
+    }
+    archivo << "linea,motivo\n";
+    for (const RechazoImportacion& rechazo : resultado.rechazos)
+        archivo << rechazo.linea << ',' << rechazo.motivo << '\n';
+    return static_cast<bool>(archivo);
+}
@@ -0,0 +1,62 @@
+#ifndef IMPORTACION_USUARIOS_H
+#define IMPORTACION_USUARIOS_H
+
+#include <string>
+#include <vector>
+#include "Cuenta.h"
+#include "IndiceCedulas.h"
+#include "PoolHilos.h"
+using namespace std;
+
+// ================================================================
+// === Importación masiva de usuarios =============================
+// ================================================================
+//
+// Un archivo CSV en texto plano con una fila "cedula,clave,nombre,saldo"
+// por usuario (una primera fila que empiece con "cedula" se toma como
+// encabezado). Las filas se validan en paralelo con las mismas reglas
+// del registro por menú; después, en orden, se descartan las cédulas que
+// ya existen o que se repiten dentro del archivo, buscándolas en el
+// índice de cédulas. Las cuentas aceptadas quedan al final del vector
+// marcadas como modificadas, así que el siguiente guardado las cifra
+// (en paralelo) y las escribe de una vez.
+
+/**
+ * @brief Una fila del CSV que no se importó.
+ */
+struct RechazoImportacion {
+    int linea = 0;                  ///< Número de línea en el CSV (desde 1)
+    const char* motivo = nullptr;   ///< Texto fijo con la causa
+};
+
+/**
+ * @brief Resumen de una importación.
+ */
+struct ResultadoImportacion {
+    int filas = 0;                          ///< Filas de datos leídas
+    int aceptadas = 0;                      ///< Cuentas agregadas
+    vector<RechazoImportacion> rechazos;    ///< En orden de línea
+    double segundosValidacion = 0;
+    double segundosDuplicados = 0;
+};
+
+/**
+ * @brief Valida un CSV de usuarios y agrega las cuentas aceptadas.
+ *
+ * @param rutaCsv Ruta del archivo CSV.
+ * @param cuentas Cuentas actuales; las aceptadas se agregan al final.
+ * @param indice Índice de cédulas de `cuentas` (se actualiza).
+ * @param pool Pool de hilos para validar.
+ * @param resultado Recibe el resumen.
+ * @return false si el archivo no se pudo leer (y entonces nada cambió).
+ */
+bool importarUsuarios(const string& rutaCsv, vector<Cuenta>& cuentas, IndiceCedulas& indice, PoolHilos& pool,
+                      ResultadoImportacion& resultado);
+
+/**
+ * @brief Escribe el reporte de rechazos ("linea,motivo" por fila).
+ * @return true si quedó escrito.
+ */
+bool guardarReporteRechazos(const string& ruta, const ResultadoImportacion& resultado);
+
+#endif // IMPORTACION_USUARIOS_H
@@ -0,0 +1,125 @@
+#include "IndiceCedulas.h"
+using namespace std;
+
+/// Longitudes que acepta errorCedula(); la cantidad de dígitos va en los 4 bits altos.
+static const size_t MIN_DIGITOS_CEDULA = 6;
+static const size_t MAX_DIGITOS_CEDULA = 10;
+
+/// Capacidad mínima de la tabla (potencia de dos).
+static const int BITS_CAPACIDAD_MINIMA = 4;
+
+/**
+ * @brief Quita espacios y tabuladores al inicio y al final.
+ */
+static string_view recortar(string_view texto) {
+    size_t inicio = 0, fin = texto.size();
+    while (inicio < fin && (texto[inicio] == ' ' || texto[inicio] == '\t')) inicio++;
+    while (fin > inicio && (texto[fin - 1] == ' ' || texto[fin - 1] == '\t' || texto[fin - 1] == '\r')) fin--;
+    return texto.substr(inicio, fin - inicio);
+}
+
+uint64_t empaquetarCedula(string_view cedula) {
+    cedula = recortar(cedula);
+    if (cedula.size() < MIN_DIGITOS_CEDULA || cedula.size() > MAX_DIGITOS_CEDULA) return 0;
+
+    uint64_t valor = 0;
+    for (char c : cedula) {
+        if (c < '0' || c > '9') return 0;
+        valor = valor * 10 + static_cast<uint64_t>(c - '0');
+    }
+    return (static_cast<uint64_t>(cedula.size()) << 60) | valor;
+}
+
+string desempaquetarCedula(uint64_t clave) {
+    size_t digitos = static_cast<size_t>(clave >> 60);
+    uint64_t valor = clave & ((uint64_t(1) << 60) - 1);
+    if (digitos < MIN_DIGITOS_CEDULA || digitos > MAX_DIGITOS_CEDULA) return "";
+
+    string texto(digitos, '0');
+    for (size_t i = digitos; i > 0 && valor > 0; i--) {
+        texto[i - 1] = static_cast<char>('0' + valor % 10);
+        valor /= 10;
+    }
+    return texto;
+}
+
+uint64_t cedulaDeLinea(string_view linea) {
+    size_t coma = linea.find(',');
+    if (coma == string_view::npos) return 0;
+    return empaquetarCedula(linea.substr(0, coma));
+}
+
+/**
+ * @brief Casilla donde empieza el sondeo (hash multiplicativo de Fibonacci).
+ */
+size_t IndiceCedulas::casillaInicial(uint64_t clave) const {
+    return static_cast<size_t>((clave * 0x9E3779B97F4A7C15ULL) >> (64 - bitsCapacidad));
+}
+
+void IndiceCedulas::redimensionar(int nuevaCapacidad) {
+    int bits = BITS_CAPACIDAD_MINIMA;
+    while ((size_t(1) << bits) < static_cast<size_t>(nuevaCapacidad)) bits++;
+
+    vector<uint64_t> viejasClaves;
+    vector<int> viejasPosiciones;
+    viejasClaves.swap(claves);
+    viejasPosiciones.swap(posiciones);
+
+    bitsCapacidad = bits;
+    claves.assign(size_t(1) << bits, 0);
+    posiciones.assign(size_t(1) << bits, -1);
+    usados = 0;
+
+    for (size_t i = 0; i < viejasClaves.size(); i++)
+        if (viejasClaves[i] != 0) insertar(viejasClaves[i], viejasPosiciones[i]);
+}
+
+void IndiceCedulas::reservar(int cantidad) {
+    if (static_cast<size_t>(cantidad) * 2 > claves.size())
+        redimensionar(cantidad * 2);
+}
+
+int IndiceCedulas::construir(const string* lineas, int numLineas) {
+    claves.clear();
+    posiciones.clear();
+    usados = 0;
+    reservar(numLineas > 0 ? numLineas : 1);
+
+    int sinIndice = 0;
+    for (int i = 0; i < numLineas; i++) {
+        uint64_t clave = cedulaDeLinea(lineas[i]);
+        if (clave == 0) {
+            sinIndice++;
+            continue;
+        }
+        insertar(clave, i);     // si se repite, queda la primera
+    }
+    return sinIndice;
+}
+
+int IndiceCedulas::buscar(uint64_t clave) const {
+    if (clave == 0 || claves.empty()) return -1;
+
+    size_t mascara = claves.size() - 1;
+    for (size_t i = casillaInicial(clave); ; i = (i + 1) & mascara) {
+        if (claves[i] == clave) return posiciones[i];
+        if (claves[i] == 0) return -1;
+    }
+}
+
+bool IndiceCedulas::insertar(uint64_t clave, int posicion) {
+    if (clave == 0) return false;
+    if (static_cast<size_t>(usados + 1) * 2 > claves.size())
+        redimensionar(static_cast<int>(claves.size() * 2));
+
+    size_t mascara = claves.size() - 1;
+    size_t i = casillaInicial(clave);
+    while (claves[i] != 0) {
+        if (claves[i] == clave) return false;
+        i = (i + 1) & mascara;
+    }
+    claves[i] = clave;
+    posiciones[i] = posicion;
+    usados++;
+    return true;
+}
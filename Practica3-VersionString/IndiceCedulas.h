@@ -0,0 +1,93 @@
+#ifndef INDICE_CEDULAS_H
+#define INDICE_CEDULAS_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+/**
+ * @brief Empaqueta una cédula en un entero de 64 bits.
+ *
+ * Los 4 bits altos guardan la cantidad de dígitos y el resto su valor,
+ * así que cédulas con ceros a la izquierda siguen siendo distintas.
+ * Se ignoran los espacios al inicio y al final.
+ *
+ * @param cedula Texto de la cédula (6 a 10 dígitos, como en errorCedula()).
+ * @return La clave, o 0 si el texto no es una cédula representable.
+ */
+uint64_t empaquetarCedula(string_view cedula);
+
+/**
+ * @brief Texto de una cédula empaquetada (inversa de empaquetarCedula()).
+ * @return La cédula con sus ceros a la izquierda, o "" si la clave es 0
+ *         o su longitud no es válida.
+ */
+string desempaquetarCedula(uint64_t clave);
+
+/**
+ * @brief Clave de la cédula de un registro "cedula,clave,...".
+ * @return La clave del primer campo, o 0 si no es una cédula válida.
+ */
+uint64_t cedulaDeLinea(string_view linea);
+
+/**
+ * @brief Índice hash cédula -> posición del registro.
+ *
+ * Direccionamiento abierto con sondeo lineal sobre una tabla de tamaño
+ * potencia de dos y ocupación máxima del 50 %, así que una búsqueda
+ * recorre en promedio una o dos casillas contiguas. La clave 0 marca una
+ * casilla libre. No se borran entradas: los registros solo se agregan.
+ */
+class IndiceCedulas {
+public:
+    IndiceCedulas() = default;
+
+    /**
+     * @brief Deja lugar para `cantidad` entradas sin volver a crecer.
+     */
+    void reservar(int cantidad);
+
+    /**
+     * @brief Reconstruye el índice a partir de registros "cedula,clave,...".
+     *
+     * Si una cédula se repite se conserva la primera aparición, igual que
+     * la búsqueda lineal que reemplaza.
+     *
+     * @return Cantidad de registros que no se pudieron indexar.
+     */
+    int construir(const string* lineas, int numLineas);
+
+    /**
+     * @brief Posición del registro con esa clave, o -1 si no existe.
+     */
+    int buscar(uint64_t clave) const;
+
+    /**
+     * @brief Posición del registro con esa cédula, o -1 si no existe.
+     */
+    int buscar(string_view cedula) const { return buscar(empaquetarCedula(cedula)); }
+
+    /**
+     * @brief Agrega una entrada.
+     * @return false si la clave es inválida o ya estaba en el índice.
+     */
+    bool insertar(uint64_t clave, int posicion);
+
+    /**
+     * @brief Número de entradas.
+     */
+    int tamanio() const { return usados; }
+
+private:
+    void redimensionar(int nuevaCapacidad);
+    size_t casillaInicial(uint64_t clave) const;
+
+    vector<uint64_t> claves;
+    vector<int> posiciones;
+    int usados = 0;
+    int bitsCapacidad = 0;
+};
+
+#endif // INDICE_CEDULAS_H
@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "AlmacenSegmentado.h"
+#include "ArchivoRanuras.h"
+#include "IndiceCedulas.h"
+#include "IndicePersistente.h"
+#include "ManipulacionArchivos.h"
+
+using namespace std;
+
+/// Primeros bytes de un índice de cédulas.
+static const char MAGIA_INDICE[4] = { 'P', '3', 'I', 'C' };
+
+/**
+ * @brief Escribe un entero de `bytes` bytes en little-endian.
+ */
+static void escribirLE(char* destino, uint64_t valor, int bytes) {
+    for (int k = 0; k < bytes; k++)
+        destino[k] = static_cast<char>((valor >> (8 * k)) & 0xFF);
+}
+
+/**
+ * @brief Lee un entero de `bytes` bytes en little-endian.
+ */
+static uint64_t leerLE(const char* origen, int bytes) {
+    uint64_t valor = 0;
+    for (int k = bytes - 1; k >= 0; k--)
+        valor = (valor << 8) | static_cast<unsigned char>(origen[k]);
+    return valor;
+}
+
+/**
+ * @brief Lo que identifica a los datos con los que se escribió un índice.
+ */
+struct HuellaDatos {
+    uint64_t generacion = 0;
+    uint64_t bytes = 0;
+    int64_t modificacion = 0;
+};
+
+/**
+ * @brief Toma la huella actual del almacén (sin leer los registros).
+ */
+static bool tomarHuella(const string& rutaDatos, HuellaDatos& huella) {
+    error_code error;
+    huella.bytes = filesystem::file_size(rutaDatos, error);
+    if (error) return false;
+    huella.modificacion = filesystem::last_write_time(rutaDatos, error).time_since_epoch().count();
+    if (error) return false;
+
+    huella.generacion = 0;
+    if (esManifiestoSegmentado(rutaDatos)) {
+        ManifiestoAlmacen manifiesto;
+        if (!leerManifiesto(rutaDatos, manifiesto)) return false;
+        huella.generacion = manifiesto.generacion;
+    }
+    return true;
+}
+
+/**
+ * @brief Tamaño de un archivo, o -1 si no se puede consultar.
+ */
+static int64_t tamanioArchivo(const string& ruta) {
+    error_code error;
+    uint64_t bytes = filesystem::file_size(ruta, error);
+    return error ? -1 : static_cast<int64_t>(bytes);
+}
+
+/**
+ * @brief Recorre las líneas de un archivo suelto (o un segmento) con las
+ *        reglas con que se escribe y anota dónde queda cada registro.
+ *
+ * @return Bytes que ocupa el archivo según esas reglas.
+ */
+static uint64_t ubicarEnArchivo(const string* lineas, int inicio, int fin, bool empaquetado, uint32_t segmento,
+                                vector<UbicacionRegistro>& ubicaciones) {
+    uint64_t pos = empaquetado ? TAM_CABECERA_EMPAQUETADO : 0;
+    for (int i = inicio; i < fin; i++) {
+        UbicacionRegistro& u = ubicaciones[i];
+        u.registro = static_cast<uint32_t>(i);
+        u.segmento = segmento;
+        if (empaquetado) {
+            if (lineas[i].empty()) continue;
+            u.desplazamiento = pos + 4;
+            u.longitud = static_cast<uint32_t>(lineas[i].size() / 8);
+            pos += 4 + u.longitud;
+        } else {
+            u.desplazamiento = pos;
+            u.longitud = static_cast<uint32_t>(lineas[i].size());
+            pos += u.longitud + 1;
+        }
+    }
+    if (!empaquetado && fin > inicio) pos--;   // la última línea va sin '\n'
+    return pos;
+}
+
+/**
+ * @brief Calcula dónde quedó cada registro y lo contrasta con los
+ *        archivos reales.
+ *
+ * @return false si el formato no se reconoce o los tamaños no coinciden.
+ */
+static bool calcularUbicaciones(const string& rutaDatos, const string* lineas, int numLineas,
+                                vector<UbicacionRegistro>& ubicaciones) {
+    ubicaciones.assign(numLineas, UbicacionRegistro());
+
+    if (esArchivoRanuras(rutaDatos)) {
+        char cabecera[16];
+        ifstream archivo(rutaDatos, ios::binary);
+        if (!archivo.read(cabecera, sizeof(cabecera))) return false;
+        uint64_t registros = leerLE(cabecera + 8, 4);
+        uint64_t tamRanura = leerLE(cabecera + 12, 4);
+
+        uint64_t k = 0;
+        for (int i = 0; i < numLineas; i++) {
+            if (lineas[i].empty()) continue;
+            UbicacionRegistro& u = ubicaciones[i];
+            u.registro = static_cast<uint32_t>(i);
+            u.desplazamiento = (++k) * tamRanura + 4;
+            u.longitud = static_cast<uint32_t>(lineas[i].size() / 8);
+        }
+        return k == registros && tamanioArchivo(rutaDatos) >= static_cast<int64_t>((registros + 1) * tamRanura);
+    }
+
+    if (esManifiestoSegmentado(rutaDatos)) {
+        ManifiestoAlmacen manifiesto;
+        if (!leerManifiesto(rutaDatos, manifiesto)) return false;
+
+        int inicio = 0;
+        for (size_t s = 0; s < manifiesto.segmentos.size(); s++) {
+            // El segmento termina cuando ya tiene sus registros no vacíos
+            uint64_t registros = 0;
+            int fin = inicio;
+            while (fin < numLineas && (registros < manifiesto.segmentos[s].registros || lineas[fin].empty()))
+                if (!lineas[fin++].empty()) registros++;
+            if (registros != manifiesto.segmentos[s].registros) return false;
+
+            uint64_t bytes = ubicarEnArchivo(lineas, inicio, fin, manifiesto.empaquetado, static_cast<uint32_t>(s),
+                                             ubicaciones);
+            if (bytes != manifiesto.segmentos[s].bytes) return false;
+            if (tamanioArchivo(rutaSegmento(rutaDatos, manifiesto.generacion, s)) != static_cast<int64_t>(bytes))
+                return false;
+            inicio = fin;
+        }
+        return inicio == numLineas;
+    }
+
+    bool empaquetado = esArchivoEmpaquetado(rutaDatos);
+    uint64_t bytes = ubicarEnArchivo(lineas, 0, numLineas, empaquetado, 0, ubicaciones);
+    return tamanioArchivo(rutaDatos) == static_cast<int64_t>(bytes);
+}
+
+/**
+ * @brief Una entrada del índice antes de codificarla.
+ */
+struct EntradaIndice {
+    uint64_t clave;
+    UbicacionRegistro ubicacion;
+};
+
+/**
+ * @brief Reparte el arreglo ordenado en orden de Eytzinger: el nodo k
+ *        (desde 1) tiene sus hijos en 2k y 2k + 1.
+ *
+ * @return Siguiente posición de `ordenadas` por tomar.
+ */
+static size_t llenarEytzinger(const vector<EntradaIndice>& ordenadas, vector<EntradaIndice>& arbol,
+                              size_t siguiente, size_t k) {
+    if (k <= ordenadas.size()) {
+        siguiente = llenarEytzinger(ordenadas, arbol, siguiente, 2 * k);
+        arbol[k - 1] = ordenadas[siguiente++];
+        siguiente = llenarEytzinger(ordenadas, arbol, siguiente, 2 * k + 1);
+    }
+    return siguiente;
+}
+
+string rutaIndicePersistente(const string& rutaDatos) {
+    return rutaDatos + ".indice";
+}
+
+bool guardarIndicePersistente(const string& rutaDatos, const Cuenta* cuentas, const string* lineas, int numCuentas) {
+    vector<uint64_t> cedulas(static_cast<size_t>(max(numCuentas, 0)));
+    for (int i = 0; i < numCuentas; i++) cedulas[i] = cuentas[i].cedula;
+    return guardarIndicePersistente(rutaDatos, cedulas.data(), lineas, numCuentas);
+}
+
+bool guardarIndicePersistente(const string& rutaDatos, const uint64_t* cedulas, const string* lineas, int numCuentas) {
+    const string ruta = rutaIndicePersistente(rutaDatos);
+    const string temporal = ruta + ".tmp";
+    try {
+        vector<UbicacionRegistro> ubicaciones;
+        if (!calcularUbicaciones(rutaDatos, lineas, numCuentas, ubicaciones)) {
+            throw "Los datos no tienen la forma esperada; no se indexan.";
+        }
+
+        vector<EntradaIndice> ordenadas;
+        ordenadas.reserve(numCuentas);
+        for (int i = 0; i < numCuentas; i++)
+            if (cedulas[i] != 0 && !lineas[i].empty())
+                ordenadas.push_back({ cedulas[i], ubicaciones[i] });
+        // Con cédulas repetidas queda la primera, igual que en memoria
+        stable_sort(ordenadas.begin(), ordenadas.end(),
+                    [](const EntradaIndice& a, const EntradaIndice& b) { return a.clave < b.clave; });
+        ordenadas.erase(unique(ordenadas.begin(), ordenadas.end(),
+                               [](const EntradaIndice& a, const EntradaIndice& b) { return a.clave == b.clave; }),
+                        ordenadas.end());
+
+        vector<EntradaIndice> arbol(ordenadas.size());
+        llenarEytzinger(ordenadas, arbol, 0, 1);
+
+        HuellaDatos huella;
+        if (!tomarHuella(rutaDatos, huella)) {
+            throw "No se pudo consultar el archivo de datos.";
+        }
+
+        vector<char> contenido(TAM_CABECERA_INDICE + arbol.size() * TAM_ENTRADA_INDICE, 0);
+        memcpy(contenido.data(), MAGIA_INDICE, 4);
+        contenido[4] = static_cast<char>(VERSION_INDICE_PERSISTENTE);
+        escribirLE(&contenido[8], huella.generacion, 8);
+        escribirLE(&contenido[16], huella.bytes, 8);
+        escribirLE(&contenido[24], static_cast<uint64_t>(huella.modificacion), 8);
+        escribirLE(&contenido[32], arbol.size(), 4);
+        escribirLE(&contenido[36], TAM_ENTRADA_INDICE, 4);
+        for (size_t k = 0; k < arbol.size(); k++) {
+            char* entrada = &contenido[TAM_CABECERA_INDICE + k * TAM_ENTRADA_INDICE];
+            escribirLE(entrada, arbol[k].clave, 8);
+            escribirLE(entrada + 8, arbol[k].ubicacion.registro, 4);
+            escribirLE(entrada + 12, arbol[k].ubicacion.segmento, 4);
+            escribirLE(entrada + 16, arbol[k].ubicacion.desplazamiento, 8);
+            escribirLE(entrada + 24, arbol[k].ubicacion.longitud, 4);
+        }
+
+        {
+            ofstream archivo(temporal, ios::trunc | ios::binary);
+            if (!archivo.is_open() || !archivo.write(contenido.data(), contenido.size())) {
+                throw "No se pudo escribir el índice.";
+            }
+        }
+        if (!reemplazarArchivo(temporal, ruta)) {
+            throw "No se pudo reemplazar el índice.";
+        }
+        return true;
+    }
+    catch (const char* e) {
+        cerr << "ERROR en guardarIndicePersistente(): " << e << endl;
+        remove(temporal.c_str());
+        return false;
+    }
+}
+
+bool IndicePersistente::abrir(const string& rutaDatos) {
+    cerrar();
+    try {
+        archivo.abrir(rutaIndicePersistente(rutaDatos));
+    }
+    catch (const char*) {
+        return false;
+    }
+
+    const char* datos = archivo.datos();
+    size_t tam = archivo.tamanio();
+    HuellaDatos huella;
+    bool valido = datos != nullptr && tam >= static_cast<size_t>(TAM_CABECERA_INDICE)
+                  && memcmp(datos, MAGIA_INDICE, 4) == 0
+                  && static_cast<uint8_t>(datos[4]) == VERSION_INDICE_PERSISTENTE
+                  && leerLE(datos + 36, 4) == static_cast<uint64_t>(TAM_ENTRADA_INDICE)
+                  && tam == TAM_CABECERA_INDICE + leerLE(datos + 32, 4) * TAM_ENTRADA_INDICE
+                  && tomarHuella(rutaDatos, huella)
+                  && leerLE(datos + 8, 8) == huella.generacion
+                  && leerLE(datos + 16, 8) == huella.bytes
+                  && static_cast<int64_t>(leerLE(datos + 24, 8)) == huella.modificacion;
+    if (!valido) {
+        archivo.cerrar();
+        return false;
+    }
+
+    numEntradas = static_cast<uint32_t>(leerLE(datos + 32, 4));
+    entradas = datos + TAM_CABECERA_INDICE;
+    return true;
+}
+
+void IndicePersistente::cerrar() {
+    archivo.cerrar();
+    entradas = nullptr;
+    numEntradas = 0;
+}
+
+bool IndicePersistente::buscar(string_view cedula, UbicacionRegistro& ubicacion) const {
+    uint64_t clave = empaquetarCedula(cedula);
+    return clave != 0 && buscar(clave, ubicacion);
+}
+
+bool IndicePersistente::buscar(uint64_t clave, UbicacionRegistro& ubicacion) const {
+    if (!entradas) return false;
+
+    // Se baja por el árbol implícito; al salir, los bits finales de k
+    // dicen en qué nodo se giró a la izquierda por última vez, que es el
+    // primero con clave >= la buscada
+    size_t k = 1;
+    while (k <= numEntradas)
+        k = 2 * k + (leerLE(entradas + (k - 1) * TAM_ENTRADA_INDICE, 8) < clave);
+    while (k & 1) k >>= 1;
+    k >>= 1;
+    if (k == 0) return false;
+
+    const char* entrada = entradas + (k - 1) * TAM_ENTRADA_INDICE;
+    if (leerLE(entrada, 8) != clave) return false;
+    ubicacion.registro = static_cast<uint32_t>(leerLE(entrada + 8, 4));
+    ubicacion.segmento = static_cast<uint32_t>(leerLE(entrada + 12, 4));
+    ubicacion.desplazamiento = leerLE(entrada + 16, 8);
+    ubicacion.longitud = static_cast<uint32_t>(leerLE(entrada + 24, 4));
+    return true;
+}
+
+bool indicePersistenteVigente(const string& rutaDatos) {
+    IndicePersistente indice;
+    return indice.abrir(rutaDatos);
+}
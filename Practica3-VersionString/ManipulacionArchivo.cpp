@@ -1,20 +1,433 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include "AlmacenSegmentado.h"
+#include "ArchivoRanuras.h"
+#include "ConversionSIMD.h"
+#include "ManipulacionArchivos.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 
+/// Tamaño máximo aceptado para un archivo de datos o un segmento.
+static const long MAX_FILE_SIZE = 10'000'000; // 10 MB
+
+/// Primeros bytes de un archivo en formato empaquetado.
+static const char MAGIA_EMPAQUETADO[4] = { 'P', '3', 'C', 'B' };
+
+void LineasMapeadas::cerrar() {
+    vistas.clear();
+    archivos.clear();
+    for (string* p : propias) delete[] p;
+    propias.clear();
+}
+
+/**
+ * @brief Agrega al final las líneas no vacías de un archivo suelto.
+ *
+ * Una sola pasada sobre la proyección: memchr() (vectorizada en las
+ * bibliotecas estándar habituales) encuentra cada '\n' y las líneas no
+ * vacías quedan como vistas, sin reservar memoria por línea. Igual que
+ * getline() en modo binario, un '\r' final forma parte de la línea.
+ *
+ * @param rutaArchivo Ruta del archivo (o segmento) a leer.
+ * @param lineas Destino de las vistas.
+ * @return Cantidad de líneas agregadas, o -1 si hubo un error.
+ * @throws const char* Si el archivo no se puede abrir o está corrupto.
+ */
+static int64_t agregarLineasArchivo(const string& rutaArchivo, LineasMapeadas& lineas) {
+    const bool ranuras = esArchivoRanuras(rutaArchivo);
+    if (ranuras || esArchivoEmpaquetado(rutaArchivo)) {
+        int numLineas = 0;
+        string* propias = ranuras ? leerArchivoRanuras(rutaArchivo, numLineas)
+                                  : leerArchivoEmpaquetado(rutaArchivo, numLineas);
+        if (!propias) return -1;
+
+        lineas.propias.push_back(propias);
+        lineas.vistas.reserve(lineas.vistas.size() + numLineas);
+        for (int i = 0; i < numLineas; i++)
+            lineas.vistas.push_back(propias[i]);
+        return numLineas;
+    }
+
+    try {
+        lineas.archivos.push_back(make_unique<ArchivoMapeado>());
+        ArchivoMapeado& archivo = *lineas.archivos.back();
+        archivo.abrir(rutaArchivo);
+        const char* datos = archivo.datos();
+        size_t fileSize = archivo.tamanio();
+        size_t previas = lineas.vistas.size();
+
+        cout << "Leyendo archivo: " << rutaArchivo << " (" << fileSize << " bytes)" << endl;
+
+        if (fileSize > static_cast<size_t>(MAX_FILE_SIZE)) {
+            throw "Archivo demasiado grande o corrupto.";
+        }
+
+        size_t pos = 0;
+        while (pos < fileSize) {
+            const char* salto = static_cast<const char*>(memchr(datos + pos, '\n', fileSize - pos));
+            size_t fin = salto ? static_cast<size_t>(salto - datos) : fileSize;
+            if (fin > pos) lineas.vistas.emplace_back(datos + pos, fin - pos);
+            pos = fin + 1;
+        }
+
+        size_t agregadas = lineas.vistas.size() - previas;
+        if (agregadas == 0) {
+            throw "El archivo está vacío.";
+        }
+
+        cout << "Archivo cargado correctamente: " << agregadas << " líneas" << endl << endl;
+        return static_cast<int64_t>(agregadas);
+    }
+    catch (const char* e) {
+        cerr << "ERROR en cargarLineasMapeadas(): " << e << endl;
+        return -1;
+    }
+}
+
+/**
+ * @brief Carga las líneas no vacías de un archivo o almacén como vistas.
+ *
+ * @param rutaArchivo Ruta del archivo o del manifiesto.
+ * @param lineas Destino de las vistas.
+ * @return true si se cargó al menos una línea.
+ */
+bool cargarLineasMapeadas(const string& rutaArchivo, LineasMapeadas& lineas) {
+    lineas.cerrar();
+
+    if (!esManifiestoSegmentado(rutaArchivo)) {
+        if (agregarLineasArchivo(rutaArchivo, lineas) > 0) return true;
+        lineas.cerrar();
+        return false;
+    }
+
+    try {
+        ManifiestoAlmacen manifiesto;
+        if (!leerManifiesto(rutaArchivo, manifiesto)) {
+            throw "Manifiesto inválido.";
+        }
+        // Las posiciones en memoria siguen siendo int en el resto del sistema
+        if (manifiesto.totalRegistros > static_cast<uint64_t>(INT32_MAX)) {
+            throw "Demasiados registros para cargarlos juntos; use cargarSegmento().";
+        }
+
+        lineas.vistas.reserve(manifiesto.totalRegistros);
+        for (size_t i = 0; i < manifiesto.segmentos.size(); i++) {
+            int64_t agregadas = agregarLineasArchivo(rutaSegmento(rutaArchivo, manifiesto.generacion, i), lineas);
+            if (agregadas < 0 || static_cast<uint64_t>(agregadas) != manifiesto.segmentos[i].registros) {
+                throw "Un segmento falta o no coincide con el manifiesto.";
+            }
+        }
+        return true;
+    }
+    catch (const char* e) {
+        cerr << "ERROR en cargarLineasMapeadas(): " << e << endl;
+        lineas.cerrar();
+        return false;
+    }
+}
+
+/**
+ * @brief Copia las vistas a un arreglo dinámico de strings.
+ *
+ * @param lineas Líneas cargadas.
+ * @param numLineas Referencia donde se almacenará el número de líneas.
+ * @return string* Arreglo dinámico de líneas, o nullptr si no hay ninguna.
+ */
+string* copiarLineas(const LineasMapeadas& lineas, int& numLineas) {
+    numLineas = static_cast<int>(lineas.vistas.size());
+    if (numLineas == 0) return nullptr;
+
+    string* copia = new string[numLineas];
+    for (int i = 0; i < numLineas; i++)
+        copia[i].assign(lineas.vistas[i].data(), lineas.vistas[i].size());
+    return copia;
+}
+
 /**
  * @brief Lee un archivo y devuelve sus líneas como un arreglo dinámico de strings.
  *
- * Cada línea se guarda como un `std::string` dentro de un arreglo `string*`.
- * Incluye validación de tamaño para evitar cargar archivos corruptos.
+ * Proyecta el archivo y lo recorre una sola vez (ver cargarLineasMapeadas());
+ * cada línea se copia exactamente una vez a su `std::string`.
  *
  * @param rutaArchivo Ruta del archivo a leer.
  * @param numLineas Referencia donde se almacenará el número de líneas leídas.
  * @return string* Arreglo dinámico de líneas, o nullptr si ocurre un error.
- * @throws const char* Si el archivo no se puede abrir o está corrupto.
  */
 string* leerArchivoLineas(const string& rutaArchivo, int& numLineas) {
+    numLineas = 0;
+    try {
+        LineasMapeadas lineas;
+        if (!cargarLineasMapeadas(rutaArchivo, lineas)) return nullptr;
+        return copiarLineas(lineas, numLineas);
+    }
+    catch (...) {
+        cerr << "ERROR desconocido en leerArchivoLineas()." << endl;
+        numLineas = 0;
+        return nullptr;
+    }
+}
+
+/// Trozos por llamada a writev(); IOV_MAX vale 1024 en Linux y macOS.
+static const size_t TROZOS_POR_ESCRITURA = 1024;
+
+/// Desde este largo una línea se escribe desde su propio buffer; las más
+/// cortas se copian, porque cada trozo le cuesta al kernel más que copiar
+/// unos pocos bytes.
+static const size_t TAM_LINEA_DIRECTA = 128;
+
+/// Buffer donde se juntan los separadores y las líneas cortas.
+static const size_t TAM_BUFFER_COPIAS = 64 * 1024;
+
+#ifndef _WIN32
+/**
+ * @brief Arma lotes de iovec y los escribe con writev().
+ *
+ * Las líneas largas se apuntan directo, sin copiarlas; los separadores y
+ * las líneas cortas se copian juntos a un buffer y comparten trozo. Un
+ * lote se escribe cuando se llenan los trozos o el buffer.
+ */
+class EscrituraReunida {
+public:
+    explicit EscrituraReunida(int descriptor) : descriptor(descriptor), copias(TAM_BUFFER_COPIAS) {
+        trozos.reserve(TROZOS_POR_ESCRITURA);
+    }
+
+    void agregar(const char* datos, size_t len) {
+        if (len == 0 || !ok) return;
+        if (len >= TAM_LINEA_DIRECTA) {
+            if (trozos.size() == TROZOS_POR_ESCRITURA) vaciar();
+            trozos.push_back({ const_cast<char*>(datos), len });
+            return;
+        }
+
+        if (usados + len > copias.size()) vaciar();
+        char* destino = copias.data() + usados;
+        bool contiguo = !trozos.empty()
+                        && static_cast<char*>(trozos.back().iov_base) + trozos.back().iov_len == destino;
+        if (!contiguo && trozos.size() == TROZOS_POR_ESCRITURA) {
+            vaciar();
+            destino = copias.data();
+        }
+        memcpy(destino, datos, len);
+        usados += len;
+        if (contiguo)
+            trozos.back().iov_len += len;
+        else
+            trozos.push_back({ destino, len });
+    }
+
+    /// Escribe lo que falte; false si alguna escritura falló.
+    bool terminar() {
+        vaciar();
+        return ok;
+    }
+
+private:
+    void vaciar() {
+        // writev() puede escribir menos de lo pedido: se sigue desde ahí
+        size_t primero = 0;
+        while (ok && primero < trozos.size()) {
+            ssize_t escritos = writev(descriptor, &trozos[primero], static_cast<int>(trozos.size() - primero));
+            if (escritos < 0) {
+                ok = false;
+                break;
+            }
+            size_t resto = static_cast<size_t>(escritos);
+            while (primero < trozos.size() && resto >= trozos[primero].iov_len)
+                resto -= trozos[primero++].iov_len;
+            if (resto > 0) {
+                trozos[primero].iov_base = static_cast<char*>(trozos[primero].iov_base) + resto;
+                trozos[primero].iov_len -= resto;
+            }
+        }
+        trozos.clear();
+        usados = 0;
+    }
+
+    int descriptor;
+    vector<iovec> trozos;
+    vector<char> copias;
+    size_t usados = 0;
+    bool ok = true;
+};
+#endif
+
+/**
+ * @brief Escribe las líneas separadas por '\n' en un archivo nuevo.
+ *
+ * En POSIX usa EscrituraReunida: unas pocas llamadas a writev() que
+ * apuntan a las líneas sin copiarlas. En Windows junta todo en un buffer
+ * y lo escribe de una vez.
+ *
+ * @param rutaArchivo Archivo a crear (se trunca si existe).
+ * @param lineas Líneas a escribir.
+ * @param numLineas Número de líneas.
+ * @return true si se escribió todo.
+ */
+static bool escribirLineasReunidas(const string& rutaArchivo, const string* lineas, int numLineas) {
+#ifdef _WIN32
+    size_t total = numLineas > 0 ? numLineas - 1 : 0;
+    for (int i = 0; i < numLineas; i++) total += lineas[i].size();
+    string contenido;
+    contenido.reserve(total);
+    for (int i = 0; i < numLineas; i++) {
+        contenido += lineas[i];
+        if (i < numLineas - 1) contenido += '\n';
+    }
+
+    ofstream archivo(rutaArchivo, ios::trunc | ios::binary);
+    if (!archivo.is_open()) return false;
+    archivo.write(contenido.data(), contenido.size());
+    archivo.close();
+    return !archivo.fail();
+#else
+    int descriptor = open(rutaArchivo.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (descriptor < 0) return false;
+
+    EscrituraReunida escritura(descriptor);
+    for (int i = 0; i < numLineas; i++) {
+        escritura.agregar(lineas[i].data(), lineas[i].size());
+        if (i < numLineas - 1) escritura.agregar("\n", 1);
+    }
+    bool ok = escritura.terminar();
+    if (close(descriptor) != 0) ok = false;
+    return ok;
+#endif
+}
+
+/**
+ * @brief Guarda un arreglo de strings en un archivo de texto.
+ *
+ * Escribe en "<ruta>.tmp" con escrituras reunidas y lo renombra sobre el
+ * archivo: si se corta a mitad queda el anterior completo.
+ *
+ * @param rutaArchivo Ruta donde se guardará el archivo.
+ * @param lineas Arreglo dinámico de líneas a guardar.
+ * @param numLineas Número de líneas a escribir.
+ * @param silencioso true para no informar en consola cuando todo sale bien.
+ * @return true si el archivo quedó reemplazado.
+ */
+bool guardarArchivoLineas(const string& rutaArchivo, const string* lineas, int numLineas, bool silencioso) {
+    const string temporal = rutaArchivo + ".tmp";
+    try {
+        if (!lineas && numLineas > 0) {
+            throw "Arreglo vacío o no inicializado.";
+        }
+        if (!escribirLineasReunidas(temporal, lineas, numLineas)) {
+            throw "Error al escribir el archivo.";
+        }
+        if (!reemplazarArchivo(temporal, rutaArchivo)) {
+            throw "No se pudo reemplazar el archivo.";
+        }
+        if (!silencioso)
+            cout << "Archivo guardado correctamente: " << numLineas << " líneas" << endl;
+        return true;
+    }
+    catch (const char* e) {
+        cerr << "ERROR en guardarArchivoLineas(): " << e << endl;
+    }
+    remove(temporal.c_str());
+    return false;
+}
+
+#ifndef _WIN32
+/**
+ * @brief Abre una ruta y la sincroniza con el disco.
+ *
+ * fsync() sobre cualquier descriptor del archivo baja todo lo que esté
+ * pendiente, así que sirve para archivos escritos con ofstream.
+ */
+static bool sincronizarRuta(const string& ruta, int banderas) {
+    int descriptor = open(ruta.c_str(), banderas);
+    if (descriptor < 0) return false;
+    bool ok = fsync(descriptor) == 0;
+    if (close(descriptor) != 0) ok = false;
+    return ok;
+}
+#endif
+
+bool reemplazarArchivo(const string& temporal, const string& rutaArchivo) {
+#ifdef _WIN32
+    HANDLE archivo = CreateFileA(temporal.c_str(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, nullptr);
+    bool ok = archivo != INVALID_HANDLE_VALUE && FlushFileBuffers(archivo);
+    if (archivo != INVALID_HANDLE_VALUE) CloseHandle(archivo);
+    // MOVEFILE_WRITE_THROUGH no vuelve hasta que el cambio de nombre está en disco
+    ok = ok && MoveFileExA(temporal.c_str(), rutaArchivo.c_str(),
+                           MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    filesystem::path carpeta = filesystem::path(rutaArchivo).parent_path();
+    if (carpeta.empty()) carpeta = ".";
+    bool ok = sincronizarRuta(temporal, O_RDONLY)
+           && rename(temporal.c_str(), rutaArchivo.c_str()) == 0
+           && sincronizarRuta(carpeta.string(), O_RDONLY | O_DIRECTORY);
+#endif
+    if (!ok) remove(temporal.c_str());
+    return ok;
+}
+
+// ================================================================
+// === Formato binario empaquetado ================================
+// ================================================================
+
+/**
+ * @brief Escribe un entero de 32 bits en little-endian.
+ */
+static void escribirU32(char* destino, uint32_t valor) {
+    for (int k = 0; k < 4; k++)
+        destino[k] = static_cast<char>((valor >> (8 * k)) & 0xFF);
+}
+
+/**
+ * @brief Lee un entero de 32 bits en little-endian.
+ */
+static uint32_t leerU32(const char* origen) {
+    uint32_t valor = 0;
+    for (int k = 3; k >= 0; k--)
+        valor = (valor << 8) | static_cast<unsigned char>(origen[k]);
+    return valor;
+}
+
+/**
+ * @brief Indica si el archivo empieza con la cabecera del formato empaquetado.
+ *
+ * @param rutaArchivo Ruta del archivo.
+ * @return true si los primeros bytes coinciden con MAGIA_EMPAQUETADO.
+ */
+bool esArchivoEmpaquetado(const string& rutaArchivo) {
+    ifstream archivo(rutaArchivo, ios::binary);
+    char magia[4];
+    if (!archivo.read(magia, 4)) return false;
+    return memcmp(magia, MAGIA_EMPAQUETADO, 4) == 0;
+}
+
+/**
+ * @brief Lee un archivo en formato empaquetado.
+ *
+ * Carga el archivo completo con una sola lectura y expande cada registro
+ * a '0'/'1', por lo que el resultado es el mismo que con el formato de
+ * texto pero leyendo 8 veces menos bytes.
+ *
+ * @param rutaArchivo Ruta del archivo a leer.
+ * @param numLineas Referencia donde se almacenará el número de registros.
+ * @return string* Arreglo dinámico de líneas, o nullptr si ocurre un error.
+ * @throws const char* Si la cabecera o algún registro están corruptos.
+ */
+string* leerArchivoEmpaquetado(const string& rutaArchivo, int& numLineas) {
+    string* lineas = nullptr;
     try {
         ifstream archivo(rutaArchivo, ios::binary);
         if (!archivo.is_open()) {
@@ -22,87 +435,170 @@ string* leerArchivoLineas(const string& rutaArchivo, int& numLineas) {
         }
 
         archivo.seekg(0, ios::end);
-        long fileSize = archivo.tellg();
+        int64_t fileSize = static_cast<int64_t>(archivo.tellg());
         archivo.seekg(0, ios::beg);
 
-        cout << "Leyendo archivo: " << rutaArchivo << " (" << fileSize << " bytes)" << endl;
+        cout << "Leyendo archivo empaquetado: " << rutaArchivo << " (" << fileSize << " bytes)" << endl;
 
-        const long MAX_FILE_SIZE = 10'000'000; // 10 MB
         if (fileSize > MAX_FILE_SIZE) {
             throw "Archivo demasiado grande o corrupto.";
         }
+        if (fileSize < TAM_CABECERA_EMPAQUETADO) {
+            throw "Cabecera incompleta.";
+        }
 
-        // Primera pasada: contar líneas no vacías
-        numLineas = 0;
-        string temp;
-        while (getline(archivo, temp)) {
-            if (!temp.empty()) numLineas++;
+        vector<char> contenido(fileSize);
+        if (!archivo.read(contenido.data(), fileSize)) {
+            throw "No se pudo leer el archivo completo.";
         }
 
-        if (numLineas == 0) {
-            throw "El archivo está vacío.";
+        if (memcmp(contenido.data(), MAGIA_EMPAQUETADO, 4) != 0) {
+            throw "El archivo no está en formato empaquetado.";
+        }
+        if (static_cast<uint8_t>(contenido[4]) != VERSION_FORMATO_EMPAQUETADO) {
+            throw "Versión de formato no soportada.";
         }
 
-        // Segunda pasada: leer y almacenar líneas
-        archivo.clear();
-        archivo.seekg(0, ios::beg);
+        uint32_t registros = leerU32(&contenido[8]);
+        // Cada registro ocupa al menos los 4 bytes de su longitud
+        if (registros == 0 || registros > static_cast<uint32_t>((fileSize - TAM_CABECERA_EMPAQUETADO) / 4)) {
+            throw "Número de registros inválido.";
+        }
+
+        numLineas = static_cast<int>(registros);
+        lineas = new string[numLineas];
 
-        string* lineas = new string[numLineas];
-        int i = 0;
-        while (getline(archivo, temp) && i < numLineas) {
-            if (!temp.empty()) {
-                lineas[i] = temp;
-                i++;
+        size_t pos = TAM_CABECERA_EMPAQUETADO;
+        for (int i = 0; i < numLineas; i++) {
+            if (pos + 4 > contenido.size()) {
+                throw "Registro truncado.";
+            }
+            uint32_t len = leerU32(&contenido[pos]);
+            pos += 4;
+            if (len > contenido.size() - pos) {
+                throw "Registro truncado.";
             }
+
+            lineas[i].resize(static_cast<size_t>(len) * 8);
+            expandirBits(reinterpret_cast<const uint8_t*>(&contenido[pos]), len, &lineas[i][0]);
+            pos += len;
         }
 
-        archivo.close();
         cout << "Archivo cargado correctamente: " << numLineas << " líneas" << endl << endl;
         return lineas;
     }
     catch (const char* e) {
-        cerr << "ERROR en leerArchivoLineas(): " << e << endl;
-        numLineas = 0;
-        return nullptr;
-    }
-    catch (...) {
-        cerr << "ERROR desconocido en leerArchivoLineas()." << endl;
+        cerr << "ERROR en leerArchivoEmpaquetado(): " << e << endl;
+        delete[] lineas;
         numLineas = 0;
         return nullptr;
     }
 }
 
 /**
- * @brief Guarda un arreglo de strings en un archivo de texto.
+ * @brief Guarda líneas binarias en formato empaquetado.
  *
- * Sobrescribe el archivo si ya existe.
+ * Arma el archivo completo en memoria (cabecera y registros) y lo escribe
+ * con una sola operación.
  *
  * @param rutaArchivo Ruta donde se guardará el archivo.
- * @param lineas Arreglo dinámico de líneas a guardar.
- * @param numLineas Número de líneas a escribir.
- * @throws const char* Si el archivo no se puede abrir para escritura.
+ * @param lineas Arreglo de líneas '0'/'1'.
+ * @param numLineas Número de líneas.
+ * @param silencioso true para no informar en consola cuando todo sale bien.
+ * @return true si el archivo se escribió completo.
+ * @throws const char* Si una línea no es binaria o no se puede escribir.
  */
-void guardarArchivoLineas(const string& rutaArchivo, string* lineas, int numLineas) {
+bool guardarArchivoEmpaquetado(const string& rutaArchivo, const string* lineas, int numLineas, bool silencioso) {
     try {
+        if (!lineas || numLineas <= 0) {
+            throw "Arreglo vacío o no inicializado.";
+        }
+
+        size_t total = TAM_CABECERA_EMPAQUETADO;
+        uint32_t registros = 0;
+        for (int i = 0; i < numLineas; i++) {
+            if (lineas[i].empty()) continue;
+            if (lineas[i].size() % 8 != 0) {
+                throw "Línea con longitud no múltiplo de 8: no se puede empaquetar.";
+            }
+            total += 4 + lineas[i].size() / 8;
+            registros++;
+        }
+
+        vector<char> contenido(total, 0);
+        memcpy(contenido.data(), MAGIA_EMPAQUETADO, 4);
+        contenido[4] = static_cast<char>(VERSION_FORMATO_EMPAQUETADO);
+        escribirU32(&contenido[8], registros);
+
+        size_t pos = TAM_CABECERA_EMPAQUETADO;
+        for (int i = 0; i < numLineas; i++) {
+            if (lineas[i].empty()) continue;
+            size_t len = lineas[i].size() / 8;
+            escribirU32(&contenido[pos], static_cast<uint32_t>(len));
+            pos += 4;
+            if (!empaquetarBits(lineas[i].data(), lineas[i].size(), reinterpret_cast<uint8_t*>(&contenido[pos]))) {
+                throw "Línea con caracteres no binarios: no se puede empaquetar.";
+            }
+            pos += len;
+        }
+
         ofstream archivo(rutaArchivo, ios::trunc | ios::binary);
         if (!archivo.is_open()) {
             throw "No se pudo abrir el archivo para escritura.";
         }
-
-        for (int i = 0; i < numLineas; i++) {
-            archivo << lineas[i];
-            if (i < numLineas - 1) archivo << '\n';
+        if (!archivo.write(contenido.data(), contenido.size())) {
+            throw "Error al escribir el archivo.";
         }
 
         archivo.close();
-        cout << "Archivo guardado correctamente: " << numLineas << " líneas" << endl;
+        if (!silencioso)
+            cout << "Archivo guardado (empaquetado): " << registros << " líneas, " << total << " bytes" << endl;
+        return true;
     }
     catch (const char* e) {
-        cerr << "ERROR en guardarArchivoLineas(): " << e << endl;
+        cerr << "ERROR en guardarArchivoEmpaquetado(): " << e << endl;
+        return false;
     }
-    catch (...) {
-        cerr << "ERROR desconocido en guardarArchivoLineas()." << endl;
+}
+
+/**
+ * @brief Convierte un archivo del formato de texto al empaquetado.
+ *
+ * @param rutaArchivo Ruta del archivo a convertir.
+ * @return true si el archivo queda en formato empaquetado.
+ */
+bool migrarArchivoEmpaquetado(const string& rutaArchivo) {
+    if (esAlmacenEmpaquetado(rutaArchivo)) {
+        cout << "El archivo ya está empaquetado: " << rutaArchivo << endl;
+        return true;
+    }
+
+    int numLineas = 0;
+    string* lineas = leerArchivoLineas(rutaArchivo, numLineas);
+    if (!lineas) return false;
+
+    if (esManifiestoSegmentado(rutaArchivo)) {
+        // guardarSegmentado() ya reemplaza el manifiesto de forma atómica
+        bool ok = guardarSegmentado(rutaArchivo, lineas, numLineas, true);
+        delete[] lineas;
+        return ok;
     }
+
+    const string temporal = rutaArchivo + ".tmp";
+    bool ok = guardarArchivoEmpaquetado(temporal, lineas, numLineas);
+    delete[] lineas;
+
+    if (!ok) {
+        remove(temporal.c_str());
+        return false;
+    }
+    if (!reemplazarArchivo(temporal, rutaArchivo)) {
+        cerr << "ERROR en migrarArchivoEmpaquetado(): no se pudo reemplazar " << rutaArchivo << endl;
+        return false;
+    }
+
+    cout << "Archivo migrado al formato empaquetado: " << rutaArchivo << endl;
+    return true;
 }
 
 /**
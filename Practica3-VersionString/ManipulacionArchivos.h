@@ -1,7 +1,12 @@
 #ifndef MANIPULACION_ARCHIVOS_H
 #define MANIPULACION_ARCHIVOS_H
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
+#include "ArchivoMapeado.h"
 using namespace std;
 
 /**
@@ -9,6 +14,8 @@ using namespace std;
  *
  * Cada línea se guarda como un `std::string` dentro de un arreglo `string*`.
  * Incluye validación de tamaño para evitar cargar archivos corruptos.
+ * Equivale a cargarLineasMapeadas() seguido de copiarLineas(); si no se
+ * van a modificar las líneas conviene usar directamente las vistas.
  *
  * @param rutaArchivo Ruta del archivo a leer.
  * @param numLineas Referencia donde se almacenará el número de líneas leídas.
@@ -17,16 +24,138 @@ using namespace std;
  */
 string* leerArchivoLineas(const string& rutaArchivo, int& numLineas);
 
+/**
+ * @brief Líneas de un archivo vistas sin copiarlas.
+ *
+ * Con el formato de texto cada vista apunta directamente a la proyección
+ * del archivo; con el empaquetado apunta a las líneas ya expandidas a
+ * '0'/'1' en `propias`. Un almacén segmentado aporta una proyección (o
+ * un arreglo de propias) por segmento. Las vistas son válidas hasta
+ * cerrar() o hasta que se destruye el objeto.
+ */
+struct LineasMapeadas {
+    vector<unique_ptr<ArchivoMapeado>> archivos;  ///< Proyecciones (formato de texto)
+    vector<string*> propias;        ///< Líneas expandidas (formato empaquetado)
+    vector<string_view> vistas;     ///< Una vista por línea no vacía
+
+    LineasMapeadas() = default;
+    ~LineasMapeadas() { cerrar(); }
+    LineasMapeadas(const LineasMapeadas&) = delete;
+    LineasMapeadas& operator=(const LineasMapeadas&) = delete;
+
+    /**
+     * @brief Libera las proyecciones y las líneas propias.
+     */
+    void cerrar();
+};
+
+/**
+ * @brief Carga las líneas no vacías de un archivo como vistas, sin copiarlas.
+ *
+ * Proyecta el archivo en memoria y lo recorre una sola vez buscando los
+ * saltos de línea con memchr(). Detecta el formato empaquetado y en ese
+ * caso usa leerArchivoEmpaquetado(). Si la ruta es el manifiesto de un
+ * almacén segmentado, carga los segmentos uno tras otro; el límite de
+ * tamaño se aplica a cada segmento, no al total.
+ *
+ * @param rutaArchivo Ruta del archivo a leer.
+ * @param lineas Destino; se cierra antes lo que tuviera.
+ * @return true si se cargó al menos una línea.
+ */
+bool cargarLineasMapeadas(const string& rutaArchivo, LineasMapeadas& lineas);
+
+/**
+ * @brief Copia las vistas a un arreglo dinámico de strings modificable.
+ *
+ * @param lineas Líneas cargadas con cargarLineasMapeadas().
+ * @param numLineas Referencia donde se almacenará el número de líneas.
+ * @return string* Arreglo dinámico (liberar con delete[]).
+ */
+string* copiarLineas(const LineasMapeadas& lineas, int& numLineas);
+
 /**
  * @brief Guarda un arreglo de strings en un archivo de texto.
  *
- * Sobrescribe el archivo si ya existe.
+ * Reemplaza el archivo de forma atómica (temporal y reemplazarArchivo()); las
+ * líneas se escriben con escrituras reunidas (writev) sin copiarlas.
  *
  * @param rutaArchivo Ruta del archivo a escribir.
  * @param lineas Arreglo de cadenas a guardar.
  * @param numLineas Número de líneas a escribir.
+ * @param silencioso true para no informar en consola cuando todo sale bien.
+ * @return true si el archivo se escribió completo.
+ */
+bool guardarArchivoLineas(const string& rutaArchivo, const string* lineas, int numLineas, bool silencioso = false);
+
+/**
+ * @brief Reemplaza un archivo por su temporal de forma durable.
+ *
+ * Sincroniza el temporal con el disco, lo renombra sobre `rutaArchivo`
+ * y sincroniza la carpeta para que el rename() tampoco se pierda en un
+ * corte de energía. Lo que el archivo nuevo deja obsoleto (la bitácora,
+ * una generación anterior) solo se borra después de que vuelve true.
+ * Si falla, borra el temporal.
+ *
+ * @param temporal Archivo ya escrito y cerrado.
+ * @param rutaArchivo Archivo que se reemplaza.
+ * @return true si el archivo nuevo quedó en disco con su nombre final.
+ */
+bool reemplazarArchivo(const string& temporal, const string& rutaArchivo);
+
+// ================================================================
+// === Formato binario empaquetado ================================
+// ================================================================
+//
+// Cabecera de 12 bytes seguida de los registros:
+//   [0..3]  "P3CB"
+//   [4]     versión del formato (VERSION_FORMATO_EMPAQUETADO)
+//   [5..7]  reservado (0)
+//   [8..11] número de registros (uint32, little-endian)
+// Cada registro: longitud en bytes (uint32, little-endian) y los bytes
+// cifrados, 8 bits por byte en lugar de 8 caracteres '0'/'1'.
+
+const uint8_t VERSION_FORMATO_EMPAQUETADO = 1;
+const int TAM_CABECERA_EMPAQUETADO = 12;
+
+/**
+ * @brief Indica si el archivo empieza con la cabecera del formato empaquetado.
+ */
+bool esArchivoEmpaquetado(const string& rutaArchivo);
+
+/**
+ * @brief Lee un archivo en formato empaquetado.
+ *
+ * Devuelve las líneas expandidas a '0'/'1', igual que leerArchivoLineas()
+ * con el formato de texto, para que el resto del sistema no cambie.
+ *
+ * @param rutaArchivo Ruta del archivo a leer.
+ * @param numLineas Referencia donde se almacenará el número de registros.
+ * @return string* Arreglo dinámico de líneas, o nullptr si ocurre un error.
+ */
+string* leerArchivoEmpaquetado(const string& rutaArchivo, int& numLineas);
+
+/**
+ * @brief Guarda líneas binarias ('0'/'1') en formato empaquetado.
+ *
+ * Las líneas vacías se omiten. Todas las demás deben ser binarias y de
+ * longitud múltiplo de 8.
+ *
+ * @param silencioso true para no informar en consola cuando todo sale bien.
+ * @return true si el archivo se escribió completo.
+ */
+bool guardarArchivoEmpaquetado(const string& rutaArchivo, const string* lineas, int numLineas, bool silencioso = false);
+
+/**
+ * @brief Convierte un archivo del formato de texto al empaquetado.
+ *
+ * Escribe primero un archivo temporal y luego lo renombra sobre el
+ * original, así que una falla a mitad de camino no pierde datos. Si el
+ * archivo ya está empaquetado no hace nada. Un almacén segmentado se
+ * reescribe con segmentos empaquetados.
+ *
+ * @return true si el archivo queda en formato empaquetado.
  */
-void guardarArchivoLineas(const string& rutaArchivo, string* lineas, int numLineas);
+bool migrarArchivoEmpaquetado(const string& rutaArchivo);
 
 /**
  * @brief Muestra en consola el contenido de un arreglo de strings.
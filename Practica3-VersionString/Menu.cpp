@@ -1,5 +1,8 @@
 #include <iostream>
 #include <cstdlib>  // stoi
+#include "Cuenta.h"
+#include "IndiceCedulas.h"
+#include "Menu.h"
 #include "OperacionesUsuario.h"
 #include "Validaciones.h"
 
@@ -71,6 +74,34 @@ void extraerCedulaYClave(const string& linea, string& cedula, string& clave) {
 // MENÚ ADMINISTRADOR
 // ==========================================================
 
+/**
+ * @brief Pide cédula y contraseña de administrador y las verifica.
+ *
+ * @param admins Arreglo de cadenas con las credenciales de los administradores.
+ * @param numAdmins Número total de administradores registrados.
+ * @param indiceAdmins Índice de cédulas de administradores.
+ * @return true si las credenciales son correctas.
+ */
+bool autenticarAdministrador(const string* admins, int numAdmins, const IndiceCedulas& indiceAdmins) {
+    string cedulaAdmin, claveIngresada;
+    cout << "\n=================================\n";
+    cout << "    ACCESO ADMINISTRADOR\n";
+    cout << "=================================\n";
+    cout << "Cédula de administrador: ";
+    cin >> cedulaAdmin;
+
+    int posAdmin = indiceAdmins.buscar(cedulaAdmin);
+    if (posAdmin < 0 || posAdmin >= numAdmins)
+        return false;
+
+    string cedulaArchivo, claveArchivo;
+    extraerCedulaYClave(admins[posAdmin], cedulaArchivo, claveArchivo);
+
+    cout << "Contraseña: ";
+    cin >> claveIngresada;
+    return claveArchivo == claveIngresada;
+}
+
 /**
  * @brief Muestra el menú de administrador y permite registrar nuevos usuarios.
  *
@@ -78,37 +109,18 @@ void extraerCedulaYClave(const string& linea, string& cedula, string& clave) {
  * poder registrar nuevos usuarios. Se validan la cédula, la contraseña,
  * el nombre y el saldo inicial del nuevo usuario.
  *
- * @param usuarios Referencia al arreglo dinámico de usuarios (se actualiza si se añade uno nuevo).
- * @param numUsuarios Referencia al número actual de usuarios.
+ * @param usuarios Cuentas de usuarios (la nueva se agrega al final).
  * @param admins Arreglo de cadenas con las credenciales de los administradores.
  * @param numAdmins Número total de administradores registrados.
+ * @param indiceUsuarios Índice de cédulas de usuarios (se actualiza al registrar).
+ * @param indiceAdmins Índice de cédulas de administradores.
+ * @param alModificar Aviso opcional con la posición del usuario registrado.
  */
-void menuAdministrador(string*& usuarios, int& numUsuarios, string* admins, int numAdmins) {
+void menuAdministrador(vector<Cuenta>& usuarios, string* admins, int numAdmins,
+                       IndiceCedulas& indiceUsuarios, const IndiceCedulas& indiceAdmins,
+                       const AlModificarCuenta& alModificar) {
     try {
-        string cedulaAdmin, claveIngresada;
-        cout << "\n=================================\n";
-        cout << "    ACCESO ADMINISTRADOR\n";
-        cout << "=================================\n";
-        cout << "Cédula de administrador: ";
-        cin >> cedulaAdmin;
-
-        bool valido = false;
-
-        for (int i = 0; i < numAdmins; i++) {
-            string cedulaArchivo, claveArchivo;
-            extraerCedulaYClave(admins[i], cedulaArchivo, claveArchivo);
-
-            if (cedulaArchivo == cedulaAdmin) {
-                cout << "Contraseña: ";
-                cin >> claveIngresada;
-
-                if (claveArchivo == claveIngresada)
-                    valido = true;
-                break;
-            }
-        }
-
-        if (!valido)
+        if (!autenticarAdministrador(admins, numAdmins, indiceAdmins))
             throw "Credenciales inválidas.";
 
         // REGISTRO DE NUEVO USUARIO
@@ -128,12 +140,8 @@ void menuAdministrador(string*& usuarios, int& numUsuarios, string* admins, int
             }
         } while (!validarCedula(cedula.c_str()));
 
-        for (int i = 0; i < numUsuarios; i++) {
-            string cedulaUsr, claveUsr;
-            extraerCedulaYClave(usuarios[i], cedulaUsr, claveUsr);
-            if (cedulaUsr == cedula)
-                throw "Ya existe un usuario con esa cédula.";
-        }
+        if (indiceUsuarios.buscar(cedula) >= 0)
+            throw "Ya existe un usuario con esa cédula.";
 
         // ===== Validar CONTRASEÑA =====
         do {
@@ -165,19 +173,19 @@ void menuAdministrador(string*& usuarios, int& numUsuarios, string* admins, int
         if (saldoInicial < 0 || saldoInicial > 1000000)
             throw "Saldo fuera del rango permitido.";
 
-        string nuevoUsuario = cedula + "," + clave + "," + nombre + "," + saldoStr + " COP";
+        Cuenta nuevoUsuario;
+        if (!crearCuenta(cedula, clave, nombre, saldoInicial, nuevoUsuario))
+            throw "La clave no puede tener comas y el nombre debe ser más corto.";
+        nuevoUsuario.modificada = true;   // aún no tiene texto cifrado
 
-        string* nuevosUsuarios = new string[numUsuarios + 1];
-        for (int i = 0; i < numUsuarios; i++) {
-            nuevosUsuarios[i] = usuarios[i];
-        }
-        nuevosUsuarios[numUsuarios] = nuevoUsuario;
-
-        delete[] usuarios;
-        usuarios = nuevosUsuarios;
-        numUsuarios++;
+        // El vector crece por duplicación: registrar no copia las demás cuentas
+        int posicion = static_cast<int>(usuarios.size());
+        usuarios.push_back(nuevoUsuario);
+        indiceUsuarios.insertar(nuevoUsuario.cedula, posicion);
 
         cout << "\n Usuario agregado correctamente (en memoria).\n";
+        if (alModificar)
+            alModificar(posicion, nuevoUsuario.saldo, MotivoCambio::Alta);
     }
     catch (const char* e) {
         cout << "\n[Error] " << e << "\n";
@@ -194,10 +202,12 @@ void menuAdministrador(string*& usuarios, int& numUsuarios, string* admins, int
  * Un usuario puede consultar su saldo (con costo de 1000 COP)
  * o retirar dinero (con costo adicional del monto retirado).
  *
- * @param usuarios Arreglo de usuarios.
- * @param numUsuarios Número de usuarios registrados.
+ * @param usuarios Cuentas de usuarios.
+ * @param indiceUsuarios Índice de cédulas de usuarios.
+ * @param alModificar Aviso opcional cuando una operación cambia el saldo.
  */
-void menuUsuario(string* usuarios, int numUsuarios) {
+void menuUsuario(vector<Cuenta>& usuarios, const IndiceCedulas& indiceUsuarios,
+                 const AlModificarCuenta& alModificar) {
     try {
         string cedula, claveIngresada;
 
@@ -209,69 +219,65 @@ void menuUsuario(string* usuarios, int numUsuarios) {
         cout << "Clave: ";
         cin >> claveIngresada;
 
-        bool encontrado = false;
-
-        for (int i = 0; i < numUsuarios; i++) {
-            string cedulaArchivo, claveArchivo;
-            extraerCedulaYClave(usuarios[i], cedulaArchivo, claveArchivo);
-
-            if (cedulaArchivo == cedula) {
-                if (claveArchivo == claveIngresada) {
-                    encontrado = true;
-                    bool continuar = true;
-
-                    while (continuar) {
-                        int opcion;
-                        cout << "\n=================================\n";
-                        cout << "    OPERACIONES DISPONIBLES\n";
-                        cout << "=================================\n";
-                        cout << "1. Consultar saldo (Costo: 1000 COP)\n";
-                        cout << "2. Retirar dinero (Costo: 1000 COP + monto)\n";
-                        cout << "3. Volver al menú principal\n";
-                        cout << "=================================\n";
-                        cout << "Opción: ";
-
-                        if (!(cin >> opcion)) {
-                            cin.clear();
-                            cin.ignore(10000, '\n');
-                            throw "Entrada inválida. Debe ingresar un número.";
-                        }
-
-                        switch (opcion) {
-                        case 1:
-                            consultarSaldoUsuario(usuarios[i], cedula);
-                            break;
-
-                        case 2: {
-                            int monto;
-                            cout << "\nMonto a retirar: ";
-                            cin >> monto;
-
-                            if (monto <= 0)
-                                throw "El monto debe ser mayor a cero.";
-                            else
-                                modificarDineroUsuario(usuarios[i], cedula, monto);
-                            break;
-                        }
-
-                        case 3:
-                            cout << "\n Volviendo al menú principal...\n";
-                            continuar = false;
-                            break;
-
-                        default:
-                            throw "Opción inválida. Debe ser 1, 2 o 3.";
-                        }
-                    }
-                } else {
-                    throw "Clave incorrecta.";
-                }
+        int i = indiceUsuarios.buscar(cedula);
+        if (i < 0 || i >= static_cast<int>(usuarios.size()))
+            throw "Cédula no encontrada en el sistema.";
+
+        if (claveIngresada != usuarios[i].clave)
+            throw "Clave incorrecta.";
+
+        bool continuar = true;
+
+        while (continuar) {
+            int opcion;
+            cout << "\n=================================\n";
+            cout << "    OPERACIONES DISPONIBLES\n";
+            cout << "=================================\n";
+            cout << "1. Consultar saldo (Costo: 1000 COP)\n";
+            cout << "2. Retirar dinero (Costo: 1000 COP + monto)\n";
+            cout << "3. Volver al menú principal\n";
+            cout << "=================================\n";
+            cout << "Opción: ";
+
+            if (!(cin >> opcion)) {
+                cin.clear();
+                cin.ignore(10000, '\n');
+                throw "Entrada inválida. Debe ingresar un número.";
+            }
+
+            int64_t saldoAntes = usuarios[i].saldo;
+            MotivoCambio motivo = MotivoCambio::Consulta;
+
+            switch (opcion) {
+            case 1:
+                consultarSaldoUsuario(usuarios[i], cedula);
+                break;
+
+            case 2: {
+                int monto;
+                cout << "\nMonto a retirar: ";
+                cin >> monto;
+
+                if (monto <= 0)
+                    throw "El monto debe ser mayor a cero.";
+                else
+                    modificarDineroUsuario(usuarios[i], cedula, monto);
+                motivo = MotivoCambio::Retiro;
                 break;
             }
-        }
 
-        if (!encontrado)
-            throw "Cédula no encontrada en el sistema.";
+            case 3:
+                cout << "\n Volviendo al menú principal...\n";
+                continuar = false;
+                break;
+
+            default:
+                throw "Opción inválida. Debe ser 1, 2 o 3.";
+            }
+
+            if (alModificar && usuarios[i].saldo != saldoAntes)
+                alModificar(i, usuarios[i].saldo - saldoAntes, motivo);
+        }
     }
     catch (const char* e) {
         cout << "\n[Error] " << e << "\n";
@@ -288,12 +294,16 @@ void menuUsuario(string* usuarios, int numUsuarios) {
  * Permite elegir entre las opciones de acceso de administrador,
  * usuario o salir del sistema.
  *
- * @param usuarios Referencia al arreglo dinámico de usuarios.
- * @param numUsuarios Referencia al número de usuarios registrados.
+ * @param usuarios Cuentas de usuarios (crece si se registra una).
  * @param admins Arreglo con los administradores.
  * @param numAdmins Cantidad de administradores.
+ * @param indiceUsuarios Índice de cédulas de usuarios.
+ * @param indiceAdmins Índice de cédulas de administradores.
+ * @param alModificar Aviso opcional cada vez que cambia una cuenta.
  */
-void menuPrincipal(string*& usuarios, int& numUsuarios, string* admins, int numAdmins) {
+void menuPrincipal(vector<Cuenta>& usuarios, string* admins, int numAdmins,
+                   IndiceCedulas& indiceUsuarios, const IndiceCedulas& indiceAdmins,
+                   const AlModificarCuenta& alModificar) {
     int opcion;
     do {
         try {
@@ -314,10 +324,10 @@ void menuPrincipal(string*& usuarios, int& numUsuarios, string* admins, int numA
 
             switch (opcion) {
             case 1:
-                menuAdministrador(usuarios, numUsuarios, admins, numAdmins);
+                menuAdministrador(usuarios, admins, numAdmins, indiceUsuarios, indiceAdmins, alModificar);
                 break;
             case 2:
-                menuUsuario(usuarios, numUsuarios);
+                menuUsuario(usuarios, indiceUsuarios, alModificar);
                 break;
             case 3:
                 cout << "\n Gracias por usar el sistema. Hasta pronto!\n";
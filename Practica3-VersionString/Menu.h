@@ -1,21 +1,45 @@
 #ifndef MENUS_BANCARIOS_H
 #define MENUS_BANCARIOS_H
 
+#include <functional>
 #include <string>
+#include <vector>
+#include "Cuenta.h"
+#include "IndiceCedulas.h"
+
+/**
+ * @brief Aviso de que la cuenta `indice` cambió (saldo o registro nuevo).
+ *
+ * Se llama apenas termina la operación con el cambio de saldo (`delta`,
+ * o el saldo inicial en un alta) y su motivo. La cuenta queda marcada
+ * como modificada; quien la persista completa en el momento puede
+ * limpiar la marca.
+ */
+using AlModificarCuenta = std::function<void(int indice, int64_t delta, MotivoCambio motivo)>;
 
 /**
  * @brief Muestra el menú principal del sistema bancario.
  */
-void menuPrincipal(std::string*& usuarios, int& numUsuarios, std::string* admins, int numAdmins);
+void menuPrincipal(std::vector<Cuenta>& usuarios, std::string* admins, int numAdmins,
+                   IndiceCedulas& indiceUsuarios, const IndiceCedulas& indiceAdmins,
+                   const AlModificarCuenta& alModificar = {});
+
+/**
+ * @brief Pide por consola las credenciales de un administrador y las verifica.
+ */
+bool autenticarAdministrador(const std::string* admins, int numAdmins, const IndiceCedulas& indiceAdmins);
 
 /**
  * @brief Menú del administrador (permite registrar nuevos usuarios).
  */
-void menuAdministrador(std::string*& usuarios, int& numUsuarios, std::string* admins, int numAdmins);
+void menuAdministrador(std::vector<Cuenta>& usuarios, std::string* admins, int numAdmins,
+                       IndiceCedulas& indiceUsuarios, const IndiceCedulas& indiceAdmins,
+                       const AlModificarCuenta& alModificar = {});
 
 /**
  * @brief Menú del usuario (consultar saldo, retirar dinero, etc.).
  */
-void menuUsuario(std::string* usuarios, int numUsuarios);
+void menuUsuario(std::vector<Cuenta>& usuarios, const IndiceCedulas& indiceUsuarios,
+                 const AlModificarCuenta& alModificar = {});
 
 #endif // MENUS_BANCARIOS_H
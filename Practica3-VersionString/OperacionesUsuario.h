@@ -2,27 +2,48 @@
 #define OPERACIONES_USUARIO_H
 
 #include <string>
+#include "Cuenta.h"
 using namespace std;
 
+/** Costo de una consulta de saldo en COP. */
+const int COSTO_CONSULTA = 1000;
+/** Costo de un retiro en COP (además del monto). */
+const int COSTO_RETIRO = 1000;
+
+/**
+ * @brief Cobra la consulta de saldo sin escribir nada.
+ *
+ * Si el saldo no alcanza se cobra lo que haya (el saldo queda en 0).
+ *
+ * @return Lo que se cobró.
+ */
+int64_t cobrarConsulta(Cuenta& cuenta);
+
+/**
+ * @brief Descuenta un retiro y su costo sin escribir nada.
+ * @return false si el monto no es positivo o el saldo no alcanza (la cuenta no cambia).
+ */
+bool aplicarRetiro(Cuenta& cuenta, int montoRetiro);
+
 /**
  * @brief Consulta el saldo de un usuario según su cédula.
  *
  * Muestra el saldo actual en consola y descuenta 1000 COP como costo de la operación.
  *
- * @param linea Línea de texto del usuario ("cedula,clave,nombre,saldo COP")
+ * @param cuenta Cuenta del usuario.
  * @param cedulaBuscada Cédula del usuario que desea consultar su saldo.
  * @return true si se encontró y actualizó correctamente, false en caso contrario.
  */
-bool consultarSaldoUsuario(string& linea, const string& cedulaBuscada);
+bool consultarSaldoUsuario(Cuenta& cuenta, const string& cedulaBuscada);
 
 /**
  * @brief Retira dinero del saldo de un usuario, cobrando 1000 COP por la operación.
  *
- * @param linea Línea de texto del usuario ("cedula,clave,nombre,saldo COP")
+ * @param cuenta Cuenta del usuario.
  * @param cedulaBuscada Cédula del usuario que realiza el retiro.
  * @param montoRetiro Monto a retirar (debe ser positivo).
  * @return true si el retiro se realizó correctamente, false si hubo error o saldo insuficiente.
  */
-bool modificarDineroUsuario(string& linea, const string& cedulaBuscada, int montoRetiro);
+bool modificarDineroUsuario(Cuenta& cuenta, const string& cedulaBuscada, int montoRetiro);
 
 #endif
@@ -0,0 +1,117 @@
+#include "PoolHilos.h"
+#include <algorithm>
+using namespace std;
+
+/**
+ * @brief Crea los hilos trabajadores; el hilo que llama cuenta como uno más.
+ *
+ * @param numHilos Hilos totales deseados; 0 o negativo usa hardware_concurrency().
+ */
+PoolHilos::PoolHilos(int numHilos) {
+    if (numHilos <= 0)
+        numHilos = static_cast<int>(thread::hardware_concurrency());
+    if (numHilos <= 0)
+        numHilos = 1;
+
+    for (int i = 1; i < numHilos; i++)
+        trabajadores.emplace_back(&PoolHilos::bucleTrabajador, this, i);
+}
+
+/**
+ * @brief Detiene y espera a todos los trabajadores.
+ */
+PoolHilos::~PoolHilos() {
+    {
+        lock_guard<mutex> lk(m);
+        detener = true;
+    }
+    hayTrabajo.notify_all();
+    for (thread& t : trabajadores)
+        t.join();
+}
+
+int PoolHilos::numHilos() const {
+    return static_cast<int>(trabajadores.size()) + 1;
+}
+
+int PoolHilos::trozoSugerido(int total, int numHilos) {
+    if (numHilos <= 1) return max(total, 1);
+    return max(1, total / (numHilos * 4));
+}
+
+/**
+ * @brief Toma trozos del contador compartido hasta que no quede ninguno.
+ */
+void PoolHilos::ejecutarTrozos(int hilo) {
+    try {
+        for (;;) {
+            int inicio = siguiente.fetch_add(trozoActual);
+            if (inicio >= totalActual) break;
+            (*tareaActual)(inicio, min(inicio + trozoActual, totalActual), hilo);
+        }
+    } catch (...) {
+        lock_guard<mutex> lk(m);
+        if (!error) error = current_exception();
+        siguiente.store(totalActual);   // que los demás no tomen más trozos
+    }
+}
+
+/**
+ * @brief Ciclo de vida de un trabajador: esperar tarea, ejecutarla, avisar.
+ */
+void PoolHilos::bucleTrabajador(int indice) {
+    unsigned long vista = 0;
+    for (;;) {
+        {
+            unique_lock<mutex> lk(m);
+            hayTrabajo.wait(lk, [&] { return detener || generacion != vista; });
+            if (detener) return;
+            vista = generacion;
+        }
+
+        ejecutarTrozos(indice);
+
+        lock_guard<mutex> lk(m);
+        if (--pendientes == 0)
+            trabajoTerminado.notify_one();
+    }
+}
+
+/**
+ * @brief Reparte [0, total) entre los hilos y bloquea hasta terminar.
+ */
+void PoolHilos::paraCadaTrozo(int total, int trozo, const Tarea& tarea) {
+    if (total <= 0) return;
+    if (trozo <= 0) trozo = 1;
+
+    if (trabajadores.empty() || total <= trozo) {
+        for (int inicio = 0; inicio < total; inicio += trozo)
+            tarea(inicio, min(inicio + trozo, total), 0);
+        return;
+    }
+
+    lock_guard<mutex> unaTarea(serializar);
+    {
+        lock_guard<mutex> lk(m);
+        tareaActual = &tarea;
+        totalActual = total;
+        trozoActual = trozo;
+        siguiente.store(0);
+        pendientes = static_cast<int>(trabajadores.size());
+        error = nullptr;
+        generacion++;
+    }
+    hayTrabajo.notify_all();
+
+    ejecutarTrozos(0);
+
+    exception_ptr fallo;
+    {
+        unique_lock<mutex> lk(m);
+        trabajoTerminado.wait(lk, [&] { return pendientes == 0; });
+        tareaActual = nullptr;
+        fallo = error;
+    }
+    if (fallo)
+        rethrow_exception(fallo);
+}
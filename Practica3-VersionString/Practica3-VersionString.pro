@@ -1,19 +1,54 @@
 TEMPLATE = app
-CONFIG += console c++17
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
 SOURCES += \
+        AlmacenSegmentado.cpp \
+        ArchivoRanuras.cpp \
+        Bitacora.cpp \
+        PuntoControl.cpp \
+        ServicioCajero.cpp \
+        ArchivoMapeado.cpp \
+        CifradoEmpaquetado.cpp \
+        ClienteCajero.cpp \
+        CifradoFlujo.cpp \
+        ConversionSIMD.cpp \
+        Cuenta.cpp \
         Encriptacion.cpp \
+        ImportacionUsuarios.cpp \
+        IndiceCedulas.cpp \
+        IndicePersistente.cpp \
         ManipulacionArchivo.cpp \
         Menu.cpp \
         OperacionUsuario.cpp \
+        PoolHilos.cpp \
+        ProcesamientoLote.cpp \
+        ProtocoloCajero.cpp \
         Validaciones.cpp \
         main.cpp
 
 HEADERS += \
+    AlmacenSegmentado.h \
+    ArchivoRanuras.h \
+    Bitacora.h \
+    PuntoControl.h \
+    ServicioCajero.h \
+    ArchivoMapeado.h \
+    CifradoEmpaquetado.h \
+    ClienteCajero.h \
+    CifradoFlujo.h \
+    ConversionSIMD.h \
+    Cuenta.h \
     Encriptacion.h \
+    EncriptacionFija.h \
+    ImportacionUsuarios.h \
+    IndiceCedulas.h \
+    IndicePersistente.h \
     ManipulacionArchivos.h \
     Menu.h \
     OperacionesUsuario.h \
+    PoolHilos.h \
+    ProcesamientoLote.h \
+    ProtocoloCajero.h \
     Validaciones.h
@@ -0,0 +1,146 @@
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include "ArchivoMapeado.h"
+#include "OperacionesUsuario.h"
+#include "ProcesamientoLote.h"
+
+using namespace std;
+
+/**
+ * @brief Separa el siguiente campo de la línea (espacios, tabulaciones o comas).
+ * @return El campo, vacío si no quedan más.
+ */
+static string_view siguienteCampo(string_view& resto) {
+    size_t inicio = 0;
+    while (inicio < resto.size() && strchr(" \t,\r", resto[inicio])) inicio++;
+    size_t fin = inicio;
+    while (fin < resto.size() && !strchr(" \t,\r", resto[fin])) fin++;
+    string_view campo = resto.substr(inicio, fin - inicio);
+    resto.remove_prefix(fin);
+    return campo;
+}
+
+/**
+ * @brief Lee un monto entero positivo que quepa en un int.
+ * @return false si el texto no es un monto válido.
+ */
+static bool leerMonto(string_view texto, int& monto) {
+    long long valor = 0;
+    auto [fin, error] = from_chars(texto.data(), texto.data() + texto.size(), valor);
+    if (error != errc() || fin != texto.data() + texto.size() || valor <= 0 || valor > INT_MAX)
+        return false;
+    monto = static_cast<int>(valor);
+    return true;
+}
+
+/**
+ * @brief Aplica una línea del lote.
+ * @return nullptr si la operación se aplicó; si no, el motivo del rechazo.
+ */
+static const char* aplicarLinea(string_view cedula, string_view operacion, string_view argumento,
+                                vector<Cuenta>& cuentas, const IndiceCedulas& indice, vector<char>& autenticadas,
+                                int& posicion, const AlModificarCuenta& alModificar, ResumenLote& resumen) {
+    posicion = indice.buscar(cedula);
+    if (posicion < 0 || posicion >= static_cast<int>(cuentas.size()))
+        return "cédula inexistente";
+    Cuenta& cuenta = cuentas[posicion];
+
+    if (operacion == "auth") {
+        resumen.autenticaciones++;
+        autenticadas[posicion] = argumento == cuenta.clave;
+        return autenticadas[posicion] ? nullptr : "clave incorrecta";
+    }
+    const bool esConsulta = operacion == "consulta";
+    if (!esConsulta && operacion != "retiro")
+        return "operación desconocida";
+    if (esConsulta) resumen.consultas++;
+    else resumen.retiros++;
+    if (!autenticadas[posicion])
+        return "sin autenticar";
+
+    int64_t saldoAntes = cuenta.saldo;
+    MotivoCambio motivo = MotivoCambio::Consulta;
+    if (esConsulta) {
+        resumen.totalCobrado += cobrarConsulta(cuenta);
+    } else {
+        int monto = 0;
+        if (!leerMonto(argumento, monto))
+            return "monto inválido";
+        if (!aplicarRetiro(cuenta, monto))
+            return "fondos insuficientes";
+        resumen.totalRetirado += monto;
+        resumen.totalCobrado += COSTO_RETIRO;
+        motivo = MotivoCambio::Retiro;
+    }
+
+    if (alModificar && cuenta.saldo != saldoAntes)
+        alModificar(posicion, cuenta.saldo - saldoAntes, motivo);
+    return nullptr;
+}
+
+bool procesarLote(const string& rutaLote, const string& rutaResultados, vector<Cuenta>& cuentas,
+                  const IndiceCedulas& indice, const AlModificarCuenta& alModificar, ResumenLote& resumen) {
+    resumen = ResumenLote();
+
+    ArchivoMapeado archivo;
+    try {
+        archivo.abrir(rutaLote);
+    }
+    catch (const char* e) {
+        cerr << "ERROR en procesarLote(): " << e << endl;
+        return false;
+    }
+    ofstream resultados(rutaResultados, ios::trunc);
+    if (!resultados.is_open()) {
+        cerr << "ERROR en procesarLote(): No se pudo crear " << rutaResultados << endl;
+        return false;
+    }
+    resultados << "linea,cedula,operacion,resultado,saldo\n";
+
+    // Sesiones abiertas por cuenta (un auth correcto las abre)
+    vector<char> autenticadas(cuentas.size(), 0);
+
+    auto inicio = chrono::steady_clock::now();
+    const char* datos = archivo.datos();
+    const char* fin = datos + archivo.tamanio();
+    int numLinea = 0;
+    for (const char* p = datos; p < fin; ) {
+        const char* salto = static_cast<const char*>(memchr(p, '\n', fin - p));
+        const char* finFila = salto ? salto : fin;
+        numLinea++;
+        string_view resto(p, finFila - p);
+        p = finFila + 1;
+
+        string_view cedula = siguienteCampo(resto);
+        if (cedula.empty() || cedula[0] == '#')
+            continue;
+        string_view operacion = siguienteCampo(resto);
+        string_view argumento = siguienteCampo(resto);
+        resumen.operaciones++;
+
+        int posicion = -1;
+        const char* error = siguienteCampo(resto).empty()
+            ? aplicarLinea(cedula, operacion, argumento, cuentas, indice, autenticadas, posicion, alModificar, resumen)
+            : "línea inválida";
+        if (error) resumen.rechazadas++;
+        else resumen.exitosas++;
+
+        resultados << numLinea << ',' << cedula << ',' << operacion << ',' << (error ? error : "ok") << ',';
+        if (posicion >= 0 && posicion < static_cast<int>(cuentas.size()))
+            resultados << cuentas[posicion].saldo;
+        resultados << '\n';
+    }
+    resultados.flush();
+    resumen.segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    if (!resultados) {
+        cerr << "ERROR en procesarLote(): No se pudo escribir " << rutaResultados << endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,207 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "ProtocoloCajero.h"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+bool ConexionCajero::conectar(const string&) {
+    cerr << "ERROR en ConexionCajero::conectar(): el servicio de cajeros solo está disponible en sistemas POSIX." << endl;
+    return false;
+}
+bool ConexionCajero::enviarLinea(string_view) { return false; }
+int ConexionCajero::recibirLinea(string&, int) { return 0; }
+void ConexionCajero::cerrar() { fd = -1; }
+int escucharEn(const string&) {
+    cerr << "ERROR en escucharEn(): el servicio de cajeros solo está disponible en sistemas POSIX." << endl;
+    return -1;
+}
+void dejarDeEscuchar(int, const string&) {}
+int aceptarConexion(int, int) { return -1; }
+
+#else
+
+/**
+ * @brief Puerto de una dirección "tcp:PUERTO", o -1 si es la ruta de un socket Unix.
+ */
+static int puertoTcp(const string& direccion) {
+    if (direccion.compare(0, 4, "tcp:") != 0) return -1;
+    int puerto = atoi(direccion.c_str() + 4);
+    return puerto > 0 && puerto < 65536 ? puerto : 0;
+}
+
+/**
+ * @brief Crea el socket y arma la dirección de destino o de escucha.
+ * @return El descriptor, o -1 si la dirección no sirve.
+ */
+static int crearSocket(const string& direccion, sockaddr_storage& destino, socklen_t& largo) {
+    memset(&destino, 0, sizeof(destino));
+    int puerto = puertoTcp(direccion);
+    if (puerto == 0) {
+        cerr << "ERROR: puerto inválido en " << direccion << endl;
+        return -1;
+    }
+    if (puerto > 0) {
+        sockaddr_in& tcp = reinterpret_cast<sockaddr_in&>(destino);
+        tcp.sin_family = AF_INET;
+        tcp.sin_port = htons(static_cast<uint16_t>(puerto));
+        tcp.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        largo = sizeof(sockaddr_in);
+        return socket(AF_INET, SOCK_STREAM, 0);
+    }
+    sockaddr_un& local = reinterpret_cast<sockaddr_un&>(destino);
+    if (direccion.empty() || direccion.size() >= sizeof(local.sun_path)) {
+        cerr << "ERROR: ruta de socket inválida: " << direccion << endl;
+        return -1;
+    }
+    local.sun_family = AF_UNIX;
+    memcpy(local.sun_path, direccion.c_str(), direccion.size() + 1);
+    largo = sizeof(sockaddr_un);
+    return socket(AF_UNIX, SOCK_STREAM, 0);
+}
+
+/**
+ * @brief Desactiva el algoritmo de Nagle: cada respuesta es una línea corta.
+ */
+static void sinRetardo(int fd) {
+    int uno = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &uno, sizeof(uno));
+}
+
+bool ConexionCajero::conectar(const string& direccion) {
+    cerrar();
+    sockaddr_storage destino;
+    socklen_t largo = 0;
+    fd = crearSocket(direccion, destino, largo);
+    if (fd < 0) return false;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&destino), largo) != 0) {
+        cerr << "ERROR: no se pudo conectar con " << direccion << ": " << strerror(errno) << endl;
+        cerrar();
+        return false;
+    }
+    if (puertoTcp(direccion) > 0) sinRetardo(fd);
+    return true;
+}
+
+bool ConexionCajero::enviarLinea(string_view linea) {
+    if (fd < 0) return false;
+    string mensaje(linea);
+    mensaje += '\n';
+    size_t enviados = 0;
+    while (enviados < mensaje.size()) {
+        ssize_t n = send(fd, mensaje.data() + enviados, mensaje.size() - enviados, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        enviados += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+int ConexionCajero::recibirLinea(string& linea, int esperaMs) {
+    while (true) {
+        size_t salto = pendiente.find('\n');
+        if (salto != string::npos) {
+            linea.assign(pendiente, 0, salto);
+            if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+            pendiente.erase(0, salto + 1);
+            return 1;
+        }
+        if (fd < 0 || pendiente.size() > TAM_MAX_LINEA_PROTOCOLO)
+            return 0;
+
+        pollfd espera = { fd, POLLIN, 0 };
+        int listo = poll(&espera, 1, esperaMs);
+        if (listo < 0 && errno == EINTR) return -1;
+        if (listo == 0) return -1;
+        if (listo < 0) return 0;
+
+        char buffer[1024];
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        pendiente.append(buffer, static_cast<size_t>(n));
+    }
+}
+
+bool ConexionCajero::peticion(string_view linea, string& respuesta) {
+    return enviarLinea(linea) && recibirLinea(respuesta) == 1;
+}
+
+void ConexionCajero::cerrar() {
+    if (fd >= 0) close(fd);
+    fd = -1;
+    pendiente.clear();
+}
+
+/**
+ * @brief Borra el socket Unix de `ruta` (el de esta ejecución o uno que quedó de otra).
+ *
+ * Solo borra la ruta si es un socket: una dirección mal escrita que
+ * apunte a un archivo de datos no lo toca.
+ *
+ * @return false si la ruta existe y no es un socket.
+ */
+static bool quitarSocket(const string& ruta) {
+    struct stat info;
+    if (lstat(ruta.c_str(), &info) != 0) return errno == ENOENT;
+    if (!S_ISSOCK(info.st_mode)) return false;
+    unlink(ruta.c_str());
+    return true;
+}
+
+int escucharEn(const string& direccion) {
+    sockaddr_storage local;
+    socklen_t largo = 0;
+    int fd = crearSocket(direccion, local, largo);
+    if (fd < 0) return -1;
+
+    if (puertoTcp(direccion) > 0) {
+        int uno = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &uno, sizeof(uno));
+    } else if (!quitarSocket(direccion)) {
+        cerr << "ERROR en escucharEn(): " << direccion << " existe y no es un socket; no se reemplaza." << endl;
+        close(fd);
+        return -1;
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&local), largo) != 0 || listen(fd, SOMAXCONN) != 0) {
+        cerr << "ERROR en escucharEn(): " << direccion << ": " << strerror(errno) << endl;
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void dejarDeEscuchar(int descriptor, const string& direccion) {
+    if (descriptor < 0) return;
+    close(descriptor);
+    if (puertoTcp(direccion) < 0) quitarSocket(direccion);
+}
+
+int aceptarConexion(int descriptor, int esperaMs) {
+    pollfd espera = { descriptor, POLLIN, 0 };
+    if (poll(&espera, 1, esperaMs) <= 0) return -1;
+    int fd = accept(descriptor, nullptr, nullptr);
+    if (fd >= 0) {
+        sockaddr_storage local;
+        socklen_t largo = sizeof(local);
+        if (getsockname(fd, reinterpret_cast<sockaddr*>(&local), &largo) == 0 && local.ss_family == AF_INET)
+            sinRetardo(fd);
+    }
+    return fd;
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef PROTOCOLO_CAJERO_H
+#define PROTOCOLO_CAJERO_H
+
+#include <string>
+#include <string_view>
+using namespace std;
+
+// ================================================================
+// === Protocolo entre cajeros y servicio =========================
+// ================================================================
+//
+// Cada petición y cada respuesta es una línea de texto terminada en
+// '\n' (a lo sumo TAM_MAX_LINEA_PROTOCOLO caracteres):
+//
+//   auth <cedula> <clave>   ->  ok <nombre>
+//   consulta                ->  ok <saldo> <cobrado>
+//   retiro <monto>          ->  ok <saldo>
+//   salir                   ->  ok            (y se cierra la conexión)
+//
+// Si algo falla la respuesta es "error <motivo>". Igual que en el
+// cajero, consulta y retiro necesitan un auth correcto en la misma
+// conexión y un auth fallido cierra la sesión.
+//
+// La dirección del servicio es la ruta de un socket Unix o
+// "tcp:PUERTO" para escuchar solo en 127.0.0.1 (pruebas).
+
+const size_t TAM_MAX_LINEA_PROTOCOLO = 256;
+
+/**
+ * @brief Conexión de un cajero con el servicio (de cualquiera de los dos lados).
+ */
+class ConexionCajero {
+public:
+    ConexionCajero() = default;
+    /** @brief Toma un socket ya conectado. */
+    explicit ConexionCajero(int descriptor) : fd(descriptor) {}
+    ~ConexionCajero() { cerrar(); }
+
+    ConexionCajero(const ConexionCajero&) = delete;
+    ConexionCajero& operator=(const ConexionCajero&) = delete;
+    ConexionCajero(ConexionCajero&& otra) noexcept : fd(otra.fd), pendiente(move(otra.pendiente)) { otra.fd = -1; }
+
+    /**
+     * @brief Se conecta al servicio.
+     * @return false si no se pudo (el motivo se informa por cerr).
+     */
+    bool conectar(const string& direccion);
+
+    /**
+     * @brief Envía una línea (se le agrega el '\n').
+     * @return false si la conexión se cerró.
+     */
+    bool enviarLinea(string_view linea);
+
+    /**
+     * @brief Lee la siguiente línea, sin el '\n'.
+     * @param esperaMs Tiempo máximo de espera; negativo = sin límite.
+     * @return 1 si leyó una línea, 0 si la conexión se cerró o la línea
+     *         es demasiado larga, -1 si pasó `esperaMs` sin una línea completa.
+     */
+    int recibirLinea(string& linea, int esperaMs = -1);
+
+    /**
+     * @brief Envía una petición y espera su respuesta.
+     * @return false si la conexión se cerró.
+     */
+    bool peticion(string_view linea, string& respuesta);
+
+    void cerrar();
+    bool abierta() const { return fd >= 0; }
+
+private:
+    int fd = -1;
+    string pendiente;       ///< Bytes recibidos después de la última línea entregada
+};
+
+/**
+ * @brief Abre un socket que escucha en la dirección.
+ *
+ * Un socket Unix que haya quedado de una ejecución anterior se reemplaza.
+ *
+ * @return El descriptor, o -1 si no se pudo (el motivo se informa por cerr).
+ */
+int escucharEn(const string& direccion);
+
+/**
+ * @brief Cierra el socket de escucha y, si era Unix, borra su archivo.
+ */
+void dejarDeEscuchar(int descriptor, const string& direccion);
+
+/**
+ * @brief Espera una conexión entrante.
+ * @param esperaMs Tiempo máximo de espera.
+ * @return El socket conectado, o -1 si no llegó ninguna.
+ */
+int aceptarConexion(int descriptor, int esperaMs);
+
+#endif // PROTOCOLO_CAJERO_H
@@ -0,0 +1,164 @@
+#include <chrono>
+#include <cstdio>
+#include "AlmacenSegmentado.h"
+#include "Encriptacion.h"
+#include "IndicePersistente.h"
+#include "PuntoControl.h"
+
+using namespace std;
+
+PuntoControl::~PuntoControl() {
+    detener();
+}
+
+void PuntoControl::iniciar(const string& ruta, const Cuenta* cuentas, int numCuentas, int semilla,
+                           bool empaquetado, PoolHilos& pool, int intervaloSeg, Bitacora* bitacora,
+                           const string& rutaBitacoraVieja) {
+    detener();
+    this->ruta = ruta;
+    this->semilla = semilla;
+    this->empaquetado = empaquetado;
+    this->pool = &pool;
+    this->intervaloSeg = intervaloSeg;
+    this->bitacora = bitacora;
+    this->rutaBitacoraVieja = rutaBitacoraVieja;
+
+    paginas.clear();
+    asegurarPaginas(static_cast<size_t>(max(numCuentas, 1)));
+    for (int i = 0; i < numCuentas; i++)
+        (*paginas[i / CUENTAS_POR_PAGINA_SOMBRA]->cuentas)[i % CUENTAS_POR_PAGINA_SOMBRA] = cuentas[i];
+    numSombra = static_cast<size_t>(max(numCuentas, 0));
+    sucia = false;
+    solicitado = false;
+    detenerHilo = false;
+    numGuardados = 0;
+    hilo = thread(&PuntoControl::bucle, this);
+}
+
+void PuntoControl::detener() {
+    if (!hilo.joinable()) return;
+    {
+        lock_guard<mutex> lock(m);
+        detenerHilo = true;
+    }
+    despertar.notify_all();
+    hilo.join();
+}
+
+void PuntoControl::asegurarPaginas(size_t numCuentas) {
+    size_t necesarias = (numCuentas + CUENTAS_POR_PAGINA_SOMBRA - 1) / CUENTAS_POR_PAGINA_SOMBRA;
+    while (paginas.size() < necesarias)
+        paginas.push_back(make_unique<Pagina>());
+}
+
+void PuntoControl::copiarASombra(int indice, const Cuenta& cuenta) {
+    Pagina& pagina = *paginas[indice / CUENTAS_POR_PAGINA_SOMBRA];
+    lock_guard<mutex> lock(pagina.m);
+    // Si el punto de control todavía la referencia se escribe en una
+    // copia. Él solo toma referencias bajo este candado, así que la cuenta
+    // nunca se queda corta; a lo sumo sobra una copia si la suelta a la vez
+    if (pagina.cuentas.use_count() > 1)
+        pagina.cuentas = make_shared<vector<Cuenta>>(*pagina.cuentas);
+    (*pagina.cuentas)[indice % CUENTAS_POR_PAGINA_SOMBRA] = cuenta;
+}
+
+void PuntoControl::actualizar(int indice, const Cuenta& cuenta) {
+    if (indice < 0 || paginas.empty()) return;
+    if (static_cast<size_t>(indice) < numSombra) {
+        copiarASombra(indice, cuenta);
+    } else {
+        lock_guard<mutex> lock(m);
+        asegurarPaginas(static_cast<size_t>(indice) + 1);
+        copiarASombra(indice, cuenta);
+        numSombra = static_cast<size_t>(indice) + 1;
+    }
+    // Solo se escribe si cambia, para no ir y venir entre núcleos
+    if (!sucia.load(memory_order_relaxed))
+        sucia = true;
+}
+
+void PuntoControl::solicitar() {
+    // Solo el primer pedido despierta al hilo; los demás ya están incluidos
+    if (solicitado.exchange(true)) return;
+    {
+        lock_guard<mutex> lock(m);
+    }
+    despertar.notify_all();
+}
+
+int PuntoControl::guardados() {
+    lock_guard<mutex> lock(m);
+    return numGuardados;
+}
+
+void PuntoControl::bucle() {
+    unique_lock<mutex> lock(m);
+    while (!detenerHilo) {
+        auto listo = [this] { return detenerHilo || solicitado; };
+        if (intervaloSeg > 0)
+            despertar.wait_for(lock, chrono::seconds(intervaloSeg), listo);
+        else
+            despertar.wait(lock, listo);
+        if (detenerHilo) break;
+
+        bool pedido = solicitado.exchange(false);
+        if (!sucia && !pedido) continue;
+
+        // La bitácora se rota antes de tomar la sombra: lo que quede en la
+        // vieja ya está en la sombra. Si la rotación no se puede hacer (no
+        // hay entradas, o la vieja sigue de un intento fallido) se guarda
+        // igual
+        lock.unlock();
+        if (bitacora) bitacora->rotar(rutaBitacoraVieja);
+        lock.lock();
+
+        // Las páginas no se liberan mientras el hilo corre: basta con
+        // anotar cuáles hay y soltar el candado general
+        size_t n = numSombra;
+        vector<Pagina*> actuales;
+        for (size_t p = 0; p * CUENTAS_POR_PAGINA_SOMBRA < n; p++) actuales.push_back(paginas[p].get());
+        sucia = false;
+        lock.unlock();
+
+        // Copia al escribir: solo se toma una referencia a cada página
+        vector<shared_ptr<vector<Cuenta>>> vistas;
+        vistas.reserve(actuales.size());
+        for (Pagina* pagina : actuales) {
+            lock_guard<mutex> lockPagina(pagina->m);
+            vistas.push_back(pagina->cuentas);
+        }
+
+        bool ok = guardar(vistas, n);
+        vistas.clear();
+
+        lock.lock();
+        if (ok)
+            numGuardados++;
+        else
+            sucia = true;   // se reintenta en el próximo intervalo
+    }
+}
+
+bool PuntoControl::guardar(const vector<shared_ptr<vector<Cuenta>>>& vistas, size_t numCuentas) {
+    int n = static_cast<int>(numCuentas);
+    string* lineas = new string[max(n, 1)];
+    vector<uint64_t> cedulas(numCuentas);
+    for (size_t p = 0; p < vistas.size(); p++) {
+        size_t base = p * CUENTAS_POR_PAGINA_SOMBRA;
+        int cuantas = static_cast<int>(min<size_t>(numCuentas - base, CUENTAS_POR_PAGINA_SOMBRA));
+        const Cuenta* cuentas = vistas[p]->data();
+        for (int i = 0; i < cuantas; i++) {
+            lineas[base + i] = serializarCuenta(cuentas[i]);
+            cedulas[base + i] = cuentas[i].cedula;
+        }
+    }
+
+    encriptarArchivo(lineas, n, semilla, *pool);
+    bool ok = guardarAlmacen(ruta, lineas, n, empaquetado, true);
+    if (ok) guardarIndicePersistente(ruta, cedulas.data(), lineas, n);
+    delete[] lineas;
+
+    if (ok && bitacora)
+        remove(rutaBitacoraVieja.c_str());
+    return ok;
+}
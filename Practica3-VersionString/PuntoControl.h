@@ -0,0 +1,140 @@
+#ifndef PUNTO_CONTROL_H
+#define PUNTO_CONTROL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Bitacora.h"
+#include "Cuenta.h"
+#include "PoolHilos.h"
+using namespace std;
+
+// ================================================================
+// === Puntos de control ==========================================
+// ================================================================
+//
+// Un hilo guarda periódicamente el snapshot de usuarios mientras el
+// menú sigue atendiendo. El menú no espera al cifrado ni a la escritura:
+// cada cambio solo copia la cuenta a una tabla sombra, y el hilo toma esa
+// tabla tal como está, la cifra y la guarda con guardarAlmacen(), que
+// escribe en un temporal y lo reemplaza con reemplazarArchivo(). Después
+// rehace el índice de cédulas en disco. El hilo no escribe en la consola:
+// el menú está esperando una opción.
+//
+// La sombra está partida en páginas de CUENTAS_POR_PAGINA_SOMBRA cuentas,
+// cada una con su candado: los cajeros del servicio que cambian cuentas
+// de páginas distintas no se esperan entre sí. El punto de control no
+// copia la tabla (copia al escribir): se queda con una referencia a las
+// cuentas de cada página, y quien cambie una página todavía referenciada
+// la copia antes y sigue sobre la copia. Lo que se está guardando no
+// cambia y nadie espera más que la copia de su página; en memoria queda
+// una sola tabla, más las páginas que cambiaron durante el punto de
+// control. El candado del punto de control solo se toma para agregar
+// páginas, que es cuando llega una cuenta nueva.
+//
+// Con bitácora, el punto de control la rota antes de tomar la sombra:
+// todo lo que quedó en la bitácora vieja ya estaba en la sombra, así que
+// cuando el snapshot está sincronizado con el disco la vieja se borra. Sin bitácora, lo
+// que se puede perder en un corte es a lo sumo un intervalo.
+
+/// Cuentas por página de la tabla sombra (lo que se copia al escribir).
+const int CUENTAS_POR_PAGINA_SOMBRA = 256;
+
+/**
+ * @brief Hilo de puntos de control sobre una copia de las cuentas.
+ */
+class PuntoControl {
+public:
+    PuntoControl() = default;
+    ~PuntoControl();
+
+    PuntoControl(const PuntoControl&) = delete;
+    PuntoControl& operator=(const PuntoControl&) = delete;
+
+    /**
+     * @brief Arranca el hilo con una copia de las cuentas actuales.
+     *
+     * @param ruta Ruta del almacén de usuarios.
+     * @param cuentas Cuentas en memoria.
+     * @param numCuentas Cantidad de cuentas.
+     * @param semilla Semilla de encriptación.
+     * @param empaquetado true para el formato empaquetado.
+     * @param pool Pool de hilos para cifrar (no debe usarse a la vez desde otro hilo).
+     * @param intervaloSeg Segundos entre puntos de control; 0 = solo a pedido.
+     * @param bitacora Bitácora a rotar en cada punto de control, o nullptr.
+     * @param rutaBitacoraVieja Ruta a la que se rota la bitácora.
+     */
+    void iniciar(const string& ruta, const Cuenta* cuentas, int numCuentas, int semilla, bool empaquetado,
+                 PoolHilos& pool, int intervaloSeg, Bitacora* bitacora = nullptr,
+                 const string& rutaBitacoraVieja = "");
+
+    /**
+     * @brief Detiene el hilo sin guardar lo pendiente (lo guarda main al salir).
+     */
+    void detener();
+
+    bool activo() const { return hilo.joinable(); }
+
+    /**
+     * @brief Copia a la sombra la cuenta `indice` (una cuenta nueva va al final).
+     *
+     * Solo toma el candado de la página de la cuenta. Una cuenta nueva
+     * puede agregar páginas, así que no debe coincidir con cambios desde
+     * otros hilos (el servicio no agrega cuentas). Con bitácora debe
+     * llamarse antes de registrar el movimiento.
+     */
+    void actualizar(int indice, const Cuenta& cuenta);
+
+    /**
+     * @brief Pide un punto de control sin esperar al intervalo.
+     */
+    void solicitar();
+
+    /**
+     * @brief Puntos de control guardados desde iniciar().
+     */
+    int guardados();
+
+private:
+    /**
+     * @brief Una página de la sombra con su propio candado.
+     *
+     * Alineada a 64 bytes para que los candados de dos páginas no
+     * compartan línea de caché.
+     */
+    struct alignas(64) Pagina {
+        mutex m;
+        /// Compartidas con el punto de control en curso mientras lo guarda
+        shared_ptr<vector<Cuenta>> cuentas = make_shared<vector<Cuenta>>(CUENTAS_POR_PAGINA_SOMBRA);
+    };
+
+    void bucle();
+    bool guardar(const vector<shared_ptr<vector<Cuenta>>>& vistas, size_t numCuentas);
+    void asegurarPaginas(size_t numCuentas);
+    void copiarASombra(int indice, const Cuenta& cuenta);
+
+    string ruta;
+    int semilla = 0;
+    bool empaquetado = false;
+    PoolHilos* pool = nullptr;
+    int intervaloSeg = 0;
+    Bitacora* bitacora = nullptr;
+    string rutaBitacoraVieja;
+
+    thread hilo;
+    mutex m;                            ///< Estado del hilo y lista de páginas
+    condition_variable despertar;
+    vector<unique_ptr<Pagina>> paginas; ///< Cuentas tal como las dejó el menú
+    atomic<size_t> numSombra{0};
+    atomic<bool> sucia{false};          ///< Hay cambios desde el último punto de control
+    atomic<bool> solicitado{false};
+    bool detenerHilo = false;
+    int numGuardados = 0;
+};
+
+#endif // PUNTO_CONTROL_H
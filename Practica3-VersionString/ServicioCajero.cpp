@@ -0,0 +1,156 @@
+#include <charconv>
+#include <climits>
+#include <csignal>
+#include <iostream>
+#include <thread>
+#include "OperacionesUsuario.h"
+#include "ServicioCajero.h"
+
+using namespace std;
+
+/** Cada cuánto revisan los hilos si deben terminar. */
+const int ESPERA_REVISION_MS = 250;
+
+/**
+ * SIGINT o SIGTERM recibida mientras se atiende. El manejador puede
+ * correr en cualquier hilo: un atómico sin bloqueo es seguro en él.
+ */
+static atomic<bool> senalRecibida{false};
+
+static void alRecibirSenal(int) {
+    senalRecibida = true;
+}
+
+/**
+ * @brief Separa el siguiente campo (separado por espacios) de `resto`.
+ */
+static string_view siguienteCampo(string_view& resto) {
+    size_t inicio = resto.find_first_not_of(' ');
+    if (inicio == string_view::npos) {
+        resto = string_view();
+        return resto;
+    }
+    size_t fin = resto.find(' ', inicio);
+    if (fin == string_view::npos) fin = resto.size();
+    string_view campo = resto.substr(inicio, fin - inicio);
+    resto.remove_prefix(fin);
+    return campo;
+}
+
+ServicioCajero::ServicioCajero(vector<Cuenta>& cuentas, const IndiceCedulas& indice, AlModificarCuenta alModificar,
+                               function<void()> esperarPersistencia)
+    : cuentas(cuentas), indice(indice), alModificar(move(alModificar)),
+      esperarPersistencia(move(esperarPersistencia)) {}
+
+bool ServicioCajero::atender(const string& direccion) {
+    int escucha = escucharEn(direccion);
+    if (escucha < 0) return false;
+
+    senalRecibida = false;
+    auto anteriorInt = signal(SIGINT, alRecibirSenal);
+    auto anteriorTerm = signal(SIGTERM, alRecibirSenal);
+
+    while (!detenido && !senalRecibida) {
+        int fd = aceptarConexion(escucha, ESPERA_REVISION_MS);
+        if (fd < 0) continue;
+        {
+            lock_guard<mutex> lock(sesionesMutex);
+            sesionesAbiertas++;
+        }
+        sesiones++;
+        thread(&ServicioCajero::atenderSesion, this, ConexionCajero(fd)).detach();
+    }
+    detenido = true;
+    dejarDeEscuchar(escucha, direccion);
+
+    // Las sesiones ven `detenido` en su siguiente revisión
+    unique_lock<mutex> lock(sesionesMutex);
+    sesionTerminada.wait(lock, [this] { return sesionesAbiertas == 0; });
+    lock.unlock();
+
+    signal(SIGINT, anteriorInt);
+    signal(SIGTERM, anteriorTerm);
+    return true;
+}
+
+void ServicioCajero::atenderSesion(ConexionCajero conexion) {
+    int sesion = -1;
+    bool salir = false;
+    string peticion;
+    while (!salir && !detenido) {
+        int leida = conexion.recibirLinea(peticion, ESPERA_REVISION_MS);
+        if (leida < 0) continue;
+        if (leida == 0) break;
+        peticiones++;
+        if (!conexion.enviarLinea(responder(peticion, sesion, salir))) break;
+    }
+    conexion.cerrar();
+
+    lock_guard<mutex> lock(sesionesMutex);
+    sesionesAbiertas--;
+    sesionTerminada.notify_all();
+}
+
+mutex& ServicioCajero::franjaDe(const Cuenta& cuenta) {
+    // El mismo hash multiplicativo del índice de cédulas
+    return franjas[(cuenta.cedula * 0x9E3779B97F4A7C15ULL) >> (64 - BITS_FRANJAS_CUENTAS)].m;
+}
+
+string ServicioCajero::responder(string_view peticion, int& sesion, bool& salir) {
+    string_view resto = peticion;
+    string_view orden = siguienteCampo(resto);
+
+    if (orden == "auth") {
+        string_view cedula = siguienteCampo(resto);
+        string_view clave = siguienteCampo(resto);
+        sesion = -1;
+        int i = indice.buscar(cedula);
+        if (i < 0 || i >= static_cast<int>(cuentas.size()))
+            return "error cédula inexistente";
+        if (clave != cuentas[i].clave)
+            return "error clave incorrecta";
+        sesion = i;
+        return string("ok ") + cuentas[i].nombre;
+    }
+    if (orden == "salir") {
+        salir = true;
+        return "ok";
+    }
+    const bool esConsulta = orden == "consulta";
+    if (!esConsulta && orden != "retiro")
+        return "error operación desconocida";
+    if (sesion < 0)
+        return "error sin autenticar";
+
+    int monto = 0;
+    if (!esConsulta) {
+        string_view texto = siguienteCampo(resto);
+        long long valor = 0;
+        auto [fin, error] = from_chars(texto.data(), texto.data() + texto.size(), valor);
+        if (texto.empty() || error != errc() || fin != texto.data() + texto.size() || valor <= 0 || valor > INT_MAX)
+            return "error monto inválido";
+        monto = static_cast<int>(valor);
+    }
+
+    int64_t saldo = 0, cobrado = 0;
+    bool cambio = false;
+    {
+        Cuenta& cuenta = cuentas[sesion];
+        lock_guard<mutex> lock(franjaDe(cuenta));
+        int64_t saldoAntes = cuenta.saldo;
+        if (esConsulta)
+            cobrado = cobrarConsulta(cuenta);
+        else if (!aplicarRetiro(cuenta, monto))
+            return "error fondos insuficientes";
+        saldo = cuenta.saldo;
+        cambio = saldo != saldoAntes;
+        if (cambio && alModificar)
+            alModificar(sesion, saldo - saldoAntes, esConsulta ? MotivoCambio::Consulta : MotivoCambio::Retiro);
+    }
+    if (cambio && esperarPersistencia)
+        esperarPersistencia();
+
+    if (esConsulta)
+        return "ok " + to_string(saldo) + " " + to_string(cobrado);
+    return "ok " + to_string(saldo);
+}
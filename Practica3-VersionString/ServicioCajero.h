@@ -0,0 +1,98 @@
+#ifndef SERVICIO_CAJERO_H
+#define SERVICIO_CAJERO_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Cuenta.h"
+#include "IndiceCedulas.h"
+#include "Menu.h"
+#include "ProtocoloCajero.h"
+using namespace std;
+
+// ================================================================
+// === Servicio de cajeros ========================================
+// ================================================================
+//
+// Las cuentas se cargan una sola vez y muchos cajeros se conectan a la
+// vez (protocolo en ProtocoloCajero.h); cada conexión se atiende en su
+// propio hilo. Las consultas y los retiros siguen las reglas del menú
+// de usuario y cada cambio se avisa con `alModificar` mientras la
+// cuenta está bloqueada. El bloqueo no es de toda la tabla: las cuentas
+// se reparten en franjas por el hash de la cédula, cada una con su
+// mutex en su propia línea de caché, así que los cajeros que operan
+// sobre cuentas distintas casi nunca se esperan (y `alModificar` puede
+// llamarse a la vez para cuentas de franjas distintas). La respuesta
+// sale después de `esperarPersistencia`, fuera del bloqueo: las esperas
+// de disco de varios cajeros se juntan en la misma sincronización de la
+// bitácora.
+
+/** Franjas de bloqueo de cuentas: 1 << BITS_FRANJAS_CUENTAS. */
+const int BITS_FRANJAS_CUENTAS = 8;
+
+/**
+ * @brief Servicio que atiende cajeros remotos sobre las cuentas cargadas.
+ */
+class ServicioCajero {
+public:
+    /**
+     * @param cuentas Cuentas de usuarios (no se agregan cuentas mientras atiende).
+     * @param indice Índice de cédulas de `cuentas`.
+     * @param alModificar Aviso de cada cambio (se llama con la franja de la
+     *        cuenta bloqueada; debe admitir llamadas simultáneas).
+     * @param esperarPersistencia Se llama sin bloqueo antes de responder un
+     *        cambio; vuelve cuando el cambio ya es durable.
+     */
+    ServicioCajero(vector<Cuenta>& cuentas, const IndiceCedulas& indice, AlModificarCuenta alModificar,
+                   function<void()> esperarPersistencia);
+
+    ServicioCajero(const ServicioCajero&) = delete;
+    ServicioCajero& operator=(const ServicioCajero&) = delete;
+
+    /**
+     * @brief Atiende conexiones hasta recibir SIGINT o SIGTERM (o detener()).
+     *
+     * Al terminar deja de aceptar, espera a que se cierren las sesiones
+     * abiertas y vuelve.
+     *
+     * @return false si no se pudo escuchar en la dirección.
+     */
+    bool atender(const string& direccion);
+
+    /**
+     * @brief Pide que atender() termine.
+     */
+    void detener() { detenido = true; }
+
+    int sesionesAtendidas() const { return sesiones; }
+    uint64_t peticionesAtendidas() const { return peticiones; }
+
+private:
+    void atenderSesion(ConexionCajero conexion);
+    string responder(string_view peticion, int& sesion, bool& salir);
+
+    /** Un mutex por línea de caché: franjas vecinas no comparten línea. */
+    struct alignas(64) FranjaCuentas {
+        mutex m;
+    };
+    mutex& franjaDe(const Cuenta& cuenta);
+
+    vector<Cuenta>& cuentas;
+    const IndiceCedulas& indice;
+    AlModificarCuenta alModificar;
+    function<void()> esperarPersistencia;
+
+    FranjaCuentas franjas[1 << BITS_FRANJAS_CUENTAS];  ///< Protegen saldos y avisos de cambio
+    mutex sesionesMutex;
+    condition_variable sesionTerminada;
+    int sesionesAbiertas = 0;
+    atomic<bool> detenido{false};
+    atomic<int> sesiones{0};
+    atomic<uint64_t> peticiones{0};
+};
+
+#endif // SERVICIO_CAJERO_H
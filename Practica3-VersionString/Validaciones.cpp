@@ -16,31 +16,34 @@ using namespace std;
  * - No puede comenzar con '0'.
  *
  * @param cedula Cadena que representa el número de cédula.
- * @return true si la cédula es válida, false en caso contrario.
- * @throws const char* Si la cédula está vacía, contiene letras o no cumple los requisitos.
+ * @return nullptr si la cédula es válida; si no, el motivo del rechazo.
  */
-bool validarCedula(const string& cedula) {
-    try {
-        if (cedula.empty())
-            throw "La cédula está vacía.";
-
-        if (cedula.size() < 6 || cedula.size() > 10)
-            throw "La cédula debe tener entre 6 y 10 dígitos.";
+const char* errorCedula(const string& cedula) {
+    if (cedula.empty())
+        return "La cédula está vacía.";
 
-        if (cedula[0] == '0')
-            throw "La cédula no puede comenzar con 0.";
+    if (cedula.size() < 6 || cedula.size() > 10)
+        return "La cédula debe tener entre 6 y 10 dígitos.";
 
-        for (char c : cedula) {
-            if (c < '0' || c > '9')
-                throw "La cédula contiene caracteres no numéricos.";
-        }
+    if (cedula[0] == '0')
+        return "La cédula no puede comenzar con 0.";
 
-        return true;
-    }
-    catch (const char* msg) {
-        cerr << "Error en validarCedula: " << msg << endl;
-        return false;
+    for (char c : cedula) {
+        if (c < '0' || c > '9')
+            return "La cédula contiene caracteres no numéricos.";
     }
+
+    return nullptr;
+}
+
+/**
+ * @brief Igual que errorCedula(), informando el motivo por cerr.
+ */
+bool validarCedula(const string& cedula) {
+    const char* error = errorCedula(cedula);
+    if (error != nullptr)
+        cerr << "Error en validarCedula: " << error << endl;
+    return error == nullptr;
 }
 
 // ================================
@@ -57,43 +60,46 @@ bool validarCedula(const string& cedula) {
  * - Solo se permiten caracteres ASCII imprimibles (33–126).
  *
  * @param clave Cadena que representa la contraseña a validar.
- * @return true si la contraseña es válida, false en caso contrario.
- * @throws const char* Si la contraseña no cumple alguna de las condiciones anteriores.
+ * @return nullptr si la contraseña es válida; si no, el motivo del rechazo.
  */
-bool validarContrasena(const string& clave) {
-    try {
-        if (clave.empty())
-            throw "La contraseña está vacía.";
-
-        if (clave.size() < 8 || clave.size() > 20)
-            throw "La contraseña debe tener entre 8 y 20 caracteres.";
-
-        bool tieneNumero = false;
-        bool tieneMayuscula = false;
-        bool tieneMinuscula = false;
-        bool tieneEspecial = false;
-
-        for (unsigned char c : clave) {
-            if (c >= '0' && c <= '9') tieneNumero = true;
-            else if (c >= 'A' && c <= 'Z') tieneMayuscula = true;
-            else if (c >= 'a' && c <= 'z') tieneMinuscula = true;
-            else if (c == ' ' || c == '\t')
-                throw "La contraseña contiene espacios o tabulaciones.";
-            else if (c >= 33 && c <= 126)
-                tieneEspecial = true;
-            else
-                throw "La contraseña contiene caracteres no válidos.";
-        }
-
-        if (!(tieneNumero && tieneMayuscula && tieneMinuscula && tieneEspecial))
-            throw "La contraseña no cumple con los requisitos de complejidad.";
-
-        return true;
-    }
-    catch (const char* msg) {
-        cerr << "Error en validarContrasena: " << msg << endl;
-        return false;
+const char* errorContrasena(const string& clave) {
+    if (clave.empty())
+        return "La contraseña está vacía.";
+
+    if (clave.size() < 8 || clave.size() > 20)
+        return "La contraseña debe tener entre 8 y 20 caracteres.";
+
+    bool tieneNumero = false;
+    bool tieneMayuscula = false;
+    bool tieneMinuscula = false;
+    bool tieneEspecial = false;
+
+    for (unsigned char c : clave) {
+        if (c >= '0' && c <= '9') tieneNumero = true;
+        else if (c >= 'A' && c <= 'Z') tieneMayuscula = true;
+        else if (c >= 'a' && c <= 'z') tieneMinuscula = true;
+        else if (c == ' ' || c == '\t')
+            return "La contraseña contiene espacios o tabulaciones.";
+        else if (c >= 33 && c <= 126)
+            tieneEspecial = true;
+        else
+            return "La contraseña contiene caracteres no válidos.";
     }
+
+    if (!(tieneNumero && tieneMayuscula && tieneMinuscula && tieneEspecial))
+        return "La contraseña no cumple con los requisitos de complejidad.";
+
+    return nullptr;
+}
+
+/**
+ * @brief Igual que errorContrasena(), informando el motivo por cerr.
+ */
+bool validarContrasena(const string& clave) {
+    const char* error = errorContrasena(clave);
+    if (error != nullptr)
+        cerr << "Error en validarContrasena: " << error << endl;
+    return error == nullptr;
 }
 
 // ================================
@@ -109,29 +115,32 @@ bool validarContrasena(const string& clave) {
  * - Valor numérico entre **0 y 1,000,000**.
  *
  * @param saldoStr Cadena que representa el saldo.
- * @return true si el saldo es válido, false en caso contrario.
- * @throws const char* Si el saldo está vacío, contiene letras o excede el máximo permitido.
+ * @return nullptr si el saldo es válido; si no, el motivo del rechazo.
  */
-bool validarSaldo(const string& saldoStr) {
-    try {
-        if (saldoStr.empty())
-            throw "El saldo está vacío.";
-
-        long saldo = 0;
+const char* errorSaldo(const string& saldoStr) {
+    if (saldoStr.empty())
+        return "El saldo está vacío.";
 
-        for (char c : saldoStr) {
-            if (c < '0' || c > '9')
-                throw "El saldo contiene caracteres no numéricos.";
+    long saldo = 0;
 
-            saldo = saldo * 10 + (c - '0');
-            if (saldo > 1000000)
-                throw "El saldo excede el máximo permitido (1,000,000).";
-        }
+    for (char c : saldoStr) {
+        if (c < '0' || c > '9')
+            return "El saldo contiene caracteres no numéricos.";
 
-        return (saldo >= 0 && saldo <= 1000000);
-    }
-    catch (const char* msg) {
-        cerr << "Error en validarSaldo: " << msg << endl;
-        return false;
+        saldo = saldo * 10 + (c - '0');
+        if (saldo > 1000000)
+            return "El saldo excede el máximo permitido (1,000,000).";
     }
+
+    return nullptr;
+}
+
+/**
+ * @brief Igual que errorSaldo(), informando el motivo por cerr.
+ */
+bool validarSaldo(const string& saldoStr) {
+    const char* error = errorSaldo(saldoStr);
+    if (error != nullptr)
+        cerr << "Error en validarSaldo: " << error << endl;
+    return error == nullptr;
 }
@@ -10,6 +10,12 @@
  */
 bool validarCedula(const std::string& cedula);
 
+/**
+ * @brief Igual que validarCedula(), sin escribir nada.
+ * @return nullptr si la cédula es válida; si no, el motivo del rechazo.
+ */
+const char* errorCedula(const std::string& cedula);
+
 /**
  * @brief Valida si una cadena cumple los requisitos de una contraseña segura.
  * @param clave Cadena con la contraseña.
@@ -17,6 +23,12 @@ bool validarCedula(const std::string& cedula);
  */
 bool validarContrasena(const std::string& clave);
 
+/**
+ * @brief Igual que validarContrasena(), sin escribir nada.
+ * @return nullptr si la contraseña es válida; si no, el motivo del rechazo.
+ */
+const char* errorContrasena(const std::string& clave);
+
 /**
  * @brief Valida si una cadena representa un saldo monetario válido.
  * @param saldoStr Cadena con el valor del saldo.
@@ -24,4 +36,10 @@ bool validarContrasena(const std::string& clave);
  */
 bool validarSaldo(const std::string& saldoStr);
 
+/**
+ * @brief Igual que validarSaldo(), sin escribir nada.
+ * @return nullptr si el saldo es válido; si no, el motivo del rechazo.
+ */
+const char* errorSaldo(const std::string& saldoStr);
+
 #endif // VALIDACIONES_H
@@ -6,42 +6,354 @@
  * ejecucion del menu principal y guardado confiable de datos.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 #include "Menu.h"
+#include "AlmacenSegmentado.h"
+#include "ArchivoRanuras.h"
+#include "Bitacora.h"
+#include "CifradoFlujo.h"
+#include "ClienteCajero.h"
+#include "Cuenta.h"
 #include "Encriptacion.h"
+#include "ImportacionUsuarios.h"
+#include "IndiceCedulas.h"
+#include "IndicePersistente.h"
 #include "ManipulacionArchivos.h"
+#include "PoolHilos.h"
+#include "ProcesamientoLote.h"
+#include "PuntoControl.h"
+#include "ServicioCajero.h"
 
 using namespace std;
 
+/**
+ * @brief Guarda las cuentas cifrando solo las que cambiaron.
+ *
+ * `cifradas` guarda el texto cifrado de cada cuenta tal como esta en el
+ * archivo. Las cuentas marcadas como modificadas (o sin texto cifrado,
+ * como las recien registradas) se serializan y se cifran; las demas
+ * reutilizan su texto cifrado. Si no hay cambios el archivo no se toca.
+ * Tras guardar, la cache queda al dia y las marcas se limpian.
+ *
+ * @param ruta Ruta del almacen de usuarios.
+ * @param cuentas Cuentas en memoria.
+ * @param cifradas Cache de texto cifrado (crece si hay cuentas nuevas).
+ * @param semilla Semilla de encriptacion.
+ * @param empaquetado true para el formato empaquetado.
+ * @param pool Pool de hilos para cifrar.
+ * @return Cantidad de cuentas cifradas de nuevo.
+ * @throws const char* Si no se pudo escribir el almacen.
+ */
+static int guardarCuentas(const string& ruta, vector<Cuenta>& cuentas, vector<string>& cifradas,
+                          int semilla, bool empaquetado, PoolHilos& pool) {
+    const int numCuentas = static_cast<int>(cuentas.size());
+    if (static_cast<int>(cifradas.size()) < numCuentas)
+        cifradas.resize(numCuentas);
+
+    vector<int> pendientes;
+    for (int i = 0; i < numCuentas; i++)
+        if (cuentas[i].modificada || cifradas[i].empty())
+            pendientes.push_back(i);
+    if (pendientes.empty())
+        return 0;
+
+    int cantidad = static_cast<int>(pendientes.size());
+    vector<string> nuevas(cantidad);
+    for (int j = 0; j < cantidad; j++)
+        nuevas[j] = serializarCuenta(cuentas[pendientes[j]]);
+    encriptarArchivo(nuevas.data(), cantidad, semilla, pool);
+    for (int j = 0; j < cantidad; j++)
+        cifradas[pendientes[j]] = move(nuevas[j]);
+
+    if (!guardarAlmacen(ruta, cifradas.data(), numCuentas, empaquetado))
+        throw "No se pudo guardar el archivo de usuarios.";
+
+    for (int i : pendientes)
+        cuentas[i].modificada = false;
+    return cantidad;
+}
+
+/**
+ * @brief Aplica sobre las cuentas cargadas las bitacoras que quedaron
+ *        de una sesion anterior.
+ *
+ * Se leen en orden la bitacora vieja (de una compactacion que no
+ * termino) y la actual. Cada entrada trae la cuenta como quedo, asi que
+ * las que ya estaban en el snapshot no cambian nada; un alta que no esta
+ * en el snapshot se agrega al final. Las cuentas que cambian quedan
+ * marcadas como modificadas.
+ *
+ * @param rutas Bitacoras, de la mas antigua a la mas nueva.
+ * @param numRutas Cantidad de bitacoras.
+ * @param semilla Semilla de encriptacion.
+ * @param cuentas Cuentas cargadas (las altas se agregan al final).
+ * @param indice Indice de cedulas de las cuentas.
+ * @param ultimaSecuencia Recibe la secuencia de la ultima entrada leida.
+ * @return Cantidad de cuentas que cambiaron.
+ * @throws const char* Si alguna bitacora esta danada.
+ */
+static int reproducirBitacoras(const string* rutas, int numRutas, int semilla, vector<Cuenta>& cuentas,
+                               IndiceCedulas& indice, uint64_t& ultimaSecuencia) {
+    const size_t numCargadas = cuentas.size();
+    vector<bool> cambiadas(numCargadas, false);
+    int altas = 0;
+    int huerfanas = 0;
+
+    auto aplicar = [&](const MovimientoCuenta& mov) {
+        ultimaSecuencia = mov.secuencia;
+        int i = indice.buscar(mov.cuenta.cedula);
+        if (i < 0) {
+            if (mov.motivo != MotivoCambio::Alta) {
+                huerfanas++;
+                return;
+            }
+            indice.insertar(mov.cuenta.cedula, static_cast<int>(cuentas.size()));
+            cuentas.push_back(mov.cuenta);
+            cuentas.back().modificada = true;
+            altas++;
+            return;
+        }
+        Cuenta& cuenta = cuentas[i];
+        if (cuenta.saldo != mov.cuenta.saldo) {
+            cuenta.saldo = mov.cuenta.saldo;
+            cuenta.modificada = true;
+            if (static_cast<size_t>(i) < numCargadas) cambiadas[i] = true;
+        }
+    };
+
+    for (int r = 0; r < numRutas; r++)
+        if (Bitacora::reproducir(rutas[r], semilla, aplicar) < 0)
+            throw "La bitacora de movimientos esta danada; no se puede recuperar la sesion anterior.";
+
+    if (huerfanas > 0)
+        cerr << "Advertencia: " << huerfanas << " movimiento(s) de cuentas inexistentes se ignoraron.\n";
+
+    int total = altas;
+    for (bool cambiada : cambiadas) total += cambiada;
+    return total;
+}
+
+/**
+ * @brief Consulta una cedula en el indice en disco y trae solo su registro.
+ *
+ * En un almacen segmentado se ubica el registro en el manifiesto y se
+ * carga unicamente su segmento; un archivo suelto se proyecta completo.
+ * Del registro se muestran el titular y el saldo (nunca la clave).
+ *
+ * @return 0 si la cedula existe, 1 si no existe o el indice no sirve.
+ */
+static int consultarIndiceCedulas(const string& rutaUsuarios, const string& cedula, int semilla) {
+    IndicePersistente indice;
+    if (!indice.abrir(rutaUsuarios)) {
+        cerr << "El indice de cedulas no existe o esta desactualizado (se rehace al iniciar el cajero).\n";
+        return 1;
+    }
+    UbicacionRegistro ubicacion;
+    if (!indice.buscar(cedula, ubicacion)) {
+        cout << "Cedula " << cedula << ": no registrada.\n";
+        return 1;
+    }
+    cout << "Cedula " << cedula << ": registro " << ubicacion.registro << ", segmento " << ubicacion.segmento
+         << ", byte " << ubicacion.desplazamiento << " (" << ubicacion.longitud << " bytes).\n";
+
+    LineasMapeadas lineas;
+    uint64_t local = ubicacion.registro;
+    bool cargado;
+    if (esManifiestoSegmentado(rutaUsuarios)) {
+        ManifiestoAlmacen manifiesto;
+        size_t segmento = 0;
+        cargado = leerManifiesto(rutaUsuarios, manifiesto)
+                  && localizarRegistro(manifiesto, ubicacion.registro, segmento, local)
+                  && segmento == ubicacion.segmento
+                  && cargarSegmento(rutaUsuarios, manifiesto, segmento, lineas);
+    } else {
+        cargado = cargarLineasMapeadas(rutaUsuarios, lineas);
+    }
+
+    Cuenta cuenta;
+    bool valido = false;
+    if (cargado && local < lineas.vistas.size()) {
+        PoolHilos pool(1);
+        string* plano = desencriptarVistas(&lineas.vistas[local], 1, semilla, pool);
+        valido = plano != nullptr && parsearCuenta(plano[0], cuenta) && cuenta.cedula == empaquetarCedula(cedula);
+        delete[] plano;
+    }
+    if (!valido) {
+        cerr << "El registro no coincide con los datos (se rehace el indice al iniciar el cajero).\n";
+        return 1;
+    }
+    cout << "  Titular: " << cuenta.nombre << ", saldo " << cuenta.saldo << " COP.\n";
+    return 0;
+}
+
+/**
+ * @brief Primera linea no vacia de un archivo suelto de texto, o "" si
+ *        no existe o esta en otro formato (empaquetado, ranuras o segmentos).
+ */
+static string primeraLineaTexto(const string& ruta) {
+    if (esManifiestoSegmentado(ruta) || esArchivoEmpaquetado(ruta) || esArchivoRanuras(ruta))
+        return "";
+    ifstream archivo(ruta, ios::binary);
+    string linea;
+    while (linea.empty() && getline(archivo, linea))
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+    return linea;
+}
+
 /**
  * @brief Funcion principal de la aplicacion.
  *
  * Ejecuta la secuencia principal de carga, encriptacion, desencriptacion,
- * menu principal y guardado seguro de datos.
+ * menu principal y guardado seguro de datos. Con el argumento `--migrar`
+ * solo convierte los archivos de datos al formato empaquetado y termina;
+ * con `--ranuras` convierte el archivo de usuarios a ranuras fijas. Si el
+ * archivo de usuarios esta en ranuras, cada cambio de una cuenta se
+ * escribe en el momento en su ranura; `--fsync=N` sincroniza a disco cada
+ * N escrituras (1 por defecto, 0 = solo al cerrar).
+ *
+ * En el primer arranque, si los dos archivos son de texto y siguen en
+ * texto plano, se cifran por flujo sin cargarlos (encriptarAlmacenFlujo()),
+ * asi que su tamano no esta limitado por la carga; si el binario no cabe
+ * en un archivo queda en un almacen segmentado.
+ *
+ * En los demas formatos cada movimiento se agrega a una bitacora cifrada
+ * antes de seguir; al arrancar se reproduce la que haya quedado de una
+ * sesion interrumpida. Un hilo guarda un punto de control cada
+ * `--punto-control=S` segundos (30 por defecto, 0 = solo cuando la
+ * bitacora crece) sin detener el menu. Con `--sin-bitacora` no se
+ * registra cada movimiento y un corte pierde a lo sumo un intervalo.
+ *
+ * Junto al archivo de usuarios se mantiene un indice de cedulas en disco;
+ * `--buscar-cedula=X` lo consulta, informa en que byte empieza el
+ * registro y trae solo ese registro (en un almacen segmentado, solo su
+ * segmento) para mostrar el titular y el saldo.
+ *
+ * `--importar=archivo.csv` carga en bloque usuarios "cedula,clave,nombre,
+ * saldo": pide las credenciales de un administrador, agrega las filas
+ * validas, guarda una sola vez y deja las rechazadas en
+ * "archivo.csv.rechazos".
+ *
+ * `--lote=archivo` aplica sin menu las operaciones del archivo (`auth`,
+ * `consulta`, `retiro <monto>` por cedula, ver ProcesamientoLote.h),
+ * deja el resultado de cada una en "archivo.resultados" e informa el
+ * rendimiento. Los cambios pasan por la misma bitacora o ranuras que
+ * los del menu y se guardan al terminar.
+ *
+ * `--servicio=DIRECCION` carga las cuentas una vez y atiende muchos
+ * cajeros a la vez sobre un socket Unix (DIRECCION es su ruta) o sobre
+ * "tcp:PUERTO" en 127.0.0.1, hasta recibir Ctrl+C; al terminar guarda
+ * como el menu. `--cliente=DIRECCION` es el menu del cajero contra ese
+ * servicio y `--carga=DIRECCION` lo somete a carga (`--clientes=N`,
+ * `--peticiones=N`, `--credenciales=archivo.csv`, una cuenta por
+ * conexion como minimo; con `--escalado` mide con 1, 2, 4, ... hasta N
+ * conexiones y termina con 1 si el rendimiento no crece con ellas, para
+ * lo que el servicio debe correr con `--sin-bitacora`). El protocolo esta en
+ * ProtocoloCajero.h.
  *
  * @return Codigo de salida del programa: 0 exito, 1 error controlado.
  */
-int main() {
+int main(int argc, char* argv[]) {
     const string rutaUsuarios = "../../Datos/usuarios.bin";
     const string rutaAdmins   = "../../Datos/sudo.bin";
     const int SEMILLA = 4;
+    const int NUM_HILOS = 0;   // 0 = un hilo por núcleo disponible
+    const uint64_t TAM_COMPACTAR_BITACORA = 1 << 20;   // bytes de bitácora antes de un punto de control
     int numUsuarios = 0, numAdmins = 0;
 
+    if (argc > 1 && string(argv[1]) == "--migrar") {
+        bool ok = migrarArchivoEmpaquetado(rutaUsuarios);
+        ok = migrarArchivoEmpaquetado(rutaAdmins) && ok;
+        return ok ? 0 : 1;
+    }
+    if (argc > 1 && string(argv[1]) == "--ranuras")
+        return migrarArchivoRanuras(rutaUsuarios) ? 0 : 1;
+    if (argc > 1 && string(argv[1]).compare(0, 16, "--buscar-cedula=") == 0)
+        return consultarIndiceCedulas(rutaUsuarios, argv[1] + 16, SEMILLA);
+
+    if (argc > 1 && string(argv[1]).compare(0, 10, "--cliente=") == 0)
+        return menuCajeroRemoto(argv[1] + 10);
+    if (argc > 1 && string(argv[1]).compare(0, 8, "--carga=") == 0) {
+        OpcionesCarga carga;
+        carga.direccion = argv[1] + 8;
+        for (int a = 2; a < argc; a++) {
+            string arg = argv[a];
+            if (arg.compare(0, 11, "--clientes=") == 0)
+                carga.clientes = max(1, atoi(arg.c_str() + 11));
+            else if (arg.compare(0, 13, "--peticiones=") == 0)
+                carga.peticiones = max(1, atoi(arg.c_str() + 13));
+            else if (arg.compare(0, 15, "--credenciales=") == 0)
+                carga.rutaCredenciales = arg.substr(15);
+            else if (arg == "--escalado")
+                carga.escalado = true;
+        }
+        return generarCarga(carga);
+    }
+
+    int fsyncCada = 1;
+    int intervaloPuntoControl = 30;
+    bool usarBitacora = true;
+    string rutaImportacion;
+    string rutaLote;
+    string direccionServicio;
+    for (int a = 1; a < argc; a++) {
+        string arg = argv[a];
+        if (arg.compare(0, 8, "--fsync=") == 0)
+            fsyncCada = max(0, atoi(arg.c_str() + 8));
+        else if (arg.compare(0, 16, "--punto-control=") == 0)
+            intervaloPuntoControl = max(0, atoi(arg.c_str() + 16));
+        else if (arg == "--sin-bitacora")
+            usarBitacora = false;
+        else if (arg.compare(0, 11, "--importar=") == 0)
+            rutaImportacion = arg.substr(11);
+        else if (arg.compare(0, 7, "--lote=") == 0)
+            rutaLote = arg.substr(7);
+        else if (arg.compare(0, 11, "--servicio=") == 0)
+            direccionServicio = arg.substr(11);
+    }
+
     try {
+        PoolHilos pool(NUM_HILOS);
+
         cout << "================================================\n";
         cout << "    SISTEMA DE CAJERO AUTOMATICO v2.0\n";
         cout << "================================================\n\n";
 
-        // [1] Cargar archivos
-        cout << "[1/5] Cargando archivos del sistema...\n";
-        string* usuarios = leerArchivoLineas(rutaUsuarios.c_str(), numUsuarios);
-        string* admins   = leerArchivoLineas(rutaAdmins.c_str(), numAdmins);
+        // [0] Primer arranque con archivos de texto en texto plano: se cifran
+        // por flujo, sin cargarlos, y se cargan ya cifrados
+        string primerUsuario = primeraLineaTexto(rutaUsuarios);
+        string primerAdmin   = primeraLineaTexto(rutaAdmins);
+        if (primerUsuario.find_first_not_of("01") != string::npos &&
+            primerAdmin.find_first_not_of("01") != string::npos) {
+            cout << "Archivos en texto plano → Encriptando por flujo con semilla " << SEMILLA << "...\n";
+            if (!encriptarAlmacenFlujo(rutaUsuarios, rutaUsuarios, SEMILLA) ||
+                !encriptarAlmacenFlujo(rutaAdmins, rutaAdmins, SEMILLA))
+                throw "Error al encriptar los archivos en texto plano.";
+            cout << "Archivos encriptados y guardados.\n\n";
+        }
 
-        if (!usuarios || numUsuarios == 0)
+        // [1] Cargar archivos (vistas sobre el archivo proyectado, sin copiar)
+        cout << "[1/5] Cargando archivos del sistema...\n";
+        LineasMapeadas mapaUsuarios, mapaAdmins;
+        if (!cargarLineasMapeadas(rutaUsuarios, mapaUsuarios))
             throw "Error: No se pudieron cargar usuarios.";
-        if (!admins || numAdmins == 0)
+        if (!cargarLineasMapeadas(rutaAdmins, mapaAdmins))
             throw "Error: No se pudieron cargar administradores.";
+        numUsuarios = static_cast<int>(mapaUsuarios.vistas.size());
+        numAdmins   = static_cast<int>(mapaAdmins.vistas.size());
+
+        // Al guardar se respeta el formato de cada archivo; guardarAlmacen()
+        // pasa a segmentos si los datos ya no caben en uno solo
+        const bool usuariosEmpaquetados = esAlmacenEmpaquetado(rutaUsuarios);
+        const bool adminsEmpaquetados   = esAlmacenEmpaquetado(rutaAdmins);
 
         cout << "Archivos cargados correctamente.\n";
         cout << "  - Usuarios: " << numUsuarios << " registros\n";
@@ -49,65 +361,245 @@ int main() {
 
         // [2] Verificar estado de encriptacion
         cout << "[2/5] Verificando estado de encriptacion...\n";
-        bool yaEncriptados = verificarEstadoEncriptacion(usuarios, admins);
+        bool yaEncriptados = verificarEstadoEncriptacion(mapaUsuarios.vistas[0], mapaAdmins.vistas[0]);
 
         if (!yaEncriptados) {
             cout << "Archivos en texto plano → Encriptando con semilla " << SEMILLA << "...\n";
-            encriptarArchivo(admins, numAdmins, SEMILLA);
-            encriptarArchivo(usuarios, numUsuarios, SEMILLA);
+            // Se van a modificar: recien aqui se copian las lineas
+            string* usuarios = copiarLineas(mapaUsuarios, numUsuarios);
+            string* admins   = copiarLineas(mapaAdmins, numAdmins);
+            mapaUsuarios.cerrar();
+            mapaAdmins.cerrar();
 
-            guardarArchivoLineas(rutaUsuarios.c_str(), usuarios, numUsuarios);
-            guardarArchivoLineas(rutaAdmins.c_str(), admins, numAdmins);
+            encriptarArchivo(admins, numAdmins, SEMILLA, pool);
+            encriptarArchivo(usuarios, numUsuarios, SEMILLA, pool);
+
+            guardarAlmacen(rutaUsuarios, usuarios, numUsuarios, usuariosEmpaquetados);
+            guardarAlmacen(rutaAdmins, admins, numAdmins, adminsEmpaquetados);
 
             cout << "Archivos encriptados y guardados.\n\n";
 
             delete[] usuarios;
             delete[] admins;
 
-            usuarios = leerArchivoLineas(rutaUsuarios.c_str(), numUsuarios);
-            admins   = leerArchivoLineas(rutaAdmins.c_str(), numAdmins);
-
-            if (!usuarios || !admins)
+            if (!cargarLineasMapeadas(rutaUsuarios, mapaUsuarios) || !cargarLineasMapeadas(rutaAdmins, mapaAdmins))
                 throw "Error al recargar los archivos encriptados.";
+            numUsuarios = static_cast<int>(mapaUsuarios.vistas.size());
+            numAdmins   = static_cast<int>(mapaAdmins.vistas.size());
 
             cout << "Archivos recargados.\n\n";
         } else {
             cout << "Los archivos ya estan encriptados.\n\n";
         }
 
-        // [3] Desencriptar en memoria
+        // [3] Desencriptar en memoria: el binario se lee de la proyeccion y
+        // solo se reserva el texto plano
         cout << "[" << (yaEncriptados ? "3" : "4") << "/5] Desencriptando datos en memoria...\n";
-        desencriptarArchivo(admins, numAdmins, SEMILLA);
-        desencriptarArchivo(usuarios, numUsuarios, SEMILLA);
-        cout << "Datos desencriptados y listos para usar.\n\n";
+        string* admins   = desencriptarVistas(mapaAdmins.vistas.data(), numAdmins, SEMILLA, pool);
+        string* usuarios = desencriptarVistas(mapaUsuarios.vistas.data(), numUsuarios, SEMILLA, pool);
+        // El texto cifrado se conserva: al guardar solo se cifran las
+        // cuentas que cambiaron
+        vector<string> cifradasUsuarios(mapaUsuarios.vistas.begin(), mapaUsuarios.vistas.end());
+        mapaUsuarios.cerrar();   // al final se sobrescriben los archivos
+        mapaAdmins.cerrar();
+        if (!usuarios || !admins)
+            throw "Error al desencriptar los datos.";
+        cout << "Datos desencriptados y listos para usar.\n";
+
+        // Mostrar datos desencriptados (modo debug; solo con el menu local)
+        if (rutaImportacion.empty() && rutaLote.empty() && direccionServicio.empty()) {
+            cout << "--- DEPURACION: Usuarios desencriptados ---\n";
+            mostrarLineas(usuarios, numUsuarios);
+            cout << "--- DEPURACION: Administradores desencriptados ---\n";
+            mostrarLineas(admins, numAdmins);
+        }
+
+        // Las cuentas se interpretan una sola vez; las lineas se vuelven a
+        // armar solo al guardar
+        vector<Cuenta> cuentas;
+        bool cargadas = cargarCuentas(usuarios, numUsuarios, cuentas);
+        delete[] usuarios;
+        if (!cargadas)
+            throw "Los registros de usuarios tienen un formato invalido.";
+
+        // Indices por cedula: las busquedas del menu dejan de recorrer
+        // todos los registros
+        IndiceCedulas indiceUsuarios, indiceAdmins;
+        int sinIndice = indexarCuentas(indiceUsuarios, cuentas.data(), numUsuarios)
+                      + indiceAdmins.construir(admins, numAdmins);
+        if (sinIndice > 0)
+            cerr << "Advertencia: " << sinIndice << " registro(s) con cedula invalida o repetida no se indexaron.\n";
+        cout << "\n";
+
+        // Bitacora: lo que una sesion interrumpida no llego a guardar se
+        // aplica y se guarda antes de empezar
+        const string rutasBitacora[] = { rutaUsuarios + ".bitacora.vieja", rutaUsuarios + ".bitacora" };
+        uint64_t ultimaSecuencia = 0;
+        int recuperadas = reproducirBitacoras(rutasBitacora, 2, SEMILLA, cuentas, indiceUsuarios, ultimaSecuencia);
+        numUsuarios = static_cast<int>(cuentas.size());
+        if (recuperadas > 0) {
+            guardarCuentas(rutaUsuarios, cuentas, cifradasUsuarios, SEMILLA, usuariosEmpaquetados, pool);
+            cout << "Bitacora: " << recuperadas << " cuenta(s) recuperadas de la sesion anterior.\n\n";
+        }
+        remove(rutasBitacora[0].c_str());
+        remove(rutasBitacora[1].c_str());
+
+        // Indice en disco: se rehace si falta o no corresponde a los datos
+        if (!indicePersistenteVigente(rutaUsuarios))
+            guardarIndicePersistente(rutaUsuarios, cuentas.data(), cifradasUsuarios.data(), numUsuarios);
 
-        // Mostrar datos desencriptados (modo debug)
-        cout << "--- DEPURACION: Usuarios desencriptados ---\n";
-        mostrarLineas(usuarios, numUsuarios);
-        cout << "--- DEPURACION: Administradores desencriptados ---\n";
-        mostrarLineas(admins, numAdmins);
+        // Importacion masiva: en lugar del menu se agregan las filas
+        // aceptadas del CSV y se guarda una sola vez
+        if (!rutaImportacion.empty()) {
+            if (!autenticarAdministrador(admins, numAdmins, indiceAdmins))
+                throw "Credenciales invalidas.";
+            ResultadoImportacion resultado;
+            if (!importarUsuarios(rutaImportacion, cuentas, indiceUsuarios, pool, resultado))
+                throw "No se pudo leer el archivo de importacion.";
+
+            auto inicioGuardado = chrono::steady_clock::now();
+            guardarCuentas(rutaUsuarios, cuentas, cifradasUsuarios, SEMILLA, usuariosEmpaquetados, pool);
+            numUsuarios = static_cast<int>(cuentas.size());
+            guardarIndicePersistente(rutaUsuarios, cuentas.data(), cifradasUsuarios.data(), numUsuarios);
+            double segundosGuardado = chrono::duration<double>(chrono::steady_clock::now() - inicioGuardado).count();
+
+            const string rutaRechazos = rutaImportacion + ".rechazos";
+            cout << "\nImportacion: " << resultado.filas << " filas, " << resultado.aceptadas << " aceptadas, "
+                 << resultado.rechazos.size() << " rechazadas.\n";
+            cout << "  Validacion " << resultado.segundosValidacion << " s, duplicados "
+                 << resultado.segundosDuplicados << " s, cifrado y guardado " << segundosGuardado << " s.\n";
+            if (!resultado.rechazos.empty() && guardarReporteRechazos(rutaRechazos, resultado))
+                cout << "  Rechazos en " << rutaRechazos << "\n";
+            delete[] admins;
+            return 0;
+        }
 
         // [4] Iniciar sistema
         cout << "[" << (yaEncriptados ? "4" : "5") << "/5] Iniciando sistema de cajero...\n";
         cout << "\n\n\n\n\n\n\n\n\n\n";
 
-        try {
-            menuPrincipal(usuarios, numUsuarios, admins, numAdmins);
-        } catch (const char* e) {
-            cerr << "[Error en menuPrincipal] " << e << endl;
+        // Con ranuras fijas cada cambio se cifra y se escribe de inmediato
+        // en la ranura de la cuenta; lo que falle queda marcado y se
+        // guarda al salir
+        ArchivoRanuras ranurasUsuarios;
+        mutex ranurasMutex;
+        int escritasEnRanura = 0;
+        AlModificarCuenta alModificar;
+        Bitacora bitacora;
+        atomic<uint64_t> ultimaEncolada{0};
+        const bool soloEncolar = !rutaLote.empty() || !direccionServicio.empty();
+        PuntoControl puntoControl;
+        // Un lote sobre ranuras no escribe cuenta por cuenta: se guarda
+        // una sola vez al terminar
+        const bool usuariosEnRanuras = esArchivoRanuras(rutaUsuarios);
+        if (usuariosEnRanuras && rutaLote.empty()) {
+            ranurasUsuarios.abrir(rutaUsuarios, fsyncCada);
+            alModificar = [&](int i, int64_t, MotivoCambio) {
+                // En el servicio llegan cambios de varias cuentas a la vez:
+                // se cifran en paralelo y solo la escritura se turna
+                string cifrada = encriptarCadena(serializarCuenta(cuentas[i]), SEMILLA);
+                lock_guard<mutex> lock(ranurasMutex);
+                if (!ranurasUsuarios.escribir(i, cifrada)) {
+                    cerr << "Advertencia: la cuenta no se pudo escribir en su ranura; se guardara al salir.\n";
+                    return;
+                }
+                if (static_cast<int>(cifradasUsuarios.size()) <= i)
+                    cifradasUsuarios.resize(i + 1);
+                cifradasUsuarios[i] = move(cifrada);
+                cuentas[i].modificada = false;
+                escritasEnRanura++;
+            };
+        } else if (!usuariosEnRanuras) {
+            // En los demas formatos el snapshot lo reescribe el hilo de
+            // puntos de control; cada movimiento se agrega antes a la
+            // bitacora y se espera a que este en disco. En un lote o en el
+            // servicio solo se encola: el lote espera una vez al final y el
+            // servicio antes de responder, fuera del bloqueo de cuentas
+            if (usarBitacora)
+                bitacora.abrir(rutasBitacora[1], SEMILLA, ultimaSecuencia + 1);
+            puntoControl.iniciar(rutaUsuarios, cuentas.data(), numUsuarios, SEMILLA, usuariosEmpaquetados, pool,
+                                 intervaloPuntoControl, usarBitacora ? &bitacora : nullptr, rutasBitacora[0]);
+            alModificar = [&](int i, int64_t delta, MotivoCambio motivo) {
+                puntoControl.actualizar(i, cuentas[i]);
+                if (!bitacora.abierta())
+                    return;
+                uint64_t secuencia = bitacora.registrar(motivo, delta, cuentas[i]);
+                if (secuencia != 0 && soloEncolar) {
+                    // Con varios cajeros a la vez solo avanza: quien espera
+                    // por la ultima encolada espera tambien por la suya
+                    uint64_t anterior = ultimaEncolada;
+                    while (anterior < secuencia && !ultimaEncolada.compare_exchange_weak(anterior, secuencia)) {}
+                } else if (secuencia == 0 || !bitacora.esperar(secuencia)) {
+                    cerr << "Advertencia: el movimiento no quedo en la bitacora; se guardara al salir.\n";
+                    return;
+                }
+                if (bitacora.tamanio() >= TAM_COMPACTAR_BITACORA)
+                    puntoControl.solicitar();
+            };
+        }
+
+        if (!rutaLote.empty()) {
+            const string rutaResultados = rutaLote + ".resultados";
+            ResumenLote resumen;
+            bool procesado = procesarLote(rutaLote, rutaResultados, cuentas, indiceUsuarios, alModificar, resumen);
+            auto inicioBitacora = chrono::steady_clock::now();
+            bool confirmado = ultimaEncolada == 0 || bitacora.esperar(ultimaEncolada);
+            double segundosBitacora = chrono::duration<double>(chrono::steady_clock::now() - inicioBitacora).count();
+
+            cout << "Lote: " << resumen.operaciones << " operaciones en " << resumen.segundos << " s ("
+                 << (resumen.segundos > 0 ? resumen.operaciones / resumen.segundos : 0) << " op/s).\n";
+            cout << "  " << resumen.exitosas << " exitosas, " << resumen.rechazadas << " rechazadas ("
+                 << resumen.autenticaciones << " auth, " << resumen.consultas << " consultas, "
+                 << resumen.retiros << " retiros).\n";
+            cout << "  Retirado " << resumen.totalRetirado << " COP, cobrado " << resumen.totalCobrado << " COP.\n";
+            if (ultimaEncolada != 0)
+                cout << "  Bitacora " << (confirmado ? "confirmada" : "NO confirmada") << " en "
+                     << segundosBitacora << " s.\n";
+            if (procesado)
+                cout << "  Resultados en " << rutaResultados << "\n";
+        } else if (!direccionServicio.empty()) {
+            ServicioCajero servicio(cuentas, indiceUsuarios, alModificar, [&] {
+                uint64_t secuencia = ultimaEncolada;
+                if (secuencia != 0 && !bitacora.esperar(secuencia))
+                    cerr << "Advertencia: el movimiento no quedo en la bitacora; se guardara al salir.\n";
+            });
+            cout << "Servicio de cajeros en " << direccionServicio << " (Ctrl+C para terminar)." << endl;
+            if (!servicio.atender(direccionServicio))
+                throw "No se pudo iniciar el servicio de cajeros.";
+            cout << "\nServicio detenido: " << servicio.sesionesAtendidas() << " sesiones, "
+                 << servicio.peticionesAtendidas() << " peticiones.\n";
+        } else {
+            try {
+                menuPrincipal(cuentas, admins, numAdmins, indiceUsuarios, indiceAdmins, alModificar);
+            } catch (const char* e) {
+                cerr << "[Error en menuPrincipal] " << e << endl;
+            }
         }
+        ranurasUsuarios.cerrar();
+        puntoControl.detener();
+        bitacora.cerrar();
 
         // [5] Guardar cambios
+        // Los administradores no cambian durante la sesion: su archivo no
+        // se reescribe
         cout << "\nGuardando cambios de forma segura...\n";
-        encriptarArchivo(admins, numAdmins, SEMILLA);
-        encriptarArchivo(usuarios, numUsuarios, SEMILLA);
+        int recifradas = guardarCuentas(rutaUsuarios, cuentas, cifradasUsuarios, SEMILLA, usuariosEmpaquetados, pool);
+        numUsuarios = static_cast<int>(cuentas.size());
+        if (!indicePersistenteVigente(rutaUsuarios))
+            guardarIndicePersistente(rutaUsuarios, cuentas.data(), cifradasUsuarios.data(), numUsuarios);
+        // El snapshot ya tiene todo y esta en disco (guardarCuentas() lanza
+        // si no): la bitacora sobra
+        remove(rutasBitacora[0].c_str());
+        remove(rutasBitacora[1].c_str());
 
-        guardarArchivoLineas(rutaUsuarios.c_str(), usuarios, numUsuarios);
-        guardarArchivoLineas(rutaAdmins.c_str(), admins, numAdmins);
+        if (recifradas > 0)
+            cout << "Datos guardados y encriptados correctamente (" << recifradas
+                 << " de " << numUsuarios << " cuentas cifradas de nuevo).\n";
+        else if (escritasEnRanura > 0)
+            cout << "Cambios ya escritos en sus ranuras: " << escritasEnRanura << ".\n";
+        else
+            cout << "No hubo cambios: los archivos no se reescribieron.\n";
 
-        cout << "Datos guardados y encriptados correctamente.\n";
-
-        delete[] usuarios;
         delete[] admins;
 
         cout << "\n================================================\n";